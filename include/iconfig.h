@@ -267,6 +267,25 @@ namespace klk
         */
         virtual const ISNMPInfo* getSNMPInfo() const throw() = 0;
 
+        /**
+           Checks message trace mode
+
+           In the mode all async messages are routed through
+           the messaging core module
+
+           @return
+           - true
+           - false
+        */
+        virtual bool isMessageTrace() const throw() = 0;
+
+        /**
+           Gets DVB adapter loops CPU affinity
+
+           @return the affinity spec (see @ref klk::conf::DVBAFFINITY)
+        */
+        virtual const std::string getDVBAffinity() const throw() = 0;
+
         /**
            Retrives the options list
 
@@ -51,6 +51,13 @@
 
 namespace klk
 {
+    namespace db
+    {
+        class ConnectionPool;
+    }
+
+    class TimerWheel;
+
     /** @defgroup grFactory Mediaserver's factory
 
         The group keeps defenitions for mediaserver's factories
@@ -224,6 +231,17 @@ namespace klk
         */
         virtual void sendMessage(const IMessagePtr& msg) = 0;
 
+        /**
+           @brief Sets message trace mode
+
+           By default async messages are delivered directly to
+           the receivers. In the trace mode they are routed through
+           the messaging core module.
+
+           @param[in] trace - enable/disable the mode
+        */
+        virtual void setMessageTrace(bool trace) = 0;
+
         /**
            @brief Retrieves modules list
 
@@ -365,6 +383,24 @@ namespace klk
         */
         virtual ITrigger* getEventTrigger() = 0;
 
+        /**
+           Gets the process-wide DB connections pool
+
+           @return the pool
+
+           @exception klk::Exception
+        */
+        virtual db::ConnectionPool* getDBPool() = 0;
+
+        /**
+           Gets the process-wide timer service
+
+           @return the timer wheel
+
+           @exception klk::Exception
+        */
+        virtual TimerWheel* getTimerWheel() = 0;
+
         /**
            Retrives the application module id
 
@@ -124,8 +124,10 @@ namespace klk
            Gets the list with modules IDs that should get the message
 
            @return the the list
+
+           @note the reference is valid while the message is alive
         */
-        virtual const StringList getReceiverList() const throw() = 0;
+        virtual const StringList& getReceiverList() const throw() = 0;
 
         /**
            Adds a new receiver to the list
@@ -170,6 +172,17 @@ namespace klk
         */
         virtual const StringList getList(const std::string& key) const = 0;
 
+        /**
+           Gets message specific data (integer value)
+
+           @param[in] key - the key name (data id)
+
+           @return the data
+
+           @exception klk::Exception if there is no data for the key
+           or it can not be represented as an integer
+        */
+        virtual long long getInteger(const std::string& key) const = 0;
 
         /**
            Sets message specific data (simple value)
@@ -189,6 +202,27 @@ namespace klk
         virtual void
             setData(const std::string& key, const StringList& data) = 0;
 
+        /**
+           Sets message specific data (integer value)
+
+           The value is kept without string conversion and is
+           accessible via getValue() as a string too
+
+           @param[in] data - the data to be set
+           @param[in] key - the key name (data id)
+        */
+        virtual void setData(const std::string& key, long long data) = 0;
+
+        /**
+           @brief Seals the message
+
+           The message is read only after the call: any data modification
+           will throw an exception. The message is sealed when it is passed
+           to a receiver module thus it can be read by several modules
+           without locking.
+        */
+        virtual void seal() throw() = 0;
+
 
         /**
            Gets message type
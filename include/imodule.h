@@ -75,6 +75,31 @@ namespace klk
            Unknown module id
         */
         const std::string UNKNOWN = "484ea667-9658-452d-9e3e-85f478083226";
+
+        /**
+           @brief Message queue statistics
+
+           Counters collected by the module message queue. The values are
+           updated without locks thus they are approximate
+        */
+        struct QueueStat
+        {
+            u_long m_received; ///< messages added to the queue
+            u_long m_processed; ///< messages taken from the queue
+            u_long m_overflow; ///< messages that did not fit the ring
+            size_t m_depth; ///< current queue depth
+            size_t m_max_depth; ///< max queue depth seen by the consumer
+            double m_wait_avg; ///< average time in queue (seconds)
+            double m_wait_max; ///< max time in queue (seconds)
+
+            /**
+               Constructor
+            */
+            QueueStat() :
+                m_received(0), m_processed(0), m_overflow(0),
+                m_depth(0), m_max_depth(0), m_wait_avg(0), m_wait_max(0)
+                {}
+        };
     };
 
     /**
@@ -173,6 +198,13 @@ namespace klk
         */
         virtual const double getCPUUsage() const = 0;
 
+        /**
+           Retrives the message queue statistics
+
+           @return the statistics
+        */
+        virtual const mod::QueueStat getQueueStat() const = 0;
+
         /**
            @brief Waits the module start
 
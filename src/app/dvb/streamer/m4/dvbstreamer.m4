@@ -9,12 +9,24 @@ dnl Station lock update interval
 DVBSTREAMER_LOCK_INTERVAL="37"
 AC_SUBST(DVBSTREAMER_LOCK_INTERVAL)
 
+dnl TS packets per UDP datagram (1..7)
+DVBSTREAMER_UDP_PACKETS="7"
+AC_SUBST(DVBSTREAMER_UDP_PACKETS)
+
+dnl UDP pacing bucket depth in datagrams (0 - no pacing)
+DVBSTREAMER_UDP_PACING="0"
+AC_SUBST(DVBSTREAMER_UDP_PACING)
+
 dnl SNMP defines
 DVBSTREAM_SNMPLIBNAME="klksnmpdvbstreamer"
 AC_SUBST(DVBSTREAM_SNMPLIBNAME)
 
 
 dnl test data
+DVBSTREAMER_TEST_FOLDER=$sharedir"/test/dvbstreamer"
+AC_SUBST(DVBSTREAMER_TEST_FOLDER)
+DVBSTREAMER_TEST_TSFILE=$DVBSTREAMER_TEST_FOLDER"/test.ts"
+AC_SUBST(DVBSTREAMER_TEST_TSFILE)
 
 dnl test sources
 DVBSTREAMER_TEST_SOURCE1="ccbc240f-d3b5-4e8c-9b8c-23797d4446a2"
@@ -69,6 +69,10 @@ int dmx_join_pid(struct adapter_s *a, unsigned int pid, int type) {
 	if(a->budgetmode && a->dmx.pidtable[0x2000].fd >= 0)
 		return 1;
 
+	/* Virtual adapter - the recording carries all PIDs */
+	if (a->virt.source)
+		return 1;
+
 	/* Already joined ? */
 	if (a->dmx.pidtable[pid].fd >= 0) {
 		logwrite(LOG_ERROR,"dmx: already joined pid %d", pid);
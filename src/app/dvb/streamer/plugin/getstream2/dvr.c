@@ -38,38 +38,151 @@ static inline char *dvrname(int adapter) {
 	return dvrname;
 }
 
-static inline void dvr_input_ts(struct adapter_s *a, uint8_t *ts) {
-	uint16_t	pid;
-	GList		*pcbl;
+static inline int dvr_wanted(struct adapter_s *a, uint16_t pid) {
+	return a->dvr.wanted[pid>>5] & (1U<<(pid&31));
+}
 
-	/* TS (Transport Stream) packets start with 0x47 */
-	if (ts[TS_SYNC_OFF] != TS_SYNC) {
-		logwrite(LOG_XTREME, "dvr: Non TS Stream packet (!0x47) received on dvr0");
-		dump_hex(LOG_XTREME, "dvr:", ts, TS_PACKET_SIZE);
-		return;
+static inline void dvr_set_wanted(struct adapter_s *a, uint16_t pid, int wanted) {
+	if (wanted)
+		a->dvr.wanted[pid>>5]|=(1U<<(pid&31));
+	else
+		a->dvr.wanted[pid>>5]&=~(1U<<(pid&31));
+}
+
+/*
+ * Append a callback to a flat dispatch table. The table grows by
+ * doubling into a fresh cache aligned block.
+ */
+static int dvr_cbtable_add(struct dvrcbtable_s *t, struct pidcallback_s *pcb) {
+	struct dvrcb_s	*cb;
+	unsigned int	size;
+
+	if (t->num == t->size) {
+		size=t->size ? t->size*2 : DVR_CB_INITIAL;
+
+		if (posix_memalign((void **) &cb, DVR_CB_ALIGN, size*sizeof(struct dvrcb_s)))
+			return 0;
+
+		if (t->num)
+			memcpy(cb, t->cb, t->num*sizeof(struct dvrcb_s));
+
+		free(t->cb);
+		t->cb=cb;
+		t->size=size;
 	}
 
-	/* Full stream callbacks - pseudo pid 0x2000 */
-	for(pcbl=g_list_first(a->dvr.fullcb);pcbl!=NULL;pcbl=g_list_next(pcbl)) {
-		struct pidcallback_s	*pcb=pcbl->data;
-		pcb->callback(ts, pcb->arg);
+	cb=&t->cb[t->num++];
+	cb->callback=pcb->callback;
+	cb->arg=pcb->arg;
+	cb->key=pcb;
+
+	return 1;
+}
+
+/*
+ * Remove a callback keeping the order of the others - consumers
+ * have been called in the order of registration ever since.
+ */
+static void dvr_cbtable_del(struct dvrcbtable_s *t, struct pidcallback_s *pcb) {
+	unsigned int	i;
+
+	for(i=0;i<t->num;i++) {
+		if (t->cb[i].key != pcb)
+			continue;
+
+		memmove(&t->cb[i], &t->cb[i+1], (t->num-i-1)*sizeof(struct dvrcb_s));
+		t->num--;
+		break;
+	}
+
+	if (!t->num) {
+		free(t->cb);
+		t->cb=NULL;
+		t->size=0;
+	}
+}
+
+/*
+ * Hand a run of count packets to every consumer of the table. Each
+ * consumer gets the whole run before the next one is called which keeps
+ * its state hot in the cache. Callbacks may add or remove entries of
+ * this very table (e.g. PAT/PMT updates) so the array and the number
+ * of entries are reread on every step.
+ */
+static inline void dvr_dispatch(struct dvrcbtable_s *t, uint8_t *ts, int count) {
+	unsigned int	i;
+	int		j;
+
+	for(i=0;i<t->num;i++) {
+		for(j=0;j<count && i<t->num;j++)
+			t->cb[i].callback(&ts[j*TS_PACKET_SIZE], t->cb[i].arg);
 	}
+}
+
+static inline void dvr_input_ts(struct adapter_s *a, uint8_t *ts, uint16_t pid, int count) {
+	a->dvr.pidtable[pid].packets+=count;
+
+	/* Full stream callbacks - pseudo pid 0x2000 */
+	if (a->dvr.fullcb.num)
+		dvr_dispatch(&a->dvr.fullcb, ts, count);
+
+	if (!dvr_wanted(a, pid))
+		return;
+
+	dvr_dispatch(&a->dvr.pidtable[pid].callback, ts, count);
+}
 
-	pid=ts_pid(ts);
-	a->dvr.pidtable[pid].packets++;
+/*
+ * Cut a chunk of TS packets into runs of packets on the same PID
+ * and fill them into dvr_input_ts. UDP datagrams staged on the way
+ * get sent at the end of the chunk
+ */
+void dvr_input(struct adapter_s *a, uint8_t *db, int len) {
+	int		i, run;
+	uint16_t	pid;
+	uint8_t		*ts;
+
+	for(i=0;i+TS_PACKET_SIZE<=len;i+=run*TS_PACKET_SIZE) {
+		run=1;
+
+		/* TS (Transport Stream) packets start with 0x47 */
+		if (db[i+TS_SYNC_OFF] != TS_SYNC) {
+			logwrite(LOG_XTREME, "dvr: Non TS Stream packet (!0x47) received on dvr0");
+			dump_hex(LOG_XTREME, "dvr:", &db[i], TS_PACKET_SIZE);
+			continue;
+		}
 
-	for(pcbl=g_list_first(a->dvr.pidtable[pid].callback);pcbl!=NULL;pcbl=g_list_next(pcbl)) {
-		struct pidcallback_s	*pcb=pcbl->data;
-		pcb->callback(ts, pcb->arg);
+		pid=ts_pid(&db[i]);
+
+		for(ts=&db[i+TS_PACKET_SIZE];ts+TS_PACKET_SIZE<=&db[len];ts+=TS_PACKET_SIZE) {
+			if (ts[TS_SYNC_OFF] != TS_SYNC || ts_pid(ts) != pid)
+				break;
+			run++;
+		}
+
+		dvr_input_ts(a, &db[i], pid, run);
 	}
+
+	/* Send what the UDP outputs staged from this chunk in one go */
+	if (a->udpdirty)
+		output_flush_udp(a);
 }
 
 void dvr_del_pcb(struct adapter_s *a, unsigned int pid, void *vpcb) {
 	struct pidcallback_s	*pcb=vpcb;
 
+	if (!pcb)
+		return;
+
 	logwrite(LOG_DEBUG, "dvr: Del callback for PID %4d (0x%04x) type %d (%s)",
 			pid, pid, pcb->pidt, pidtnames[pcb->pidt]);
 
+	/* Joined pseudo pid 0x2000 e.g. input full */
+	if (pid == PID_MAX+1) {
+		dvr_cbtable_del(&a->dvr.fullcb, pcb);
+		free(pcb);
+		return;
+	}
 
 	switch(pcb->type) {
 		case(DVRCB_SECTION):
@@ -81,16 +194,16 @@ void dvr_del_pcb(struct adapter_s *a, unsigned int pid, void *vpcb) {
 				a->dvr.pidtable[pid].seccb=NULL;
 			}
 
-			a->dvr.pidtable[pid].sectioncallback=
-				g_list_remove(a->dvr.pidtable[pid].sectioncallback, pcb);
+			dvr_cbtable_del(&a->dvr.pidtable[pid].sectioncallback, pcb);
 
 			break;
 		case(DVRCB_TS):
-			a->dvr.pidtable[pid].callback=
-				g_list_remove(a->dvr.pidtable[pid].callback, pcb);
+			dvr_cbtable_del(&a->dvr.pidtable[pid].callback, pcb);
 
-			if (!a->dvr.pidtable[pid].callback)
+			if (!a->dvr.pidtable[pid].callback.num) {
+				dvr_set_wanted(a, pid, 0);
 				dmx_leave_pid(a, pid);
+			}
 
 			break;
 	}
@@ -102,7 +215,7 @@ void dvr_del_pcb(struct adapter_s *a, unsigned int pid, void *vpcb) {
 void dvr_section_reassemble(void *ts, void *arg) {
 	struct dvrpt_s	*pidentry=arg;
 	int		off=0;
-	GList		*cbl;
+	unsigned int	i;
 
 	while(off < TS_PACKET_SIZE) {
 		off=psi_reassemble(pidentry->section, ts, off);
@@ -110,10 +223,9 @@ void dvr_section_reassemble(void *ts, void *arg) {
 		if (off<0)
 			break;
 
-		for(cbl=g_list_first(pidentry->sectioncallback);cbl!=NULL;cbl=g_list_next(cbl)) {
-			struct pidcallback_s	*pcb=cbl->data;
-			pcb->callback(pidentry->section, pcb->arg);
-		}
+		for(i=0;i<pidentry->sectioncallback.num;i++)
+			pidentry->sectioncallback.cb[i].callback(pidentry->section,
+					pidentry->sectioncallback.cb[i].arg);
 	}
 }
 
@@ -136,12 +248,16 @@ void *dvr_add_pcb(struct adapter_s *a, unsigned int pid, unsigned int type,
 	/* Joined pseudo pid 0x2000 e.g. input full */
 	if (pid == PID_MAX+1) {
 		/* FIXME: How to detect we need to join 0x2000? */
-		a->dvr.fullcb=g_list_append(a->dvr.fullcb, pcb);
+		if (!dvr_cbtable_add(&a->dvr.fullcb, pcb))
+			goto nomem;
 		return pcb;
 	}
 
 	switch(type) {
 		case(DVRCB_SECTION):
+			if (!dvr_cbtable_add(&a->dvr.pidtable[pid].sectioncallback, pcb))
+				goto nomem;
+
 			if (!a->dvr.pidtable[pid].secuser) {
 				a->dvr.pidtable[pid].section=psi_section_new();
 
@@ -153,20 +269,25 @@ void *dvr_add_pcb(struct adapter_s *a, unsigned int pid, unsigned int type,
 
 			a->dvr.pidtable[pid].secuser++;
 
-			a->dvr.pidtable[pid].sectioncallback=
-				g_list_append(a->dvr.pidtable[pid].sectioncallback, pcb);
-
 			break;
 		case(DVRCB_TS):
-			if (!a->dvr.pidtable[pid].callback)
+			/* Add first - a failed add must not leave the PID joined */
+			if (!dvr_cbtable_add(&a->dvr.pidtable[pid].callback, pcb))
+				goto nomem;
+
+			if (a->dvr.pidtable[pid].callback.num == 1)
 				dmx_join_pid(a, pid, DMX_PES_OTHER);
 
-			a->dvr.pidtable[pid].callback=
-				g_list_append(a->dvr.pidtable[pid].callback, pcb);
+			dvr_set_wanted(a, pid, 1);
 			break;
 	}
 
 	return pcb;
+
+nomem:
+	logwrite(LOG_ERROR, "dvr: Out of memory adding callback for PID %4d (0x%04x)", pid, pid);
+	free(pcb);
+	return NULL;
 }
 
 /*
@@ -174,7 +295,7 @@ void *dvr_add_pcb(struct adapter_s *a, unsigned int pid, unsigned int type,
  * another into dvr_input_ts
  */
 static void dvr_read(int fd, short event, void *arg) {
-	int			len, i;
+	int			len;
 	struct adapter_s	*adapter=arg;
 	uint8_t			*db=adapter->dvr.buffer.ptr;
 
@@ -207,10 +328,8 @@ static void dvr_read(int fd, short event, void *arg) {
 			break;
 		}
 
-		/* Loop on TS packets and fill them into dvr_input_ts */
-		for(i=0;i<len;i+=TS_PACKET_SIZE) {
-			dvr_input_ts(adapter, &db[i]);
-		}
+		/* Split into same PID runs and fill them into dvr_input_ts */
+		dvr_input(adapter, db, len);
 
 	} while (len == adapter->dvr.buffer.size*TS_PACKET_SIZE);
 }
@@ -314,6 +433,19 @@ int dvr_init(struct adapter_s *a) {
 
 	a->dvr.buffer.ptr=malloc(a->dvr.buffer.size*TS_PACKET_SIZE);
 
+	/* Virtual adapter - feed dvr_input from a recording */
+	if (a->virt.source) {
+		a->dvr.fd=-1;
+
+		if (!virt_init(a))
+			return 0;
+
+		dvr_init_stat_timer(a);
+		dvr_stuck_init(a);
+
+		return 1;
+	}
+
 	dvrfd=open(dvrname(a->no), O_RDONLY|O_NONBLOCK);
 
 	if (dvrfd < 0)
@@ -343,11 +475,17 @@ int dvr_init(struct adapter_s *a) {
 #ifdef KLK_SOURCE
 void dvr_deinit(struct adapter_s *adapter)
 {
-    event_del(&adapter->dvr.dvrevent);
-    evtimer_del(&adapter->dvr.stat.event);    
-    evtimer_del(&adapter->dvr.stucktimer);    
-
-    close(adapter->dvr.fd);
+    if (adapter->virt.source)
+        virt_deinit(adapter);
+    else
+        event_del(&adapter->dvr.dvrevent);
+    if (adapter->dvr.stat.interval)
+        evtimer_del(&adapter->dvr.stat.event);    
+    if (adapter->dvr.stuckinterval)
+        evtimer_del(&adapter->dvr.stucktimer);    
+
+    if (adapter->dvr.fd >= 0)
+        close(adapter->dvr.fd);
     
     if (adapter->dvr.buffer.ptr)
     {        
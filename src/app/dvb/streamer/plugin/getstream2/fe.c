@@ -483,6 +483,10 @@ static int fe_tune(struct adapter_s *adapter) {
 void fe_retune(struct adapter_s *adapter) {
 	time_t		now;
 
+	/* Nothing to tune for a virtual adapter */
+	if (adapter->virt.source)
+		return;
+
 	now=time(NULL);
 
 	/* Debounce the retuning */
@@ -697,6 +701,13 @@ static void fe_checkcap(struct adapter_s *adapter) {
 int fe_tune_init(struct adapter_s *adapter) {
 	char		fename[128];
 
+	/* Virtual adapter - there is no frontend, fe_get_status fakes one */
+	if (adapter->virt.source) {
+		adapter->fe.fd=-1;
+		logwrite(LOG_INFO, "fe: Adapter %d is virtual - skipping tuning", adapter->no);
+		return 0;
+	}
+
 	sprintf(fename, "/dev/dvb/adapter%d/frontend0", adapter->no);
 
 	adapter->fe.fd=open(fename, O_RDWR|O_NONBLOCK);
@@ -741,9 +752,41 @@ int fe_tune_init(struct adapter_s *adapter) {
 	return 0;
 }
 
+/*
+ * Read the frontend status and signal quality. A virtual adapter
+ * reports a perfect lock as long as its source is open.
+ */
+void fe_get_status(struct adapter_s *adapter, fe_status_t *status,
+		uint16_t *signal, uint16_t *snr, uint32_t *ber, uint32_t *unc) {
+
+	*status=0;
+	*signal=0;
+	*snr=0;
+	*ber=0;
+	*unc=0;
+
+	if (adapter->virt.source) {
+		if (adapter->virt.fd >= 0) {
+			*status=FE_HAS_SIGNAL|FE_HAS_CARRIER|FE_HAS_VITERBI|FE_HAS_SYNC|FE_HAS_LOCK;
+			*signal=0xffff;
+			*snr=0xffff;
+		}
+		return;
+	}
+
+	ioctl(adapter->fe.fd, FE_READ_STATUS, status);
+	ioctl(adapter->fe.fd, FE_READ_SIGNAL_STRENGTH, signal);
+	ioctl(adapter->fe.fd, FE_READ_SNR, snr);
+	ioctl(adapter->fe.fd, FE_READ_BER, ber);
+	ioctl(adapter->fe.fd, FE_READ_UNCORRECTED_BLOCKS, unc);
+}
+
 #ifdef KLK_SOURCE
 void fe_tune_deinit(struct adapter_s *adapter)
 {
+    if (adapter->virt.source)
+        return;
+
     event_del(&adapter->fe.event);    
     evtimer_del(&adapter->fe.timer);        
     if (adapter->fe.fd >= 0)
@@ -223,6 +223,10 @@ struct klkstat_s
 {
     int count; ///< data count read
     struct timeval lastupdate; ///< last update time
+    int drops; ///< datagrams dropped at send
+    int eagain; ///< sends refused with EAGAIN
+    int jitter; ///< paced datagrams departure jitter (usec)
+    int burst; ///< max datagrams sent back to back
 };    
 #endif //KLK_SOURCE
 
@@ -256,9 +260,30 @@ struct stream_s {
 #endif //KLKSOURCE
 };
 
+/*
+ * Flat PID dispatch - callback and argument are copied out of the
+ * pidcallback_s into a contiguous, cache aligned array so the per
+ * packet path walks memory linearly instead of chasing GList nodes.
+ */
+#define DVR_CB_ALIGN		64
+#define DVR_CB_INITIAL		4
+#define DVR_WANTED_WORDS	((PID_MAX+1)/32)
+
+struct dvrcb_s {
+	void		(*callback)(void *data, void *arg);
+	void		*arg;
+	void		*key;		/* pidcallback_s handed out by dvr_add_pcb */
+};
+
+struct dvrcbtable_s {
+	struct dvrcb_s	*cb;
+	unsigned int	num;
+	unsigned int	size;
+};
+
 struct dvrpt_s {
-	GList		*callback;
-	GList		*sectioncallback;
+	struct dvrcbtable_s	callback;
+	struct dvrcbtable_s	sectioncallback;
 	unsigned long	packets;
 
 	struct psisec_s	*section;
@@ -322,8 +347,11 @@ struct adapter_s {
 		time_t			lastinput;
 		int			stuckinterval;
 
-		/* List of full stream callbacks */
-		GList			*fullcb;
+		/* Full stream callbacks */
+		struct dvrcbtable_s	fullcb;
+
+		/* Bitmap of PIDs having TS callbacks */
+		uint32_t		wanted[DVR_WANTED_WORDS];
 
 		struct dvrpt_s		pidtable[PID_MAX+1];
 
@@ -354,6 +382,24 @@ struct adapter_s {
 		} pidtable[PID_MAX+1+1];			/* Space for 0x200 pid structures */
 	} dmx;
 
+	/* virtual.c - recorded TS from a file or FIFO instead of the DVB card */
+	struct {
+		char			*source;	/* NULL for a DVB card */
+		int			realtime;	/* PCR paced or max speed */
+		int			fd;
+		int			fifo;
+		struct event		event;
+		int			len;		/* Bytes in dvr.buffer */
+		int			off;		/* Bytes already fed */
+		unsigned int		pcrpid;		/* PID the pacing is locked to */
+		uint64_t		pcrbase;	/* 27MHz */
+		struct timeval		timebase;	/* Wall clock at pcrbase */
+		unsigned long		loops;		/* File restarts */
+	} virt;
+
+	/* UDP outputs with staged datagrams - flushed by dvr_input */
+	struct output_s		*udpdirty;
+
 	/* PAT */
 	struct {
 		void		*cbc;
@@ -399,6 +445,8 @@ void fe_tune_deinit(struct adapter_s *adapter);
 #endif
 
 void fe_retune(struct adapter_s *adapter);
+void fe_get_status(struct adapter_s *adapter, fe_status_t *status,
+		uint16_t *signal, uint16_t *snr, uint32_t *ber, uint32_t *unc);
 
 /*
  *
@@ -426,6 +474,7 @@ void stream_deinit(struct stream_s *stream);
 #endif // KLK_SOURCE
 
 void stream_send(void *data, void *arg);
+unsigned int stream_pcrpid(struct stream_s *stream);
 
 /*
  *
@@ -485,6 +534,22 @@ void dvr_deinit(struct adapter_s *adapter);
 void *dvr_add_pcb(struct adapter_s *a, unsigned int pid, unsigned int type,
 		unsigned int pidt, void (*callback)(void *data, void *arg), void *arg);
 void dvr_del_pcb(struct adapter_s *a, unsigned int pid, void *cbs);
+void dvr_input(struct adapter_s *a, uint8_t *buf, int len);
+void output_flush_udp(struct adapter_s *a);
+
+/*
+ *
+ *
+ * virtual.c
+ *
+ *
+ *
+ */
+#define VIRT_PCR_NONE		0xffff
+#define VIRT_IDLE_MS		10		/* Retry interval for an empty FIFO */
+
+int virt_init(struct adapter_s *adapter);
+void virt_deinit(struct adapter_s *adapter);
 
 /*
  *
@@ -525,6 +590,7 @@ void pmt_pidfrompat(struct adapter_s *a, unsigned int pnr, unsigned int pmtpid);
 void *pmt_join_pnr(struct adapter_s *a, unsigned int pnr, \
 			void (*callback)(void *data, void *arg), void *arg);
 unsigned int pmt_get_pmtpid(void *program);
+unsigned int pmt_get_pcrpid(void *program);
 
 #ifdef KLK_SOURCE
 void pmt_leave_pnr(struct adapter_s *a, unsigned int pnr, void *arg);
@@ -595,6 +661,26 @@ static inline unsigned int ts_cc(uint8_t *tsp) {
 	return (tsp[TS_CC_OFF] & TS_CC_MASK);
 }
 
+#define TS_PCR_HZ	27000000ULL
+#define TS_PCR_WRAP	((1ULL<<33)*300)
+
+/* Returns 1 and fills in the PCR (27MHz) if the packet carries one */
+static inline int ts_pcr(uint8_t *tsp, uint64_t *pcr) {
+	uint64_t	base;
+
+	if (!ts_has_af(tsp) || tsp[TS_AFC_LEN] < 7)
+		return 0;
+
+	/* PCR flag */
+	if (!(tsp[TS_AF_OFF+1] & 0x10))
+		return 0;
+
+	base=(uint64_t) tsp[6]<<25 | tsp[7]<<17 | tsp[8]<<9 | tsp[9]<<1 | tsp[10]>>7;
+	*pcr=base*300+((tsp[10]&0x1)<<8 | tsp[11]);
+
+	return 1;
+}
+
 #ifdef KLK_SOURCE
 #ifdef __cplusplus
 }
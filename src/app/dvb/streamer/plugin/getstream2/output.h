@@ -7,6 +7,7 @@
 #include <glib.h>
 
 #include <event.h>
+#include <time.h>
 
 #define RTCP_BUFFER_SIZE	4096
 
@@ -94,6 +95,27 @@ struct output_s	{
 	int			remoteport;
 	int			ttl;
 
+	/* UDP batching - datagrams are staged until the dvr chunk is done */
+	int			tspd;			/* TS packets per datagram */
+	int			gso;			/* Try UDP_SEGMENT */
+	int			udpstaged;		/* Linked on adapter udpdirty */
+	struct output_s		*udpnext;
+
+	/* UDP pacing - datagrams leave at the PCR derived bitrate */
+	struct {
+		int		burst;		/* Bucket depth in datagrams - 0 no pacing */
+		int		fd;		/* timerfd */
+		struct event	event;
+		unsigned int	pcrpid;
+		uint64_t	pcr;		/* Last PCR - 27MHz */
+		uint64_t	bytes;		/* Bytes since the last PCR */
+		uint64_t	rate;		/* Bytes per second - 0 not known yet */
+		int64_t		tokens;		/* Bytes */
+		struct timespec	last;		/* Last bucket refill */
+		struct timespec	lastsend;	/* Last datagram departure */
+		int64_t		jitter;		/* Departure jitter - nsec */
+	} pace;
+
 	/* RTCP or HTTP local port or local address */
 	char			*localaddr;
 
@@ -133,6 +155,10 @@ struct output_s	{
 
 };
 
+#if defined(KLK_SOURCE) && defined(__cplusplus)
+extern "C" {
+#endif // KLK_SOURCE
+
 int output_init(struct output_s *channel);
 int output_init_udp(struct output_s *o);
 int output_init_rtp(struct output_s *o);
@@ -151,4 +177,8 @@ void output_send_rtp(struct output_s *o, uint8_t *tsp);
 void output_send_http(struct output_s *o, uint8_t *tsp);
 void output_send_pipe(struct output_s *o, uint8_t *tsp);
 
+#if defined(KLK_SOURCE) && defined(__cplusplus)
+}
+#endif // KLK_SOURCE
+
 #endif
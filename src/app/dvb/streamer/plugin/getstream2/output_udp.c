@@ -1,12 +1,17 @@
+#define _GNU_SOURCE	/* sendmmsg */
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <unistd.h>
+#include <time.h>
 
 #include "getstream.h"
 #include "simplebuffer.h"
@@ -15,8 +20,106 @@
 
 #define UDP_MAX_TS	((1500-40)/TS_PACKET_SIZE)
 
+/*
+ * Datagrams staged per output - UDP_BATCH*UDP_MAX_TS packets fit into
+ * a single GSO send (64KB and 64 segments max)
+ */
+#define UDP_BATCH	32
+
+/*
+ * Pacing - instead of leaving in DVR read bursts the datagrams leave at
+ * the bitrate the PCRs on the program's PCR PID imply. A token bucket
+ * (bytes) is refilled at that rate and a timerfd wakes us once the next
+ * datagram is due.
+ */
+#define PACE_NONE	0xffff
+#define PACE_PCR_MAXGAP	(TS_PCR_HZ/2)	/* PCRs are max 100ms apart - larger gaps are discontinuities */
+#define PACE_NSEC	1000000000LL
+#define PACE_JITTER_SHIFT	4	/* RFC 3550 - J+=(|D|-J)/16 */
+
+static void output_udp_pace_timer(int fd, short event, void *arg);
+
+static int64_t pace_nsec(struct timespec *from, struct timespec *to) {
+	return (int64_t) (to->tv_sec-from->tv_sec)*PACE_NSEC+(to->tv_nsec-from->tv_nsec);
+}
+
+static int output_udp_pace_init(struct output_s *o) {
+	o->pace.fd=timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+	if (o->pace.fd < 0) {
+		logwrite(LOG_ERROR, "streamudp: No timerfd for pacing %s:%d - %s",
+				o->remoteaddr, o->remoteport, strerror(errno));
+		o->pace.burst=0;
+		return 0;
+	}
+
+	o->pace.pcrpid=PACE_NONE;
+	o->pace.rate=0;
+	o->pace.bytes=0;
+	o->pace.jitter=0;
+	o->pace.tokens=o->pace.burst*o->tspd*TS_PACKET_SIZE;
+	clock_gettime(CLOCK_MONOTONIC, &o->pace.last);
+	o->pace.lastsend=o->pace.last;
+
+	event_set(&o->pace.event, o->pace.fd, EV_READ|EV_PERSIST, output_udp_pace_timer, o);
+#ifdef KLK_SOURCE
+	event_base_set(o->stream->adapter->klkbase, &o->pace.event);
+#endif // KLK_SOURCE
+	event_add(&o->pace.event, NULL);
+
+	return 1;
+}
+
+/*
+ * Track the bitrate of the stream - bytes which went through the output
+ * between two PCRs on the PCR PID. As long as the PMT was not seen the
+ * first PID carrying a PCR is used.
+ */
+static void output_udp_pace_pcr(struct output_s *o, uint8_t *tsp) {
+	unsigned int	pid, want;
+	uint64_t	pcr, delta, rate;
+
+	o->pace.bytes+=TS_PACKET_SIZE;
+
+	if (!ts_pcr(tsp, &pcr))
+		return;
+
+	pid=ts_pid(tsp);
+	want=stream_pcrpid(o->stream);
+	if (want == PID_MAX)
+		want=(o->pace.pcrpid == PACE_NONE) ? pid : o->pace.pcrpid;
+
+	if (pid != want)
+		return;
+
+	if (pid != o->pace.pcrpid) {
+		logwrite(LOG_DEBUG, "streamudp: Pacing %s:%d on PCR PID %d",
+				o->remoteaddr, o->remoteport, pid);
+		o->pace.pcrpid=pid;
+		o->pace.pcr=pcr;
+		o->pace.bytes=0;
+		return;
+	}
+
+	delta=(pcr+TS_PCR_WRAP-o->pace.pcr)%TS_PCR_WRAP;
+	o->pace.pcr=pcr;
+
+	/* PCR discontinuity or a jump backwards - keep the last rate */
+	if (delta == 0 || delta > PACE_PCR_MAXGAP) {
+		o->pace.bytes=0;
+		return;
+	}
+
+	rate=o->pace.bytes*TS_PCR_HZ/delta;
+	o->pace.rate=(o->pace.rate) ? (o->pace.rate*7+rate)/8 : rate;
+	o->pace.bytes=0;
+}
+
 int output_init_udp(struct output_s *o) {
-	o->buffer=sb_init(UDP_MAX_TS, TS_PACKET_SIZE, 0);
+	/* Packets per datagram - defaults to as many as fit into the MTU */
+	if (o->tspd <= 0 || o->tspd > UDP_MAX_TS)
+		o->tspd=UDP_MAX_TS;
+
+	o->buffer=sb_init(UDP_BATCH*o->tspd, TS_PACKET_SIZE, 0);
 	if (!o->buffer)
 		goto errout1;
 
@@ -42,6 +145,18 @@ int output_init_udp(struct output_s *o) {
 	if (o->ttl)
 		socket_set_ttl(o->sockfd, o->ttl);
 
+	/* Try UDP segmentation offload first - the first failure turns it off */
+#ifdef UDP_SEGMENT
+	o->gso=1;
+#else
+	o->gso=0;
+#endif
+	o->udpstaged=0;
+	o->udpnext=NULL;
+
+	if (o->pace.burst > 0)
+		output_udp_pace_init(o);
+
 	/* We do want to get TSP packets */
 	o->receiver=1;
 
@@ -55,31 +170,252 @@ errout1:
 	return 0;
 }
 
-void output_send_udp(struct output_s *o, uint8_t *tsp) {
-	int	len;
+#ifdef UDP_SEGMENT
+/*
+ * Send all staged datagrams with a single sendmsg and let the kernel
+ * (or the NIC) cut them. Returns the datagrams sent or -1 in case
+ * the socket/device does not support UDP_SEGMENT.
+ */
+static int output_udp_send_gso(struct output_s *o, uint8_t *buf, int dlen, int dgrams) {
+	struct msghdr	msg;
+	struct iovec	iov;
+	struct cmsghdr	*cm;
+	char		control[CMSG_SPACE(sizeof(uint16_t))];
+	int		len;
 
-	sb_add_atoms(o->buffer, tsp, 1);
+	iov.iov_base=buf;
+	iov.iov_len=dlen*dgrams;
 
-	/* check whether another packet would fit ? */
-	if (!sb_free_atoms(o->buffer)) {
-		/* Send packet and reset valid counter */
-		len=send(o->sockfd, sb_bufptr(o->buffer), sb_buflen(o->buffer), MSG_DONTWAIT);
+	memset(&msg, 0, sizeof(msg));
+	memset(control, 0, sizeof(control));
+	msg.msg_iov=&iov;
+	msg.msg_iovlen=1;
+	msg.msg_control=control;
+	msg.msg_controllen=sizeof(control);
+
+	cm=CMSG_FIRSTHDR(&msg);
+	cm->cmsg_level=SOL_UDP;
+	cm->cmsg_type=UDP_SEGMENT;
+	cm->cmsg_len=CMSG_LEN(sizeof(uint16_t));
+	*((uint16_t *) CMSG_DATA(cm))=dlen;
+
+	len=sendmsg(o->sockfd, &msg, MSG_DONTWAIT);
+
+	if (len == dlen*dgrams)
+		return dgrams;
+
+	if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		return 0;
+
+	if (len < 0 && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP)) {
+		logwrite(LOG_INFO, "streamudp: UDP GSO not usable for %s:%d (%s) - using sendmmsg",
+				o->remoteaddr, o->remoteport, strerror(errno));
+		return -1;
+	}
+
+	/* Other errors - GSO sends are all or nothing */
+	return 0;
+}
+#endif
+
+/*
+ * Paced outputs - RFC 3550 style jitter of the datagram departures
+ * against the gap the bitrate implies. Datagrams sent back to back
+ * count with a gap of 0.
+ */
+static void output_udp_pace_jitter(struct output_s *o, int dlen, int dgrams) {
+	struct timespec	now;
+	int64_t		ideal, d;
+	int		i;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ideal=dlen*PACE_NSEC/o->pace.rate;
+
+	for(i=0;i<dgrams;i++) {
+		d=(i ? 0 : pace_nsec(&o->pace.lastsend, &now))-ideal;
+		if (d < 0)
+			d=-d;
+		o->pace.jitter+=(d-o->pace.jitter)>>PACE_JITTER_SHIFT;
+	}
+
+	o->pace.lastsend=now;
+}
+
+/*
+ * Send the first dgrams complete datagrams staged at the output.
+ * Whatever the socket does not take right now is dropped - a live
+ * stream must not queue up behind a slow receiver.
+ */
+static void output_udp_send_staged(struct output_s *o, int dgrams) {
+	struct mmsghdr	msg[UDP_BATCH];
+	struct iovec	iov[UDP_BATCH];
+	int		dlen=o->tspd*TS_PACKET_SIZE;
+	uint8_t		*buf=sb_bufptr(o->buffer);
+	int		sent=-1, len, i;
 
-		if (len != sb_buflen(o->buffer))
-			logwrite(LOG_DEBUG, "streamudp: send didnt send all %d of %d byte - %s\n",
-					len, sb_buflen(o->buffer), strerror(errno));
+	if (dgrams <= 0)
+		return;
 
-		sb_zap(o->buffer);
+	if (o->pace.burst && o->pace.rate)
+		output_udp_pace_jitter(o, dlen, dgrams);
+
+#ifdef UDP_SEGMENT
+	if (o->gso && dgrams > 1) {
+		sent=output_udp_send_gso(o, buf, dlen, dgrams);
+		if (sent < 0)
+			o->gso=0;
+	}
+#endif
+
+	if (sent < 0) {
+		memset(msg, 0, dgrams*sizeof(struct mmsghdr));
+		for(i=0;i<dgrams;i++) {
+			iov[i].iov_base=&buf[i*dlen];
+			iov[i].iov_len=dlen;
+			msg[i].msg_hdr.msg_iov=&iov[i];
+			msg[i].msg_hdr.msg_iovlen=1;
+		}
+
+		/* sendmmsg stops at the first failing datagram */
+		for(sent=0;sent<dgrams;sent+=len) {
+			len=sendmmsg(o->sockfd, &msg[sent], dgrams-sent, MSG_DONTWAIT);
+			if (len <= 0)
+				break;
+		}
+	}
+
+	if (sent < dgrams) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+			logwrite(LOG_DEBUG, "streamudp: dropped %d of %d datagrams to %s:%d - %s",
+					dgrams-sent, dgrams, o->remoteaddr, o->remoteport, strerror(errno));
+	}
 
 #ifdef KLK_SOURCE
-                if (len > 0 && o->klkstat)
-                {
-                    o->klkstat->count += len;                    
-                }                
+	if (o->klkstat) {
+		o->klkstat->count+=sent*dlen;
+		if (dgrams > o->klkstat->burst)
+			o->klkstat->burst=dgrams;
+		if (o->pace.burst)
+			o->klkstat->jitter=o->pace.jitter/1000;
+		if (sent < dgrams) {
+			o->klkstat->drops+=dgrams-sent;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				o->klkstat->eagain++;
+		}
+	}
 #endif //KLK_SOURCE
 
+	sb_drop_atoms(o->buffer, dgrams*o->tspd);
+}
+
+/*
+ * Send as many staged datagrams as the token bucket allows and arm the
+ * timer for the rest. Until the bitrate is known everything goes out.
+ */
+static void output_udp_pace(struct output_s *o) {
+	struct itimerspec	its;
+	struct timespec		now;
+	int			dlen=o->tspd*TS_PACKET_SIZE;
+	int			dgrams=sb_used_atoms(o->buffer)/o->tspd;
+	int64_t			elapsed, wait;
+	int			due;
+
+	if (!o->pace.rate) {
+		output_udp_send_staged(o, dgrams);
+		return;
+	}
+
+	/* Refill - an idle second fills any bucket */
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	elapsed=pace_nsec(&o->pace.last, &now);
+	if (elapsed > PACE_NSEC)
+		elapsed=PACE_NSEC;
+	o->pace.last=now;
+
+	o->pace.tokens+=o->pace.rate*elapsed/PACE_NSEC;
+	if (o->pace.tokens > (int64_t) o->pace.burst*dlen)
+		o->pace.tokens=(int64_t) o->pace.burst*dlen;
+
+	due=(o->pace.tokens > 0) ? o->pace.tokens/dlen : 0;
+	if (due > dgrams)
+		due=dgrams;
 
+	if (due) {
+		o->pace.tokens-=(int64_t) due*dlen;
+		output_udp_send_staged(o, due);
 	}
+
+	if (due == dgrams)
+		return;
+
+	/* Wake up once the next datagram is covered by tokens */
+	wait=(dlen-o->pace.tokens)*PACE_NSEC/o->pace.rate;
+	if (wait <= 0)
+		wait=1;
+
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec=wait/PACE_NSEC;
+	its.it_value.tv_nsec=wait%PACE_NSEC;
+	timerfd_settime(o->pace.fd, 0, &its, NULL);
+}
+
+static void output_udp_pace_timer(int fd, short event, void *arg) {
+	struct output_s	*o=arg;
+	uint64_t	expired;
+
+	if (read(fd, &expired, sizeof(expired)) != sizeof(expired))
+		return;
+
+	output_udp_pace(o);
+}
+
+void output_send_udp(struct output_s *o, uint8_t *tsp) {
+	struct adapter_s	*a=o->stream->adapter;
+
+	if (o->pace.burst)
+		output_udp_pace_pcr(o, tsp);
+
+	sb_add_atoms(o->buffer, tsp, 1);
+
+	/* Only complete datagrams get staged */
+	if (sb_used_atoms(o->buffer) % o->tspd)
+		return;
+
+	if (!o->udpstaged) {
+		o->udpstaged=1;
+		o->udpnext=a->udpdirty;
+		a->udpdirty=o;
+	}
+
+	/*
+	 * Staging full - do not wait for the end of the dvr chunk or the
+	 * pacing timer. The bucket debt of a paced output is forgiven.
+	 */
+	if (!sb_free_atoms(o->buffer)) {
+		output_udp_send_staged(o, sb_used_atoms(o->buffer)/o->tspd);
+		o->pace.tokens=0;
+	}
+}
+
+/*
+ * Called by dvr_input once a chunk of TS packets went through the
+ * demux - sends the datagrams staged by all UDP outputs of the adapter
+ */
+void output_flush_udp(struct adapter_s *a) {
+	struct output_s	*o, *next;
+
+	for(o=a->udpdirty;o!=NULL;o=next) {
+		next=o->udpnext;
+		o->udpnext=NULL;
+		o->udpstaged=0;
+
+		if (o->pace.burst)
+			output_udp_pace(o);
+		else
+			output_udp_send_staged(o, sb_used_atoms(o->buffer)/o->tspd);
+	}
+
+	a->udpdirty=NULL;
 }
 
 #ifdef KLK_SOURCE
@@ -87,6 +423,24 @@ void output_deinit_udp(struct output_s *o)
 {
     if (o)
     {  
+	struct output_s	**op;
+
+	/* Forget staged datagrams */
+	if (o->udpstaged) {
+		for(op=&o->stream->adapter->udpdirty;*op!=NULL;op=&(*op)->udpnext) {
+			if (*op == o) {
+				*op=o->udpnext;
+				break;
+			}
+		}
+		o->udpstaged=0;
+	}
+
+	if (o->pace.burst) {
+		event_del(&o->pace.event);
+		close(o->pace.fd);
+	}
+
 	/* Leave Multicast group if its a multicast destination */
 	socket_leave_multicast(o->sockfd, o->remoteaddr);
 
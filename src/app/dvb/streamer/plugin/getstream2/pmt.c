@@ -195,6 +195,16 @@ unsigned int pmt_get_pmtpid(void *pvoid) {
 	return prog->pmtpid;
 }
 
+/* PCR PID of the current PMT - PID_MAX if there is no PMT yet */
+unsigned int pmt_get_pcrpid(void *pvoid) {
+	struct program_s	*prog=pvoid;
+
+	if (!prog->pmtcurrent)
+		return PID_MAX;
+
+	return prog->pmtcurrent->pcrpid;
+}
+
 struct pmt_s *pmt_new(void ) {
 	return calloc(1, sizeof(struct pmt_s));
 }
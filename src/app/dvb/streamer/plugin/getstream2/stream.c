@@ -13,6 +13,23 @@ void stream_send(void *data, void *arg) {
 	}
 }
 
+/*
+ * PCR PID of the (first) program in the stream - PID_MAX if the
+ * stream has no program input or its PMT was not seen yet
+ */
+unsigned int stream_pcrpid(struct stream_s *stream) {
+	GList	*il;
+
+	for(il=g_list_first(stream->input);il;il=g_list_next(il)) {
+		struct input_s	*input=il->data;
+
+		if (input->type == INPUT_PNR && input->pnr.program)
+			return pmt_get_pcrpid(input->pnr.program);
+	}
+
+	return PID_MAX;
+}
+
 static void stream_init_pat(struct stream_s *stream);
 
 static void stream_send_pat(int fd, short event, void *arg) {
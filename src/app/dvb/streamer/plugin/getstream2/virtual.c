@@ -0,0 +1,194 @@
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include <event.h>
+
+#include "getstream.h"
+
+/*
+ * Virtual adapter - a recorded (multi program) TS is read from a file
+ * or a FIFO and fed into the same dvr_input/PSI pipeline a DVB card
+ * feeds. The frontend and the demux are faked (see fe.c and dmx.c) so
+ * streaming can be tested and benchmarked without tuner cards.
+ *
+ * In realtime mode the input is paced by the PCR of the first PID
+ * carrying one, otherwise the file is read as fast as the consumers
+ * eat it. Files are restarted at their end.
+ */
+
+#define VIRT_PCR_MAXJUMP	(5*TS_PCR_HZ)		/* Larger steps are discontinuities */
+
+static void virt_rebase(struct adapter_s *a, unsigned int pid, uint64_t pcr) {
+	a->virt.pcrpid=pid;
+	a->virt.pcrbase=pcr;
+	gettimeofday(&a->virt.timebase, NULL);
+}
+
+/*
+ * Returns the number of bytes which are due now. In case a PCR packet
+ * is in the future the delay until it is due is filled in.
+ */
+static int virt_pace(struct adapter_s *a, uint8_t *buf, int len, struct timeval *delay) {
+	struct timeval	now, due;
+	uint64_t	pcr, delta;
+	uint8_t		*ts;
+	int		i;
+
+	for(i=0;i+TS_PACKET_SIZE<=len;i+=TS_PACKET_SIZE) {
+		ts=&buf[i];
+
+		if (ts[TS_SYNC_OFF] != TS_SYNC || !ts_pcr(ts, &pcr))
+			continue;
+
+		if (a->virt.pcrpid == VIRT_PCR_NONE) {
+			virt_rebase(a, ts_pid(ts), pcr);
+			logwrite(LOG_DEBUG, "virtual: Pacing on PCR PID %d", a->virt.pcrpid);
+			continue;
+		}
+
+		if (ts_pid(ts) != a->virt.pcrpid)
+			continue;
+
+		delta=(pcr+TS_PCR_WRAP-a->virt.pcrbase)%TS_PCR_WRAP;
+
+		/* PCR discontinuity or a jump backwards */
+		if (delta > VIRT_PCR_MAXJUMP) {
+			virt_rebase(a, a->virt.pcrpid, pcr);
+			continue;
+		}
+
+		due.tv_sec=a->virt.timebase.tv_sec+delta/TS_PCR_HZ;
+		due.tv_usec=a->virt.timebase.tv_usec+(delta%TS_PCR_HZ)/27;
+		if (due.tv_usec >= 1000000) {
+			due.tv_sec++;
+			due.tv_usec-=1000000;
+		}
+
+		gettimeofday(&now, NULL);
+		if (timercmp(&due, &now, >)) {
+			timersub(&due, &now, delay);
+			return i;
+		}
+	}
+
+	return i;
+}
+
+static void virt_read(int fd, short event, void *arg) {
+	struct adapter_s	*a=arg;
+	uint8_t			*db=a->dvr.buffer.ptr;
+	int			size=a->dvr.buffer.size*TS_PACKET_SIZE;
+	int			len, n;
+	struct timeval		tv;
+
+	tv.tv_sec=0;
+	tv.tv_usec=0;
+
+	/* Refill - a partial packet from a FIFO is moved to the front */
+	if (a->virt.len-a->virt.off < TS_PACKET_SIZE) {
+		n=a->virt.len-a->virt.off;
+		if (n > 0)
+			memmove(db, &db[a->virt.off], n);
+		a->virt.len=n;
+		a->virt.off=0;
+
+		len=read(a->virt.fd, &db[n], size-n);
+
+		/* Keep the stuck check of dvr.c happy */
+		a->dvr.stat.reads++;
+
+		if (len == 0 && !a->virt.fifo) {
+			/* End of the recording - start over */
+			lseek(a->virt.fd, 0, SEEK_SET);
+			a->virt.len=0;
+			a->virt.pcrpid=VIRT_PCR_NONE;
+			a->virt.loops++;
+			goto next;
+		}
+
+		if (len <= 0) {
+			if (len < 0 && errno != EAGAIN)
+				logwrite(LOG_ERROR, "virtual: read from %s returned with errno %d / %s",
+						a->virt.source, errno, strerror(errno));
+
+			/* Empty FIFO or no writer yet */
+			tv.tv_usec=VIRT_IDLE_MS*1000;
+			goto next;
+		}
+
+#ifdef KLK_SOURCE
+		a->dvr.klkstat.count+=len;
+#endif
+		a->virt.len+=len;
+	}
+
+	/* Recordings do not need to start on a packet boundary */
+	while(a->virt.off < a->virt.len && db[a->virt.off] != TS_SYNC)
+		a->virt.off++;
+
+	n=a->virt.len-a->virt.off;
+	n-=n%TS_PACKET_SIZE;
+
+	if (a->virt.realtime)
+		n=virt_pace(a, &db[a->virt.off], n, &tv);
+
+	if (n > 0) {
+		dvr_input(a, &db[a->virt.off], n);
+		a->virt.off+=n;
+	}
+
+next:
+	evtimer_add(&a->virt.event, &tv);
+}
+
+int virt_init(struct adapter_s *a) {
+	struct stat	st;
+	struct timeval	tv;
+
+	a->virt.fd=open(a->virt.source, O_RDONLY|O_NONBLOCK);
+
+	if (a->virt.fd < 0) {
+		logwrite(LOG_ERROR, "virtual: failed opening %s: %s",
+				a->virt.source, strerror(errno));
+		return 0;
+	}
+
+	a->virt.fifo=(fstat(a->virt.fd, &st) == 0 && S_ISFIFO(st.st_mode));
+	a->virt.len=0;
+	a->virt.off=0;
+	a->virt.pcrpid=VIRT_PCR_NONE;
+	a->virt.loops=0;
+
+	logwrite(LOG_INFO, "virtual: Adapter %d reads %s %s at %s",
+			a->no, (a->virt.fifo ? "FIFO" : "file"), a->virt.source,
+			(a->virt.realtime ? "PCR pace" : "max speed"));
+
+	tv.tv_sec=0;
+	tv.tv_usec=0;
+
+	evtimer_set(&a->virt.event, virt_read, a);
+#ifdef KLK_SOURCE
+	event_base_set(a->klkbase, &a->virt.event);
+#endif // KLK_SOURCE
+	evtimer_add(&a->virt.event, &tv);
+
+	return 1;
+}
+
+void virt_deinit(struct adapter_s *a) {
+	evtimer_del(&a->virt.event);
+
+	if (a->virt.fd >= 0)
+		close(a->virt.fd);
+	a->virt.fd=-1;
+}
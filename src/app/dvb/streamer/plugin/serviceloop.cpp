@@ -0,0 +1,123 @@
+/**
+   @file serviceloop.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include "serviceloop.h"
+#include "stream.h"
+#include "log.h"
+#include "defines.h"
+
+using namespace klk;
+using namespace klk::dvb::stream::getstream2;
+
+//
+// ServiceLoop class
+//
+
+// Constructor
+ServiceLoop::ServiceLoop() :
+    m_lock(), m_streams(), m_event(), m_stop(false), m_scheduler()
+{
+    m_scheduler.startThread(
+        IThreadPtr(new base::FunctionThread(
+                       boost::bind(&ServiceLoop::run, this),
+                       boost::bind(&ServiceLoop::wakeup, this))));
+}
+
+// Destructor
+ServiceLoop::~ServiceLoop()
+{
+    m_stop = true;
+    m_scheduler.stop();
+}
+
+// Adds an adapter stream for servicing
+void ServiceLoop::add(Stream* stream)
+{
+    BOOST_ASSERT(stream);
+    Locker lock(&m_lock);
+    m_streams.push_back(stream);
+}
+
+// Removes the adapter stream
+void ServiceLoop::remove(Stream* stream) throw()
+{
+    // the lock is held by the service thread while it updates the streams
+    Locker lock(&m_lock);
+    m_streams.remove(stream);
+}
+
+// Service thread body
+void ServiceLoop::run()
+{
+    // the frontend polling should not preempt the adapter loops
+    if (setpriority(PRIO_PROCESS, syscall(SYS_gettid),
+                    PLUGIN_SERVICE_NICE) != 0)
+    {
+        klk_log(KLKLOG_ERROR, "Failed to lower DVB service loop priority");
+    }
+
+    while (!m_stop)
+    {
+        {
+            Locker lock(&m_lock);
+            std::for_each(m_streams.begin(), m_streams.end(),
+                          boost::bind(&Stream::updateStatus, _1));
+        }
+
+        if (m_stop)
+        {
+            break;
+        }
+        m_event.startWait(PLUGIN_UPDATEINFOINTERVAL);
+    }
+}
+
+// Wakes up the service thread at the stop
+void ServiceLoop::wakeup() throw()
+{
+    m_stop = true;
+    m_event.stopWait();
+}
@@ -0,0 +1,133 @@
+/**
+   @file serviceloop.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_SERVICELOOP_H
+#define KLK_SERVICELOOP_H
+
+#include <list>
+
+#include <boost/shared_ptr.hpp>
+
+#include "thread.h"
+#include "scheduler.h"
+
+namespace klk
+{
+    namespace dvb
+    {
+        namespace stream
+        {
+            namespace getstream2
+            {
+                class Stream;
+
+                /**
+                   @brief Low priority service loop for the DVB adapters
+
+                   The adapter loops only read the DVR devices and send
+                   the data. The frontend status polling and the device
+                   stat updates of all adapters are done there by
+                   the single low priority thread.
+                */
+                class ServiceLoop
+                {
+                public:
+                    /**
+                       Constructor
+
+                       @exception klk::Exception
+                    */
+                    ServiceLoop();
+
+                    /**
+                       Destructor
+                    */
+                    virtual ~ServiceLoop();
+
+                    /**
+                       Adds an adapter stream for servicing
+
+                       @param[in] stream - the stream to be added
+                    */
+                    void add(Stream* stream);
+
+                    /**
+                       Removes the adapter stream
+
+                       @param[in] stream - the stream to be removed
+
+                       @note the stream is not used after the return
+                    */
+                    void remove(Stream* stream) throw();
+                private:
+                    typedef std::list<Stream*> StreamList;
+
+                    mutable Mutex m_lock; ///< streams locker
+                    StreamList m_streams; ///< serviced streams
+                    Event m_event; ///< update interval wait
+                    volatile bool m_stop; ///< stop flag
+                    base::Scheduler m_scheduler; ///< service thread
+
+                    /**
+                       Service thread body
+                    */
+                    void run();
+
+                    /**
+                       Wakes up the service thread at the stop
+                    */
+                    void wakeup() throw();
+                private:
+                    /**
+                       Copy constructor
+                       @param[in] value - the copy param
+                    */
+                    ServiceLoop(const ServiceLoop& value);
+
+                    /**
+                       Assigment operator
+                       @param[in] value - the copy param
+                    */
+                    ServiceLoop& operator=(const ServiceLoop& value);
+                };
+
+                /**
+                   Smart pointer
+                */
+                typedef boost::shared_ptr<ServiceLoop> ServiceLoopPtr;
+            }
+        }
+    }
+}
+
+#endif //KLK_SERVICELOOP_H
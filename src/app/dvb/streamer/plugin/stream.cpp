@@ -39,8 +39,8 @@
 #endif
 
 #include <string.h>
-#include <sys/ioctl.h>
 #include <errno.h>
+#include <time.h>
 
 #include <boost/bind.hpp>
 
@@ -48,6 +48,7 @@
 #include "log.h"
 #include "exception.h"
 #include "defines.h"
+#include "affinity.h"
 
 // extrenal modules
 #include "dvb/dvbdev.h"
@@ -99,12 +100,26 @@ static void update_info_timer(int fd, short event, void *arg)
 // Stream class
 //
 
+// Retrives the clock time in microseconds
+static u_long get_clock_usec(clockid_t clock)
+{
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0)
+    {
+        return 0;
+    }
+    return static_cast<u_long>(ts.tv_sec) * 1000000UL + ts.tv_nsec / 1000;
+}
+
 // Constructor
-Stream::Stream(const IDevPtr& dev) :
-    m_dev(dev),
-    m_lock(), m_streams(), m_add_streams(), m_del_streams()
+Stream::Stream(const IDevPtr& dev, const std::string& affinity,
+               const ServiceLoopPtr& service) :
+    m_dev(dev), m_affinity(affinity), m_service(service),
+    m_lock(), m_thread(), m_haslock(0), m_lastcpu(0), m_lastwall(0),
+    m_streams(), m_add_streams(), m_del_streams()
 {
     BOOST_ASSERT(m_dev);
+    BOOST_ASSERT(m_service);
 
     memset(&m_adapter, 0, sizeof(m_adapter));
 }
@@ -120,10 +135,13 @@ void Stream::clean() throw()
 {
     if (m_adapter.klkbase)
         event_base_free(m_adapter.klkbase);
+    KLKFREE(m_adapter.virt.source);
     memset(&m_adapter, 0, sizeof(m_adapter));
 
     // no lock for the dev
+    m_haslock = 0;
     m_dev->setParam(dev::HASLOCK, "0");
+    m_dev->setParam(dev::LOOP_LOAD, 0);
 
     // not processed streams
     Locker lock(&m_lock);
@@ -183,6 +201,21 @@ void Stream::start()
     // base should be initialized
     BOOST_ASSERT(m_adapter.klkbase);
 
+    // the loop stays on the core (node) where its DVR buffers are
+    std::string affinity = m_affinity;
+    if (Affinity::pin(affinity) != OK)
+    {
+        klk_log(KLKLOG_ERROR, "Failed to pin adapter '%s' loop to '%s'",
+                m_dev->getStringParam(dev::NAME).c_str(), affinity.c_str());
+        affinity = "none";
+    }
+    m_dev->setParam(dev::LOOP_AFFINITY, affinity);
+
+    m_thread = pthread_self();
+    m_lastcpu = 0;
+    m_lastwall = 0;
+    m_service->add(this);
+
     try
     {
         // start main loopt
@@ -198,6 +231,9 @@ void Stream::start()
         klk_log(KLKLOG_ERROR, "Unknown exception in event_base_dispatch()");
     }
 
+    // no frontend polling after the release
+    m_service->remove(this);
+
     // deinit adapter
     releaseInit();
 
@@ -234,41 +270,72 @@ void Stream::stop() throw()
     }
 }
 
-// Updates DVB stat info
-void Stream::updateInfo()
+// Updates the frontend status and the loop load
+void Stream::updateStatus() throw()
 {
-    fe_status_t status;
-    uint16_t snr, signal;
-    uint32_t ber, unc;
+    try
+    {
+        fe_status_t status;
+        uint16_t snr, signal;
+        uint32_t ber, unc;
+
+        fe_get_status(&m_adapter, &status, &signal, &snr, &ber, &unc);
 
-    ioctl(m_adapter.fe.fd, FE_READ_STATUS, &status);
-    ioctl(m_adapter.fe.fd, FE_READ_SIGNAL_STRENGTH, &signal);
-    ioctl(m_adapter.fe.fd, FE_READ_SNR, &snr);
-    ioctl(m_adapter.fe.fd, FE_READ_BER, &ber);
-    ioctl(m_adapter.fe.fd, FE_READ_UNCORRECTED_BLOCKS, &unc);
+        // update dev
+        if (signal == 0)
+        {
+            klk_log(KLKLOG_ERROR, "Adapter '%s' does not have signal",
+                    m_dev->getStringParam(dev::NAME).c_str());
+        }
+
+        m_dev->setParam(dev::SIGNAL, signal);
+        m_dev->setParam(dev::SNR, snr);
+        m_dev->setParam(dev::BER, ber);
+        m_dev->setParam(dev::UNC, unc);
+        if (status & FE_HAS_LOCK)
+        {
+            m_haslock = 1;
+            m_dev->setParam(dev::HASLOCK, 1);
+        }
+        else
+        {
+            m_haslock = 0;
+            m_dev->setParam(dev::HASLOCK, 0);
+            klk_log(KLKLOG_ERROR, "Adapter '%s' does not have lock",
+                    m_dev->getStringParam(dev::NAME).c_str());
+        }
 
-    // update dev
-    if (signal == 0)
+        updateLoad();
+    }
+    catch(...)
     {
-        klk_log(KLKLOG_ERROR, "Adapter '%s' does not have signal",
-                m_dev->getStringParam(dev::NAME).c_str());
+        klk_log(KLKLOG_ERROR, "Got an exception while updating status");
     }
+}
 
-    m_dev->setParam(dev::SIGNAL, signal);
-    m_dev->setParam(dev::SNR, snr);
-    m_dev->setParam(dev::BER, ber);
-    m_dev->setParam(dev::UNC, unc);
-    if (status & FE_HAS_LOCK)
+// Updates the adapter loop CPU utilisation
+void Stream::updateLoad() throw()
+{
+    clockid_t clock;
+    if (pthread_getcpuclockid(m_thread, &clock) != 0)
     {
-        m_dev->setParam(dev::HASLOCK, 1);
+        return;
     }
-    else
+
+    const u_long cpu = get_clock_usec(clock);
+    const u_long wall = get_clock_usec(CLOCK_MONOTONIC);
+    if (m_lastwall != 0 && wall != m_lastwall)
     {
-        m_dev->setParam(dev::HASLOCK, 0);
-        klk_log(KLKLOG_ERROR, "Adapter '%s' does not have lock",
-                m_dev->getStringParam(dev::NAME).c_str());
+        const u_long load = (cpu - m_lastcpu) * 100 / (wall - m_lastwall);
+        m_dev->setParam(dev::LOOP_LOAD, static_cast<int>(load));
     }
+    m_lastcpu = cpu;
+    m_lastwall = wall;
+}
 
+// Updates DVB stat info
+void Stream::updateInfo()
+{
     // update dev rate
     try
     {
@@ -295,8 +362,8 @@ void Stream::updateInfo()
                   boost::bind(&Stream::updateRate, this, _1));
 
 
-    // add list first
-    if (status & FE_HAS_LOCK)
+    // add list first (the lock is updated by the service loop)
+    if (m_haslock)
     {
         std::for_each(m_add_streams.begin(), m_add_streams.end(),
                       boost::bind(&Stream::initStation, this, _1));
@@ -374,6 +441,18 @@ void Stream::initAdapter()
     int adapter_no = m_dev->getIntParam(dev::ADAPTER);
     m_adapter.no = adapter_no;
 
+    // a virtual adapter reads a recorded TS instead of the DVB card
+    m_adapter.virt.fd = -1;
+    if (m_dev->hasParam(dev::VIRTUAL_SOURCE) &&
+        !m_dev->getStringParam(dev::VIRTUAL_SOURCE).empty())
+    {
+        m_adapter.virt.source =
+            strdup(m_dev->getStringParam(dev::VIRTUAL_SOURCE).c_str());
+        BOOST_ASSERT(m_adapter.virt.source);
+        m_adapter.virt.realtime =
+            m_dev->getIntParam(dev::VIRTUAL_REALTIME);
+    }
+
     // FIXME!!! frontend does not used
     //int frontend_no =
     //boost::lexical_cast<int>(m_dev->getParam(dev::FRONTEND));
@@ -493,8 +572,10 @@ void Stream::checkAdapter()
 
     // now check the status
     fe_status_t status;
+    uint16_t snr, signal;
+    uint32_t ber, unc;
 
-    ioctl(m_adapter.fe.fd, FE_READ_STATUS, &status);
+    fe_get_status(&m_adapter, &status, &signal, &snr, &ber, &unc);
 
     if (!(status & FE_HAS_SIGNAL))
     {
@@ -510,6 +591,8 @@ void Stream::checkAdapter()
                         m_dev->getStringParam(dev::NAME).c_str());
     }
 
+    m_haslock = 1;
+
 }
 
 // Tune deinit
@@ -535,6 +618,10 @@ void Stream::initStation(const IStationPtr& station)
         stream->psineeded = 1;
         // stat collector
         stream->klkstat.count = 0;
+        stream->klkstat.drops = 0;
+        stream->klkstat.eagain = 0;
+        stream->klkstat.jitter = 0;
+        stream->klkstat.burst = 0;
         if (gettimeofday(&stream->klkstat.lastupdate, NULL) < 0)
         {
             throw Exception(__FILE__, __LINE__,
@@ -557,6 +644,8 @@ void Stream::initStation(const IStationPtr& station)
         BOOST_ASSERT(output);
 	output->type = OTYPE_UDP;
 	output->ttl = 15;
+        output->tspd = PLUGIN_UDP_PACKETS;
+        output->pace.burst = PLUGIN_UDP_PACING;
         output->remoteaddr = strdup(station->getRoute().getHost().c_str());
         BOOST_ASSERT(output->remoteaddr);
         output->remoteport = station->getRoute().getPort();
@@ -674,6 +763,21 @@ void Stream::updateRate(IStationPtr& station) throw()
 
         int rate = getRate(stream->klkstat);
         station->setRate(rate);
+
+        // datagrams the socket did not take since last update
+        if (stream->klkstat.drops != 0)
+        {
+            klk_log(KLKLOG_ERROR, "DVB stream for channel '%d' dropped "
+                    "%d UDP datagrams (%d EAGAIN)",
+                    pnr, stream->klkstat.drops, stream->klkstat.eagain);
+            stream->klkstat.drops = 0;
+            stream->klkstat.eagain = 0;
+        }
+
+        klk_log(KLKLOG_DEBUG, "DVB stream for channel '%d': %d bytes/sec, "
+                "burst %d datagrams, jitter %d usec",
+                pnr, rate, stream->klkstat.burst, stream->klkstat.jitter);
+        stream->klkstat.burst = 0;
     }
     catch(const std::exception& err)
     {
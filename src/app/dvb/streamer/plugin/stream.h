@@ -37,12 +37,15 @@
 #ifndef KLK_STREAM_H
 #define KLK_STREAM_H
 
+#include <pthread.h>
+
 #include <list>
 
 #include "thread.h"
 #include "ithreadfactory.h"
 
 #include "getstream2/getstream.h"
+#include "serviceloop.h"
 
 namespace klk
 {
@@ -64,9 +67,12 @@ namespace klk
                        Constructor
 
                        @param[in] dev - the dev with initial tune info
-
+                       @param[in] affinity - the loop pin target
+                       (none, cpuN or nodeN)
+                       @param[in] service - the frontend service loop
                     */
-                    explicit Stream(const IDevPtr& dev);
+                    Stream(const IDevPtr& dev, const std::string& affinity,
+                           const ServiceLoopPtr& service);
 
                     /**
                        Destructor
@@ -78,6 +84,13 @@ namespace klk
                     */
                     void updateInfo();
 
+                    /**
+                       Updates the frontend status and the loop load
+
+                       @note called from the service loop thread
+                    */
+                    void updateStatus() throw();
+
                     /**
                        Inits info timer
                     */
@@ -101,7 +114,13 @@ namespace klk
                     void stop() throw();
                 private:
                     const IDevPtr m_dev; ///< dev container with tune info
+                    const std::string m_affinity; ///< loop pin target
+                    const ServiceLoopPtr m_service; ///< frontend service
                     mutable klk::Mutex m_lock; ///< adapter lock mutex
+                    pthread_t m_thread; ///< adapter loop thread
+                    volatile int m_haslock; ///< frontend has lock
+                    u_long m_lastcpu; ///< loop thread CPU time (usec)
+                    u_long m_lastwall; ///< wall time at m_lastcpu (usec)
 
                     struct adapter_s m_adapter; ///< adapter structure
                     struct event m_checkdevevent; ///< checkdev event
@@ -203,6 +222,11 @@ namespace klk
                        @exception klk::Exception
                     */
                     const int getRate(struct klkstat_s& stat) const;
+
+                    /**
+                       Updates the adapter loop CPU utilisation
+                    */
+                    void updateLoad() throw();
                 private:
                     /**
                        Copy constructor
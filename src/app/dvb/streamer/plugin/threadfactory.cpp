@@ -43,6 +43,10 @@
 #include "stream.h"
 #include "streamthread.h"
 #include "dvbthreadinfo.h"
+#include "affinity.h"
+
+// extrenal modules
+#include "dvb/dvbdev.h"
 
 using namespace klk;
 using namespace klk::dvb::stream;
@@ -54,7 +58,7 @@ using namespace klk::dvb::stream::getstream2;
 
 // Constructor
 ThreadFactory::ThreadFactory(IFactory* factory) :
-    m_factory(factory)
+    m_factory(factory), m_service(new ServiceLoop())
 {
     BOOST_ASSERT(m_factory);
 }
@@ -68,7 +72,11 @@ ThreadFactory::~ThreadFactory()
 const IThreadInfoPtr ThreadFactory::createStreamThread(const IDevPtr& dev)
 {
     BOOST_ASSERT(dev);
-    StreamPtr stream(new Stream(dev));
+    const Affinity affinity(m_factory->getConfig()->getDVBAffinity());
+    StreamPtr stream(
+        new Stream(dev,
+                   affinity.getTarget(dev->getIntParam(dev::ADAPTER)),
+                   m_service));
     boost::shared_ptr<StreamThread> thread(new StreamThread(stream));
     return dvb::stream::IThreadInfoPtr(
         new dvb::stream::ThreadInfo(thread, dev, stream));
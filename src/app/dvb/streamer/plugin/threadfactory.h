@@ -39,6 +39,7 @@
 
 #include "ithreadfactory.h"
 #include "ifactory.h"
+#include "serviceloop.h"
 
 namespace klk
 {
@@ -77,6 +78,7 @@ namespace klk
                     virtual ~ThreadFactory();
                 private:
                     IFactory* const m_factory; ///< factory
+                    ServiceLoopPtr m_service; ///< adapters frontend service
 
                     /**
                        Gets a StreamThread pointer
@@ -63,7 +63,9 @@ typedef enum
     COLUMN_STATION = 2,
     COLUMN_DESTINATIONADDR = 3,
     COLUMN_DATARATE = 4,
-    COLUMN_DEVNAME = 5
+    COLUMN_DEVNAME = 5,
+    COLUMN_LOOPAFFINITY = 6,
+    COLUMN_LOOPLOAD = 7
 } Column;
 
 using namespace klk;
@@ -143,7 +145,7 @@ static void init_table(void)
         ASN_COUNTER,  /* index: klkIndex */
         0);
     table_info->min_column = COLUMN_INDEX;
-    table_info->max_column = COLUMN_DEVNAME;
+    table_info->max_column = COLUMN_LOOPLOAD;
 
     iinfo = SNMP_MALLOC_TYPEDEF(netsnmp_iterator_info);
     iinfo->get_first_data_point = table_get_first_data;
@@ -297,6 +299,7 @@ static int table_handler(
                 case COLUMN_STATION:
                 case COLUMN_DESTINATIONADDR:
                 case COLUMN_DEVNAME:
+                case COLUMN_LOOPAFFINITY:
                     snmp_set_var_typed_value(
                         request->requestvb,
                         ASN_OCTET_STR,
@@ -304,6 +307,7 @@ static int table_handler(
                         val.toString().size());
                     break;
                 case COLUMN_DATARATE:
+                case COLUMN_LOOPLOAD:
                     snmp_set_var_typed_integer(request->requestvb, ASN_INTEGER,
                                                val.toInt());
 
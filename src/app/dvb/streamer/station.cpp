@@ -38,8 +38,6 @@
 #include "config.h"
 #endif
 
-#include <boost/lexical_cast.hpp>
-
 #include "station.h"
 #include "log.h"
 #include "defines.h"
@@ -208,16 +206,8 @@ void  Station::setChannel(const std::string& channel)
     m_dev = m_factory->getResources()->getResourceByUUID(dev_uuid);
     BOOST_ASSERT(m_dev);
 
-    try
-    {
-        // channel number
-        m_no =
-            boost::lexical_cast<u_int>(res->getValue(msg::key::TVCHANNELNO));
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw Exception(__FILE__, __LINE__, err::BADLEXCAST);
-    }
+    // channel number
+    m_no = static_cast<u_int>(res->getInteger(msg::key::TVCHANNELNO));
 
     m_channel = channel;
     setInUse(true);
@@ -259,19 +249,12 @@ void Station::setRoute(const std::string& route)
                         proto.c_str());
     }
 
-    try
-    {
-        const std::string host = response->getValue(msg::key::NETHOST);
-        int port =
-            boost::lexical_cast<int>(response->getValue(msg::key::NETPORT));
+    const std::string host = response->getValue(msg::key::NETHOST);
+    const int port =
+        static_cast<int>(response->getInteger(msg::key::NETPORT));
 
-        // FIXME!!! retrive all info from the message
-        m_route = sock::RouteInfo(host, port, sock::UDP, sock::MULTICAST);
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw Exception(__FILE__, __LINE__, err::BADLEXCAST);
-    }
+    // FIXME!!! retrive all info from the message
+    m_route = sock::RouteInfo(host, port, sock::UDP, sock::MULTICAST);
 }
 
 
@@ -544,7 +544,9 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
         //klkStation          DisplayString,
         //klkDestinationAddr  DisplayString,
         //klkDataRate         Integer32,
-        //klkDevName          DisplayString
+        //klkDevName          DisplayString,
+        //klkLoopAffinity     DisplayString,
+        //klkLoopLoad         Integer32
 
         StationPtr station = *i;
         BOOST_ASSERT(station);
@@ -559,13 +561,32 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
                 boost::lexical_cast<std::string>(route.getPort());
             row.push_back(addr);
             row.push_back(station->getRate());
-            if (station->getDev())
+            const IDevPtr device = station->getDev();
+            if (device)
             {
-                row.push_back(station->getDev()->getStringParam(dev::NAME));
+                row.push_back(device->getStringParam(dev::NAME));
+                if (device->hasParam(dev::LOOP_AFFINITY))
+                {
+                    row.push_back(device->getStringParam(dev::LOOP_AFFINITY));
+                }
+                else
+                {
+                    row.push_back("none");
+                }
+                if (device->hasParam(dev::LOOP_LOAD))
+                {
+                    row.push_back(device->getIntParam(dev::LOOP_LOAD));
+                }
+                else
+                {
+                    row.push_back(0);
+                }
             }
             else
             {
                 row.push_back(NOTAVAILABLE);
+                row.push_back("none");
+                row.push_back(0);
             }
         }
         catch(...)
@@ -576,6 +597,8 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
             row.push_back(NOTAVAILABLE);
             row.push_back(0);
             row.push_back(NOTAVAILABLE);
+            row.push_back("none");
+            row.push_back(0);
         }
         table->addRow(row);
     }
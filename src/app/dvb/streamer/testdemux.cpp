@@ -0,0 +1,589 @@
+/**
+   @file testdemux.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <event.h>
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+#include "testdemux.h"
+#include "testdefines.h"
+#include "testutils.h"
+
+using namespace klk;
+using namespace klk::dvb::stream;
+
+namespace
+{
+    /// Packets to be fed through the demux at the benchmark
+    const size_t BENCHPACKETS = 5000000;
+
+    /// Creates a test TS packet
+    void makePacket(uint8_t* ts, unsigned int pid)
+    {
+        memset(ts, 0xff, TS_PACKET_SIZE);
+        ts[TS_SYNC_OFF] = TS_SYNC;
+        ts[TS_PID_OFF1] = (pid >> 8) & 0x1f;
+        ts[TS_PID_OFF2] = pid & 0xff;
+        ts[TS_CC_OFF] = 0x10;
+    }
+
+    /// Checks the wanted PID bitmap
+    bool isWanted(struct adapter_s* adapter, unsigned int pid)
+    {
+        return (adapter->dvr.wanted[pid >> 5] & (1U << (pid & 31))) != 0;
+    }
+
+    /// Receive buffer at the UDP output test
+    const size_t UDP_MAX_PAYLOAD = 65536;
+
+    /// TS packets per datagram at the default UDP output
+    const size_t UDP_MAX_PACKETS = 7;
+
+    /// Packet number offset at the UDP output test (first payload byte)
+    const size_t MARKER_OFF = 4;
+
+    /// Receives a datagram and checks the packet numbers at it
+    bool checkDatagram(int fd, int tspd, int first, int last)
+    {
+        uint8_t dgram[UDP_MAX_PAYLOAD];
+        ssize_t len = recv(fd, dgram, sizeof(dgram), MSG_DONTWAIT);
+        if (len != tspd * TS_PACKET_SIZE)
+        {
+            return false;
+        }
+        return dgram[TS_SYNC_OFF] == TS_SYNC &&
+            dgram[MARKER_OFF] == first &&
+            dgram[(tspd - 1) * TS_PACKET_SIZE + MARKER_OFF] == last;
+    }
+
+    /// Packets at the virtual adapter test file
+    const size_t VIRTPACKETS = 1000;
+
+    /// PCR step at the virtual adapter test file (10 ms at 27 MHz)
+    const uint64_t VIRTPCRSTEP = 270000;
+
+    /// Creates a test TS packet with PCR
+    void makePCRPacket(uint8_t* ts, unsigned int pid, uint64_t pcr)
+    {
+        makePacket(ts, pid);
+        const uint64_t base = pcr / 300;
+        const unsigned int ext = pcr % 300;
+        ts[TS_AFC_OFF] = 0x30; // adaptation field and payload
+        ts[TS_AFC_LEN] = 7;
+        ts[TS_AF_OFF + 1] = 0x10; // PCR flag
+        ts[6] = (base >> 25) & 0xff;
+        ts[7] = (base >> 17) & 0xff;
+        ts[8] = (base >> 9) & 0xff;
+        ts[9] = (base >> 1) & 0xff;
+        ts[10] = ((base & 0x1) << 7) | 0x7e | ((ext >> 8) & 0x1);
+        ts[11] = ext & 0xff;
+    }
+}
+
+//
+// TestDemux class
+//
+
+// Constructor
+TestDemux::TestDemux() :
+    m_adapter(NULL), m_keys(), m_pids()
+{
+}
+
+// Set up context before running a test.
+void TestDemux::setUp()
+{
+    m_adapter = static_cast<struct adapter_s*>(
+        calloc(1, sizeof(struct adapter_s)));
+    CPPUNIT_ASSERT(m_adapter);
+    CPPUNIT_ASSERT(dmx_init(m_adapter) == 1);
+    // the budget filter makes dmx_join_pid a no-op
+    // thus no DVB device is necessary for the test
+    m_adapter->budgetmode = 1;
+    m_adapter->dmx.pidtable[PID_MAX + 1].fd = open("/dev/null", O_RDONLY);
+    CPPUNIT_ASSERT(m_adapter->dmx.pidtable[PID_MAX + 1].fd >= 0);
+}
+
+// Clean up after the test run.
+void TestDemux::tearDown()
+{
+    if (m_adapter == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < m_keys.size(); i++)
+    {
+        dvr_del_pcb(m_adapter, m_pids[i], m_keys[i]);
+    }
+    m_keys.clear();
+    m_pids.clear();
+
+    close(m_adapter->dmx.pidtable[PID_MAX + 1].fd);
+    free(m_adapter);
+    m_adapter = NULL;
+}
+
+// Registers a TS callback that counts packets
+void TestDemux::addCounter(unsigned int pid, unsigned long* counter)
+{
+    void* key = dvr_add_pcb(m_adapter, pid, DVRCB_TS, PID_OTHER,
+                            &TestDemux::count, counter);
+    CPPUNIT_ASSERT(key);
+    m_keys.push_back(key);
+    m_pids.push_back(pid);
+}
+
+// The counting callback
+void TestDemux::count(void* data, void* arg)
+{
+    uint8_t* ts = static_cast<uint8_t*>(data);
+    BOOST_ASSERT(ts[TS_SYNC_OFF] == TS_SYNC);
+    (*static_cast<unsigned long*>(arg))++;
+}
+
+// The callback that feeds an UDP output
+void TestDemux::sendUDP(void* data, void* arg)
+{
+    output_send_udp(static_cast<struct output_s*>(arg),
+                    static_cast<uint8_t*>(data));
+}
+
+// The dispatch test
+void TestDemux::testDispatch()
+{
+    test::printOut("\nDemux dispatch test ... ");
+
+    const unsigned int pids[] = {0x100, 0x100, 0x100, 0x101, 0x100,
+                                 0x200, 0x200, 0x1fff, 0x101, 0x101};
+    const size_t count = sizeof(pids) / sizeof(pids[0]);
+    std::vector<uint8_t> buffer(count * TS_PACKET_SIZE);
+    for (size_t i = 0; i < count; i++)
+    {
+        makePacket(&buffer[i * TS_PACKET_SIZE], pids[i]);
+    }
+    // broken sync byte at the last packet
+    buffer[(count - 1) * TS_PACKET_SIZE] = 0;
+
+    unsigned long counters[4] = {0, 0, 0, 0};
+    addCounter(0x100, &counters[0]);
+    addCounter(0x101, &counters[1]);
+    addCounter(0x101, &counters[2]);
+    addCounter(PID_MAX + 1, &counters[3]);
+
+    CPPUNIT_ASSERT(isWanted(m_adapter, 0x100) == true);
+    CPPUNIT_ASSERT(isWanted(m_adapter, 0x101) == true);
+    CPPUNIT_ASSERT(isWanted(m_adapter, 0x200) == false);
+    // the callbacks array is cache aligned
+    CPPUNIT_ASSERT(
+        (reinterpret_cast<uintptr_t>(
+            m_adapter->dvr.pidtable[0x101].callback.cb) % DVR_CB_ALIGN) == 0);
+
+    dvr_input(m_adapter, &buffer[0], buffer.size());
+    CPPUNIT_ASSERT(counters[0] == 4);
+    CPPUNIT_ASSERT(counters[1] == 2);
+    CPPUNIT_ASSERT(counters[2] == 2);
+    CPPUNIT_ASSERT(counters[3] == count - 1);
+    // unwanted packets are counted for the stats
+    CPPUNIT_ASSERT(m_adapter->dvr.pidtable[0x200].packets == 2);
+
+    // the PID leaves the bitmap with its last callback
+    dvr_del_pcb(m_adapter, m_pids[1], m_keys[1]);
+    CPPUNIT_ASSERT(isWanted(m_adapter, 0x101) == true);
+    CPPUNIT_ASSERT(m_adapter->dvr.pidtable[0x101].callback.num == 1);
+    dvr_del_pcb(m_adapter, m_pids[2], m_keys[2]);
+    CPPUNIT_ASSERT(isWanted(m_adapter, 0x101) == false);
+    CPPUNIT_ASSERT(m_adapter->dvr.pidtable[0x101].callback.cb == NULL);
+    m_keys.erase(m_keys.begin() + 1, m_keys.begin() + 3);
+    m_pids.erase(m_pids.begin() + 1, m_pids.begin() + 3);
+
+    // a partial packet at the end is ignored
+    dvr_input(m_adapter, &buffer[0], 3 * TS_PACKET_SIZE + 100);
+    CPPUNIT_ASSERT(counters[0] == 7);
+    CPPUNIT_ASSERT(counters[1] == 2);
+    CPPUNIT_ASSERT(counters[3] == count + 2);
+}
+
+// Runs the virtual adapter over a file
+unsigned long TestDemux::runVirtual(const std::string& path,
+                                    bool realtime, u_int msec,
+                                    u_int& elapsed)
+{
+    unsigned long counter = 0;
+    addCounter(0x100, &counter);
+
+    m_adapter->klkbase = event_base_new();
+    CPPUNIT_ASSERT(m_adapter->klkbase);
+    m_adapter->dvr.buffer.size = DVR_BUFFER_DEFAULT;
+    m_adapter->virt.source = const_cast<char*>(path.c_str());
+    m_adapter->virt.realtime = realtime ? 1 : 0;
+    CPPUNIT_ASSERT(fe_tune_init(m_adapter) == 0);
+    CPPUNIT_ASSERT(dvr_init(m_adapter) == 1);
+
+    fe_status_t status;
+    uint16_t snr, signal;
+    uint32_t ber, unc;
+    fe_get_status(m_adapter, &status, &signal, &snr, &ber, &unc);
+    CPPUNIT_ASSERT(status & FE_HAS_LOCK);
+
+    struct timeval tv;
+    tv.tv_sec = msec / 1000;
+    tv.tv_usec = (msec % 1000) * 1000;
+    const double start = test::getTime();
+    event_base_loopexit(m_adapter->klkbase, &tv);
+    event_base_dispatch(m_adapter->klkbase);
+    elapsed = static_cast<u_int>((test::getTime() - start) * 1000);
+
+    dvr_deinit(m_adapter);
+    fe_tune_deinit(m_adapter);
+    event_base_free(m_adapter->klkbase);
+    m_adapter->klkbase = NULL;
+    m_adapter->virt.source = NULL;
+
+    dvr_del_pcb(m_adapter, m_pids.back(), m_keys.back());
+    m_keys.pop_back();
+    m_pids.pop_back();
+
+    return counter;
+}
+
+// The virtual adapter test
+void TestDemux::testVirtual()
+{
+    test::printOut("\nVirtual adapter test ... ");
+
+    // 1 second of a single program: PCR every 10th packet
+    char path[] = "/tmp/klktestvirtXXXXXX";
+    const int fd = mkstemp(path);
+    CPPUNIT_ASSERT(fd >= 0);
+    std::vector<uint8_t> buffer(VIRTPACKETS * TS_PACKET_SIZE);
+    for (size_t i = 0; i < VIRTPACKETS; i++)
+    {
+        uint8_t* ts = &buffer[i * TS_PACKET_SIZE];
+        if (i % 10 == 0)
+        {
+            makePCRPacket(ts, 0x100, (i / 10) * VIRTPCRSTEP);
+        }
+        else
+        {
+            makePacket(ts, 0x100);
+        }
+    }
+    const ssize_t written = write(fd, &buffer[0], buffer.size());
+    close(fd);
+    CPPUNIT_ASSERT(written == static_cast<ssize_t>(buffer.size()));
+
+    try
+    {
+        // the pacing never runs ahead of the PCR: not more than
+        // the elapsed time of the recording (plus the next PCR interval)
+        // is delivered. A loaded host can only deliver less
+        u_int elapsed = 0;
+        const unsigned long realtime = runVirtual(path, true, 300, elapsed);
+        CPPUNIT_ASSERT(realtime > 0);
+        CPPUNIT_ASSERT(realtime <= (elapsed / 10 + 2) * 10);
+        if (elapsed < 900)
+        {
+            CPPUNIT_ASSERT(realtime < VIRTPACKETS);
+            CPPUNIT_ASSERT(m_adapter->virt.loops == 0);
+        }
+
+        // max speed restarts the file many times
+        const unsigned long maxspeed = runVirtual(path, false, 100, elapsed);
+        CPPUNIT_ASSERT(maxspeed > VIRTPACKETS);
+        CPPUNIT_ASSERT(m_adapter->virt.loops > 0);
+    }
+    catch(...)
+    {
+        unlink(path);
+        throw;
+    }
+    unlink(path);
+}
+
+// The batched UDP output test
+void TestDemux::testUDP()
+{
+    test::printOut("\nDemux batched UDP output test ... ");
+
+    // the receiver at the loopback
+    int rcvfd = socket(AF_INET, SOCK_DGRAM, 0);
+    CPPUNIT_ASSERT(rcvfd >= 0);
+    struct sockaddr_in sin;
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CPPUNIT_ASSERT(bind(rcvfd, reinterpret_cast<struct sockaddr*>(&sin),
+                        sizeof(sin)) == 0);
+    socklen_t sinlen = sizeof(sin);
+    CPPUNIT_ASSERT(getsockname(rcvfd,
+                               reinterpret_cast<struct sockaddr*>(&sin),
+                               &sinlen) == 0);
+
+    const int tspd = 4;
+    struct stream_s stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.adapter = m_adapter;
+    struct output_s output;
+    memset(&output, 0, sizeof(output));
+    output.type = OTYPE_UDP;
+    output.stream = &stream;
+    output.remoteaddr = const_cast<char*>("127.0.0.1");
+    output.remoteport = ntohs(sin.sin_port);
+    output.tspd = tspd;
+    output.klkstat = &stream.klkstat;
+    CPPUNIT_ASSERT(output_init_udp(&output) == 1);
+
+    void* key = dvr_add_pcb(m_adapter, 0x100, DVRCB_TS, PID_OTHER,
+                            sendUDP, &output);
+    CPPUNIT_ASSERT(key);
+    m_keys.push_back(key);
+    m_pids.push_back(0x100);
+
+    // 2 complete datagrams and 2 packets left for the next chunk
+    const size_t count = 2 * tspd + 2;
+    std::vector<uint8_t> buffer(count * TS_PACKET_SIZE);
+    for (size_t i = 0; i < count; i++)
+    {
+        makePacket(&buffer[i * TS_PACKET_SIZE], 0x100);
+        buffer[i * TS_PACKET_SIZE + MARKER_OFF] = i;
+    }
+    dvr_input(m_adapter, &buffer[0], buffer.size());
+    CPPUNIT_ASSERT(m_adapter->udpdirty == NULL);
+    CPPUNIT_ASSERT(stream.klkstat.count == 2 * tspd * TS_PACKET_SIZE);
+    CPPUNIT_ASSERT(stream.klkstat.drops == 0);
+    CPPUNIT_ASSERT(checkDatagram(rcvfd, tspd, 0, tspd - 1));
+    CPPUNIT_ASSERT(checkDatagram(rcvfd, tspd, tspd, 2 * tspd - 1));
+    uint8_t dgram[UDP_MAX_PAYLOAD];
+    CPPUNIT_ASSERT(recv(rcvfd, dgram, sizeof(dgram), MSG_DONTWAIT) < 0);
+
+    // the next chunk completes the third datagram
+    // the packets order is kept across the chunks
+    dvr_input(m_adapter, &buffer[0], (tspd - 2) * TS_PACKET_SIZE);
+    CPPUNIT_ASSERT(stream.klkstat.count == 3 * tspd * TS_PACKET_SIZE);
+    CPPUNIT_ASSERT(checkDatagram(rcvfd, tspd, 2 * tspd, 1));
+    CPPUNIT_ASSERT(recv(rcvfd, dgram, sizeof(dgram), MSG_DONTWAIT) < 0);
+
+    dvr_del_pcb(m_adapter, 0x100, key);
+    m_keys.pop_back();
+    m_pids.pop_back();
+    output_deinit_udp(&output);
+    close(rcvfd);
+}
+
+// The PCR paced UDP output test
+void TestDemux::testPacing()
+{
+    test::printOut("\nDemux PCR paced UDP output test ... ");
+
+    m_adapter->klkbase = event_base_new();
+    CPPUNIT_ASSERT(m_adapter->klkbase);
+
+    int rcvfd = socket(AF_INET, SOCK_DGRAM, 0);
+    CPPUNIT_ASSERT(rcvfd >= 0);
+    struct sockaddr_in sin;
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CPPUNIT_ASSERT(bind(rcvfd, reinterpret_cast<struct sockaddr*>(&sin),
+                        sizeof(sin)) == 0);
+    socklen_t sinlen = sizeof(sin);
+    CPPUNIT_ASSERT(getsockname(rcvfd,
+                               reinterpret_cast<struct sockaddr*>(&sin),
+                               &sinlen) == 0);
+
+    struct stream_s stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.adapter = m_adapter;
+    struct output_s output;
+    memset(&output, 0, sizeof(output));
+    output.type = OTYPE_UDP;
+    output.stream = &stream;
+    output.remoteaddr = const_cast<char*>("127.0.0.1");
+    output.remoteport = ntohs(sin.sin_port);
+    output.pace.burst = 2;
+    output.klkstat = &stream.klkstat;
+    CPPUNIT_ASSERT(output_init_udp(&output) == 1);
+    CPPUNIT_ASSERT(output.pace.burst == 2);
+
+    void* key = dvr_add_pcb(m_adapter, 0x100, DVRCB_TS, PID_OTHER,
+                            sendUDP, &output);
+    CPPUNIT_ASSERT(key);
+    m_keys.push_back(key);
+    m_pids.push_back(0x100);
+
+    // 100 ms of the virtual adapter test stream per DVR read burst:
+    // 188000 bytes/sec, a datagram each 7 ms
+    const size_t chunks = 5, chunk = VIRTPACKETS / 10;
+    std::vector<uint8_t> buffer(chunk * TS_PACKET_SIZE);
+    unsigned long datagrams = 0;
+    for (size_t c = 0; c < chunks; c++)
+    {
+        for (size_t i = 0; i < chunk; i++)
+        {
+            const size_t n = c * chunk + i;
+            uint8_t* ts = &buffer[i * TS_PACKET_SIZE];
+            if (n % 10 == 0)
+            {
+                makePCRPacket(ts, 0x100, (n / 10) * VIRTPCRSTEP);
+            }
+            else
+            {
+                makePacket(ts, 0x100);
+            }
+        }
+        dvr_input(m_adapter, &buffer[0], buffer.size());
+        // the rate is known since the second PCR
+        CPPUNIT_ASSERT(output.pace.rate == chunk * 10 * TS_PACKET_SIZE);
+
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = 100000;
+        event_base_loopexit(m_adapter->klkbase, &tv);
+        event_base_dispatch(m_adapter->klkbase);
+
+        uint8_t dgram[UDP_MAX_PAYLOAD];
+        while (recv(rcvfd, dgram, sizeof(dgram), MSG_DONTWAIT) > 0)
+        {
+            datagrams++;
+        }
+    }
+
+    // the bursts are spread over the 100 ms
+    // the jitter depends on the host load thus it's just reported
+    CPPUNIT_ASSERT(stream.klkstat.burst <= output.pace.burst);
+    CPPUNIT_ASSERT(stream.klkstat.drops == 0);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "\n\tjitter: %lu usec",
+             static_cast<u_long>(stream.klkstat.jitter));
+    test::printOut(msg);
+    const unsigned long expected = chunks * chunk / UDP_MAX_PACKETS;
+    CPPUNIT_ASSERT(datagrams + 1 >= expected);
+    CPPUNIT_ASSERT(datagrams <= expected);
+
+    dvr_del_pcb(m_adapter, 0x100, key);
+    m_keys.pop_back();
+    m_pids.pop_back();
+    output_deinit_udp(&output);
+    close(rcvfd);
+    event_base_free(m_adapter->klkbase);
+    m_adapter->klkbase = NULL;
+}
+
+// The recorded TS file benchmark
+void TestDemux::testBenchmark()
+{
+    test::printOut("\nDemux benchmark ... ");
+
+    std::ifstream file(TESTTSFILE.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        test::printOut("skipped (no " + TESTTSFILE + ")");
+        return;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    const size_t packets = data.size() / TS_PACKET_SIZE;
+    CPPUNIT_ASSERT(packets > 0);
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(&data[0]);
+
+    // one consumer per PID found at the file as a full transponder
+    // streaming does plus the full stream consumer
+    std::vector<unsigned long> counters(PID_MAX + 2, 0);
+    size_t valid = 0;
+    for (size_t i = 0; i < packets; i++)
+    {
+        uint8_t* ts = buffer + i * TS_PACKET_SIZE;
+        if (ts[TS_SYNC_OFF] != TS_SYNC)
+        {
+            continue;
+        }
+        valid++;
+        const unsigned int pid = ts_pid(ts);
+        if (!isWanted(m_adapter, pid))
+        {
+            addCounter(pid, &counters[pid]);
+        }
+    }
+    addCounter(PID_MAX + 1, &counters[PID_MAX + 1]);
+
+    // the same chunks as dvr_read() gets from the device
+    const size_t chunk = DVR_BUFFER_DEFAULT * TS_PACKET_SIZE;
+    const size_t size = packets * TS_PACKET_SIZE;
+    const size_t passes = BENCHPACKETS / packets + 1;
+    const double start = test::getTime();
+    for (size_t pass = 0; pass < passes; pass++)
+    {
+        for (size_t off = 0; off < size; off += chunk)
+        {
+            dvr_input(m_adapter, buffer + off,
+                      static_cast<int>(std::min(chunk, size - off)));
+        }
+    }
+    const double duration = test::getTime() - start;
+
+    unsigned long total = 0;
+    for (unsigned int pid = 0; pid <= PID_MAX; pid++)
+    {
+        total += counters[pid];
+    }
+    CPPUNIT_ASSERT(total == passes * valid);
+    CPPUNIT_ASSERT(counters[PID_MAX + 1] == passes * valid);
+
+    const double rate = (duration > 0) ? passes * packets / duration : 0;
+    char msg[128];
+    snprintf(msg, sizeof(msg),
+             "\n\t%d packets, %d consumers: %.0f pkt/sec (%.0f Mbit/sec)",
+             static_cast<int>(passes * packets),
+             static_cast<int>(m_keys.size()),
+             rate, rate * TS_PACKET_SIZE * 8 / 1000000);
+    test::printOut(msg);
+}
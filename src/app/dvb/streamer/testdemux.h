@@ -0,0 +1,151 @@
+/**
+   @file testdemux.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TESTDEMUX_H
+#define KLK_TESTDEMUX_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+#include "plugin/getstream2/getstream.h"
+
+namespace klk
+{
+    namespace dvb
+    {
+        namespace stream
+        {
+            /**
+               @brief The getstream2 demux unit test
+
+               The test checks the flat PID dispatch at getstream2
+               dvr.c: same PID runs, wanted PID bitmap and callbacks
+               removal, the virtual adapter that reads a recorded
+               TS instead of a DVB card, the batched UDP output
+               flushed at the end of each chunk and its PCR pacing.
+               There is also a benchmark
+               that feeds a recorded TS file through the demux
+
+               @ingroup grDVBStreamerTest
+            */
+            class TestDemux : public CppUnit::TestFixture
+            {
+                CPPUNIT_TEST_SUITE(TestDemux);
+                CPPUNIT_TEST(testDispatch);
+                CPPUNIT_TEST(testVirtual);
+                CPPUNIT_TEST(testUDP);
+                CPPUNIT_TEST(testPacing);
+                CPPUNIT_TEST(testBenchmark);
+                CPPUNIT_TEST_SUITE_END();
+            public:
+                /// Constructor
+                TestDemux();
+
+                /// Destructor
+                virtual ~TestDemux(){}
+
+                /// Set up context before running a test.
+                virtual void setUp();
+
+                /// Clean up after the test run.
+                virtual void tearDown();
+
+                /// The dispatch test
+                void testDispatch();
+
+                /// The virtual adapter test
+                void testVirtual();
+
+                /// The batched UDP output test
+                void testUDP();
+
+                /// The PCR paced UDP output test
+                void testPacing();
+
+                /// The recorded TS file benchmark
+                void testBenchmark();
+            private:
+                struct adapter_s* m_adapter; ///< the adapter under test
+                std::vector<void*> m_keys; ///< registered callbacks
+                std::vector<unsigned int> m_pids; ///< PIDs of the callbacks
+
+                /**
+                   Registers a TS callback that counts packets
+
+                   @param[in] pid - the PID (PID_MAX + 1 for full stream)
+                   @param[in] counter - the counter to be increased
+                */
+                void addCounter(unsigned int pid, unsigned long* counter);
+
+                /**
+                   Runs the virtual adapter over a file
+
+                   @param[in] path - the recorded TS
+                   @param[in] realtime - PCR paced or max speed
+                   @param[in] msec - how long to run
+                   @param[out] elapsed - how long it was run in fact (ms)
+
+                   @return the packets delivered
+                */
+                unsigned long runVirtual(const std::string& path,
+                                         bool realtime, u_int msec,
+                                         u_int& elapsed);
+
+                /**
+                   The counting callback
+
+                   @param[in] data - the TS packet
+                   @param[in] arg - the counter
+                */
+                static void count(void* data, void* arg);
+
+                /**
+                   The callback that feeds an UDP output
+
+                   @param[in] data - the TS packet
+                   @param[in] arg - the output
+                */
+                static void sendUDP(void* data, void* arg);
+            private:
+                /// Fake copy constructor
+                TestDemux(const TestDemux&);
+
+                /// Fake assigment operator
+                TestDemux& operator=(const TestDemux&);
+            };
+        }
+    }
+}
+
+#endif //KLK_TESTDEMUX_H
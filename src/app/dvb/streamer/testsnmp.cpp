@@ -93,7 +93,7 @@ void TestSNMP::testTableGet()
     while (snmp::TableRow *row = SNMPFactory::instance()->getNext())
     {
         // check row size
-        CPPUNIT_ASSERT(row->size() == 5);
+        CPPUNIT_ASSERT(row->size() == 7);
 
         // klkStation        DisplayString,
         if ((*row)[1].toString() == TESTSTATION1)
@@ -108,6 +108,10 @@ void TestSNMP::testTableGet()
             // klkDevName
             CPPUNIT_ASSERT((*row)[4].toString() ==
                            m_dev1->getStringParam(dev::NAME));
+            // klkLoopAffinity
+            CPPUNIT_ASSERT((*row)[5].toString() == "none");
+            // klkLoopLoad
+            CPPUNIT_ASSERT((*row)[6].toInt() == 0);
         }
         else if ((*row)[1].toString() == TESTSTATION2)
         {
@@ -121,6 +125,10 @@ void TestSNMP::testTableGet()
             // klkDevName
             CPPUNIT_ASSERT((*row)[4].toString() ==
                            m_dev1->getStringParam(dev::NAME));
+            // klkLoopAffinity
+            CPPUNIT_ASSERT((*row)[5].toString() == "none");
+            // klkLoopLoad
+            CPPUNIT_ASSERT((*row)[6].toInt() == 0);
         }
         else
         {
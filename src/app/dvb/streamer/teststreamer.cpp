@@ -56,6 +56,7 @@
 #include "testplugin.h"
 #include "streamerutils.h"
 #include "testsnmp.h"
+#include "testdemux.h"
 #include "testutils.h"
 
 // modules specific info
@@ -86,6 +87,10 @@ void klk_module_test_init()
     CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestSNMP, TESTSNMP);
     CPPUNIT_REGISTRY_ADD(TESTSNMP, MODNAME);
 
+    const std::string TESTDEMUX = MODNAME + "/demux";
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestDemux, TESTDEMUX);
+    CPPUNIT_REGISTRY_ADD(TESTDEMUX, MODNAME);
+
     CPPUNIT_REGISTRY_ADD(MODNAME, test::ALL);
 }
 
@@ -0,0 +1,240 @@
+/**
+   @file chunk.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "chunk.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Chunked transfer tail
+    const BinaryData CHUNK_TAIL("\r\n");
+}
+
+//
+// Chunk class
+//
+
+// Constructor
+Chunk::Chunk(BinaryData& data, bool keyframe) :
+    m_data(), m_head(), m_keyframe(keyframe)
+{
+    m_data.swap(data);
+
+    // See also http://en.wikipedia.org/wiki/Chunked_transfer_encoding
+    char head[64];
+    snprintf(head, sizeof(head), "%x\r\n",
+             static_cast<u_int>(m_data.size()));
+    m_head = BinaryData(std::string(head));
+}
+
+// Destructor
+Chunk::~Chunk()
+{
+}
+
+// Retrives the chunked transfer tail (CRLF)
+const BinaryData& Chunk::getTail() const throw()
+{
+    return CHUNK_TAIL;
+}
+
+//
+// ChunkRing class
+//
+
+// Constructor
+ChunkRing::ChunkRing(size_t max_size) :
+    m_lock(), m_items(), m_begin(0), m_total(0), m_size(0),
+    m_keyframe(0), m_has_keyframe(false), m_max_size(max_size)
+{
+    BOOST_ASSERT(m_max_size > 0);
+}
+
+// Destructor
+ChunkRing::~ChunkRing()
+{
+}
+
+// Adds a chunk
+void ChunkRing::push(const ChunkPtr& chunk)
+{
+    BOOST_ASSERT(chunk);
+
+    Item item;
+    item.m_chunk = chunk;
+
+    Locker lock(&m_lock);
+    item.m_offset = m_total;
+    if (chunk->isKeyFrame())
+    {
+        m_keyframe = m_begin + m_items.size();
+        m_has_keyframe = true;
+    }
+    m_items.push_back(item);
+    m_total += chunk->size();
+    m_size += chunk->size();
+
+    // drop the oldest chunks but keep the last one
+    while (m_size > m_max_size && m_items.size() > 1)
+    {
+        m_size -= m_items.front().m_chunk->size();
+        m_items.pop_front();
+        m_begin++;
+    }
+}
+
+// Retrives the sequence number for the next chunk to be added
+const u_int64_t ChunkRing::getEnd() const throw()
+{
+    Locker lock(&m_lock);
+    return m_begin + m_items.size();
+}
+
+// Retrives the sequence number of the latest keyframe chunk
+const u_int64_t ChunkRing::getKeyFrame() const throw()
+{
+    Locker lock(&m_lock);
+    if (m_has_keyframe && m_keyframe >= m_begin)
+    {
+        return m_keyframe;
+    }
+    return m_begin + m_items.size();
+}
+
+// Drops all chunks
+void ChunkRing::reset() throw()
+{
+    Locker lock(&m_lock);
+    m_begin += m_items.size();
+    m_items.clear();
+    m_size = 0;
+    m_has_keyframe = false;
+}
+
+// Retrives a chunk by its sequence number
+const ChunkPtr ChunkRing::get(u_int64_t& seq) const
+{
+    Locker lock(&m_lock);
+    if (seq < m_begin)
+    {
+        // the chunk was dropped
+        seq = m_begin;
+    }
+
+    if (seq >= m_begin + m_items.size())
+    {
+        return ChunkPtr();
+    }
+
+    return m_items[seq - m_begin].m_chunk;
+}
+
+// Skips data that exceeds the lag limit
+const u_int64_t ChunkRing::skip(u_int64_t seq, size_t max_lag,
+                                bool keyframe) const
+{
+    Locker lock(&m_lock);
+    if (seq < m_begin)
+    {
+        seq = m_begin;
+    }
+
+    const size_t count = m_items.size();
+    size_t first = static_cast<size_t>(seq - m_begin);
+    if (first >= count)
+    {
+        return seq;
+    }
+
+    // the offsets are sorted thus binary search is used
+    const u_int64_t min_offset = (m_total > max_lag) ? m_total - max_lag : 0;
+    size_t last = count;
+    while (first < last)
+    {
+        const size_t middle = first + (last - first) / 2;
+        if (m_items[middle].m_offset < min_offset)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    if (keyframe)
+    {
+        for (size_t i = first; i < count; i++)
+        {
+            if (m_items[i].m_chunk->isKeyFrame())
+            {
+                first = i;
+                break;
+            }
+        }
+    }
+
+    return m_begin + first;
+}
+
+// Retrives data size between the sequence number and the ring end
+const size_t ChunkRing::getLag(u_int64_t seq) const throw()
+{
+    Locker lock(&m_lock);
+    if (seq < m_begin)
+    {
+        return m_size;
+    }
+
+    if (seq >= m_begin + m_items.size())
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(m_total - m_items[seq - m_begin].m_offset);
+}
+
+// Retrives the ring data size
+const size_t ChunkRing::size() const throw()
+{
+    Locker lock(&m_lock);
+    return m_size;
+}
@@ -0,0 +1,279 @@
+/**
+   @file chunk.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_CHUNK_H
+#define KLK_CHUNK_H
+
+#include <sys/types.h>
+
+#include <deque>
+
+#include <boost/shared_ptr.hpp>
+
+#include "binarydata.h"
+#include "thread.h"
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief Immutable data chunk
+
+           The chunk is an immutable analog of klk::BinaryData. It's
+           created once by an input thread and shared by all connections
+           that consume the input path. It also keeps the HTTP/1.1 chunked
+           transfer framing, thus the connections send it without any copy.
+
+           @ingroup grHTTP
+        */
+        class Chunk
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in,out] data - the data. The data is moved into
+               the chunk and the param becomes empty
+               @param[in] keyframe - does the data start with a keyframe
+            */
+            explicit Chunk(BinaryData& data, bool keyframe = false);
+
+            /**
+               Destructor
+            */
+            ~Chunk();
+
+            /**
+               Retrives the chunk data
+
+               @return the data
+            */
+            const BinaryData& getData() const throw(){return m_data;}
+
+            /**
+               Retrives the chunked transfer head (the size line)
+
+               @return the head
+            */
+            const BinaryData& getHead() const throw(){return m_head;}
+
+            /**
+               Retrives the chunked transfer tail (CRLF)
+
+               @return the tail
+            */
+            const BinaryData& getTail() const throw();
+
+            /**
+               Retrives the data size
+
+               @return the size
+            */
+            const size_t size() const throw(){return m_data.size();}
+
+            /**
+               Does the data start with a keyframe
+
+               @return
+               - true
+               - false
+            */
+            const bool isKeyFrame() const throw(){return m_keyframe;}
+        private:
+            BinaryData m_data; ///< the data
+            BinaryData m_head; ///< chunked transfer head
+            const bool m_keyframe; ///< keyframe flag
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            Chunk(const Chunk& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            Chunk& operator=(const Chunk& value);
+        };
+
+        /**
+           Smart pointer for the chunk
+        */
+        typedef boost::shared_ptr<const Chunk> ChunkPtr;
+
+        /**
+           @brief Ring with data chunks
+
+           Each input thread keeps its data at the ring. The connections
+           hold only read cursors (chunk sequence numbers) into it.
+           The ring size is limited by bytes, the oldest chunks are
+           dropped when the limit is reached.
+
+           @ingroup grHTTP
+        */
+        class ChunkRing
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] max_size - the max size (in bytes)
+            */
+            explicit ChunkRing(size_t max_size);
+
+            /**
+               Destructor
+            */
+            ~ChunkRing();
+
+            /**
+               Adds a chunk
+
+               @param[in] chunk - the chunk to be added
+            */
+            void push(const ChunkPtr& chunk);
+
+            /**
+               Retrives the sequence number for the next chunk to be added
+
+               @return the sequence number
+            */
+            const u_int64_t getEnd() const throw();
+
+            /**
+               Retrives the sequence number of the latest keyframe chunk
+
+               New connections start from it thus they get the whole
+               GOP at once and do not wait for the next keyframe
+
+               @return the sequence number or the ring end if there is
+               no keyframe at the ring
+            */
+            const u_int64_t getKeyFrame() const throw();
+
+            /**
+               Drops all chunks
+
+               The sequence numbers are not reset thus the cursors
+               hold by connections stay valid
+            */
+            void reset() throw();
+
+            /**
+               Retrives a chunk by its sequence number
+
+               @param[in,out] seq - the sequence number. If the chunk
+               was already dropped the number is moved to the oldest
+               available chunk
+
+               @return the chunk or NULL if there is no such one yet
+            */
+            const ChunkPtr get(u_int64_t& seq) const;
+
+            /**
+               Skips data that exceeds the lag limit
+
+               @param[in] seq - the sequence number
+               @param[in] max_lag - the max data size between the
+               sequence number and the ring end
+               @param[in] keyframe - should the result point to a keyframe
+               (if there is such one)
+
+               @return the new sequence number
+            */
+            const u_int64_t skip(u_int64_t seq, size_t max_lag,
+                                 bool keyframe) const;
+
+            /**
+               Retrives data size between the sequence number and the
+               ring end
+
+               @param[in] seq - the sequence number
+
+               @return the size in bytes
+            */
+            const size_t getLag(u_int64_t seq) const throw();
+
+            /**
+               Retrives the ring data size
+
+               @return the size in bytes
+            */
+            const size_t size() const throw();
+        private:
+            /**
+               Ring element
+            */
+            struct Item
+            {
+                ChunkPtr m_chunk; ///< the chunk
+                u_int64_t m_offset; ///< total bytes before the chunk
+            };
+
+            /**
+               Ring elements storage
+            */
+            typedef std::deque<Item> ItemList;
+
+            mutable klk::Mutex m_lock; ///< locker
+            ItemList m_items; ///< the chunks
+            u_int64_t m_begin; ///< sequence number of the first chunk
+            u_int64_t m_total; ///< total bytes added to the ring
+            size_t m_size; ///< the data size
+            u_int64_t m_keyframe; ///< the latest keyframe sequence number
+            bool m_has_keyframe; ///< is there the keyframe sequence number
+            const size_t m_max_size; ///< the max data size
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            ChunkRing(const ChunkRing& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            ChunkRing& operator=(const ChunkRing& value);
+        };
+
+        /**
+           Smart pointer for the ring
+        */
+        typedef boost::shared_ptr<ChunkRing> ChunkRingPtr;
+    }
+}
+
+#endif //KLK_CHUNK_H
@@ -0,0 +1,380 @@
+/**
+   @file connection.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "connection.h"
+#include "exception.h"
+#include "utils.h"
+#include "httpfactory.h"
+#include "conthread.h"
+#include "defines.h"
+
+using namespace klk;
+using namespace klk::http;
+
+//
+// Connection class
+//
+
+// Constructor
+Connection::Connection(Factory* factory, const ISocketPtr& sock) :
+    Base(factory),
+    m_uuid(base::Utils::generateUUID()),
+    m_sock(sock),
+    m_request_type(REQ_UNKNOWN),
+    m_response_type(RES_UNKNOWN),
+    m_http_version(HTTP_UNKNOWN),
+    m_path_lock(), m_path(), m_policy(CONNECTION_OVERFLOW_POLICY),
+    m_hang_time(0), m_ring(), m_cursor(0), m_keep_alive(false),
+    m_client()
+{
+    BOOST_ASSERT(m_sock);
+}
+
+// Destructor
+Connection::~Connection()
+{
+}
+
+// Retrives the path
+const std::string Connection::getPath() const throw()
+{
+    Locker lock(&m_path_lock);
+    return m_path;
+}
+
+// Checks path
+const bool Connection::isPathMatch(const std::string& path) const throw()
+{
+    Locker lock(&m_path_lock);
+    return (path == m_path);
+}
+
+// Retrives rate
+const double Connection::getRate() const
+{
+    return m_sock->getOutputRate();
+}
+
+// Retrives in thread
+InThreadPtr Connection::getInThread()
+{
+    return getFactory()->getInThreadContainer()->getThreadByPath(getPath());
+}
+
+// Processes request
+const BinaryData Connection::processRequest()
+{
+    BOOST_ASSERT(m_request.getStatus() != Request::PARSE_MORE);
+
+    m_response_type = RES_UNKNOWN;
+    m_keep_alive = false;
+    if (m_request.getStatus() == Request::PARSE_ERROR)
+    {
+        m_request_type = REQ_UNKNOWN;
+        m_client = m_sock->getPeerName();
+        klk_log(KLKLOG_ERROR, "Incorrect HTTP request from %s. "
+                "Error code: %d", m_client.c_str(), m_request.getError());
+        m_response_type = FAILED;
+        return makeError(m_request.getError());
+    }
+
+    setRequest();
+    klk_log(KLKLOG_DEBUG, "Got the following HTTP request from %s: "
+            "%s %s. User agent: %s",
+            m_client.c_str(),
+            (m_request_type == GET) ? "GET" : "HEAD",
+            getPath().c_str(),
+            m_request.getUserAgent().c_str());
+
+    // a live stream does not have byte positions: the range is ignored
+    // and the stream is sent with 200 from the current position
+    // (players probe the stream with bytes=0-1)
+    u_int64_t first = 0, last = 0;
+    if (m_request.getRange(first, last) != Request::RANGE_NONE)
+    {
+        klk_log(KLKLOG_DEBUG, "Range request from %s is ignored",
+                m_client.c_str());
+    }
+
+    InThreadPtr inthread = getInThread();
+    if (!inthread)
+    {
+        m_response_type = NOT_FOUND;
+        m_keep_alive = m_request.isKeepAlive();
+        return makeNotFound();
+    }
+
+    m_response_type = OK;
+    if (m_request_type == HEAD)
+    {
+        // status probe: there is not any data for the connection
+        m_keep_alive = m_request.isKeepAlive();
+        return makeOK(inthread);
+    }
+
+    // stop waiting in input thread
+    inthread->increaseConnectionCount();
+    // the connection starts from the latest keyframe thus
+    // the client gets the cached GOP at once and can display
+    // the picture without waiting for the next keyframe
+    m_ring = inthread->getRing();
+    m_cursor = m_ring->getKeyFrame();
+    // the GOP can be larger than the connection limit (HD streams):
+    // the primed data should not be treated as a slow client
+    if (m_ring->getLag(m_cursor) > CONNECTIONBUFFER_MAX_SIZE)
+    {
+        m_cursor = m_ring->skip(m_cursor, CONNECTIONBUFFER_MAX_SIZE, true);
+    }
+    getFactory()->getConnectThreadContainer()->subscribe(
+        getPath(), shared_from_this());
+    return makeOK(inthread);
+}
+
+// Sets internal parameters from the parsed request:
+// request type, path, HTTP version and the client
+void Connection::setRequest()
+{
+    BOOST_ASSERT(m_request.getStatus() == Request::PARSE_DONE);
+
+    m_request_type =
+        (m_request.getMethod() == Request::METHOD_GET) ? GET : HEAD;
+    m_http_version =
+        (m_request.getVersion() == Request::VERSION_11) ? HTTP11 : HTTP10;
+
+    {
+        Locker lock(&m_path_lock);
+        m_path = m_request.getPath();
+    }
+
+    m_client = m_sock->getPeerName();
+    const std::string forwarded = m_request.getForwardedFor();
+    if (!forwarded.empty())
+    {
+        m_client = forwarded + " via " + m_client;
+    }
+}
+
+// Makes an OK response
+const BinaryData Connection::makeOK(const InThreadPtr& inthread)
+{
+    BOOST_ASSERT(inthread);
+    BOOST_ASSERT(m_response_type == OK);
+
+    klk_log(KLKLOG_DEBUG, "Starts processing new request for path: %s",
+            getPath().c_str());
+
+    const bool keep_alive = isStreaming() ?
+        (m_http_version == HTTP11) : m_keep_alive;
+    return getFactory()->getResponseCache()->getOK(
+        getPath(), inthread->getReader(), m_http_version == HTTP11,
+        keep_alive);
+}
+
+// Makes a Not Found response
+const BinaryData Connection::makeNotFound()
+{
+    klk_log(KLKLOG_ERROR, "Path '%s' was not found", getPath().c_str());
+
+    BOOST_ASSERT(m_response_type == NOT_FOUND);
+    return makeError(404);
+}
+
+// Makes a response with an error code
+const BinaryData Connection::makeError(u_int code)
+{
+    return getFactory()->getResponseCache()->getError(
+        code, m_request_type == HEAD, m_keep_alive);
+}
+
+// Checks the unsent data size and hang up conditions
+const Connection::QueueState Connection::checkQueue()
+{
+    if (!m_ring || m_ring->getLag(m_cursor) <= CONNECTIONBUFFER_MAX_SIZE)
+    {
+        if (m_policy == DISCONNECT)
+        {
+            m_hang_time = 0;
+        }
+        return QUEUE_OK;
+    }
+
+    // the hang up time is reset when the client gets data
+    // for drop policies (see nextChunk)
+    if (m_hang_time == 0)
+    {
+        m_hang_time = time(NULL);
+    }
+    else if (time(NULL) - m_hang_time > WAITINTERVAL4SLOW)
+    {
+        klk_log(KLKLOG_ERROR, "Hang-up detected. Requested path: %s. "
+                "Client: %s",
+                getPath().c_str(),
+                getClient().c_str());
+        return QUEUE_HANGUP;
+    }
+
+    if (m_policy != DISCONNECT)
+    {
+        const u_int64_t cursor = m_cursor;
+        m_cursor = m_ring->skip(m_cursor, CONNECTIONBUFFER_MAX_SIZE,
+                                m_policy == DROP_TO_KEYFRAME);
+        klk_log(KLKLOG_DEBUG, "%d data chunks were dropped for slow "
+                "client %s",
+                static_cast<int>(m_cursor - cursor),
+                getClient().c_str());
+    }
+
+    return QUEUE_FULL;
+}
+
+// Retrives the next chunk from the input thread ring
+const ChunkPtr Connection::nextChunk()
+{
+    if (!m_ring)
+    {
+        return ChunkPtr();
+    }
+
+    const u_int64_t cursor = m_cursor;
+    ChunkPtr chunk = m_ring->get(m_cursor);
+    if (cursor != m_cursor)
+    {
+        klk_log(KLKLOG_ERROR, "%d data chunks were lost for slow client %s. "
+                "Requested path: %s",
+                static_cast<int>(m_cursor - cursor),
+                getClient().c_str(),
+                getPath().c_str());
+    }
+
+    if (chunk)
+    {
+        m_cursor++;
+        if (m_policy != DISCONNECT)
+        {
+            m_hang_time = 0;
+        }
+    }
+    return chunk;
+}
+
+// Makes a chunk for sending
+// There are some code from getstream2
+// http://silicon-verl.de/home/flo/projects/streaming/
+/*
+ * Function to return an http chunk with previous unknown size.
+ * HTTP/1.1 allows for chunked transfers which HTTP/1.0 doesnt
+ * know about. There is no legal way to do this so we hope our best.
+ *
+ */
+// See also http://en.wikipedia.org/wiki/Chunked_transfer_encoding
+const BinaryData Connection::makeChunk(const BinaryData& data) const
+{
+    if (m_http_version != HTTP11)
+    {
+        // just send data
+        return data;
+    }
+
+    if (data.empty())
+    {
+        // Chunked transfer - send a 0 chunk
+        return BinaryData("0\r\n\r\n");
+    }
+
+    char head[64];
+    snprintf(head, sizeof(head), "%x\r\n",
+             static_cast<u_int>(data.size()));
+    BinaryData chunk(head);
+    chunk.add(data);
+    chunk.add(BinaryData("\r\n"));
+    return chunk;
+}
+
+// Adds the chunk buffers to the vectored send data
+void Connection::addChunk(const ChunkPtr& chunk, BinaryDataVector& data) const
+{
+    BOOST_ASSERT(chunk);
+    if (m_http_version == HTTP11)
+    {
+        data.push_back(&chunk->getHead());
+        data.push_back(&chunk->getData());
+        data.push_back(&chunk->getTail());
+    }
+    else
+    {
+        // just send data
+        data.push_back(&chunk->getData());
+    }
+}
+
+// Retrives the chunk size on the wire
+const size_t Connection::getChunkSize(const ChunkPtr& chunk) const throw()
+{
+    BOOST_ASSERT(chunk);
+    if (m_http_version == HTTP11)
+    {
+        return chunk->getHead().size() + chunk->size() +
+            chunk->getTail().size();
+    }
+    return chunk->size();
+}
+
+// Does final clearing for the connection
+void Connection::release() throw()
+{
+    try
+    {
+        // decrease connetion count
+        if (isStreaming())
+        {
+            getFactory()->getConnectThreadContainer()->unsubscribe(
+                getPath(), this);
+            if (InThreadPtr inthread = getInThread())
+            {
+                inthread->decreaseConnectionCount();
+            }
+        }
+    }
+    catch(...)
+    {
+        // nothing to do
+    }
+
+    m_sock->disconnect();
+}
@@ -0,0 +1,365 @@
+/**
+   @file connection.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_CONNECTION_H
+#define KLK_CONNECTION_H
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+
+#include "socket/socket.h"
+#include "thread.h"
+#include "binarydata.h"
+#include "httpbase.h"
+#include "inthread.h"
+#include "chunk.h"
+#include "httprequest.h"
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           Slow client policies: the unsent data of a connection
+           exceeds klk::http::CONNECTIONBUFFER_MAX_SIZE
+        */
+        typedef enum
+        {
+            DROP_OLDEST = 0, ///< the oldest data is dropped
+            DROP_TO_KEYFRAME = 1, ///< the data is dropped up to a keyframe
+            DISCONNECT = 2 ///< the client is disconnected
+                           ///< after klk::http::WAITINTERVAL4SLOW
+        } OverflowPolicy;
+
+        /**
+           @brief Base class for client connections
+
+           The class keeps data and routins that are common for all
+           connection engines: the client socket, the requested path and
+           the HTTP request parameters. There are two engines:
+           - klk::http::ConnectThread - a thread per connection
+           - klk::http::ReactorConnection - the connection is served
+           by an epoll reactor (klk::http::Reactor)
+
+           @ingroup grHTTP
+        */
+        class Connection : public Base,
+            public boost::enable_shared_from_this<Connection>
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] factory - the factory
+               @param[in] sock - the socket
+            */
+            Connection(Factory* factory, const klk::ISocketPtr& sock);
+
+            /**
+               Destructor
+            */
+            virtual ~Connection();
+
+            /**
+               Retrives uuid
+            */
+            const std::string getUUID() const throw(){return m_uuid;}
+
+            /**
+               Retrives the path
+
+               @return the path
+            */
+            const std::string getPath() const throw();
+
+            /**
+               @brief Notifies about new data
+
+               The connection will send the new data from the input
+               thread ring. The method is called only for connections
+               subscribed for the path
+
+               @param[in] path - the path for the data
+
+               @exception klk::Exception
+            */
+            virtual void notifyData(const std::string& path) = 0;
+
+            /**
+               Requests the connection close
+
+               @note can be called from any thread
+            */
+            virtual void close() throw() = 0;
+
+            /**
+               Retrives rate
+
+               @return the rate
+            */
+            virtual const double getRate() const;
+        protected:
+            /**
+               Request type
+            */
+            typedef enum
+            {
+                REQ_UNKNOWN = 0,
+                HEAD = 1,
+                GET = 2
+            } RequestType;
+
+            /**
+               Result type
+            */
+            typedef enum
+            {
+                RES_UNKNOWN = 0,
+                OK = 1,
+                NOT_FOUND = 2,
+                FAILED = 3 ///< the request was rejected with an error code
+            } ResponseType;
+
+            /**
+               HTTP proto version
+            */
+            typedef enum
+            {
+                HTTP_UNKNOWN = 0,
+                HTTP10 = 1,
+                HTTP11 = 2
+            } HTTPVersion;
+
+            /**
+               The connection data queue state
+            */
+            typedef enum
+            {
+                QUEUE_OK = 0, ///< the client reads data in time
+                QUEUE_FULL = 1, ///< the client is slow (the overflow
+                                ///< policy was applied)
+                QUEUE_HANGUP = 2 ///< the connection should be closed
+            } QueueState;
+
+            const std::string m_uuid; ///< the connection uuid
+            klk::ISocketPtr m_sock; ///< socket
+            RequestType m_request_type; ///< request type
+            ResponseType m_response_type; ///< response type
+            HTTPVersion m_http_version; ///< http version
+            Request m_request; ///< the request parser
+
+            /**
+               Processes request
+
+               Determines the parsed request type and makes the
+               response. Incorrect requests get the response with
+               the corresponding error code
+
+               @return the response to be sent
+
+               @exception klk::Exception
+            */
+            const BinaryData processRequest();
+
+            /**
+               Should the connection wait for the next request after
+               the response or not. It's used for HEAD and not found
+               requests at persistent connections
+
+               @return
+               - true - the next request is expected
+               - false - the connection should be closed
+            */
+            const bool isKeepAlive() const throw(){return m_keep_alive;}
+
+            /**
+               Retrives the client description for logs: the peer
+               name and the X-Forwarded-For header value
+
+               @return the description
+            */
+            const std::string getClient() const {return m_client;}
+
+            /**
+               Retrives in thread
+
+               @return the input thread pointer
+            */
+            InThreadPtr getInThread();
+
+            /**
+               Check path
+
+               Is the path match or not
+
+               @param[in] path - the path to be checked
+
+               @return
+               - true
+               - false
+            */
+            const bool isPathMatch(const std::string& path) const throw();
+
+            /**
+               Is the connection going to stream data or not
+
+               @return
+               - true - the GET request was accepted
+               - false - there is not any data for the connection
+            */
+            const bool isStreaming() const throw()
+            {
+                return (m_request_type == GET && m_response_type == OK);
+            }
+
+            /**
+               Checks the unsent data size and hang up conditions
+
+               @return the queue state
+            */
+            const QueueState checkQueue();
+
+            /**
+               Retrives the next chunk from the input thread ring
+
+               @return the chunk or NULL if there is no new data
+            */
+            const ChunkPtr nextChunk();
+
+            /**
+               Makes a chunk for sending
+
+               In case of Transfer-Encoding: chunked the data will be
+               framed as a HTTP chunk, otherwise the data is returned
+               as is
+
+               @param[in] data - the data to be sent
+
+               @return the data to be sent over the socket
+            */
+            const BinaryData makeChunk(const BinaryData& data) const;
+
+            /**
+               Adds the chunk buffers to the vectored send data
+
+               In case of Transfer-Encoding: chunked the chunk head
+               and tail are added around the data
+
+               @param[in] chunk - the chunk to be added
+               @param[out] data - the data for klk::ISocket::sendv
+            */
+            void addChunk(const ChunkPtr& chunk, BinaryDataVector& data) const;
+
+            /**
+               Retrives the chunk size on the wire
+
+               @param[in] chunk - the chunk
+
+               @return the size with the chunked transfer framing
+            */
+            const size_t getChunkSize(const ChunkPtr& chunk) const throw();
+
+            /**
+               Does final clearing for the connection
+            */
+            void release() throw();
+        private:
+            mutable klk::Mutex m_path_lock; ///< path locker
+            std::string m_path; ///< the path for this connection
+            const OverflowPolicy m_policy; ///< slow client policy
+            time_t m_hang_time; ///< time when hang up was started
+            ChunkRingPtr m_ring; ///< the input thread ring
+            u_int64_t m_cursor; ///< the next chunk sequence number
+            bool m_keep_alive; ///< the next request is expected
+            std::string m_client; ///< the client description
+
+            /**
+               Sets internal parameters from the parsed request:
+               request type, path, HTTP version and the client
+            */
+            void setRequest();
+
+            /**
+               Makes an OK response
+
+               @param[in] inthread - the input thread
+
+               @exception klk::Exception
+            */
+            const BinaryData makeOK(const InThreadPtr& inthread);
+
+            /**
+               Makes a Not Found response
+
+               @exception klk::Exception
+            */
+            const BinaryData makeNotFound();
+
+            /**
+               Makes a response with an error code
+
+               @param[in] code - the HTTP status code
+
+               @exception klk::Exception
+            */
+            const BinaryData makeError(u_int code);
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            Connection(const Connection& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            Connection& operator=(const Connection& value);
+        };
+
+        /**
+           Slow client policy. It's applied when the unsent data
+           exceeds klk::http::CONNECTIONBUFFER_MAX_SIZE
+        */
+        const OverflowPolicy CONNECTION_OVERFLOW_POLICY = DISCONNECT;
+
+        /**
+           Smart pointer for a connection
+        */
+        typedef boost::shared_ptr<Connection> ConnectionPtr;
+    }
+}
+
+#endif //KLK_CONNECTION_H
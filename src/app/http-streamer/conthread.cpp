@@ -38,23 +38,34 @@
 #include "config.h"
 #endif
 
-#include <stdio.h>
+#include <unistd.h>
 
-#include <sstream>
+#include <algorithm>
 
 #include <boost/bind.hpp>
 
 #include "conthread.h"
 #include "exception.h"
+#include "socket/exception.h"
 #include "utils.h"
 #include "httpfactory.h"
-#include "version.h"
-#include "utils.h"
 #include "defines.h"
 
 using namespace klk;
 using namespace klk::http;
 
+// Stops a finished connection thread (executed at the task pool)
+// @param[in] scheduler - the scheduler that runs the thread
+// @param[in] thread - the thread to be stopped
+static void stop_connect_thread(const SchedulerPtr& scheduler,
+                                const IThreadPtr& thread)
+{
+    if (scheduler->isStarted(thread))
+    {
+        scheduler->stopThread(thread);
+    }
+}
+
 //
 // ConnectThread class
 //
@@ -62,13 +73,8 @@ using namespace klk::http;
 // Constructor
 ConnectThread::ConnectThread(Factory* factory,
                              const ISocketPtr& sock) :
-    Thread(factory),
-    m_uuid(base::Utils::generateUUID()),
-    m_sock(sock), m_path(),
-    m_data(), m_wait(), m_request_type(REQ_UNKNOWN),
-    m_response_type(RES_UNKNOWN),
-    m_http_version(HTTP_UNKNOWN),
-    m_hang_time(0)
+    base::Thread(), Connection(factory, sock),
+    m_wait()
 {
     m_sock->setSendTimeout(5/*WAITINTERVAL4SLOW*/);
 }
@@ -82,7 +88,7 @@ ConnectThread::~ConnectThread()
 void ConnectThread::init()
 {
     BOOST_ASSERT(m_sock);
-    Thread::init();
+    base::Thread::init();
 }
 
 
@@ -95,7 +101,7 @@ void ConnectThread::start()
     {
         // do processing
         processRequest();
-        if (m_request_type == GET && m_response_type == OK)
+        if (isStreaming())
         {
             processData();
         }
@@ -112,75 +118,27 @@ void ConnectThread::start()
                 "Unknown exception gotten at HTTP connection thread");
     }
 
-    // crease connetion count
-    if (InThreadPtr inthread = getInThread())
-    {
-        inthread->decreaseConnectionCount();
-    }
-
-    m_sock->disconnect();
+    release();
     notifyStop();
     klk_log(KLKLOG_DEBUG, "Finished connection thread");
 }
 
-// Retrives the path
-const std::string ConnectThread::getPath() const throw()
+// Notifies about new data
+void ConnectThread::notifyData(const std::string& path)
 {
-    Locker lock(&m_lock);
-    return m_path;
+    m_wait.stopWait();
 }
 
-// Checks path
-const bool ConnectThread::isPathMatch(const std::string& path) const throw()
+// Requests the connection close
+void ConnectThread::close() throw()
 {
-    Locker lock(&m_lock);
-    return (path == m_path);
-}
-
-// Sends a binary data portion
-void ConnectThread::addData(const std::string& path,
-                            const BinaryData& data)
-{
-    if (isPathMatch(path))
-    {
-        // Check hang up conditions
-        if (m_data.size() > CONNECTIONBUFFER_MAX_SIZE)
-        {
-#if 0
-            klk_log(KLKLOG_DEBUG, "Data size: %d->%d. Time: %d->%d",
-                    m_data.size(), CONNECTIONBUFFER_MAX_SIZE,
-                    time(NULL) - m_hang_time.getValue(),
-                    WAITINTERVAL4SLOW);
-#endif
-            if (m_hang_time.getValue() == 0)
-            {
-                m_hang_time.setValue(time(NULL));
-            }
-            else if (time(NULL) - m_hang_time.getValue() > WAITINTERVAL4SLOW)
-            {
-                klk_log(KLKLOG_ERROR, "Hang-up detected. Requested path: %s. "
-                        "Client: %s",
-                        path.c_str(),
-                        m_sock->getPeerName().c_str());
-                // stop the thread
-                stop();
-                return;
-            }
-        }
-        else
-        {
-            m_hang_time.setValue(0);
-            m_data.push_back(data);
-        }
-
-        m_wait.stopWait();
-    }
+    stop();
 }
 
 // Stops thread
 void ConnectThread::stop() throw()
 {
-    Thread::stop();
+    base::Thread::stop();
     m_wait.stopWait();
 }
 
@@ -190,72 +148,104 @@ void ConnectThread::notifyStop()
     getFactory()->getConnectThreadContainer()->notifyStopConnectThread(this);
 }
 
-// Processes request
+// Processes requests
+// HEAD, not found and incorrect requests at a persistent connection
+// can be followed by the next request
 void ConnectThread::processRequest()
 {
-    const std::string SEPARATOR1("\r\n\r\n");
-    const std::string SEPARATOR2("\n\n");
-    std::string request;
-    for(;;)
+    for (size_t count = 0; count < KEEPALIVE_MAX_REQUESTS; count++)
     {
-        if (m_sock->checkData(WAITINTERVAL) != klk::OK)
+        if (isStopped() || !readRequest())
+        {
+            break;
+        }
+
+        sendResponse();
+        if (isStreaming() || !isKeepAlive())
         {
+            break;
+        }
+        m_request.next();
+    }
+}
+
+// Reads the request
+const bool ConnectThread::readRequest()
+{
+    // the previous response was sent to a persistent connection
+    const bool keep_alive = isKeepAlive();
+    const time_t interval = keep_alive ? KEEPALIVE_WAITINTERVAL : WAITINTERVAL;
+    while (m_request.getStatus() == Request::PARSE_MORE)
+    {
+        if (m_sock->checkData(interval) != klk::OK)
+        {
+            if (keep_alive && m_request.empty())
+            {
+                // the client does not need the connection anymore
+                return false;
+            }
             // timeout exceed
             throw Exception(__FILE__, __LINE__,
                             "No input data within %d seconds",
-                            WAITINTERVAL);
+                            interval);
         }
-        BinaryData buff(SOCKBUFFSIZE);
-        m_sock->recv(buff);
-        if (buff.empty())
+
+        size_t size = 0;
+        m_request.getSpace(size);
+        BinaryData buff(std::min(size, SOCKBUFFSIZE));
+        try
         {
-            throw Exception(__FILE__, __LINE__,
-                            "Connection closed by client");
+            m_sock->recv(buff);
         }
-
-        request += buff.toString();
-        // check separator
-        if (request.find(SEPARATOR1) != std::string::npos ||
-            request.find(SEPARATOR2) != std::string::npos)
+        catch(const ClosedConnection&)
         {
-            // we got the header
-            break;
+            if (keep_alive && m_request.empty())
+            {
+                // closed by the client between requests
+                return false;
+            }
+            throw;
         }
-        if (buff.size() != SOCKBUFFSIZE)
+        if (buff.empty())
         {
-            // try again
-            continue;
+            throw Exception(__FILE__, __LINE__,
+                            "Connection closed by client");
         }
+
+        m_request.add(static_cast<const char*>(buff.toVoid()), buff.size());
     }
 
-    // split by \r\n
-    std::vector<std::string> vector = base::Utils::split(request, "\r\n");
-    klk_log(KLKLOG_DEBUG, "Got the following HTTP request from %s: %s",
-            m_sock->getPeerName().c_str(),
-            vector[0].c_str());
+    return true;
+}
 
-    parseRequest(vector[0]);
+// Sends the response for the request
+void ConnectThread::sendResponse()
+{
+    const BinaryData response = Connection::processRequest();
+    BinaryDataVector data;
+    data.push_back(&response);
 
+    // send a multimedia data header together with the response
+    BinaryData header;
     InThreadPtr inthread = getInThread();
-
-    processResponse(inthread);
-
-    // send a multimedia data header
-    if (m_request_type == GET && m_response_type == OK && inthread)
+    if (isStreaming() && inthread)
     {
-        const BinaryData header = inthread->getReader()->getHeader();
+        header = inthread->getReader()->getHeader();
         if (header.empty())
         {
             klk_log(KLKLOG_DEBUG, "No header data for connection thread");
         }
         else
         {
-            m_data.push_back(header);
+            header = makeChunk(header);
+            data.push_back(&header);
             klk_log(KLKLOG_DEBUG,
-                    "Header data for connection thread was added. "
+                    "Header data for connection thread was sent. "
                     "Header size: %d", header.size());
         }
     }
+
+    m_sock->sendv(data);
 }
 
 // Processes data
@@ -264,6 +254,14 @@ void ConnectThread::processData()
     // main loop
     while(!isStopped())
     {
+        // Check hang up conditions
+        if (checkQueue() == QUEUE_HANGUP)
+        {
+            break;
+        }
+        // send the available data first: a new connection
+        // has the cached GOP there
+        sendData();
         if (m_wait.startWait(WAITINTERVAL) != klk::OK)
         {
             // timeout exceed
@@ -271,258 +269,229 @@ void ConnectThread::processData()
                             "No input data within %d seconds",
                             WAITINTERVAL);
         }
-        if (isStopped())
-        {
-            break;
-        }
-        // we have data to be sent
-        while (m_data.empty() == false)
-        {
-            sendData(m_data.retrive_front());
-        }
     }
 }
 
-// Sends a data portion
-// There are some code from getstream2
-// http://silicon-verl.de/home/flo/projects/streaming/
-/*
- * Function to return an http chunk with previous unknown size.
- * HTTP/1.1 allows for chunked transfers which HTTP/1.0 doesnt
- * know about. There is no legal way to do this so we hope our best.
- *
- */
-// See also http://en.wikipedia.org/wiki/Chunked_transfer_encoding
-void ConnectThread::sendData(const BinaryData& data)
+// Sends the available data chunks
+// Several chunks with the chunked transfer framing are sent
+// with one system call
+void ConnectThread::sendData()
 {
-    if (data.empty())
+    for(;;)
     {
-        // Chunked transfer - send a 0 chunk
-        if (m_http_version == HTTP11)
+        std::vector<ChunkPtr> chunks;
+        BinaryDataVector data;
+        while (chunks.size() < SENDV_MAX_CHUNKS)
         {
-            m_sock->send(BinaryData("0\r\n\r\n"));
+            ChunkPtr chunk = nextChunk();
+            if (!chunk)
+            {
+                break;
+            }
+            chunks.push_back(chunk);
+            addChunk(chunk, data);
         }
-        // FIXME!!! and the closing connection here
-    }
 
-    // In case of Transfer-Encoding: chunked send a chunk
-    // otherwise just data
-    if (m_http_version == HTTP11)
-    {
-        char head[64];
-        snprintf(head, sizeof(head), "%x\r\n",
-                 static_cast<u_int>(data.size()));
-        m_sock->send(BinaryData(head));
-        m_sock->send(data);
-        m_sock->send(BinaryData("\r\n"));
-    }
-    else
-    {
-        // just send data
-        m_sock->send(data);
-    }
+        if (chunks.empty())
+        {
+            break;
+        }
+
+        m_sock->sendv(data);
 
 #if 0
-    // save result
-    base::Utils::saveData2File("contmp.flv", *data);
+        // save result
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            base::Utils::saveData2File("contmp.flv", chunks[i]->getData());
+        }
 #endif
+    }
 }
 
-InThreadPtr ConnectThread::getInThread()
-{
-    std::string path;
-    {
-        Locker lock(&m_lock);
-        path = m_path;
-    }
+//
+// ConnectThreadContainer class
+//
 
-    return getFactory()->getInThreadContainer()->getThreadByPath(path);
+// Constructor
+ConnectThreadContainer::ConnectThreadContainer(Factory* factory) :
+    BaseContainer(factory), m_list(), m_reactors(), m_next_reactor(0),
+    m_subscribers_lock(), m_subscribers(SubscriberMapPtr(new SubscriberMap()))
+{
 }
 
-// Parses request and set internal parameters:
-// request type, path and HTTP version
-void ConnectThread::parseRequest(const std::string& reqstr)
+// Destructor
+ConnectThreadContainer::~ConnectThreadContainer()
 {
-    std::vector<std::string> vec = base::Utils::split(reqstr, "\t ");
-    if (vec.size() != 3)
-    {
-        throw Exception(__FILE__, __LINE__,
-                        "Incorrect HTTP request: " + reqstr);
-    }
+}
 
+// Starts connection engine
+void ConnectThreadContainer::init(ConnectionEngine engine)
+{
     Locker lock(&m_lock);
+    m_reactors.clear();
+    m_next_reactor = 0;
 
-    // request type
-    if (vec[0] == "HEAD")
-    {
-        m_request_type = HEAD;
-    }
-    else if (vec[0] == "GET")
-    {
-        m_request_type = GET;
-    }
-    else
+    if (engine != ENGINE_REACTOR)
     {
-        throw Exception(__FILE__, __LINE__,
-                        "Incorrect HTTP request: " + reqstr);
+        klk_log(KLKLOG_DEBUG, "HTTP streamer uses thread per connection");
+        return;
     }
 
+    // one reactor per CPU core
+    long count = std::min(static_cast<size_t>(TaskPool::getCPUCount()),
+                          REACTOR_MAX_COUNT);
 
-    // path
-    if (*vec[1].begin() != '/')
-    {
-        throw Exception(__FILE__, __LINE__,
-                        "Incorrect HTTP request: " + reqstr);
-    }
-    m_path = vec[1];
-
-    // HTTP version
-    m_http_version = HTTP_UNKNOWN;
-    if (vec[2] == "HTTP/1.0")
+    try
     {
-        m_http_version = HTTP10;
+        for (long i = 0; i < count; i++)
+        {
+            ReactorPtr reactor(new Reactor(getFactory(),
+                                           static_cast<u_int>(i)));
+            getFactory()->getScheduler()->startThread(reactor);
+            m_reactors.push_back(reactor);
+        }
     }
-    else if (vec[2] == "HTTP/1.1")
+    catch(const std::bad_alloc&)
     {
-        m_http_version = HTTP11;
+        throw Exception(__FILE__, __LINE__, err::MEMORYALLOC);
     }
-    else
+    catch(const std::exception& err)
     {
-        throw Exception(__FILE__, __LINE__,
-                        "Incorrect HTTP request: " + reqstr);
+        klk_log(KLKLOG_ERROR, "Reactor start failed: %s. "
+                "HTTP streamer will use thread per connection",
+                err.what());
+        for (ReactorList::iterator i = m_reactors.begin();
+             i != m_reactors.end(); i++)
+        {
+            getFactory()->getScheduler()->stopThread(*i);
+        }
+        m_reactors.clear();
+        return;
     }
+
+    klk_log(KLKLOG_DEBUG, "HTTP streamer uses %d connection reactors",
+            m_reactors.size());
 }
 
-// Processes a response
-void ConnectThread::processResponse(const InThreadPtr& inthread)
+// Notifies all connections that new data is available
+// only the path subscribers are touched and no container lock is held
+void ConnectThreadContainer::notifyConnections(const std::string& path)
 {
-    m_response_type = RES_UNKNOWN;
+    if (m_stop.isStopped())
+        return;
 
-    if (inthread)
-    {
-        // stop waiting in input thread
-        inthread->increaseConnectionCount();
-        // set type and process the response
-        m_response_type = OK;
-        processOK(inthread);
-    }
-    else
-    {
-        m_response_type = NOT_FOUND;
-        processNotFound();
-    }
+    BOOST_ASSERT(path.empty() == false);
+    SubscriberListPtr subscribers = getSubscribers(path);
+    if (!subscribers)
+        return; // no viewers
+
+    std::for_each(subscribers->begin(), subscribers->end(),
+                  boost::bind(&Connection::notifyData, _1,
+                              boost::ref(path)));
 }
 
-// Processes an OK response
-void ConnectThread::processOK(const InThreadPtr& inthread)
+// Subscribes a connection for the path data
+void ConnectThreadContainer::subscribe(const std::string& path,
+                                       const ConnectionPtr& connection)
 {
-    BOOST_ASSERT(inthread);
-    BOOST_ASSERT(m_response_type == OK);
-
-    klk_log(KLKLOG_DEBUG, "Starts processing new request for path: %s",
-            getPath().c_str());
-
-    std::stringstream response;
-    response << "HTTP/1.1 200 OK\r\n";
-    response << "Date: " <<
-        base::Utils::getCurrentTime("%a, %d %b %Y %H:%M:%S %Z\r\n");
-    response << "Server: " << VERSION_STR << "\r\n";
-    response << "Pragma: no-cache,private\r\n";
-    response << "Cache-Control: no-cache\r\n";
-    response << "Content-Type: "
-             << inthread->getReader()->getContentType() << "\r\n";
-    if (m_http_version == HTTP11)
-    {
-        response << "Transfer-Encoding: chunked\r\n";
-    }
-    else
-    {
-        response << "Accept-Ranges: bytes\r\n";
-        response << "Length: unspecified [" <<
-            inthread->getReader()->getContentType() << "]\r\n";
-    }
-
-    if (m_http_version == HTTP11 && m_request_type == GET)
-    {
-        response << "Connection: keep-alive\r\n";
-    }
-    else
+    BOOST_ASSERT(path.empty() == false);
+    BOOST_ASSERT(connection);
+
+    Locker lock(&m_subscribers_lock);
+    SubscriberMapPtr current = m_subscribers.getValue();
+    boost::shared_ptr<SubscriberMap> map(new SubscriberMap(*current));
+    boost::shared_ptr<SubscriberList> list(new SubscriberList());
+    SubscriberMap::const_iterator i = map->find(path);
+    if (i != map->end())
     {
-        response << "Connection: close\r\n";
+        *list = *i->second;
     }
-
-    response << "\r\n";
-
-    m_sock->send(BinaryData(response.str()));
+    list->push_back(connection);
+    (*map)[path] = list;
+    m_subscribers.setValue(map);
 }
 
-// Processes a Not Found response
-void ConnectThread::processNotFound()
+// Unsubscribes a connection
+void ConnectThreadContainer::unsubscribe(const std::string& path,
+                                         const Connection* connection) throw()
 {
+    BOOST_ASSERT(connection);
 
-    klk_log(KLKLOG_ERROR, "Path '%s' was not found", getPath().c_str());
-
-    BOOST_ASSERT(m_response_type == NOT_FOUND);
+    try
+    {
+        Locker lock(&m_subscribers_lock);
+        SubscriberMapPtr current = m_subscribers.getValue();
+        SubscriberMap::const_iterator i = current->find(path);
+        if (i == current->end())
+            return; // nothing to do
+
+        boost::shared_ptr<SubscriberList> list(new SubscriberList());
+        for (SubscriberList::const_iterator j = i->second->begin();
+             j != i->second->end(); j++)
+        {
+            if (j->get() != connection)
+            {
+                list->push_back(*j);
+            }
+        }
 
-    std::stringstream response;
-    response << "HTTP/1.1 404 Not Found\r\n";
-    response << "Date: " <<
-        base::Utils::getCurrentTime("%a, %d %b %Y %H:%M:%S %Z\r\n");
-    response << "Server: " << VERSION_STR << "\r\n";
-    response << "Pragma: no-cache,private\r\n";
-    response << "Cache-Control: no-cache\r\n";
-    response << "Connection: close\r\n";
-    response << "\r\n";
-    if (m_request_type == GET)
+        boost::shared_ptr<SubscriberMap> map(new SubscriberMap(*current));
+        if (list->empty())
+        {
+            map->erase(path);
+        }
+        else
+        {
+            (*map)[path] = list;
+        }
+        m_subscribers.setValue(map);
+    }
+    catch(...)
     {
-        const std::string data =
-            "<!DOCTYPE HTML PUBLIC \"-//IETF//DTD HTML 2.0//EN\">"
-            "<html><head>"
-            "<title>404 Not Found</title>"
-            "</head><body>"
-            "<h1>404 Not Found</h1>"
-            "</body>"
-            "</html>";
-        response << data;
+        klk_log(KLKLOG_ERROR, "Failed to unsubscribe a connection "
+                "from path '%s'", path.c_str());
     }
-
-    m_sock->send(BinaryData(response.str()));
 }
 
-// Retrives rate
-const double ConnectThread::getRate() const
+// Retrives subscribers for the path
+const ConnectThreadContainer::SubscriberListPtr
+ConnectThreadContainer::getSubscribers(const std::string& path) const
 {
-    return m_sock->getOutputRate();
+    SubscriberMapPtr map = m_subscribers.getValue();
+    SubscriberMap::const_iterator i = map->find(path);
+    if (i == map->end())
+    {
+        return SubscriberListPtr();
+    }
+    return i->second;
 }
 
-//
-// ConnectThreadContainer class
-//
-
-// Constructor
-ConnectThreadContainer::ConnectThreadContainer(Factory* factory) :
-    BaseContainer(factory), m_list()
+// Starts a connection
+void ConnectThreadContainer::startConnection(const ISocketPtr& sock)
 {
-}
+    if (m_stop.isStopped())
+        return;
 
-// Destructor
-ConnectThreadContainer::~ConnectThreadContainer()
-{
-}
+    ReactorPtr reactor;
+    {
+        Locker lock(&m_lock);
+        if (!m_reactors.empty())
+        {
+            reactor = m_reactors[m_next_reactor % m_reactors.size()];
+            m_next_reactor++;
+        }
+    }
 
-// Sends a connection data to all out threads
-void ConnectThreadContainer::sendConnectionData(const std::string& path,
-                                                const BinaryData& data)
-{
-    if (m_stop.isStopped())
+    if (reactor)
+    {
+        reactor->addConnection(sock);
         return;
+    }
 
-    BOOST_ASSERT(path.empty() == false);
-    Locker lock(&m_lock);
-    std::for_each(m_list.begin(), m_list.end(),
-                  boost::bind(&ConnectThread::addData, _1,
-                              boost::ref(path),
-                              boost::ref(data)));
+    // fallback: thread per connection
+    ConnectThreadPtr thread(new ConnectThread(getFactory(), sock));
+    startConnectThread(thread);
 }
 
 // Starts connection thread
@@ -559,8 +528,10 @@ void ConnectThreadContainer::notifyStopConnectThread(
     if (i == m_list.end())
         return; // nothing to do
 
-    // stop it
-    getFactory()->getStopThread()->addConnectThread(*i);
+    // stop it at the task pool: the thread can not join itself
+    getFactory()->getTaskPool()->post(
+        boost::bind(stop_connect_thread,
+                    getFactory()->getScheduler(), IThreadPtr(*i)));
     // some clearing
     m_list.erase(i);
 }
@@ -572,24 +543,12 @@ void ConnectThreadContainer::stopThreads(const InThreadPtr& thread)
     const std::string path = thread->getInfo()->getPath();
     BOOST_ASSERT(path.empty() == false);
 
-    ConnectThreadList stoplist;
-
-    Locker lock(&m_lock);
-    for (ConnectThreadList::iterator i = m_list.begin();
-         i != m_list.end(); i++)
+    // the connections will be unsubscribed at their threads
+    SubscriberListPtr subscribers = getSubscribers(path);
+    if (subscribers)
     {
-        if ((*i)->getPath() == path)
-        {
-            stoplist.push_back(*i);
-            getFactory()->getStopThread()->addConnectThread(*i);
-        }
-    }
-
-    // remove them from the list
-    for (ConnectThreadList::iterator i = stoplist.begin();
-         i != stoplist.end(); i++)
-    {
-        m_list.remove(*i);
+        std::for_each(subscribers->begin(), subscribers->end(),
+                      boost::bind(&Connection::close, _1));
     }
 }
 
@@ -599,11 +558,11 @@ ConnectThreadContainer::getConnectionRate(const std::string& path) const
 {
     BOOST_ASSERT(path.empty() == false);
     double res = 0;
-    Locker lock(&m_lock);
-    for (ConnectThreadList::const_iterator i = m_list.begin();
-         i != m_list.end(); i++)
+    SubscriberListPtr subscribers = getSubscribers(path);
+    if (subscribers)
     {
-        if ((*i)->getPath() == path)
+        for (SubscriberList::const_iterator i = subscribers->begin();
+             i != subscribers->end(); i++)
         {
             res += (*i)->getRate();
         }
@@ -611,4 +570,3 @@ ConnectThreadContainer::getConnectionRate(const std::string& path) const
 
     return res;
 }
-
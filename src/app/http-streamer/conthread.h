@@ -39,6 +39,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
@@ -46,7 +47,8 @@
 #include "thread.h"
 #include "binarydata.h"
 #include "inthread.h"
-#include "safelist.h"
+#include "connection.h"
+#include "reactor.h"
 
 namespace klk
 {
@@ -56,11 +58,12 @@ namespace klk
            @brief Connection thread
 
            The connection thread. The thread processes incomming
-           connections
+           connections. It's the connection engine that is used as
+           a fallback for the reactor based one (klk::http::Reactor)
 
            @ingroup grHTTP
         */
-        class ConnectThread : public Thread
+        class ConnectThread : public base::Thread, public Connection
         {
         public:
             /**
@@ -76,85 +79,13 @@ namespace klk
             */
             virtual ~ConnectThread();
 
-            /**
-               Retrives the path
-
-               @return the path
-            */
-            const std::string getPath() const throw();
-
-            /**
-               @brief Adds a binary data portion for processing
-
-               The method checks path and if the path is OK the data
-               will be added for processing
-
-               In other cases just return
-
-               @param[in] path - the path for the data
-               @param[in] data - the data to be added
-
-               @exception klk::Exception
-            */
-            void addData(const std::string& path,
-                         const klk::BinaryData& data);
-
-            /**
-               Retrives uuid
-            */
-            const std::string getUUID() const throw(){return m_uuid;}
+            /// @copydoc klk::http::Connection::notifyData
+            virtual void notifyData(const std::string& path);
 
-            /**
-               Retrives rate
-
-               @return the rate
-            */
-            virtual const double getRate() const;
+            /// @copydoc klk::http::Connection::close
+            virtual void close() throw();
         private:
-            /**
-               List with data
-            */
-            typedef SafeList<BinaryData> DataList;
-
-            /**
-               Request type
-            */
-            typedef enum
-            {
-                REQ_UNKNOWN = 0,
-                HEAD = 1,
-                GET = 2
-            } RequestType;
-
-            /**
-               Result type
-            */
-            typedef enum
-            {
-                RES_UNKNOWN = 0,
-                OK = 1,
-                NOT_FOUND = 2
-            } ResponseType;
-
-            /**
-               HTTP proto version
-            */
-            typedef enum
-            {
-                HTTP_UNKNOWN = 0,
-                HTTP10 = 1,
-                HTTP11 = 2
-            } HTTPVersion;
-
-            const std::string m_uuid; ///< the thread uuid
-            klk::ISocketPtr m_sock; ///< socket
-            std::string m_path; ///< the path for this connection
-            DataList m_data;    ///< data list
             klk::Event m_wait; ///< wait event
-            RequestType m_request_type; ///< request type
-            ResponseType m_response_type; ///< response type
-            HTTPVersion m_http_version; ///< http version
-            SafeValue<time_t> m_hang_time; ///< time when hang up was started
 
             /// @copydoc IThread::init()
             virtual void init();
@@ -169,79 +100,45 @@ namespace klk
             void notifyStop();
 
             /**
-               Processes request
+               Processes requests
 
-               determine it's type and sends initial response
+               Reads requests and sends responses until a GET request
+               is accepted or the connection is not persistent
             */
             void processRequest();
 
             /**
-               Processes data
-            */
-            void processData();
-
-            /**
-               Retrives in thread
-
-               @return the input thread pointer
-            */
-            InThreadPtr getInThread();
-
-            /**
-               Parses request and set internal parameters:
-               request type, path and HTTP version
-
-               @param[in] reqstr - the request string
-               for example HEAD /path HTTP/1.0
-            */
-            void parseRequest(const std::string& reqstr);
-
-            /**
-               Check path
-
-               Is the path match or not
-
-               @param[in] path - the path to be checked
+               Reads the request
 
                @return
-               - true
-               - false
-            */
-            const bool isPathMatch(const std::string& path) const throw();
-
-            /**
-               Processes a response
-
-               @param[in] inthread - the input thread
+               - true - the request was received
+               - false - the persistent connection was closed by the
+               client or the next request did not come in time
 
                @exception klk::Exception
             */
-            void processResponse(const InThreadPtr& inthread);
+            const bool readRequest();
 
             /**
-               Processes an OK response
+               Sends the response for the request
 
-               @param[in] inthread - the input thread
+               determine it's type and sends initial response
 
                @exception klk::Exception
             */
-            void processOK(const InThreadPtr& inthread);
+            void sendResponse();
 
             /**
-               Processes a Not Found response
-
-               @exception klk::Exception
+               Processes data
             */
-            void processNotFound();
+            void processData();
 
             /**
-               Sends a data portion
-
-               @param[in] data - the data to be sent
+               Sends the available data chunks
 
                @exception klk::Exception
             */
-            void sendData(const klk::BinaryData& data);
+            void sendData();
         private:
             /**
                Copy constructor
@@ -261,10 +158,29 @@ namespace klk
         */
         typedef boost::shared_ptr<ConnectThread> ConnectThreadPtr;
 
+        /**
+           Connection engine types
+        */
+        typedef enum
+        {
+            ENGINE_THREAD = 0, ///< a separate thread per connection
+            ENGINE_REACTOR = 1 ///< epoll reactors (one per CPU core)
+        } ConnectionEngine;
+
+        /// Default connection engine
+#ifdef LINUX
+        const ConnectionEngine CONNECTION_ENGINE = ENGINE_REACTOR;
+#else
+        const ConnectionEngine CONNECTION_ENGINE = ENGINE_THREAD;
+#endif
+
         /**
            @brief List with connection threads
 
-           List with connection threads
+           List with connection threads. The container also keeps
+           connections indexed by the input path. The index is a
+           copy-on-write snapshot thus input threads publish data
+           to their own viewers without any container lock.
 
            @ingroup grHTTP
         */
@@ -281,15 +197,55 @@ namespace klk
             virtual ~ConnectThreadContainer();
 
             /**
-               Sends a connection data to all out threads
+               Starts connection engine
+
+               @param[in] engine - the engine type to be used
+
+               @exception klk::Exception
+            */
+            void init(ConnectionEngine engine);
+
+            /**
+               Notifies all connections that new data is available
+               at the input thread ring
 
-               @param[in] path - the path for determining socket data
-               @param[in] data - the data to be sent
+               @param[in] path - the input thread path
 
                @exception klk::Exception
             */
-            void sendConnectionData(const std::string& path,
-                                    const klk::BinaryData& data);
+            void notifyConnections(const std::string& path);
+
+            /**
+               Subscribes a connection for the path data
+
+               @param[in] path - the input thread path
+               @param[in] connection - the connection
+
+               @exception klk::Exception
+            */
+            void subscribe(const std::string& path,
+                           const ConnectionPtr& connection);
+
+            /**
+               Unsubscribes a connection
+
+               @param[in] path - the input thread path
+               @param[in] connection - the connection
+            */
+            void unsubscribe(const std::string& path,
+                             const Connection* connection) throw();
+
+            /**
+               Starts a connection
+
+               The connection will be served by a reactor or by a
+               separate thread depending on the connection engine type
+
+               @param[in] sock - the accepted client socket
+
+               @exception klk::Exception
+            */
+            void startConnection(const klk::ISocketPtr& sock);
 
             /**
                Starts connection thread
@@ -332,7 +288,51 @@ namespace klk
             */
             typedef std::list<ConnectThreadPtr> ConnectThreadList;
 
+            /**
+               Reactors list
+            */
+            typedef std::vector<ReactorPtr> ReactorList;
+
+            /**
+               Connections subscribed for a path
+
+               @note the list is never changed after creation
+               (copy-on-write)
+            */
+            typedef std::vector<ConnectionPtr> SubscriberList;
+
+            /**
+               Smart pointer for the subscribers list
+            */
+            typedef boost::shared_ptr<const SubscriberList> SubscriberListPtr;
+
+            /**
+               Path to subscribers map
+            */
+            typedef std::map<std::string, SubscriberListPtr> SubscriberMap;
+
+            /**
+               Smart pointer for the subscribers map snapshot
+            */
+            typedef boost::shared_ptr<const SubscriberMap> SubscriberMapPtr;
+
             ConnectThreadList m_list; ///< list with input threads
+            ReactorList m_reactors; ///< reactors (per-reactor registries)
+            size_t m_next_reactor; ///< next reactor for a new connection
+            /// subscribers changes locker
+            klk::Mutex m_subscribers_lock;
+            /// the current subscribers snapshot
+            SafeValue<SubscriberMapPtr> m_subscribers;
+
+            /**
+               Retrives subscribers for the path
+
+               @param[in] path - the input thread path
+
+               @return the subscribers snapshot (can be NULL)
+            */
+            const SubscriberListPtr getSubscribers(
+                const std::string& path) const;
         private:
             /**
                Copy constructor
@@ -64,11 +64,12 @@ Factory::Factory() :
     m_lock(),
     m_stop(),
     m_scheduler(),
-    m_stopthread(),
+    m_tasks(),
     m_outthread(),
     m_inthreads(),
     m_conthreads(),
-    m_readers()
+    m_readers(),
+    m_responses()
 {
     m_readers[media::TXT] = boost::bind(&TXTReader::make, _1);
     m_readers[media::FLV] = boost::bind(&FLVReader::make, _1);
@@ -96,8 +97,8 @@ void Factory::init()
         m_scheduler = SchedulerPtr(new base::Scheduler());
         m_outthread.reset();
         m_outthread = OutThreadPtr(new OutThread(this));
-        m_stopthread.reset();
-        m_stopthread = StopThreadPtr(new StopThread(this));
+        m_tasks.reset();
+        m_tasks = TaskPoolPtr(new TaskPool());
         m_inthreads.reset();
         m_inthreads = InThreadContainerPtr(new InThreadContainer(this));
         m_conthreads.reset();
@@ -111,7 +112,7 @@ void Factory::init()
     BOOST_ASSERT(m_scheduler);
 
     // start threads
-    m_scheduler->startThread(m_stopthread);
+    m_conthreads->init(CONNECTION_ENGINE);
 }
 
 // Stops factory usage
@@ -128,6 +129,12 @@ void Factory::stop() throw()
         m_conthreads->stop();
     }
 
+    // finish connections teardown
+    if (m_tasks)
+    {
+        m_tasks->stop();
+    }
+
     if (m_scheduler)
     {
         m_scheduler->stop();
@@ -143,7 +150,7 @@ void Factory::clear() throw()
     m_conthreads.reset();
     m_scheduler.reset();
     m_outthread.reset();
-    m_stopthread.reset();
+    m_tasks.reset();
 }
 
 // Retrives pointer to scheduler
@@ -180,12 +187,12 @@ const OutThreadPtr Factory::getOutThread() const
     return m_outthread;
 }
 
-// Retrives ouput thread
-const StopThreadPtr Factory::getStopThread() const
+// Retrives the pool for short jobs
+const TaskPoolPtr Factory::getTaskPool() const
 {
     Locker lock(&m_lock);
-    BOOST_ASSERT(m_stopthread);
-    return m_stopthread;
+    BOOST_ASSERT(m_tasks);
+    return m_tasks;
 }
 
 // Retrives input thread container
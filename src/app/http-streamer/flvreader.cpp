@@ -86,7 +86,8 @@ using namespace klk::http;
 
 // Constructor
 FLVReader::FLVReader(const ISocketPtr& sock) :
-    Reader(sock, WAITINTERVAL), m_header(13), m_real_header()
+    Reader(sock, WAITINTERVAL), m_header(13), m_real_header(),
+    m_keyframe(false)
 {
     setHeader();
 }
@@ -148,6 +149,12 @@ void FLVReader::setHeader()
 #define FLV_VIDEODATA	9
 #define FLV_SCRIPTDATAOBJECT	18
 
+/**
+   Video tag frame type (the high 4 bits of the first data byte)
+   for a keyframe
+*/
+#define FLV_FRAME_KEY	1
+
 typedef struct {
     unsigned char signature[3];
     unsigned char version;
@@ -209,8 +216,18 @@ void FLVReader::getData(BinaryData& data)
     }
     BOOST_ASSERT(real_data.size() == real_data_size);
 
+    const u_char* video =
+        static_cast<const u_char*>(real_data.toVoid());
+    m_keyframe = (flvtag->type == FLV_VIDEODATA && real_data_size > 4 &&
+                  (video[0] >> 4) == FLV_FRAME_KEY);
+
     BOOST_ASSERT(data.empty() == true);
     data.add(tag);
     data.add(real_data);
 }
 
+// Is the last tag a video keyframe
+const bool FLVReader::isKeyFrame() const throw()
+{
+    return m_keyframe;
+}
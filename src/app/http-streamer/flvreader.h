@@ -76,6 +76,7 @@ namespace http
     private:
         BinaryData m_header; ///< header
         BinaryData m_real_header; ///< real header
+        bool m_keyframe; ///< is the last tag a video keyframe
 
         /**
            Constructor
@@ -109,6 +110,13 @@ namespace http
         */
         virtual void getData(BinaryData& data);
 
+        /**
+           Is the last tag a video keyframe
+
+           @return true if it is
+        */
+        virtual const bool isKeyFrame() const throw();
+
         /**
            Sets header
 
@@ -46,7 +46,9 @@
 #include "inthread.h"
 #include "outthread.h"
 #include "conthread.h"
+#include "httpresponse.h"
 #include "thread.h"
+#include "taskpool.h"
 
 namespace klk
 {
@@ -117,11 +119,11 @@ namespace klk
             const OutThreadPtr getOutThread() const;
 
             /**
-               Retrives stop thread
+               Retrives the pool for short jobs (connections teardown)
 
-               @return the thread
+               @return the pool
             */
-            const StopThreadPtr getStopThread() const;
+            const TaskPoolPtr getTaskPool() const;
 
             /**
                Retrives input thread container
@@ -141,6 +143,13 @@ namespace klk
             */
             const ConnectThreadContainerPtr getConnectThreadContainer() const;
 
+            /**
+               Retrives the HTTP responses cache
+
+               @return the cache
+            */
+            ResponseCache* getResponseCache() throw(){return &m_responses;}
+
             /**
                Gets reader by the media type (HTTP) uuid
 
@@ -183,11 +192,12 @@ namespace klk
             mutable klk::Mutex m_lock; ///< main locker
             klk::Trigger m_stop; ///< stop event trigger
             SchedulerPtr m_scheduler; ///< scheduler
-            StopThreadPtr m_stopthread; ///< stop thread
+            TaskPoolPtr m_tasks; ///< pool for short jobs
             OutThreadPtr m_outthread; ///< out thread
             InThreadContainerPtr m_inthreads; ///< input threads list
             ConnectThreadContainerPtr m_conthreads; ///< connection threads
             MakeReaderStorage m_readers; ///< readers functor
+            ResponseCache m_responses; ///< HTTP responses cache
 
             /**
                Clears all internal data
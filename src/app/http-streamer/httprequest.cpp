@@ -0,0 +1,546 @@
+/**
+   @file httprequest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <strings.h>
+
+#include <boost/assert.hpp>
+
+#include "httprequest.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Known headers names (in lower case)
+    const char* HEADER_NAMES[] =
+    {
+        "",
+        "host",
+        "user-agent",
+        "x-forwarded-for",
+        "range",
+        "connection"
+    };
+
+    /// Checks is the character allowed at a token (RFC 2616 2.2)
+    inline bool isTokenChar(char c)
+    {
+        if (c <= 0x20 || c >= 0x7f)
+        {
+            return false;
+        }
+        return (strchr("()<>@,;:\\\"/[]?={}", c) == NULL);
+    }
+
+    /// Checks is the character a control one
+    inline bool isControlChar(char c)
+    {
+        return (static_cast<u_char>(c) < 0x20 || c == 0x7f);
+    }
+
+    /// Parses a decimal number
+    /// @return the position after the number or NULL on error
+    const char* parseNumber(const char* begin, const char* end,
+                            u_int64_t& value)
+    {
+        const u_int64_t max = static_cast<u_int64_t>(-1) / 10 - 1;
+        value = 0;
+        const char* i = begin;
+        for (; i != end && *i >= '0' && *i <= '9'; i++)
+        {
+            if (value > max)
+            {
+                return NULL;
+            }
+            value = value * 10 + (*i - '0');
+        }
+        return (i == begin) ? NULL : i;
+    }
+}
+
+//
+// Request class
+//
+
+// Constructor
+Request::Request() :
+    m_size(0), m_pos(0), m_state(ST_START), m_status(PARSE_MORE),
+    m_error(0), m_method(METHOD_UNKNOWN), m_version(VERSION_UNKNOWN),
+    m_headers(0), m_header(HDR_UNKNOWN)
+{
+    reset();
+}
+
+// Destructor
+Request::~Request()
+{
+}
+
+// Retrives the free space at the buffer
+char* Request::getSpace(size_t& size) throw()
+{
+    size = sizeof(m_buffer) - m_size;
+    return m_buffer + m_size;
+}
+
+// Parses the data that was received to the free space
+const Request::Status Request::commit(size_t size) throw()
+{
+    BOOST_ASSERT(m_size + size <= sizeof(m_buffer));
+    m_size += size;
+    if (m_status != PARSE_MORE)
+    {
+        // the data belongs to the next request
+        return m_status;
+    }
+    return parse();
+}
+
+// Adds the data and parses it
+const Request::Status Request::add(const char* data, size_t size) throw()
+{
+    size_t free = 0;
+    char* space = getSpace(free);
+    // the rest data is lost if the buffer is full: the request
+    // is too long and will be rejected
+    const size_t count = (size < free) ? size : free;
+    memcpy(space, data, count);
+    return commit(count);
+}
+
+// Removes the parsed request from the buffer
+const Request::Status Request::next() throw()
+{
+    if (m_status != PARSE_DONE)
+    {
+        // there is no way to find the next request start
+        reset();
+        return m_status;
+    }
+
+    const size_t rest = m_size - m_pos;
+    memmove(m_buffer, m_buffer + m_pos, rest);
+    reset();
+    m_size = rest;
+    return parse();
+}
+
+// Resets the parser
+void Request::reset() throw()
+{
+    m_size = 0;
+    m_pos = 0;
+    m_state = ST_START;
+    m_status = PARSE_MORE;
+    m_error = 0;
+    m_method = METHOD_UNKNOWN;
+    m_version = VERSION_UNKNOWN;
+    m_headers = 0;
+    m_header = HDR_UNKNOWN;
+    memset(&m_token, 0, sizeof(m_token));
+    memset(&m_path, 0, sizeof(m_path));
+    memset(m_fields, 0, sizeof(m_fields));
+}
+
+// Retrives the requested path
+const std::string Request::getPath() const
+{
+    return getToken(m_path);
+}
+
+// Retrives the User-Agent header value
+const std::string Request::getUserAgent() const
+{
+    return getToken(m_fields[HDR_USER_AGENT]);
+}
+
+// Retrives the X-Forwarded-For header value
+const std::string Request::getForwardedFor() const
+{
+    return getToken(m_fields[HDR_FORWARDED_FOR]);
+}
+
+// Retrives the Host header value
+const std::string Request::getHost() const
+{
+    return getToken(m_fields[HDR_HOST]);
+}
+
+// Checks should the connection be kept alive
+const bool Request::isKeepAlive() const throw()
+{
+    if (m_version == VERSION_11)
+    {
+        return !hasValue(m_fields[HDR_CONNECTION], "close");
+    }
+    return hasValue(m_fields[HDR_CONNECTION], "keep-alive");
+}
+
+// Parses the Range header
+const Request::RangeType Request::getRange(u_int64_t& first,
+                                           u_int64_t& last) const throw()
+{
+    first = last = 0;
+    const Token& token = m_fields[HDR_RANGE];
+    if (token.m_size == 0)
+    {
+        return RANGE_NONE;
+    }
+
+    const char* UNIT = "bytes=";
+    const size_t UNIT_SIZE = strlen(UNIT);
+    const char* i = m_buffer + token.m_start;
+    const char* end = i + token.m_size;
+    if (token.m_size <= UNIT_SIZE || strncasecmp(i, UNIT, UNIT_SIZE) != 0)
+    {
+        return RANGE_INVALID;
+    }
+    i += UNIT_SIZE;
+
+    if (*i == '-')
+    {
+        // bytes=-suffix
+        i = parseNumber(i + 1, end, first);
+        return (i == end) ? RANGE_CLOSED : RANGE_INVALID;
+    }
+
+    i = parseNumber(i, end, first);
+    if (i == NULL || i == end || *i != '-')
+    {
+        return RANGE_INVALID;
+    }
+    if (++i == end)
+    {
+        // bytes=first-
+        return RANGE_OPEN;
+    }
+
+    // multiple ranges are not supported
+    i = parseNumber(i, end, last);
+    if (i != end || last < first)
+    {
+        return RANGE_INVALID;
+    }
+    return RANGE_CLOSED;
+}
+
+// Parses the data from the current position
+const Request::Status Request::parse() throw()
+{
+    BOOST_ASSERT(m_status == PARSE_MORE);
+    for (; m_pos < m_size; m_pos++)
+    {
+        const char c = m_buffer[m_pos];
+        switch (m_state)
+        {
+        case ST_START:
+            // RFC 2616 4.1: empty lines before the request line
+            // should be ignored
+            if (c == '\r' || c == '\n')
+            {
+                break;
+            }
+            m_token.m_start = m_pos;
+            m_state = ST_METHOD;
+            // no break: the char is the first one of the method
+        case ST_METHOD:
+            if (c == ' ')
+            {
+                m_token.m_size = m_pos - m_token.m_start;
+                setMethod();
+                if (m_method == METHOD_UNKNOWN)
+                {
+                    return setError(m_token.m_size ? 405 : 400);
+                }
+                m_path.m_start = m_pos + 1;
+                m_state = ST_PATH;
+            }
+            else if (!isTokenChar(c))
+            {
+                return setError(400);
+            }
+            break;
+        case ST_PATH:
+        case ST_QUERY:
+            if (c == ' ' || c == '?')
+            {
+                if (m_state == ST_PATH)
+                {
+                    m_path.m_size = m_pos - m_path.m_start;
+                    if (m_path.m_size == 0 || m_buffer[m_path.m_start] != '/')
+                    {
+                        return setError(400);
+                    }
+                }
+                if (c == ' ')
+                {
+                    m_token.m_start = m_pos + 1;
+                    m_state = ST_VERSION;
+                }
+                else
+                {
+                    m_state = ST_QUERY;
+                }
+            }
+            else if (isControlChar(c))
+            {
+                // HTTP/0.9 requests are not supported
+                return setError(400);
+            }
+            break;
+        case ST_VERSION:
+            if (c == '\r' || c == '\n')
+            {
+                m_token.m_size = m_pos - m_token.m_start;
+                if (!setVersion())
+                {
+                    return m_status;
+                }
+                m_state = (c == '\r') ? ST_REQUEST_LF : ST_HEADER_START;
+            }
+            else if (!isTokenChar(c) && c != '/')
+            {
+                return setError(400);
+            }
+            break;
+        case ST_REQUEST_LF:
+        case ST_HEADER_LF:
+            if (c != '\n')
+            {
+                return setError(400);
+            }
+            m_state = ST_HEADER_START;
+            break;
+        case ST_HEADER_START:
+            if (c == '\r')
+            {
+                m_state = ST_END_LF;
+                break;
+            }
+            if (c == '\n')
+            {
+                m_pos++;
+                m_status = PARSE_DONE;
+                return m_status;
+            }
+            if (++m_headers > REQUEST_MAX_HEADERS)
+            {
+                return setError(431);
+            }
+            // folded lines are rejected too
+            if (!isTokenChar(c))
+            {
+                return setError(400);
+            }
+            m_token.m_start = m_pos;
+            m_state = ST_HEADER_NAME;
+            break;
+        case ST_HEADER_NAME:
+            if (c == ':')
+            {
+                m_token.m_size = m_pos - m_token.m_start;
+                setHeader();
+                m_state = ST_HEADER_SPACE;
+            }
+            else if (!isTokenChar(c))
+            {
+                return setError(400);
+            }
+            break;
+        case ST_HEADER_SPACE:
+            if (c == ' ' || c == '\t')
+            {
+                break;
+            }
+            m_token.m_start = m_pos;
+            m_state = ST_HEADER_VALUE;
+            // no break: the char is the first one of the value
+        case ST_HEADER_VALUE:
+            if (c == '\r' || c == '\n')
+            {
+                size_t end = m_pos;
+                while (end > m_token.m_start &&
+                       (m_buffer[end - 1] == ' ' ||
+                        m_buffer[end - 1] == '\t'))
+                {
+                    end--;
+                }
+                m_token.m_size = end - m_token.m_start;
+                if (m_header != HDR_UNKNOWN)
+                {
+                    m_fields[m_header] = m_token;
+                }
+                m_state = (c == '\r') ? ST_HEADER_LF : ST_HEADER_START;
+            }
+            else if (isControlChar(c) && c != '\t')
+            {
+                return setError(400);
+            }
+            break;
+        case ST_END_LF:
+            if (c != '\n')
+            {
+                return setError(400);
+            }
+            m_pos++;
+            m_status = PARSE_DONE;
+            return m_status;
+        default:
+            BOOST_ASSERT(false);
+            return setError(400);
+        }
+    }
+
+    if (m_size == sizeof(m_buffer))
+    {
+        // the buffer is full but the request was not completed
+        return setError(m_state <= ST_VERSION ? 414 : 431);
+    }
+
+    return m_status;
+}
+
+// Sets the error status
+const Request::Status Request::setError(u_int code) throw()
+{
+    m_error = code;
+    m_status = PARSE_ERROR;
+    return m_status;
+}
+
+// Finishes the method token
+void Request::setMethod() throw()
+{
+    // the method is case-sensitive
+    const char* method = m_buffer + m_token.m_start;
+    if (m_token.m_size == 3 && strncmp(method, "GET", 3) == 0)
+    {
+        m_method = METHOD_GET;
+    }
+    else if (m_token.m_size == 4 && strncmp(method, "HEAD", 4) == 0)
+    {
+        m_method = METHOD_HEAD;
+    }
+    else
+    {
+        m_method = METHOD_UNKNOWN;
+    }
+}
+
+// Finishes the version token
+const bool Request::setVersion() throw()
+{
+    const char* PREFIX = "HTTP/";
+    const size_t PREFIX_SIZE = strlen(PREFIX);
+    const char* version = m_buffer + m_token.m_start;
+    if (m_token.m_size != PREFIX_SIZE + 3 ||
+        strncmp(version, PREFIX, PREFIX_SIZE) != 0 ||
+        version[PREFIX_SIZE + 1] != '.')
+    {
+        setError(400);
+        return false;
+    }
+
+    const char major = version[PREFIX_SIZE];
+    const char minor = version[PREFIX_SIZE + 2];
+    if (major == '1' && minor == '1')
+    {
+        m_version = VERSION_11;
+    }
+    else if (major == '1' && minor == '0')
+    {
+        m_version = VERSION_10;
+    }
+    else if (major >= '0' && major <= '9' && minor >= '0' && minor <= '9')
+    {
+        setError(505);
+        return false;
+    }
+    else
+    {
+        setError(400);
+        return false;
+    }
+
+    return true;
+}
+
+// Finishes the header name token
+void Request::setHeader() throw()
+{
+    m_header = HDR_UNKNOWN;
+    const char* name = m_buffer + m_token.m_start;
+    for (size_t i = HDR_UNKNOWN + 1; i < HDR_COUNT; i++)
+    {
+        if (strlen(HEADER_NAMES[i]) == m_token.m_size &&
+            strncasecmp(name, HEADER_NAMES[i], m_token.m_size) == 0)
+        {
+            m_header = static_cast<Header>(i);
+            break;
+        }
+    }
+}
+
+// Retrives a token as string
+const std::string Request::getToken(const Token& token) const
+{
+    return std::string(m_buffer + token.m_start, token.m_size);
+}
+
+// Checks a token value (case insensitive)
+const bool Request::hasValue(const Token& token,
+                             const char* value) const throw()
+{
+    const size_t size = strlen(value);
+    if (token.m_size < size)
+    {
+        return false;
+    }
+
+    const char* data = m_buffer + token.m_start;
+    for (size_t i = 0; i + size <= token.m_size; i++)
+    {
+        if (strncasecmp(data + i, value, size) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
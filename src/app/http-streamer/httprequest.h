@@ -0,0 +1,383 @@
+/**
+   @file httprequest.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_HTTPREQUEST_H
+#define KLK_HTTPREQUEST_H
+
+#include <sys/types.h>
+
+#include <string>
+
+namespace klk
+{
+    namespace http
+    {
+        /// Max size of the HTTP request header (request line and headers)
+        const size_t REQUEST_MAX_SIZE = 8192;
+
+        /// Max headers count at the HTTP request
+        const size_t REQUEST_MAX_HEADERS = 64;
+
+        /**
+           @brief HTTP/1.1 request parser
+
+           The parser is a state machine over a fixed buffer. The data
+           can be added by any portions: the parsing is continued
+           from the place where it was stopped, thus each byte is looked
+           only once. There is not any memory allocation while parsing,
+           the parsed fields are kept as offsets at the buffer.
+
+           The data after the parsed request (pipelined requests) is kept
+           at the buffer and will be parsed after klk::http::Request::next
+           call.
+
+           @ingroup grHTTP
+        */
+        class Request
+        {
+        public:
+            /**
+               Parsing status
+            */
+            typedef enum
+            {
+                PARSE_MORE = 0, ///< more data is necessary
+                PARSE_DONE = 1, ///< the request was completely parsed
+                PARSE_ERROR = 2 ///< the request is incorrect
+            } Status;
+
+            /**
+               Request method
+            */
+            typedef enum
+            {
+                METHOD_UNKNOWN = 0,
+                METHOD_HEAD = 1,
+                METHOD_GET = 2
+            } Method;
+
+            /**
+               HTTP version
+            */
+            typedef enum
+            {
+                VERSION_UNKNOWN = 0,
+                VERSION_10 = 1,
+                VERSION_11 = 2
+            } Version;
+
+            /**
+               Range header type
+            */
+            typedef enum
+            {
+                RANGE_NONE = 0, ///< there is no Range header
+                RANGE_OPEN = 1, ///< bytes=first-
+                RANGE_CLOSED = 2, ///< bytes=first-last or bytes=-suffix
+                RANGE_INVALID = 3 ///< the header can not be parsed
+            } RangeType;
+
+            /**
+               Constructor
+            */
+            Request();
+
+            /**
+               Destructor
+            */
+            ~Request();
+
+            /**
+               Retrives the free space at the buffer. The data can be
+               received there directly and committed by
+               klk::http::Request::commit
+
+               @param[out] size - the free space size
+
+               @return the pointer to the free space
+            */
+            char* getSpace(size_t& size) throw();
+
+            /**
+               Parses the data that was received to the free space
+
+               @param[in] size - the received data size
+
+               @return the parsing status
+            */
+            const Status commit(size_t size) throw();
+
+            /**
+               Adds the data and parses it. The data that does not
+               fit the free space is ignored
+
+               @param[in] data - the data
+               @param[in] size - the data size
+
+               @return the parsing status
+            */
+            const Status add(const char* data, size_t size) throw();
+
+            /**
+               Removes the parsed request from the buffer and parses
+               the rest data (pipelined requests)
+
+               @return the parsing status
+            */
+            const Status next() throw();
+
+            /**
+               Resets the parser and removes all the data
+            */
+            void reset() throw();
+
+            /**
+               Retrives the parsing status
+
+               @return the status
+            */
+            const Status getStatus() const throw(){return m_status;}
+
+            /**
+               Checks is there any data at the buffer
+
+               @return
+               - true - there is no data
+               - false - there is some data
+            */
+            const bool empty() const throw(){return m_size == 0;}
+
+            /**
+               Retrives the HTTP status code for incorrect request
+
+               @return the code (400, 405, 414, 431, 505)
+            */
+            const u_int getError() const throw(){return m_error;}
+
+            /**
+               Retrives the request method
+
+               @return the method
+            */
+            const Method getMethod() const throw(){return m_method;}
+
+            /**
+               Retrives the HTTP version
+
+               @return the version
+            */
+            const Version getVersion() const throw(){return m_version;}
+
+            /**
+               Retrives the requested path without the query string
+
+               @return the path
+            */
+            const std::string getPath() const;
+
+            /**
+               Retrives the User-Agent header value
+
+               @return the value or an empty string
+            */
+            const std::string getUserAgent() const;
+
+            /**
+               Retrives the X-Forwarded-For header value
+
+               @return the value or an empty string
+            */
+            const std::string getForwardedFor() const;
+
+            /**
+               Retrives the Host header value
+
+               @return the value or an empty string
+            */
+            const std::string getHost() const;
+
+            /**
+               Checks should the connection be kept alive after
+               the response or not. HTTP/1.1 connections are persistent
+               by default, HTTP/1.0 ones require Connection: keep-alive
+
+               @return
+               - true
+               - false
+            */
+            const bool isKeepAlive() const throw();
+
+            /**
+               Parses the Range header. Only one bytes range is
+               supported
+
+               @param[out] first - the first byte position (or suffix
+               length for bytes=-suffix)
+               @param[out] last - the last byte position (0 for
+               open or suffix ranges)
+
+               @return the range type
+            */
+            const RangeType getRange(u_int64_t& first,
+                                     u_int64_t& last) const throw();
+        private:
+            /**
+               Parser state
+            */
+            typedef enum
+            {
+                ST_START = 0, ///< empty lines before the request line
+                ST_METHOD,
+                ST_PATH,
+                ST_QUERY,
+                ST_VERSION,
+                ST_REQUEST_LF,
+                ST_HEADER_START,
+                ST_HEADER_NAME,
+                ST_HEADER_SPACE,
+                ST_HEADER_VALUE,
+                ST_HEADER_LF,
+                ST_END_LF
+            } State;
+
+            /**
+               Known headers
+            */
+            typedef enum
+            {
+                HDR_UNKNOWN = 0,
+                HDR_HOST,
+                HDR_USER_AGENT,
+                HDR_FORWARDED_FOR,
+                HDR_RANGE,
+                HDR_CONNECTION,
+                HDR_COUNT
+            } Header;
+
+            /**
+               Field position at the buffer
+            */
+            struct Token
+            {
+                u_short m_start; ///< the first byte offset
+                u_short m_size; ///< the size
+            };
+
+            char m_buffer[REQUEST_MAX_SIZE]; ///< the data
+            size_t m_size; ///< the data size
+            size_t m_pos; ///< the parsing position
+            State m_state; ///< the parser state
+            Status m_status; ///< the parsing status
+            u_int m_error; ///< HTTP status code for incorrect request
+            Method m_method; ///< the method
+            Version m_version; ///< the HTTP version
+            size_t m_headers; ///< the headers count
+            Header m_header; ///< the header that is being parsed
+            Token m_token; ///< the field that is being parsed
+            Token m_path; ///< the path
+            Token m_fields[HDR_COUNT]; ///< the known headers values
+
+            /**
+               Parses the data from the current position
+
+               @return the parsing status
+            */
+            const Status parse() throw();
+
+            /**
+               Sets the error status
+
+               @param[in] code - the HTTP status code
+
+               @return the parsing status
+            */
+            const Status setError(u_int code) throw();
+
+            /**
+               Finishes the method token
+            */
+            void setMethod() throw();
+
+            /**
+               Finishes the version token
+
+               @return
+               - true - the version is supported
+               - false - there was an error
+            */
+            const bool setVersion() throw();
+
+            /**
+               Finishes the header name token
+            */
+            void setHeader() throw();
+
+            /**
+               Retrives a token as string
+
+               @param[in] token - the token
+
+               @return the string
+            */
+            const std::string getToken(const Token& token) const;
+
+            /**
+               Checks a token value (case insensitive)
+
+               @param[in] token - the token
+               @param[in] value - the value (in lower case)
+
+               @return
+               - true - the token contains the value
+               - false
+            */
+            const bool hasValue(const Token& token,
+                                const char* value) const throw();
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            Request(const Request& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            Request& operator=(const Request& value);
+        };
+    }
+}
+
+#endif //KLK_HTTPREQUEST_H
@@ -0,0 +1,238 @@
+/**
+   @file httpresponse.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#include <sstream>
+
+#include "httpresponse.h"
+#include "exception.h"
+#include "version.h"
+
+using namespace klk;
+using namespace klk::http;
+
+//
+// ResponseCache class
+//
+
+// Constructor
+ResponseCache::ResponseCache() :
+    m_lock(), m_time(0), m_date(), m_paths(), m_errors(), m_bodies()
+{
+}
+
+// Destructor
+ResponseCache::~ResponseCache()
+{
+}
+
+// Retrives an OK response for the input path
+const BinaryData ResponseCache::getOK(const std::string& path,
+                                      const IReaderPtr& reader,
+                                      bool http11, bool keep_alive)
+{
+    BOOST_ASSERT(reader);
+
+    Locker lock(&m_lock);
+    updateClock();
+
+    PathResponses& responses = m_paths[path];
+    if (responses.m_reader.lock() != reader)
+    {
+        // new input source: all responses should be rebuilt
+        responses.m_reader = reader;
+        responses.m_content_type = reader->getContentType();
+        for (size_t i = 0; i < OK_VARIANTS; i++)
+        {
+            responses.m_responses[i].m_time = 0;
+        }
+    }
+
+    Response& response =
+        responses.m_responses[(http11 ? 2 : 0) + (keep_alive ? 1 : 0)];
+    if (response.m_time != m_time)
+    {
+        response.m_data = makeOK(responses.m_content_type,
+                                 http11, keep_alive);
+        response.m_time = m_time;
+    }
+    return response.m_data;
+}
+
+// Retrives a response with an error code
+const BinaryData ResponseCache::getError(u_int code, bool head,
+                                         bool keep_alive)
+{
+    Locker lock(&m_lock);
+    updateClock();
+
+    Response& response =
+        m_errors[code * 4 + (head ? 2 : 0) + (keep_alive ? 1 : 0)];
+    if (response.m_time != m_time)
+    {
+        response.m_data = makeError(code, head, keep_alive);
+        response.m_time = m_time;
+    }
+    return response.m_data;
+}
+
+// Retrives the Date header value
+const std::string ResponseCache::getDate()
+{
+    Locker lock(&m_lock);
+    updateClock();
+    return m_date;
+}
+
+// Updates the shared clock
+void ResponseCache::updateClock()
+{
+    const time_t now = time(NULL);
+    if (now == m_time)
+    {
+        return;
+    }
+
+    struct tm gmt;
+    if (gmtime_r(&now, &gmt) == NULL)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Error %d in gmtime_r(): %s",
+                        errno, strerror(errno));
+    }
+    char buff[64];
+    strftime(buff, sizeof(buff), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    m_date = buff;
+    m_time = now;
+}
+
+// Makes an OK response
+const BinaryData ResponseCache::makeOK(const std::string& content_type,
+                                       bool http11, bool keep_alive) const
+{
+    std::stringstream response;
+    response << "HTTP/1.1 200 OK\r\n";
+    response << "Date: " << m_date << "\r\n";
+    response << "Server: " << VERSION_STR << "\r\n";
+    response << "Pragma: no-cache,private\r\n";
+    response << "Cache-Control: no-cache\r\n";
+    response << "Content-Type: " << content_type << "\r\n";
+    if (http11)
+    {
+        response << "Transfer-Encoding: chunked\r\n";
+    }
+    else
+    {
+        response << "Length: unspecified [" << content_type << "]\r\n";
+    }
+    response << "Connection: " <<
+        (keep_alive ? "keep-alive" : "close") << "\r\n";
+    response << "\r\n";
+
+    return BinaryData(response.str());
+}
+
+// Makes a response with an error code
+const BinaryData ResponseCache::makeError(u_int code, bool head,
+                                          bool keep_alive)
+{
+    const std::string status = getStatus(code);
+
+    // the body is built once
+    BodyMap::iterator body = m_bodies.find(code);
+    if (body == m_bodies.end())
+    {
+        const std::string data =
+            "<!DOCTYPE HTML PUBLIC \"-//IETF//DTD HTML 2.0//EN\">"
+            "<html><head>"
+            "<title>" + status + "</title>"
+            "</head><body>"
+            "<h1>" + status + "</h1>"
+            "</body>"
+            "</html>";
+        body = m_bodies.insert(BodyMap::value_type(code, data)).first;
+    }
+
+    std::stringstream response;
+    response << "HTTP/1.1 " << status << "\r\n";
+    response << "Date: " << m_date << "\r\n";
+    response << "Server: " << VERSION_STR << "\r\n";
+    response << "Pragma: no-cache,private\r\n";
+    response << "Cache-Control: no-cache\r\n";
+    if (code == 405)
+    {
+        response << "Allow: GET, HEAD\r\n";
+    }
+    response << "Content-Length: " << body->second.size() << "\r\n";
+    response << "Connection: " <<
+        (keep_alive ? "keep-alive" : "close") << "\r\n";
+    response << "\r\n";
+    if (!head)
+    {
+        response << body->second;
+    }
+
+    return BinaryData(response.str());
+}
+
+// Retrives the status line text
+const std::string ResponseCache::getStatus(u_int code)
+{
+    switch (code)
+    {
+    case 400:
+        return "400 Bad Request";
+    case 404:
+        return "404 Not Found";
+    case 405:
+        return "405 Method Not Allowed";
+    case 414:
+        return "414 Request-URI Too Long";
+    case 431:
+        return "431 Request Header Fields Too Large";
+    case 505:
+        return "505 HTTP Version Not Supported";
+    default:
+        break;
+    }
+
+    BOOST_ASSERT(false);
+    return "500 Internal Server Error";
+}
@@ -0,0 +1,218 @@
+/**
+   @file httpresponse.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_HTTPRESPONSE_H
+#define KLK_HTTPRESPONSE_H
+
+#include <time.h>
+
+#include <map>
+#include <string>
+
+#include <boost/weak_ptr.hpp>
+
+#include "binarydata.h"
+#include "thread.h"
+#include "reader.h"
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief Cache with HTTP responses
+
+           The responses are built once per input path, HTTP version and
+           connection type. The error responses are built once per error
+           code. The Date header is refreshed by a clock that is shared
+           by all responses: a cached response is rebuilt only if it was
+           made in the previous second. Thus a new connection gets its
+           response by a copy from the cache.
+
+           @ingroup grHTTP
+        */
+        class ResponseCache
+        {
+        public:
+            /**
+               Constructor
+            */
+            ResponseCache();
+
+            /**
+               Destructor
+            */
+            ~ResponseCache();
+
+            /**
+               Retrives an OK response for the input path
+
+               @param[in] path - the input path
+               @param[in] reader - the input reader, the content type
+               is asked only when the reader is changed
+               @param[in] http11 - HTTP/1.1 (chunked) response or not
+               @param[in] keep_alive - the Connection header value
+
+               @return the response
+
+               @exception klk::Exception
+            */
+            const BinaryData getOK(const std::string& path,
+                                   const IReaderPtr& reader,
+                                   bool http11, bool keep_alive);
+
+            /**
+               Retrives a response with an error code
+
+               @param[in] code - the HTTP status code
+               @param[in] head - is it a response for HEAD request or not
+               (there is no body for HEAD)
+               @param[in] keep_alive - the Connection header value
+
+               @return the response
+
+               @exception klk::Exception
+            */
+            const BinaryData getError(u_int code, bool head, bool keep_alive);
+
+            /**
+               Retrives the Date header value
+
+               @return the current time in RFC 1123 format
+            */
+            const std::string getDate();
+        private:
+            /// OK responses count for a path: HTTP version x connection
+            static const size_t OK_VARIANTS = 4;
+
+            /**
+               A cached response
+            */
+            struct Response
+            {
+                BinaryData m_data; ///< the response
+                time_t m_time; ///< the Date header value
+
+                /// Constructor
+                Response() : m_data(), m_time(0){}
+            };
+
+            /**
+               The responses for an input path
+            */
+            struct PathResponses
+            {
+                boost::weak_ptr<IReader> m_reader; ///< the input reader
+                std::string m_content_type; ///< the content type
+                Response m_responses[OK_VARIANTS]; ///< the responses
+            };
+
+            /**
+               Path responses storage
+            */
+            typedef std::map<std::string, PathResponses> PathMap;
+
+            /**
+               Error responses storage
+            */
+            typedef std::map<u_int, Response> ErrorMap;
+
+            /**
+               Error bodies storage
+            */
+            typedef std::map<u_int, std::string> BodyMap;
+
+            klk::Mutex m_lock; ///< locker
+            time_t m_time; ///< the clock time
+            std::string m_date; ///< the Date header value
+            PathMap m_paths; ///< the OK responses
+            ErrorMap m_errors; ///< the error responses
+            BodyMap m_bodies; ///< the error bodies
+
+            /**
+               Updates the shared clock
+
+               @note should be called under the lock
+            */
+            void updateClock();
+
+            /**
+               Makes an OK response
+
+               @param[in] content_type - the content type
+               @param[in] http11 - HTTP/1.1 (chunked) response or not
+               @param[in] keep_alive - the Connection header value
+
+               @return the response
+            */
+            const BinaryData makeOK(const std::string& content_type,
+                                    bool http11, bool keep_alive) const;
+
+            /**
+               Makes a response with an error code
+
+               @param[in] code - the HTTP status code
+               @param[in] head - is it a response for HEAD request or not
+               @param[in] keep_alive - the Connection header value
+
+               @return the response
+            */
+            const BinaryData makeError(u_int code, bool head,
+                                       bool keep_alive);
+
+            /**
+               Retrives the status line text
+
+               @param[in] code - the HTTP status code
+
+               @return the text, for example "404 Not Found"
+            */
+            static const std::string getStatus(u_int code);
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            ResponseCache(const ResponseCache& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            ResponseCache& operator=(const ResponseCache& value);
+        };
+    }
+}
+
+#endif //KLK_HTTPRESPONSE_H
@@ -98,7 +98,8 @@ void InputInfo::setMediaTypeUuid(const std::string& muuid)
 // Constructor
 InThread::InThread(Factory* factory, const InputInfoPtr& info) :
     RouteThread(factory), m_reader_lock(), m_info(info),
-    m_reader(), m_con_count_lock(), m_con_count(0)
+    m_reader(), m_con_count_lock(), m_con_count(0),
+    m_ring(new ChunkRing(INPUTRING_MAX_SIZE))
 {
     BOOST_ASSERT(m_info);
     setRoute(m_info->getRouteInfo());
@@ -204,6 +205,8 @@ void InThread::resetReader()
 {
     Locker lock(&m_reader_lock);
     m_reader.reset();
+    // the cached GOP belongs to the previous source
+    m_ring->reset();
 }
 
 // Inits reader
@@ -213,6 +216,11 @@ void InThread::initReader()
 
     // setting keep alive interval
     sock->setKeepAlive(10);
+    if (getRoute()->getProtocol() == sock::UDP)
+    {
+        // a large buffer prevents datagram drops at bitrate peaks
+        sock->setRecvBuffer(INPUT_UDP_RCVBUF_SIZE);
+    }
 
     Locker lock(&m_reader_lock);
     const std::string mtype = m_info->getMediaTypeUuid();
@@ -253,8 +261,9 @@ void InThread::doLoopAction()
         return;
 
 
+    const IReaderPtr reader = getReader();
     BinaryData buff;
-    getReader()->getData(buff);
+    reader->getData(buff);
     BOOST_ASSERT(buff.empty() == false);
 
 #if 0
@@ -262,9 +271,10 @@ void InThread::doLoopAction()
             "Got %d bytes for HTTP streamer at inthread", buff.size());
 #endif
 
-    // send the data to recived connection from end-users
-    getFactory()->getConnectThreadContainer()->sendConnectionData(
-        m_info->getPath(), buff);
+    // the data is shared by all connections from end-users
+    m_ring->push(ChunkPtr(new Chunk(buff, reader->isKeyFrame())));
+    getFactory()->getConnectThreadContainer()->notifyConnections(
+        m_info->getPath());
 }
 
 // Increases connection count
@@ -43,6 +43,7 @@
 
 #include "routethread.h"
 #include "reader.h"
+#include "chunk.h"
 
 namespace klk
 {
@@ -186,6 +187,13 @@ namespace klk
             */
             const IReaderPtr getReader() const;
 
+            /**
+               Retrives the data ring
+
+               @return the ring
+            */
+            const ChunkRingPtr getRing() const throw(){return m_ring;}
+
             /**
                Increases connection count
             */
@@ -248,6 +256,7 @@ namespace klk
             IReaderPtr m_reader; ///< the reader
             mutable klk::Mutex m_con_count_lock; ///< connection counter locker
             u_long m_con_count; ///< connection count
+            const ChunkRingPtr m_ring; ///< the data ring
 
             /**
                @copydoc IThread::start()
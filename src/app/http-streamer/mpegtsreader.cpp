@@ -39,6 +39,7 @@
 #endif
 
 #include <string.h>
+#include <sys/time.h>
 
 #include "mpegtsreader.h"
 #include "exception.h"
@@ -56,9 +57,183 @@ using namespace klk::http;
 */
 const size_t MPEGTS_PACKET_SIZE = 188;
 
+/**
+   MpegTS sync byte
+*/
+const u_char MPEGTS_SYNC_BYTE = 0x47;
+
+/**
+   Null packets PID
+*/
+const u_int MPEGTS_NULL_PID = 0x1FFF;
+
+/**
+   PID count
+*/
+const size_t MPEGTS_PID_COUNT = 0x2000;
+
+/**
+   The data portion size for a single read. It holds a whole UDP
+   batch of datagrams with 7 packets each
+*/
+const size_t MPEGTS_READ_SIZE = MPEGTS_PACKET_SIZE * 7 * UDP_BATCH_SIZE;
+
+/**
+   Max chunk size
+*/
+const size_t MPEGTS_CHUNK_MAX_SIZE = MPEGTS_PACKET_SIZE * 1050;
+
+/**
+   Chunk duration (in ms)
+*/
+const u_int64_t MPEGTS_CHUNK_INTERVAL = 40;
+
+/**
+   PCR base clock (90 kHz) ticks per ms
+*/
+const u_int64_t PCR_TICKS_PER_MS = 90;
+
+/**
+   PCR base is 33 bits long
+*/
+const u_int64_t PCR_MASK = (static_cast<u_int64_t>(1) << 33) - 1;
+
+/**
+   PCR difference that is treated as a discontinuity (10 sec)
+*/
+const u_int64_t PCR_MAX_JUMP = 10000 * PCR_TICKS_PER_MS;
+
+/**
+   H.264 NAL unit types that start a keyframe: SPS and IDR slice
+*/
+const u_char H264_NAL_SPS = 7;
+const u_char H264_NAL_IDR = 5;
+
+/**
+   MPEG-2 video sequence header start code
+*/
+const u_char MPEG2_SEQUENCE_HEADER = 0xB3;
+
+/**
+   Retrives the packet PID
+
+   @param[in] packet - the packet
+
+   @return the PID
+*/
+static u_int getPID(const u_char* packet)
+{
+    return ((packet[1] & 0x1F) << 8) | packet[2];
+}
+
+/**
+   Retrives PCR base (90 kHz) from the packet
+
+   @param[in] packet - the packet
+   @param[out] pcr - the PCR
+
+   @return true if the packet has PCR
+*/
+static bool getPCR(const u_char* packet, u_int64_t& pcr)
+{
+    if ((packet[3] & 0x20) == 0 || packet[4] < 7 || (packet[5] & 0x10) == 0)
+    {
+        return false;
+    }
+
+    pcr = (static_cast<u_int64_t>(packet[6]) << 25) |
+        (static_cast<u_int64_t>(packet[7]) << 17) |
+        (static_cast<u_int64_t>(packet[8]) << 9) |
+        (static_cast<u_int64_t>(packet[9]) << 1) |
+        (static_cast<u_int64_t>(packet[10]) >> 7);
+    return true;
+}
+
+/**
+   Retrives the current time in ms
+
+   @return the time
+*/
+static u_int64_t getTime()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return static_cast<u_int64_t>(now.tv_sec) * 1000 + now.tv_usec / 1000;
+}
+
+/**
+   Checks is the packet a random access point
+
+   The adaptation field random_access_indicator is checked first
+   but only at the PCR (video) PID: many muxers set it at each audio PES.
+   A packet with PCR is at the PCR PID even if it's not known yet.
+   Some muxers do not set it thus the start of a video PES
+   is also checked for H.264 SPS/IDR or MPEG-2 sequence header
+
+   @param[in] packet - the packet
+   @param[in] pcrpid - the PCR PID or -1 if it's unknown yet
+
+   @return true if it is
+*/
+static bool isRandomAccess(const u_char* packet, int pcrpid)
+{
+    if (packet[0] != MPEGTS_SYNC_BYTE)
+    {
+        return false;
+    }
+
+    const u_char control = (packet[3] >> 4) & 0x03;
+    size_t payload = 4;
+    if (control & 0x02)
+    {
+        // adaptation field
+        const u_char length = packet[4];
+        if (length > 0 && (packet[5] & 0x40) &&
+            ((packet[5] & 0x10) ||
+             static_cast<int>(getPID(packet)) == pcrpid))
+        {
+            return true;
+        }
+        payload += 1 + length;
+    }
+
+    // only the payload unit start is interesting for us
+    if ((control & 0x01) == 0 || (packet[1] & 0x40) == 0 ||
+        payload + 9 > MPEGTS_PACKET_SIZE)
+    {
+        return false;
+    }
+
+    // video PES: 00 00 01 Ex
+    const u_char* pes = packet + payload;
+    if (pes[0] != 0 || pes[1] != 0 || pes[2] != 1 || (pes[3] & 0xF0) != 0xE0)
+    {
+        return false;
+    }
+
+    for (size_t i = payload + 9 + pes[8]; i + 3 < MPEGTS_PACKET_SIZE; i++)
+    {
+        if (packet[i] == 0 && packet[i + 1] == 0 && packet[i + 2] == 1)
+        {
+            const u_char code = packet[i + 3];
+            const u_char type = code & 0x1F;
+            if (code == MPEG2_SEQUENCE_HEADER ||
+                type == H264_NAL_SPS || type == H264_NAL_IDR)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 // Constructor
 MPEGTSReader::MPEGTSReader(const ISocketPtr& sock) :
-    Reader(sock, WAITINTERVAL), m_header()
+    Reader(sock, WAITINTERVAL), m_header(), m_buffer(), m_pos(0),
+    m_synced(false), m_chunk(), m_chunk_keyframe(false), m_chunk_time(0),
+    m_pcr_pid(-1), m_pcr_start(0), m_has_pcr_start(false),
+    m_cc(MPEGTS_PID_COUNT, -1), m_keyframe(false)
 {
 }
 
@@ -82,7 +257,201 @@ const BinaryData MPEGTSReader::getHeader() const
 void MPEGTSReader::getData(BinaryData& data)
 {
     BOOST_ASSERT(data.empty() == true);
-    data.resize(MPEGTS_PACKET_SIZE*1050);
-    m_sock->recvAll(data);
+    for(;;)
+    {
+        while (sync())
+        {
+            const u_char* packet = &m_buffer[m_pos];
+            if (getPID(packet) != MPEGTS_NULL_PID)
+            {
+                if (isFlushNeeded(packet))
+                {
+                    flush(data);
+                    return;
+                }
+                addPacket(packet);
+            }
+            m_pos += MPEGTS_PACKET_SIZE;
+        }
+
+        // no PCR in the stream: the wall clock is used
+        if (!m_chunk.empty() && m_pcr_pid < 0 &&
+            getTime() - m_chunk_time >= MPEGTS_CHUNK_INTERVAL)
+        {
+            flush(data);
+            return;
+        }
+
+        // read more data
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_pos);
+        m_pos = 0;
+        BinaryData buff(MPEGTS_READ_SIZE);
+        m_sock->recv(buff);
+        if (buff.empty())
+        {
+            // end of data
+            flush(data);
+            return;
+        }
+        const u_char* begin = static_cast<const u_char*>(buff.toVoid());
+        m_buffer.insert(m_buffer.end(), begin, begin + buff.size());
+    }
+}
+
+// Does the last data portion start with a keyframe
+const bool MPEGTSReader::isKeyFrame() const throw()
+{
+    return m_keyframe;
+}
+
+// Checks is there any data available
+const Result MPEGTSReader::checkData()
+{
+    if (m_pos + MPEGTS_PACKET_SIZE <= m_buffer.size())
+    {
+        // there are packets that were not processed yet
+        return OK;
+    }
+    return Reader::checkData();
 }
 
+// Finds the next packet at the buffer
+const bool MPEGTSReader::sync()
+{
+    const size_t size = m_buffer.size();
+    while (m_pos + MPEGTS_PACKET_SIZE <= size)
+    {
+        if (m_buffer[m_pos] == MPEGTS_SYNC_BYTE)
+        {
+            if (m_synced)
+            {
+                return true;
+            }
+            // the next packet should also start with the sync byte
+            if (m_pos + MPEGTS_PACKET_SIZE >= size)
+            {
+                return false;
+            }
+            if (m_buffer[m_pos + MPEGTS_PACKET_SIZE] == MPEGTS_SYNC_BYTE)
+            {
+                m_synced = true;
+                return true;
+            }
+        }
+        else if (m_synced)
+        {
+            m_synced = false;
+            increaseBrokenCount();
+            klk_log(KLKLOG_DEBUG, "MPEG-TS sync was lost for data from %s",
+                    m_sock->getPeerName().c_str());
+        }
+        m_pos++;
+    }
+
+    return false;
+}
+
+// Checks should the chunk be sent before the packet
+const bool MPEGTSReader::isFlushNeeded(const u_char* packet) const
+{
+    if (m_chunk.empty())
+    {
+        return false;
+    }
+
+    if (m_chunk.size() + MPEGTS_PACKET_SIZE > MPEGTS_CHUNK_MAX_SIZE)
+    {
+        return true;
+    }
+
+    // a keyframe begins a chunk
+    if (isRandomAccess(packet, m_pcr_pid))
+    {
+        return true;
+    }
+
+    u_int64_t pcr = 0;
+    if (m_has_pcr_start && static_cast<int>(getPID(packet)) == m_pcr_pid &&
+        getPCR(packet, pcr))
+    {
+        const u_int64_t diff = (pcr - m_pcr_start) & PCR_MASK;
+        return (diff >= MPEGTS_CHUNK_INTERVAL * PCR_TICKS_PER_MS &&
+                diff < PCR_MAX_JUMP);
+    }
+
+    return false;
+}
+
+// Adds the packet to the chunk
+void MPEGTSReader::addPacket(const u_char* packet)
+{
+    if (m_chunk.empty())
+    {
+        m_chunk_keyframe = isRandomAccess(packet, m_pcr_pid);
+        m_chunk_time = getTime();
+        m_has_pcr_start = false;
+    }
+
+    checkContinuity(packet);
+
+    u_int64_t pcr = 0;
+    if (getPCR(packet, pcr))
+    {
+        const int pid = static_cast<int>(getPID(packet));
+        if (m_pcr_pid < 0)
+        {
+            m_pcr_pid = pid;
+        }
+        // the start is also reset at a PCR discontinuity
+        if (pid == m_pcr_pid &&
+            (!m_has_pcr_start ||
+             ((pcr - m_pcr_start) & PCR_MASK) >= PCR_MAX_JUMP))
+        {
+            m_pcr_start = pcr;
+            m_has_pcr_start = true;
+        }
+    }
+
+    const size_t size = m_chunk.size();
+    m_chunk.resize(size + MPEGTS_PACKET_SIZE);
+    memcpy(static_cast<u_char*>(m_chunk.toVoid()) + size, packet,
+           MPEGTS_PACKET_SIZE);
+}
+
+// Checks the continuity counter of the packet
+void MPEGTSReader::checkContinuity(const u_char* packet)
+{
+    const u_char control = (packet[3] >> 4) & 0x03;
+    if ((control & 0x01) == 0)
+    {
+        // the counter is not incremented for packets without payload
+        return;
+    }
+
+    const u_int pid = getPID(packet);
+    const int cc = packet[3] & 0x0F;
+    const int last = m_cc[pid];
+    m_cc[pid] = cc;
+    if (last < 0 || cc == last)
+    {
+        // the first packet or a duplicate one
+        return;
+    }
+
+    const bool discontinuity =
+        (control & 0x02) && packet[4] > 0 && (packet[5] & 0x80);
+    if (cc != ((last + 1) & 0x0F) && !discontinuity)
+    {
+        increaseBrokenCount();
+    }
+}
+
+// Moves the collected chunk to the output
+void MPEGTSReader::flush(BinaryData& data)
+{
+    BOOST_ASSERT(data.empty() == true);
+    data.swap(m_chunk);
+    m_keyframe = m_chunk_keyframe;
+    m_chunk_keyframe = false;
+    m_has_pcr_start = false;
+}
@@ -37,6 +37,8 @@
 #ifndef KLK_MPEGTSREADER_H
 #define KLK_MPEGTSREADER_H
 
+#include <vector>
+
 #include "reader.h"
 
 namespace klk
@@ -47,9 +49,15 @@ namespace klk
            @brief Mpegts reader
 
            Reader for mpeg ts media data. Mpeg TS has a simple format
-           with fixed block size (188 bytes length). We read several packets
-           in a time before sending (> 1000 packets). It's necessary
-           to prevent resource usage if we read just a packet before send.
+           with fixed block size (188 bytes length). The reader
+           looks for the packet boundaries (sync byte 0x47) and
+           resynchronises if some data was lost. It checks the
+           continuity counters and drops the null packets.
+
+           The packets are collected into a chunk that is sent when
+           40 ms of PCR time is reached (or by the wall clock if the
+           stream does not have PCR). A keyframe always starts a new
+           chunk.
 
            @ingrou grHTTPReader
         */
@@ -73,7 +81,23 @@ namespace klk
                 return IReaderPtr(new MPEGTSReader(sock));
             }
         private:
+            /**
+               Buffer with received data
+            */
+            typedef std::vector<u_char> PacketBuffer;
+
             klk::BinaryData m_header; ///< header
+            PacketBuffer m_buffer; ///< the received data
+            size_t m_pos; ///< processed bytes count at the buffer
+            bool m_synced; ///< are the packet boundaries known
+            klk::BinaryData m_chunk; ///< the chunk that is being collected
+            bool m_chunk_keyframe; ///< does the chunk start with a keyframe
+            u_int64_t m_chunk_time; ///< the chunk start time (in ms)
+            int m_pcr_pid; ///< PID with PCR or -1 if it's unknown yet
+            u_int64_t m_pcr_start; ///< PCR at the chunk start
+            bool m_has_pcr_start; ///< was the chunk start PCR found
+            std::vector<int> m_cc; ///< the last continuity counters by PID
+            bool m_keyframe; ///< does the last portion start with a keyframe
 
             /**
                Constructor
@@ -106,6 +130,61 @@ namespace klk
                @exception klk::Exception
             */
             virtual void getData(klk::BinaryData& data);
+
+            /**
+               Does the last data portion start with a keyframe
+
+               @return true if it does
+            */
+            virtual const bool isKeyFrame() const throw();
+
+            /**
+               Checks is there any data available
+
+               The packets that were received but not processed
+               yet are also taken into account
+
+               @see klk::Socket::checkData
+            */
+            virtual const Result checkData();
+
+            /**
+               Finds the next packet at the buffer
+
+               @return true if the packet is available at the
+               current position
+            */
+            const bool sync();
+
+            /**
+               Checks should the chunk be sent before the packet
+
+               @param[in] packet - the packet
+
+               @return true if it should
+            */
+            const bool isFlushNeeded(const u_char* packet) const;
+
+            /**
+               Adds the packet to the chunk
+
+               @param[in] packet - the packet
+            */
+            void addPacket(const u_char* packet);
+
+            /**
+               Checks the continuity counter of the packet
+
+               @param[in] packet - the packet
+            */
+            void checkContinuity(const u_char* packet);
+
+            /**
+               Moves the collected chunk to the output
+
+               @param[out] data - the data container
+            */
+            void flush(klk::BinaryData& data);
         private:
             /**
                Assigment operator
@@ -69,9 +69,7 @@ void OutThread::start()
         try
         {
             ISocketPtr sock = getListener()->accept();
-            ConnectThreadPtr thread(new ConnectThread(getFactory(), sock));
-            getFactory()->getConnectThreadContainer()->startConnectThread(
-                thread);
+            getFactory()->getConnectThreadContainer()->startConnection(sock);
         }
         catch(const std::exception& err)
         {
@@ -40,7 +40,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "routethread.h"
-#include "stopthread.h"
+#include "conthread.h"
 
 namespace klk
 {
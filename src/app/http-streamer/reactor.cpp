@@ -0,0 +1,723 @@
+/**
+   @file reactor.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#ifdef LINUX
+#include <sys/epoll.h>
+#endif
+
+#include <list>
+
+#include "reactor.h"
+#include "exception.h"
+#include "httpfactory.h"
+#include "taskpool.h"
+#include "defines.h"
+
+using namespace klk;
+using namespace klk::http;
+
+//
+// ReactorConnection class
+//
+
+// Constructor
+ReactorConnection::ReactorConnection(Factory* factory,
+                                     const ISocketPtr& sock,
+                                     Reactor* reactor) :
+    Connection(factory, sock), m_reactor(reactor),
+    m_fd(sock->getDescriptor()), m_start_time(time(NULL)), m_requests(0),
+    m_prefix(), m_chunks(), m_offset(0),
+    m_pending(false), m_write_waiting(false),
+    m_streaming(false), m_closed(false), m_last_time(time(NULL))
+{
+    BOOST_ASSERT(m_reactor);
+    BOOST_ASSERT(m_fd >= 0);
+}
+
+// Destructor
+ReactorConnection::~ReactorConnection()
+{
+}
+
+// Notifies about new data
+// @note called from input threads
+void ReactorConnection::notifyData(const std::string& path)
+{
+    if (!m_streaming.getValue() || isClosed())
+    {
+        return;
+    }
+
+    m_last_time.setValue(time(NULL));
+    m_reactor->notify(m_fd);
+}
+
+// Reads data that is available at the socket
+const bool ReactorConnection::read() throw()
+{
+    // the socket is used directly without klk::ISocket::recv
+    // because the last one closes the descriptor on errors
+    // but the descriptor should be removed from the reactor poll first
+    // The request is received directly to the parser buffer
+    char drain[SOCKBUFFSIZE];
+    size_t size = 0;
+    char* buffer = m_request.getSpace(size);
+    if (m_streaming.getValue())
+    {
+        // nothing is expected from the client after the GET request
+        buffer = drain;
+        size = sizeof(drain);
+    }
+    else if (size == 0)
+    {
+        // the pipelined requests wait for the response
+        klk_log(KLKLOG_ERROR, "Too many pipelined HTTP requests from %s",
+                m_sock->getPeerName().c_str());
+        return false;
+    }
+
+    ssize_t count = ::recv(m_fd, buffer, size, MSG_DONTWAIT);
+    if (count < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    else if (count == 0)
+    {
+        // closed by the client
+        return false;
+    }
+
+    if (m_streaming.getValue())
+    {
+        return true;
+    }
+
+    const Request::Status status = m_request.commit(count);
+    if (m_response_type != RES_UNKNOWN || status == Request::PARSE_MORE)
+    {
+        // the response for the previous request is being sent or
+        // more data is necessary
+        return true;
+    }
+
+    try
+    {
+        processRequest();
+    }
+    catch(const std::exception& err)
+    {
+        klk_log(KLKLOG_ERROR, "Error while processing HTTP request "
+                "from %s: %s", m_sock->getPeerName().c_str(),
+                err.what());
+        return false;
+    }
+
+    return true;
+}
+
+// Processes the request when it was completely received
+void ReactorConnection::processRequest()
+{
+    m_prefix.push_back(Connection::processRequest());
+    m_requests++;
+
+    if (isStreaming())
+    {
+        // the header should be the first data in the stream
+        InThreadPtr inthread = getInThread();
+        if (inthread)
+        {
+            const BinaryData header = inthread->getReader()->getHeader();
+            if (!header.empty())
+            {
+                m_prefix.push_back(makeChunk(header));
+            }
+        }
+        m_streaming.setValue(true);
+    }
+}
+
+// Sends queued data until the socket would block
+const bool ReactorConnection::write() throw()
+{
+    try
+    {
+        // Check hang up conditions
+        if (checkQueue() == QUEUE_HANGUP)
+        {
+            return false;
+        }
+
+        m_pending = false;
+        for(;;)
+        {
+            consumeData();
+            BinaryDataVector data;
+            makeData(data);
+            if (data.empty())
+            {
+                break;
+            }
+
+            // the response, the framing and several chunks
+            // are sent with one system call
+            const size_t sent = m_sock->sendvNonBlock(data, m_offset);
+            if (sent == 0)
+            {
+                // the socket is not ready
+                m_pending = true;
+                return true;
+            }
+            m_offset += sent;
+        }
+    }
+    catch(const std::exception& err)
+    {
+        klk_log(KLKLOG_DEBUG, "Connection to %s was broken: %s",
+                m_sock->getPeerName().c_str(), err.what());
+        return false;
+    }
+
+    if (m_response_type != RES_UNKNOWN && !isStreaming())
+    {
+        // HEAD, not found or error: the response was sent
+        return nextRequest();
+    }
+
+    return true;
+}
+
+// Prepares a persistent connection for the next request
+const bool ReactorConnection::nextRequest() throw()
+{
+    if (!isKeepAlive() || m_requests >= KEEPALIVE_MAX_REQUESTS)
+    {
+        return false;
+    }
+
+    m_response_type = RES_UNKNOWN;
+    m_start_time = time(NULL);
+    if (m_request.next() == Request::PARSE_MORE)
+    {
+        return true;
+    }
+
+    // the next request was pipelined
+    try
+    {
+        processRequest();
+    }
+    catch(const std::exception& err)
+    {
+        klk_log(KLKLOG_ERROR, "Error while processing HTTP request "
+                "from %s: %s", m_sock->getPeerName().c_str(),
+                err.what());
+        return false;
+    }
+
+    // the response will be sent at the next reactor iteration
+    m_reactor->notify(m_fd);
+    return true;
+}
+
+// Makes the data for the vectored send
+void ReactorConnection::makeData(BinaryDataVector& data)
+{
+    while (m_chunks.size() < SENDV_MAX_CHUNKS)
+    {
+        ChunkPtr chunk = nextChunk();
+        if (!chunk)
+        {
+            break;
+        }
+        m_chunks.push_back(chunk);
+    }
+
+    for (DataList::const_iterator i = m_prefix.begin();
+         i != m_prefix.end(); i++)
+    {
+        data.push_back(&(*i));
+    }
+    for (ChunkList::const_iterator i = m_chunks.begin();
+         i != m_chunks.end(); i++)
+    {
+        addChunk(*i, data);
+    }
+}
+
+// Removes the buffers that were completely sent
+void ReactorConnection::consumeData()
+{
+    while (!m_prefix.empty() && m_offset >= m_prefix.front().size())
+    {
+        m_offset -= m_prefix.front().size();
+        m_prefix.pop_front();
+    }
+    if (!m_prefix.empty())
+    {
+        return;
+    }
+
+    while (!m_chunks.empty())
+    {
+        const size_t size = getChunkSize(m_chunks.front());
+        if (m_offset < size)
+        {
+            break;
+        }
+        m_offset -= size;
+        m_chunks.pop_front();
+    }
+}
+
+// Checks timeouts for the connection
+const bool ReactorConnection::isExpired(time_t now) const throw()
+{
+    if (m_response_type == RES_UNKNOWN)
+    {
+        // waiting for the request
+        return (now - m_start_time > getWaitInterval());
+    }
+
+    if (m_streaming.getValue())
+    {
+        // waiting for the data
+        return (now - m_last_time.getValue() > getWaitInterval());
+    }
+
+    return false;
+}
+
+// Retrives the timeout for the connection state
+const time_t ReactorConnection::getWaitInterval() const throw()
+{
+    if (m_response_type == RES_UNKNOWN && m_requests)
+    {
+        return KEEPALIVE_WAITINTERVAL;
+    }
+    return WAITINTERVAL;
+}
+
+// Checks is the persistent connection idle
+const bool ReactorConnection::isIdle() const throw()
+{
+    return (m_response_type == RES_UNKNOWN && m_requests &&
+            m_request.empty());
+}
+
+// Marks the connection as closed
+void ReactorConnection::close() throw()
+{
+    m_closed.setValue(true);
+    m_reactor->notify(m_fd);
+}
+
+// Does final clearing for the connection
+void ReactorConnection::release() throw()
+{
+    m_closed.setValue(true);
+    Connection::release();
+}
+
+//
+// Reactor class
+//
+
+// Constructor
+Reactor::Reactor(Factory* factory, u_int cpu) :
+    Thread(factory), m_poll(-1), m_connections(), m_ready_lock(),
+    m_ready(), m_check_time(time(NULL)), m_cpu(cpu)
+{
+    m_wakeup[0] = m_wakeup[1] = -1;
+}
+
+// Destructor
+Reactor::~Reactor()
+{
+    closeAll();
+
+    if (m_poll >= 0)
+    {
+        ::close(m_poll);
+    }
+    for (size_t i = 0; i < 2; i++)
+    {
+        if (m_wakeup[i] >= 0)
+        {
+            ::close(m_wakeup[i]);
+        }
+    }
+}
+
+// Thread initialization and check
+void Reactor::init()
+{
+#ifdef LINUX
+    if (m_poll < 0)
+    {
+        m_poll = epoll_create(REACTOR_MAX_EVENTS);
+        if (m_poll < 0)
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Error %d in epoll_create(): %s",
+                            errno, strerror(errno));
+        }
+
+        if (pipe(m_wakeup) < 0)
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Error %d in pipe(): %s",
+                            errno, strerror(errno));
+        }
+        for (size_t i = 0; i < 2; i++)
+        {
+            fcntl(m_wakeup[i], F_SETFL,
+                  fcntl(m_wakeup[i], F_GETFL) | O_NONBLOCK);
+        }
+        control(EPOLL_CTL_ADD, m_wakeup[0], false);
+    }
+#else
+    throw Exception(__FILE__, __LINE__,
+                    "Reactor connection engine is not supported "
+                    "on the platform");
+#endif //LINUX
+
+    Thread::init();
+}
+
+// main thread body
+void Reactor::start()
+{
+    if (REACTOR_CPU_PINNING && TaskPool::pinThread(m_cpu) == OK)
+    {
+        klk_log(KLKLOG_DEBUG, "HTTP reactor was pinned to CPU %u", m_cpu);
+    }
+
+#ifdef LINUX
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    while (!isStopped())
+    {
+        int count = epoll_wait(m_poll, events, REACTOR_MAX_EVENTS,
+                               REACTOR_WAITINTERVAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            klk_log(KLKLOG_ERROR, "Error %d in epoll_wait(): %s",
+                    errno, strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].data.fd == m_wakeup[0])
+            {
+                drainWakeup();
+            }
+            else
+            {
+                processEvent(events[i].data.fd, events[i].events);
+            }
+        }
+
+        processReady();
+        checkTimeouts();
+    }
+#endif //LINUX
+
+    closeAll();
+}
+
+// Stops the thread
+void Reactor::stop() throw()
+{
+    Thread::stop();
+    if (m_wakeup[1] >= 0)
+    {
+        const char byte = 0;
+        ssize_t res = ::write(m_wakeup[1], &byte, sizeof(byte));
+        (void)res;
+    }
+}
+
+// Adds a new client connection
+void Reactor::addConnection(const ISocketPtr& sock)
+{
+    BOOST_ASSERT(sock);
+    ReactorConnectionPtr conn(new ReactorConnection(getFactory(), sock, this));
+
+    klk_log(KLKLOG_DEBUG, "Got a connection request");
+
+    {
+        Locker lock(&m_lock);
+        BOOST_ASSERT(m_connections.find(conn->getDescriptor()) ==
+                     m_connections.end());
+        m_connections[conn->getDescriptor()] = conn;
+    }
+
+    try
+    {
+        control(EPOLL_CTL_ADD, conn->getDescriptor(), false);
+    }
+    catch(...)
+    {
+        {
+            Locker lock(&m_lock);
+            m_connections.erase(conn->getDescriptor());
+        }
+        conn->release();
+        throw;
+    }
+}
+
+// Retrives connections count served by the reactor
+const size_t Reactor::getConnectionCount() const throw()
+{
+    Locker lock(&m_lock);
+    return m_connections.size();
+}
+
+// Notifies the reactor that a connection has something to do
+void Reactor::notify(int fd) throw()
+{
+    bool wakeup = false;
+    {
+        Locker lock(&m_ready_lock);
+        wakeup = m_ready.empty();
+        m_ready.insert(fd);
+    }
+
+    // the pipe is written only when the set becomes non empty
+    // thus there is only one wakeup per reactor loop iteration
+    if (wakeup && m_wakeup[1] >= 0)
+    {
+        const char byte = 0;
+        ssize_t res = ::write(m_wakeup[1], &byte, sizeof(byte));
+        (void)res;
+    }
+}
+
+// Retrives a connection by its descriptor
+const ReactorConnectionPtr Reactor::getConnection(int fd) const
+{
+    Locker lock(&m_lock);
+    ConnectionMap::const_iterator i = m_connections.find(fd);
+    if (i == m_connections.end())
+    {
+        return ReactorConnectionPtr();
+    }
+    return i->second;
+}
+
+// Processes an event for a connection
+void Reactor::processEvent(int fd, u_int events)
+{
+#ifdef LINUX
+    ReactorConnectionPtr conn = getConnection(fd);
+    if (!conn)
+    {
+        return;
+    }
+
+    if ((events & (EPOLLERR | EPOLLHUP)) ||
+        ((events & EPOLLIN) && !conn->read()))
+    {
+        closeConnection(conn);
+        return;
+    }
+
+    write(conn);
+#endif //LINUX
+}
+
+// Processes connections that have new data
+void Reactor::processReady()
+{
+    DescriptorSet ready;
+    {
+        Locker lock(&m_ready_lock);
+        ready.swap(m_ready);
+    }
+
+    for (DescriptorSet::iterator i = ready.begin(); i != ready.end(); i++)
+    {
+        if (ReactorConnectionPtr conn = getConnection(*i))
+        {
+            write(conn);
+        }
+    }
+}
+
+// Checks connections timeouts
+void Reactor::checkTimeouts()
+{
+    const time_t now = time(NULL);
+    if (now == m_check_time)
+    {
+        return;
+    }
+    m_check_time = now;
+
+    std::list<ReactorConnectionPtr> expired;
+    {
+        Locker lock(&m_lock);
+        for (ConnectionMap::iterator i = m_connections.begin();
+             i != m_connections.end(); i++)
+        {
+            if (i->second->isExpired(now))
+            {
+                expired.push_back(i->second);
+            }
+        }
+    }
+
+    for (std::list<ReactorConnectionPtr>::iterator i = expired.begin();
+         i != expired.end(); i++)
+    {
+        if ((*i)->isIdle())
+        {
+            // the client does not need the connection anymore
+            klk_log(KLKLOG_DEBUG, "Keep-alive connection was idle "
+                    "within %d seconds",
+                    static_cast<int>(KEEPALIVE_WAITINTERVAL));
+        }
+        else
+        {
+            klk_log(KLKLOG_ERROR, "No input data within %d seconds",
+                    static_cast<int>((*i)->getWaitInterval()));
+        }
+        closeConnection(*i);
+    }
+}
+
+// Sends queued data and updates events subscription
+void Reactor::write(const ReactorConnectionPtr& conn)
+{
+    if (conn->isClosed() || !conn->write())
+    {
+        closeConnection(conn);
+        return;
+    }
+
+    // subscribe for EPOLLOUT only while there is unsent data
+    const bool pending = conn->isPending();
+    if (pending != conn->isWriteWaiting())
+    {
+        try
+        {
+            control(EPOLL_CTL_MOD, conn->getDescriptor(), pending);
+            conn->setWriteWaiting(pending);
+        }
+        catch(const std::exception& err)
+        {
+            klk_log(KLKLOG_ERROR, "Reactor error: %s", err.what());
+            closeConnection(conn);
+        }
+    }
+}
+
+// Closes a connection and removes it from the registry
+void Reactor::closeConnection(const ReactorConnectionPtr& conn) throw()
+{
+#ifdef LINUX
+    // the descriptor should be removed from the poll before close
+    // because it can be reused by a new connection
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(m_poll, EPOLL_CTL_DEL, conn->getDescriptor(), &event);
+#endif //LINUX
+
+    {
+        Locker lock(&m_lock);
+        m_connections.erase(conn->getDescriptor());
+    }
+
+    conn->release();
+    klk_log(KLKLOG_DEBUG, "Finished connection");
+}
+
+// Closes all connections
+void Reactor::closeAll() throw()
+{
+    ConnectionMap connections;
+    {
+        Locker lock(&m_lock);
+        connections.swap(m_connections);
+    }
+
+    for (ConnectionMap::iterator i = connections.begin();
+         i != connections.end(); i++)
+    {
+        i->second->release();
+    }
+}
+
+// Drains the wakeup pipe
+void Reactor::drainWakeup() throw()
+{
+    char buffer[64];
+    while (::read(m_wakeup[0], buffer, sizeof(buffer)) > 0)
+    {
+        // nothing to do
+    }
+}
+
+// Does the control operation on the poll descriptor
+void Reactor::control(int op, int fd, bool write)
+{
+#ifdef LINUX
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | (write ? EPOLLOUT : 0);
+    event.data.fd = fd;
+    if (epoll_ctl(m_poll, op, fd, &event) < 0)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Error %d in epoll_ctl(): %s",
+                        errno, strerror(errno));
+    }
+#endif //LINUX
+}
@@ -0,0 +1,419 @@
+/**
+   @file reactor.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_REACTOR_H
+#define KLK_REACTOR_H
+
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+
+#include <boost/shared_ptr.hpp>
+
+#include "socket/socket.h"
+#include "routethread.h"
+#include "binarydata.h"
+#include "chunk.h"
+#include "connection.h"
+
+namespace klk
+{
+    namespace http
+    {
+        class Reactor;
+
+        /**
+           @brief Connection served by a reactor
+
+           The connection does not have its own thread. All socket
+           operations are done by the reactor thread when the socket
+           is ready for them. Input threads just put data to the
+           connection queue and notify the reactor
+
+           @ingroup grHTTP
+        */
+        class ReactorConnection : public Connection
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] factory - the factory
+               @param[in] sock - the socket
+               @param[in] reactor - the reactor that serves the connection
+            */
+            ReactorConnection(Factory* factory, const klk::ISocketPtr& sock,
+                              Reactor* reactor);
+
+            /**
+               Destructor
+            */
+            virtual ~ReactorConnection();
+
+            /// @copydoc klk::http::Connection::notifyData
+            virtual void notifyData(const std::string& path);
+
+            /**
+               Retrives the socket descriptor
+
+               @return the descriptor
+            */
+            const int getDescriptor() const throw(){return m_fd;}
+
+            /**
+               Reads data that is available at the socket
+
+               @return
+               - true - the connection is alive
+               - false - the connection should be closed
+            */
+            const bool read() throw();
+
+            /**
+               Sends queued data until the socket would block
+
+               @return
+               - true - the connection is alive
+               - false - the connection should be closed
+            */
+            const bool write() throw();
+
+            /**
+               Is there any data that waits for the socket
+
+               @return
+               - true
+               - false
+            */
+            const bool isPending() const throw(){return m_pending;}
+
+            /**
+               Checks timeouts for the connection
+
+               @param[in] now - the current time
+
+               @return
+               - true - the connection was expired
+               - false - the connection is alive
+            */
+            const bool isExpired(time_t now) const throw();
+
+            /**
+               Retrives the timeout that is used for the connection
+               at its current state
+
+               @return the timeout in seconds
+            */
+            const time_t getWaitInterval() const throw();
+
+            /**
+               Checks is the persistent connection waiting for the
+               next request without any received data
+
+               @return
+               - true
+               - false
+            */
+            const bool isIdle() const throw();
+
+            /**
+               Marks the connection as closed. The real close will be
+               done by the reactor
+
+               @note can be called from any thread
+            */
+            virtual void close() throw();
+
+            /**
+               Checks is the connection closed or not
+
+               @return
+               - true
+               - false
+            */
+            const bool isClosed() const throw(){return m_closed.getValue();}
+
+            /**
+               Does final clearing for the connection
+
+               @note should be called by the reactor thread only
+            */
+            void release() throw();
+
+            /**
+               Retrives the flag that shows EPOLLOUT registration
+
+               @return the flag value
+            */
+            const bool isWriteWaiting() const throw(){return m_write_waiting;}
+
+            /**
+               Sets the flag that shows EPOLLOUT registration
+
+               @param[in] value - the value to be set
+            */
+            void setWriteWaiting(bool value) throw(){m_write_waiting = value;}
+        private:
+            /**
+               List with data
+            */
+            typedef std::list<BinaryData> DataList;
+
+            /**
+               List with data chunks
+            */
+            typedef std::deque<ChunkPtr> ChunkList;
+
+            Reactor* m_reactor; ///< the reactor
+            const int m_fd; ///< the socket descriptor
+            time_t m_start_time; ///< the request wait start time
+            size_t m_requests; ///< served requests count
+            DataList m_prefix; ///< the response and the media header
+            ChunkList m_chunks; ///< the chunks that are being sent
+            size_t m_offset; ///< sent bytes count at the first buffer
+            bool m_pending; ///< the socket is not ready for the data
+            bool m_write_waiting; ///< EPOLLOUT was registered
+            SafeValue<bool> m_streaming; ///< GET request was accepted
+            SafeValue<bool> m_closed; ///< the connection was closed
+            SafeValue<time_t> m_last_time; ///< last data time
+
+            /**
+               Processes the request when it was completely received
+
+               @exception klk::Exception
+            */
+            void processRequest();
+
+            /**
+               Prepares a persistent connection for the next request
+               after the response was sent
+
+               @return
+               - true - the connection waits for the next request
+               - false - the connection should be closed
+            */
+            const bool nextRequest() throw();
+
+            /**
+               Makes the data for the vectored send: the prefix
+               and the queued chunks. New chunks are taken from
+               the input ring
+
+               @param[out] data - the data to be sent
+            */
+            void makeData(BinaryDataVector& data);
+
+            /**
+               Removes the buffers that were completely sent
+            */
+            void consumeData();
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            ReactorConnection(const ReactorConnection& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            ReactorConnection& operator=(const ReactorConnection& value);
+        };
+
+        /**
+           Smart pointer for reactor connection
+        */
+        typedef boost::shared_ptr<ReactorConnection> ReactorConnectionPtr;
+
+        /**
+           @brief Connections reactor
+
+           The reactor serves a set of client connections by means of
+           epoll. There is a small fixed pool of reactors (one per CPU
+           core) instead of a separate thread for each client. Each reactor
+           keeps its own connections registry.
+
+           @ingroup grHTTP
+        */
+        class Reactor : public Thread
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] factory - the factory
+               @param[in] cpu - the reactor CPU core
+               (see @ref klk::http::REACTOR_CPU_PINNING)
+            */
+            Reactor(Factory* factory, u_int cpu);
+
+            /**
+               Destructor
+            */
+            virtual ~Reactor();
+
+            /**
+               Adds a new client connection
+
+               @param[in] sock - the accepted client socket
+
+               @exception klk::Exception
+            */
+            void addConnection(const klk::ISocketPtr& sock);
+
+            /**
+               Retrives connections count served by the reactor
+
+               @return the count
+            */
+            const size_t getConnectionCount() const throw();
+
+            /**
+               Notifies the reactor that a connection has something to do
+
+               @param[in] fd - the connection descriptor
+            */
+            void notify(int fd) throw();
+        private:
+            /**
+               Connections registry
+            */
+            typedef std::map<int, ReactorConnectionPtr> ConnectionMap;
+
+            /**
+               Set with descriptors
+            */
+            typedef std::set<int> DescriptorSet;
+
+            int m_poll; ///< the epoll descriptor
+            int m_wakeup[2]; ///< wakeup pipe
+            ConnectionMap m_connections; ///< connections registry
+            mutable klk::Mutex m_ready_lock; ///< ready set locker
+            DescriptorSet m_ready; ///< connections that have data to be sent
+            time_t m_check_time; ///< last timeouts check time
+            const u_int m_cpu; ///< the reactor CPU core
+
+            /// @copydoc IThread::init()
+            virtual void init();
+
+            /// @copydoc IThread::start()
+            virtual void start();
+
+            /// @copydoc IThread::stop()
+            virtual void stop() throw();
+
+            /**
+               Retrives a connection by its descriptor
+
+               @param[in] fd - the descriptor
+
+               @return the connection or NULL if there is no such one
+            */
+            const ReactorConnectionPtr getConnection(int fd) const;
+
+            /**
+               Processes an event for a connection
+
+               @param[in] fd - the connection descriptor
+               @param[in] events - the events mask
+            */
+            void processEvent(int fd, u_int events);
+
+            /**
+               Processes connections that have new data
+            */
+            void processReady();
+
+            /**
+               Checks connections timeouts
+            */
+            void checkTimeouts();
+
+            /**
+               Sends queued data and updates events subscription
+
+               @param[in] conn - the connection
+            */
+            void write(const ReactorConnectionPtr& conn);
+
+            /**
+               Closes a connection and removes it from the registry
+
+               @param[in] conn - the connection to be closed
+            */
+            void closeConnection(const ReactorConnectionPtr& conn) throw();
+
+            /**
+               Closes all connections
+            */
+            void closeAll() throw();
+
+            /**
+               Drains the wakeup pipe
+            */
+            void drainWakeup() throw();
+
+            /**
+               Does the control operation on the poll descriptor
+
+               @param[in] op - the operation
+               @param[in] fd - the descriptor
+               @param[in] write - subscribe for write events or not
+
+               @exception klk::Exception
+            */
+            void control(int op, int fd, bool write);
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            Reactor(const Reactor& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            Reactor& operator=(const Reactor& value);
+        };
+
+        /**
+           Smart pointer for reactor
+        */
+        typedef boost::shared_ptr<Reactor> ReactorPtr;
+    }
+}
+
+#endif //KLK_REACTOR_H
@@ -76,6 +76,12 @@ const std::string Reader::getPeerName() const
     return m_sock->getPeerName();
 }
 
+// Does the last data portion start with a keyframe
+const bool Reader::isKeyFrame() const throw()
+{
+    return false;
+}
+
 // @see Socket::checkData
 const Result Reader::checkData()
 {
@@ -97,6 +103,13 @@ const u_long Reader::getBrokenCount() const
     return m_broken_count;
 }
 
+// Retrives the dropped data packets count
+const u_long Reader::getDroppedCount() const
+{
+    BOOST_ASSERT(m_sock);
+    return m_sock->getDroppedCount();
+}
+
 // Retrives rate
 const double Reader::getRate() const
 {
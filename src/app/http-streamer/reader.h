@@ -102,6 +102,16 @@ namespace klk
             */
             virtual void getData(BinaryData& data) = 0;
 
+            /**
+               Does the last data portion start with a keyframe
+
+               New connections start from the keyframe thus they do
+               not wait for the next one to display the picture
+
+               @return true if the last portion starts with a keyframe
+            */
+            virtual const bool isKeyFrame() const throw() = 0;
+
             /**
                Retrives peer name
 
@@ -128,6 +138,14 @@ namespace klk
             */
             virtual const u_long getBrokenCount() const = 0;
 
+            /**
+               Retrives the count of data packets that were dropped
+               before they were received (input buffer overflow)
+
+               @return the count
+            */
+            virtual const u_long getDroppedCount() const = 0;
+
             /**
                Retrives rate
 
@@ -170,6 +188,11 @@ namespace klk
                Increases broken package count
             */
             void increaseBrokenCount();
+
+            /**
+               @see klk::Socket::checkData
+            */
+            virtual const Result checkData();
         private:
             mutable Mutex m_broken_count_lock; ///< broken count lock
             u_long m_broken_count; ///< broken package count
@@ -190,9 +213,13 @@ namespace klk
             virtual const std::string getPeerName() const;
 
             /**
-               @see klk::Socket::checkData
+               Does the last data portion start with a keyframe
+
+               There is no keyframe info by default
+
+               @return false
             */
-            virtual const Result checkData();
+            virtual const bool isKeyFrame() const throw();
 
             /**
                Retrives broken packages count
@@ -201,6 +228,13 @@ namespace klk
             */
             virtual const u_long getBrokenCount() const;
 
+            /**
+               Retrives the dropped data packets count
+
+               @return the count
+            */
+            virtual const u_long getDroppedCount() const;
+
             /**
                Retrives rate
 
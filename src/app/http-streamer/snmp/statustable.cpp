@@ -65,7 +65,8 @@ typedef enum
     COLUMN_INPUTRATE = 4,
     COLUMN_OUTPUTRATE = 5,
     COLUMN_OUTPUTCONN = 6,
-    COLUMN_BROKENPACKAGES = 7
+    COLUMN_BROKENPACKAGES = 7,
+    COLUMN_DROPPEDPACKAGES = 8
 } Column;
 
 using namespace klk;
@@ -145,7 +146,7 @@ static void init_table(void)
         ASN_COUNTER,  /* index: klkIndex */
         0);
     table_info->min_column = COLUMN_INDEX;
-    table_info->max_column = COLUMN_BROKENPACKAGES;
+    table_info->max_column = COLUMN_DROPPEDPACKAGES;
 
     iinfo = SNMP_MALLOC_TYPEDEF(netsnmp_iterator_info);
     iinfo->get_first_data_point = table_get_first_data;
@@ -313,6 +314,7 @@ static int table_handler(
                 case COLUMN_INDEX:
                 case COLUMN_OUTPUTCONN:
                 case COLUMN_BROKENPACKAGES:
+                case COLUMN_DROPPEDPACKAGES:
                     snmp_set_var_typed_integer(request->requestvb, ASN_COUNTER,
                                                val.toInt());
 
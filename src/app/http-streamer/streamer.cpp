@@ -38,7 +38,6 @@
 #include "config.h"
 #endif
 
-#include <boost/lexical_cast.hpp>
 #include <boost/bind.hpp>
 
 
@@ -391,15 +390,7 @@ const RouteInfoPtr Streamer::getRouteInfoByUUID(const std::string& uuid)
         type = sock::MULTICAST;
     }
 
-    u_int port = 0;
-    try
-    {
-        port = boost::lexical_cast<u_int>(res->getValue(msg::key::NETPORT));
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw Exception(__FILE__, __LINE__, err::BADLEXCAST);
-    }
+    const u_int port = static_cast<u_int>(res->getInteger(msg::key::NETPORT));
 
     sock::Protocol proto = sock::TCPIP;
     if (res->getValue(msg::key::NETPROTO) == net::UDP)
@@ -479,6 +470,7 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
         // klkOutputRate        Integer32,
         // klkOutputConn        Counter32,
         // klkBrokenPackages    Counter32
+        // klkDroppedPackages   Counter32
 
         snmp::TableRow row;
         row.push_back(count);
@@ -494,6 +486,7 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
             row.push_back(o_rate);
             row.push_back(inthread->getConnectionCount());
             row.push_back(inthread->getReader()->getBrokenCount());
+            row.push_back(inthread->getReader()->getDroppedCount());
         }
         catch(const std::exception&)
         {
@@ -505,6 +498,7 @@ const snmp::IDataPtr Streamer::processSNMP(const snmp::IDataPtr& req)
             row.push_back(0);
             row.push_back(0);
             row.push_back(0);
+            row.push_back(0);
         }
         table->addRow(row);
     }
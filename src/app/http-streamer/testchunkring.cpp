@@ -0,0 +1,181 @@
+/**
+   @file testchunkring.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "testchunkring.h"
+#include "testutils.h"
+#include "chunk.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Creates a test chunk
+    const ChunkPtr makeChunk(size_t size, char value, bool keyframe = false)
+    {
+        BinaryData data(std::string(size, value));
+        return ChunkPtr(new Chunk(data, keyframe));
+    }
+}
+
+//
+// TestChunkRing class
+//
+
+// Constructor
+TestChunkRing::TestChunkRing()
+{
+}
+
+// The chunk test
+void TestChunkRing::testChunk()
+{
+    test::printOut("\nHTTP data chunk test ... ");
+
+    BinaryData data(std::string("0123456789"));
+    Chunk chunk(data);
+    // the data was moved into the chunk
+    CPPUNIT_ASSERT(data.empty() == true);
+    CPPUNIT_ASSERT(chunk.size() == 10);
+    CPPUNIT_ASSERT(chunk.getData().toString() == "0123456789");
+    CPPUNIT_ASSERT(chunk.getHead().toString() == "a\r\n");
+    CPPUNIT_ASSERT(chunk.getTail().toString() == "\r\n");
+}
+
+// The ring test
+void TestChunkRing::testRing()
+{
+    test::printOut("\nHTTP data ring test ... ");
+
+    ChunkRing ring(100);
+    CPPUNIT_ASSERT(ring.getEnd() == 0);
+    CPPUNIT_ASSERT(ring.size() == 0);
+
+    // two readers share the same chunk
+    u_int64_t cursor1 = ring.getEnd(), cursor2 = ring.getEnd();
+    ring.push(makeChunk(40, 'a'));
+    CPPUNIT_ASSERT(ring.getEnd() == 1);
+    CPPUNIT_ASSERT(ring.getLag(cursor1) == 40);
+    ChunkPtr chunk1 = ring.get(cursor1);
+    ChunkPtr chunk2 = ring.get(cursor2);
+    CPPUNIT_ASSERT(chunk1);
+    CPPUNIT_ASSERT(chunk1.get() == chunk2.get());
+    cursor1++;
+    CPPUNIT_ASSERT(ring.getLag(cursor1) == 0);
+    CPPUNIT_ASSERT(!ring.get(cursor1));
+    CPPUNIT_ASSERT(cursor1 == 1);
+
+    // the size limit
+    ring.push(makeChunk(40, 'b'));
+    CPPUNIT_ASSERT(ring.size() == 80);
+    CPPUNIT_ASSERT(ring.getLag(cursor2) == 80);
+    ring.push(makeChunk(40, 'c'));
+    CPPUNIT_ASSERT(ring.size() == 80);
+    CPPUNIT_ASSERT(ring.getEnd() == 3);
+
+    // the slow reader lost the first chunk
+    CPPUNIT_ASSERT(cursor2 == 0);
+    chunk2 = ring.get(cursor2);
+    CPPUNIT_ASSERT(cursor2 == 1);
+    CPPUNIT_ASSERT(chunk2);
+    CPPUNIT_ASSERT(chunk2->getData().toString() == std::string(40, 'b'));
+
+    // the chunk is alive while somebody uses it
+    CPPUNIT_ASSERT(chunk1->getData().toString() == std::string(40, 'a'));
+
+    // the last chunk is always kept
+    ring.push(makeChunk(200, 'd'));
+    CPPUNIT_ASSERT(ring.size() == 200);
+    CPPUNIT_ASSERT(ring.getEnd() == 4);
+    u_int64_t cursor3 = 0;
+    ChunkPtr chunk3 = ring.get(cursor3);
+    CPPUNIT_ASSERT(cursor3 == 3);
+    CPPUNIT_ASSERT(chunk3 && chunk3->size() == 200);
+
+    // skip data for a slow reader
+    ChunkRing ring2(1000);
+    for (size_t i = 0; i < 10; i++)
+    {
+        BinaryData data(std::string(10, 'e'));
+        ring2.push(ChunkPtr(new Chunk(data, i == 2 || i == 7)));
+    }
+    CPPUNIT_ASSERT(ring2.skip(0, 100, false) == 0);
+    CPPUNIT_ASSERT(ring2.skip(0, 45, false) == 6);
+    CPPUNIT_ASSERT(ring2.skip(0, 45, true) == 7);
+    CPPUNIT_ASSERT(ring2.skip(0, 25, true) == 8);
+    CPPUNIT_ASSERT(ring2.skip(9, 0, false) == 10);
+}
+
+// The GOP cache test
+void TestChunkRing::testKeyFrame()
+{
+    test::printOut("\nHTTP GOP cache test ... ");
+
+    ChunkRing ring(100);
+    // no keyframes: a new reader starts from the ring end
+    ring.push(makeChunk(10, 'a'));
+    CPPUNIT_ASSERT(ring.getKeyFrame() == ring.getEnd());
+
+    // a new reader gets the whole GOP
+    ring.push(makeChunk(10, 'b', true));
+    ring.push(makeChunk(10, 'c'));
+    CPPUNIT_ASSERT(ring.getKeyFrame() == 1);
+    u_int64_t cursor = ring.getKeyFrame();
+    ChunkPtr chunk = ring.get(cursor);
+    CPPUNIT_ASSERT(chunk && chunk->isKeyFrame());
+    CPPUNIT_ASSERT(ring.getLag(cursor) == 20);
+
+    // the latest keyframe is used
+    ring.push(makeChunk(10, 'd', true));
+    CPPUNIT_ASSERT(ring.getKeyFrame() == 3);
+
+    // the keyframe was dropped
+    ring.push(makeChunk(95, 'e'));
+    CPPUNIT_ASSERT(ring.getEnd() == 5);
+    CPPUNIT_ASSERT(ring.getKeyFrame() == 5);
+
+    // reset keeps the sequence numbers
+    ring.push(makeChunk(10, 'f', true));
+    CPPUNIT_ASSERT(ring.getKeyFrame() == 5);
+    ring.reset();
+    CPPUNIT_ASSERT(ring.size() == 0);
+    CPPUNIT_ASSERT(ring.getEnd() == 6);
+    CPPUNIT_ASSERT(ring.getKeyFrame() == 6);
+    cursor = 5;
+    CPPUNIT_ASSERT(!ring.get(cursor));
+    CPPUNIT_ASSERT(cursor == 6);
+}
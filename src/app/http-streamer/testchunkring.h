@@ -0,0 +1,84 @@
+/**
+   @file testchunkring.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TESTCHUNKRING_H
+#define KLK_TESTCHUNKRING_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief The data ring unit test
+
+           The test checks klk::http::Chunk and klk::http::ChunkRing:
+           the chunks sharing, the ring limits, the read cursors
+           and the GOP cache
+
+           @ingroup grTestHTTP
+        */
+        class TestChunkRing : public CppUnit::TestFixture
+        {
+            CPPUNIT_TEST_SUITE(TestChunkRing);
+            CPPUNIT_TEST(testChunk);
+            CPPUNIT_TEST(testRing);
+            CPPUNIT_TEST(testKeyFrame);
+            CPPUNIT_TEST_SUITE_END();
+        public:
+            /// Constructor
+            TestChunkRing();
+
+            /// Destructor
+            virtual ~TestChunkRing(){}
+
+            /// The chunk test
+            void testChunk();
+
+            /// The ring test
+            void testRing();
+
+            /// The GOP cache test
+            void testKeyFrame();
+        private:
+            /// Fake copy constructor
+            TestChunkRing(const TestChunkRing&);
+
+            /// Fake assigment operator
+            TestChunkRing& operator=(const TestChunkRing&);
+        };
+    }
+}
+
+#endif //KLK_TESTCHUNKRING_H
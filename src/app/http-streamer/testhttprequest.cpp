@@ -0,0 +1,332 @@
+/**
+   @file testhttprequest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "testhttprequest.h"
+#include "testutils.h"
+#include "httprequest.h"
+#include "utils.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Requests count for the benchmark
+    const size_t REQCOUNT = 100000;
+
+    /// A typical request from a media player
+    const std::string PLAYER_REQUEST =
+        "GET /stream/channel1.ts?token=12345 HTTP/1.1\r\n"
+        "Host: streamer.example.com:8000\r\n"
+        "User-Agent: VLC/2.0.8 LibVLC/2.0.8\r\n"
+        "Range: bytes=0-\r\n"
+        "Connection: close\r\n"
+        "Icy-MetaData: 1\r\n"
+        "X-Forwarded-For: 192.168.1.15\r\n"
+        "\r\n";
+
+    /// Parses a request that is added at once
+    Request::Status parse(Request& request, const std::string& data)
+    {
+        request.reset();
+        return request.add(data.c_str(), data.size());
+    }
+}
+
+//
+// TestHTTPRequest class
+//
+
+// Constructor
+TestHTTPRequest::TestHTTPRequest()
+{
+}
+
+// The parsing test
+void TestHTTPRequest::testParser()
+{
+    test::printOut("\nHTTP request parser test ... ");
+
+    Request request;
+
+    // the request at once
+    CPPUNIT_ASSERT(parse(request, PLAYER_REQUEST) == Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getMethod() == Request::METHOD_GET);
+    CPPUNIT_ASSERT(request.getVersion() == Request::VERSION_11);
+    CPPUNIT_ASSERT(request.getPath() == "/stream/channel1.ts");
+    CPPUNIT_ASSERT(request.getHost() == "streamer.example.com:8000");
+    CPPUNIT_ASSERT(request.getUserAgent() == "VLC/2.0.8 LibVLC/2.0.8");
+    CPPUNIT_ASSERT(request.getForwardedFor() == "192.168.1.15");
+
+    // byte by byte
+    request.reset();
+    for (size_t i = 0; i < PLAYER_REQUEST.size() - 1; i++)
+    {
+        CPPUNIT_ASSERT(request.add(PLAYER_REQUEST.c_str() + i, 1) ==
+                       Request::PARSE_MORE);
+    }
+    CPPUNIT_ASSERT(request.add(PLAYER_REQUEST.c_str() +
+                               PLAYER_REQUEST.size() - 1, 1) ==
+                   Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getPath() == "/stream/channel1.ts");
+    CPPUNIT_ASSERT(request.getUserAgent() == "VLC/2.0.8 LibVLC/2.0.8");
+
+    // the data is received directly to the parser buffer
+    request.reset();
+    size_t size = 0;
+    char* space = request.getSpace(size);
+    CPPUNIT_ASSERT(size >= PLAYER_REQUEST.size());
+    memcpy(space, PLAYER_REQUEST.c_str(), PLAYER_REQUEST.size());
+    CPPUNIT_ASSERT(request.commit(PLAYER_REQUEST.size()) ==
+                   Request::PARSE_DONE);
+
+    // bare LF, leading empty lines and header without spaces
+    CPPUNIT_ASSERT(parse(request, "\r\nHEAD /path HTTP/1.0\n"
+                         "user-agent:wget  \n\n") == Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getMethod() == Request::METHOD_HEAD);
+    CPPUNIT_ASSERT(request.getVersion() == Request::VERSION_10);
+    CPPUNIT_ASSERT(request.getPath() == "/path");
+    CPPUNIT_ASSERT(request.getUserAgent() == "wget");
+    CPPUNIT_ASSERT(request.getHost().empty() == true);
+
+    // pipelined requests
+    CPPUNIT_ASSERT(parse(request, "HEAD /a HTTP/1.1\r\n\r\n"
+                         "HEAD /b HTTP/1.1\r\n\r\n"
+                         "GET /c HTTP/1.1\r\n") == Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getPath() == "/a");
+    CPPUNIT_ASSERT(request.next() == Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getPath() == "/b");
+    CPPUNIT_ASSERT(request.next() == Request::PARSE_MORE);
+    CPPUNIT_ASSERT(request.add("\r\n", 2) == Request::PARSE_DONE);
+    CPPUNIT_ASSERT(request.getPath() == "/c");
+    CPPUNIT_ASSERT(request.getMethod() == Request::METHOD_GET);
+    CPPUNIT_ASSERT(request.next() == Request::PARSE_MORE);
+    CPPUNIT_ASSERT(request.empty() == true);
+}
+
+// The incorrect requests test
+void TestHTTPRequest::testErrors()
+{
+    test::printOut("\nHTTP request parser errors test ... ");
+
+    Request request;
+
+    CPPUNIT_ASSERT(parse(request, "POST / HTTP/1.1\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 405);
+
+    CPPUNIT_ASSERT(parse(request, "GET / HTTP/2.0\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 505);
+
+    CPPUNIT_ASSERT(parse(request, "GET / FTP/1.0\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 400);
+
+    // HTTP/0.9
+    CPPUNIT_ASSERT(parse(request, "GET /\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 400);
+
+    CPPUNIT_ASSERT(parse(request, "GET path HTTP/1.1\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 400);
+
+    CPPUNIT_ASSERT(parse(request, "GET / HTTP/1.1\r\nHost\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 400);
+
+    // folded header
+    CPPUNIT_ASSERT(parse(request, "GET / HTTP/1.1\r\nHost: a\r\n b\r\n\r\n") ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 400);
+
+    // too long path
+    const std::string path(REQUEST_MAX_SIZE, 'a');
+    CPPUNIT_ASSERT(parse(request, "GET /" + path) == Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 414);
+
+    // too many headers
+    std::string headers = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i <= REQUEST_MAX_HEADERS; i++)
+    {
+        headers += "X-Test: 1\r\n";
+    }
+    CPPUNIT_ASSERT(parse(request, headers + "\r\n") == Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 431);
+
+    // too long header
+    const std::string value(REQUEST_MAX_SIZE, 'a');
+    CPPUNIT_ASSERT(parse(request, "GET / HTTP/1.1\r\nX-Test: " + value) ==
+                   Request::PARSE_ERROR);
+    CPPUNIT_ASSERT(request.getError() == 431);
+
+    // the parser can be used after an error
+    CPPUNIT_ASSERT(request.next() == Request::PARSE_MORE);
+    CPPUNIT_ASSERT(request.add("GET / HTTP/1.1\r\n\r\n", 18) ==
+                   Request::PARSE_DONE);
+}
+
+// Keep-alive and Range headers test
+void TestHTTPRequest::testHeaders()
+{
+    test::printOut("\nHTTP request parser headers test ... ");
+
+    Request request;
+
+    // persistent connections
+    parse(request, "HEAD / HTTP/1.1\r\n\r\n");
+    CPPUNIT_ASSERT(request.isKeepAlive() == true);
+    parse(request, "HEAD / HTTP/1.1\r\nConnection: Close\r\n\r\n");
+    CPPUNIT_ASSERT(request.isKeepAlive() == false);
+    parse(request, "HEAD / HTTP/1.0\r\n\r\n");
+    CPPUNIT_ASSERT(request.isKeepAlive() == false);
+    parse(request, "HEAD / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n");
+    CPPUNIT_ASSERT(request.isKeepAlive() == true);
+
+    // Range
+    u_int64_t first = 0, last = 0;
+    parse(request, "GET / HTTP/1.1\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_NONE);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: bytes=100-\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_OPEN);
+    CPPUNIT_ASSERT(first == 100);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: bytes=100-199\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_CLOSED);
+    CPPUNIT_ASSERT(first == 100);
+    CPPUNIT_ASSERT(last == 199);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: bytes=-500\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_CLOSED);
+    CPPUNIT_ASSERT(first == 500);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: bytes=5-1\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_INVALID);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: bytes=0-1,5-6\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_INVALID);
+
+    parse(request, "GET / HTTP/1.1\r\nRange: items=0-\r\n\r\n");
+    CPPUNIT_ASSERT(request.getRange(first, last) == Request::RANGE_INVALID);
+}
+
+// The parsing benchmark
+void TestHTTPRequest::testBenchmark()
+{
+    test::printOut("\nHTTP request parser benchmark ... ");
+
+    const double parser = measureParser();
+    const double split = measureSplit();
+    char msg[128];
+    snprintf(msg, sizeof(msg), "\n\tparser: %.0f req/sec"
+             "\n\tsplit: %.0f req/sec", parser, split);
+    test::printOut(msg);
+
+    // the check is very rough to avoid false failures on loaded hosts
+    CPPUNIT_ASSERT(parser * 2 > split);
+}
+
+// Measures the parser throughput
+double TestHTTPRequest::measureParser()
+{
+    // the request comes by 3 parts
+    const size_t part = PLAYER_REQUEST.size() / 3;
+    const char* data = PLAYER_REQUEST.c_str();
+    Request request;
+    size_t count = 0;
+    const double start = test::getTime();
+    for (size_t i = 0; i < REQCOUNT; i++)
+    {
+        request.reset();
+        request.add(data, part);
+        request.add(data + part, part);
+        request.add(data + 2 * part, PLAYER_REQUEST.size() - 2 * part);
+        if (request.getStatus() == Request::PARSE_DONE &&
+            request.getMethod() == Request::METHOD_GET &&
+            request.getPath().size() > 1)
+        {
+            count++;
+        }
+    }
+    const double duration = test::getTime() - start;
+
+    CPPUNIT_ASSERT(count == REQCOUNT);
+    return (duration > 0) ? REQCOUNT / duration : REQCOUNT;
+}
+
+// Measures the split based parsing throughput
+double TestHTTPRequest::measureSplit()
+{
+    const size_t part = PLAYER_REQUEST.size() / 3;
+    size_t count = 0;
+    const double start = test::getTime();
+    for (size_t i = 0; i < REQCOUNT; i++)
+    {
+        // the same way as it was done at the connection thread
+        std::string request;
+        for (size_t pos = 0; pos < PLAYER_REQUEST.size(); pos += part)
+        {
+            request += PLAYER_REQUEST.substr(pos, part);
+            if (request.find("\r\n\r\n") != std::string::npos ||
+                request.find("\n\n") != std::string::npos)
+            {
+                break;
+            }
+        }
+
+        std::vector<std::string> lines =
+            base::Utils::split(request, "\r\n");
+        std::vector<std::string> vec = base::Utils::split(lines[0], "\t ");
+        if (vec.size() == 3 && vec[0] == "GET" && vec[1].size() > 1)
+        {
+            count++;
+        }
+    }
+    const double duration = test::getTime() - start;
+
+    CPPUNIT_ASSERT(count == REQCOUNT);
+    return (duration > 0) ? REQCOUNT / duration : REQCOUNT;
+}
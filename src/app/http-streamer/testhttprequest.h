@@ -0,0 +1,104 @@
+/**
+   @file testhttprequest.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_TESTHTTPREQUEST_H
+#define KLK_TESTHTTPREQUEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief HTTP request parser test
+
+           The test checks klk::http::Request: the partial data, the
+           pipelined requests, error codes, persistent connections and
+           the Range header. There is also a benchmark that compares
+           the parser with the split based parsing that was used before
+
+           @ingroup grTestHTTP
+        */
+        class TestHTTPRequest : public CppUnit::TestFixture
+        {
+            CPPUNIT_TEST_SUITE(TestHTTPRequest);
+            CPPUNIT_TEST(testParser);
+            CPPUNIT_TEST(testErrors);
+            CPPUNIT_TEST(testHeaders);
+            CPPUNIT_TEST(testBenchmark);
+            CPPUNIT_TEST_SUITE_END();
+        public:
+            /// Constructor
+            TestHTTPRequest();
+
+            /// Destructor
+            virtual ~TestHTTPRequest(){}
+
+            /// The parsing test
+            void testParser();
+
+            /// The incorrect requests test
+            void testErrors();
+
+            /// Keep-alive and Range headers test
+            void testHeaders();
+
+            /// The parsing benchmark
+            void testBenchmark();
+        private:
+            /**
+               Measures the parser throughput
+
+               @return parsed requests per second
+            */
+            double measureParser();
+
+            /**
+               Measures the split based parsing throughput
+
+               @return parsed requests per second
+            */
+            double measureSplit();
+        private:
+            /// Fake copy constructor
+            TestHTTPRequest(const TestHTTPRequest&);
+
+            /// Fake assigment operator
+            TestHTTPRequest& operator=(const TestHTTPRequest&);
+        };
+    }
+}
+
+#endif //KLK_TESTHTTPREQUEST_H
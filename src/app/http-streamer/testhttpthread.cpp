@@ -42,6 +42,7 @@
 
 #include "testhttpthread.h"
 #include "exception.h"
+#include "socket/exception.h"
 #include "testdefines.h"
 #include "testutils.h"
 
@@ -95,6 +96,8 @@ void TestConsumerThread::mainLoop()
         testHead(TESTPATH2);
         testGet(TESTPATH2);
         testNotFound();
+        testKeepAlive(TESTPATH1);
+        testRange(TESTPATH1);
     }
 }
 
@@ -292,3 +295,108 @@ void TestConsumerThread::testNotFound()
     }
 
 }
+
+// Test persistent connection
+// HEAD /path HTTP/1.1
+// User-Agent: klktest
+//
+// HEAD /blabla HTTP/1.1
+// Connection: close
+//
+// HTTP/1.1 200 OK
+// ...
+// Connection: keep-alive
+//
+// HTTP/1.1 404 Not Found
+// ...
+// Connection: close
+// Connection closed by foreign host.
+void TestConsumerThread::testKeepAlive(const std::string& path)
+{
+    if (isStopped())
+        return;
+
+    ISocketPtr sock = sock::Factory::getSocket(sock::TCPIP);
+
+    sock::RouteInfo
+        route(TESTSERVERHOST, TESTSERVERPORT, sock::TCPIP, sock::UNICAST);
+    sock->connect(route);
+    // both requests are sent at once
+    BinaryData req("HEAD " + path + " HTTP/1.1\r\n"
+                   "User-Agent: klktest\r\n\r\n"
+                   "HEAD /blabla HTTP/1.1\r\n"
+                   "Connection: close\r\n\r\n");
+    sock->send(req);
+
+    // read until the connection is closed by the server
+    std::string response;
+    try
+    {
+        for (;;)
+        {
+            Result rc = sock->checkData(2);
+            BOOST_ASSERT(rc == OK);
+            BinaryData tmp(SOCKBUFFSIZE);
+            sock->recv(tmp);
+            response += tmp.toString();
+        }
+    }
+    catch(const ClosedConnection&)
+    {
+        // the server closes the connection after the last response
+    }
+
+    const size_t ok = response.find("HTTP/1.1 200 OK");
+    const size_t notfound = response.find("HTTP/1.1 404 Not Found");
+    BOOST_ASSERT(ok != std::string::npos);
+    BOOST_ASSERT(notfound != std::string::npos);
+    BOOST_ASSERT(ok < notfound);
+    BOOST_ASSERT(response.find("Connection: keep-alive") < notfound);
+    BOOST_ASSERT(response.find("Connection: close") > notfound);
+}
+
+// Test range probe: the range is ignored for a live stream
+// HEAD /path HTTP/1.1
+// Range: bytes=0-1
+// Connection: close
+//
+// HTTP/1.1 200 OK
+// ...
+// Connection: close
+// Connection closed by foreign host.
+void TestConsumerThread::testRange(const std::string& path)
+{
+    if (isStopped())
+        return;
+
+    ISocketPtr sock = sock::Factory::getSocket(sock::TCPIP);
+
+    sock::RouteInfo
+        route(TESTSERVERHOST, TESTSERVERPORT, sock::TCPIP, sock::UNICAST);
+    sock->connect(route);
+    BinaryData req("HEAD " + path + " HTTP/1.1\r\n"
+                   "Range: bytes=0-1\r\n"
+                   "Connection: close\r\n\r\n");
+    sock->send(req);
+
+    // read until the connection is closed by the server
+    std::string response;
+    try
+    {
+        for (;;)
+        {
+            Result rc = sock->checkData(2);
+            BOOST_ASSERT(rc == OK);
+            BinaryData tmp(SOCKBUFFSIZE);
+            sock->recv(tmp);
+            response += tmp.toString();
+        }
+    }
+    catch(const ClosedConnection&)
+    {
+        // the server closes the connection after the response
+    }
+
+    BOOST_ASSERT(response.find("HTTP/1.1 200 OK") != std::string::npos);
+    BOOST_ASSERT(response.find("Accept-Ranges") == std::string::npos);
+}
@@ -127,6 +127,26 @@ namespace klk
                @exception klk::Exception - there was an error
             */
             void testNotFound();
+
+            /**
+               Test persistent connection: pipelined HEAD requests
+               are served by the same connection
+
+               @param[in] path - the path on the http streamer
+
+               @exception klk::Exception - there was an error
+            */
+            void testKeepAlive(const std::string& path);
+
+            /**
+               Test range probe: a live stream ignores the Range header
+               and answers 200
+
+               @param[in] path - the path on the http streamer
+
+               @exception klk::Exception - there was an error
+            */
+            void testRange(const std::string& path);
         private:
             /**
                Copy constructor
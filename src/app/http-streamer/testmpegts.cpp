@@ -0,0 +1,186 @@
+/**
+   @file testmpegts.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <fstream>
+#include <vector>
+
+#include "testmpegts.h"
+#include "testutils.h"
+#include "testsocket.h"
+#include "mpegtsreader.h"
+#include "utils.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Test file name
+    const std::string TESTMPEGTSFILE = "/tmp/klktestmpegts.ts";
+
+    /// Packet size
+    const size_t PACKET_SIZE = 188;
+
+    /// Test stream PID
+    const u_int TESTPID = 0x100;
+
+    /// Test audio PID (random access indicator without PCR)
+    const u_int AUDIOPID = 0x101;
+
+    /// Writes a test packet
+    void writePacket(std::ofstream& file, u_int pid, u_int cc,
+                     bool has_pcr, u_int64_t pcr, bool keyframe)
+    {
+        u_char packet[PACKET_SIZE];
+        memset(packet, 0xFF, sizeof(packet));
+        packet[0] = 0x47;
+        packet[1] = (pid >> 8) & 0x1F;
+        packet[2] = pid & 0xFF;
+        packet[3] = 0x10 | (cc & 0x0F);
+        if (has_pcr || keyframe)
+        {
+            // adaptation field with PCR and random access indicator
+            packet[3] |= 0x20;
+            packet[4] = 7;
+            packet[5] = (has_pcr ? 0x10 : 0) | (keyframe ? 0x40 : 0);
+            packet[6] = (pcr >> 25) & 0xFF;
+            packet[7] = (pcr >> 17) & 0xFF;
+            packet[8] = (pcr >> 9) & 0xFF;
+            packet[9] = (pcr >> 1) & 0xFF;
+            packet[10] = ((pcr & 0x01) << 7) | 0x7E;
+            packet[11] = 0;
+        }
+        file.write(reinterpret_cast<const char*>(packet), sizeof(packet));
+    }
+}
+
+//
+// TestMPEGTS class
+//
+
+// Constructor
+TestMPEGTS::TestMPEGTS()
+{
+}
+
+// Setups data for the test
+// There are 100 packets with PCR at each 10th one (20 ms step)
+// and keyframes at 0 and 50. A null packet follows each 5th packet.
+// An audio packet with random access indicator follows the packet 25.
+// There are 3 garbage bytes after the packet 30 and the packet 70
+// is lost
+void TestMPEGTS::setUp()
+{
+    base::Utils::unlink(TESTMPEGTSFILE);
+    std::ofstream file(TESTMPEGTSFILE.c_str(),
+                       std::ofstream::out|std::ofstream::binary);
+    CPPUNIT_ASSERT(file.good());
+    for (u_int i = 0; i < 100; i++)
+    {
+        if (i != 70)
+        {
+            writePacket(file, TESTPID, i, i % 10 == 0,
+                        (i / 10) * 1800, i == 0 || i == 50);
+        }
+        if (i % 5 == 4)
+        {
+            writePacket(file, 0x1FFF, 0, false, 0, false);
+        }
+        if (i == 25)
+        {
+            writePacket(file, AUDIOPID, 0, false, 0, true);
+        }
+        if (i == 30)
+        {
+            file.write("\0\0\0", 3);
+        }
+    }
+    file.close();
+}
+
+// Clears utest data
+void TestMPEGTS::tearDown()
+{
+    base::Utils::unlink(TESTMPEGTSFILE);
+}
+
+// Do the test
+void TestMPEGTS::testReader()
+{
+    test::printOut("\nHTTP Streamer MPEG-TS reader test ... ");
+
+    IReaderPtr reader =
+        MPEGTSReader::make(ISocketPtr(new TestSocket(TESTMPEGTSFILE)));
+    std::vector<size_t> sizes;
+    std::vector<bool> keyframes;
+    for (;;)
+    {
+        BinaryData data;
+        reader->getData(data);
+        if (data.empty())
+        {
+            break;
+        }
+
+        CPPUNIT_ASSERT(data.size() % PACKET_SIZE == 0);
+        const u_char* packets = static_cast<const u_char*>(data.toVoid());
+        for (size_t i = 0; i < data.size(); i += PACKET_SIZE)
+        {
+            // there are not null packets
+            CPPUNIT_ASSERT(packets[i] == 0x47);
+            CPPUNIT_ASSERT(packets[i + 1] == ((TESTPID >> 8) & 0x1F));
+            CPPUNIT_ASSERT(packets[i + 2] == (TESTPID & 0xFF) ||
+                           packets[i + 2] == (AUDIOPID & 0xFF));
+        }
+        sizes.push_back(data.size() / PACKET_SIZE);
+        keyframes.push_back(reader->isKeyFrame());
+    }
+
+    // the sync loss and the lost packet
+    CPPUNIT_ASSERT(reader->getBrokenCount() == 2);
+
+    // 40 ms PCR chunks, the keyframe starts a new one
+    // but the audio random access indicator does not
+    CPPUNIT_ASSERT(sizes.size() == 5);
+    CPPUNIT_ASSERT(sizes[0] == 20 && keyframes[0] == true);
+    CPPUNIT_ASSERT(sizes[1] == 21 && keyframes[1] == false);
+    CPPUNIT_ASSERT(sizes[2] == 10 && keyframes[2] == false);
+    CPPUNIT_ASSERT(sizes[3] == 29 && keyframes[3] == true);
+    CPPUNIT_ASSERT(sizes[4] == 20 && keyframes[4] == false);
+}
@@ -0,0 +1,81 @@
+/**
+   @file testmpegts.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TESTMPEGTS_H
+#define KLK_TESTMPEGTS_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief MPEG-TS reader test
+
+           The test checks the sync recovery, the continuity counter
+           errors, the null packets filtering and the PCR based chunks
+
+           @ingroup grTestHTTP
+        */
+        class TestMPEGTS : public CppUnit::TestFixture
+        {
+            CPPUNIT_TEST_SUITE(TestMPEGTS);
+            CPPUNIT_TEST(testReader);
+            CPPUNIT_TEST_SUITE_END();
+        public:
+            /// Constructor
+            TestMPEGTS();
+
+            /// Destructor
+            virtual ~TestMPEGTS(){}
+
+            /// Setups data for the test
+            virtual void setUp();
+
+            /// Clears utest data
+            virtual void tearDown();
+
+            /// Do the test
+            void testReader();
+        private:
+            /// Fake copy constructor
+            TestMPEGTS(const TestMPEGTS&);
+
+            /// Fake assigment operator
+            TestMPEGTS& operator=(const TestMPEGTS&);
+        };
+    }
+}
+
+#endif //KLK_TESTMPEGTS_H
@@ -0,0 +1,201 @@
+/**
+   @file testresponsecache.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include <sstream>
+
+#include "testresponsecache.h"
+#include "testutils.h"
+#include "testsocket.h"
+#include "httpresponse.h"
+#include "txtreader.h"
+#include "utils.h"
+#include "version.h"
+
+using namespace klk;
+using namespace klk::http;
+
+namespace
+{
+    /// Responses count for the benchmark
+    const size_t RESCOUNT = 100000;
+
+    /// The input path for tests
+    const std::string PATH = "/test";
+
+    /// Makes a reader for tests
+    const IReaderPtr makeReader()
+    {
+        return TXTReader::make(ISocketPtr(new TestSocket("/dev/null")));
+    }
+}
+
+//
+// TestResponseCache class
+//
+
+// Constructor
+TestResponseCache::TestResponseCache()
+{
+}
+
+// The responses test
+void TestResponseCache::testCache()
+{
+    test::printOut("\nHTTP responses cache test ... ");
+
+    ResponseCache cache;
+    IReaderPtr reader = makeReader();
+    const std::string type = reader->getContentType();
+
+    // the Date header in RFC 1123 format
+    const std::string date = cache.getDate();
+    CPPUNIT_ASSERT(date.size() == 29);
+    CPPUNIT_ASSERT(date.substr(date.size() - 4) == " GMT");
+
+    // OK responses
+    const std::string ok11 =
+        cache.getOK(PATH, reader, true, true).toString();
+    CPPUNIT_ASSERT(ok11.find("HTTP/1.1 200 OK\r\n") == 0);
+    CPPUNIT_ASSERT(ok11.find("Content-Type: " + type + "\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(ok11.find("Transfer-Encoding: chunked\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(ok11.find("Connection: keep-alive\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(ok11.find("Date: ") != std::string::npos);
+    CPPUNIT_ASSERT(ok11.substr(ok11.size() - 4) == "\r\n\r\n");
+
+    const std::string ok10 =
+        cache.getOK(PATH, reader, false, false).toString();
+    CPPUNIT_ASSERT(ok10.find("Transfer-Encoding") == std::string::npos);
+    CPPUNIT_ASSERT(ok10.find("Connection: close\r\n") != std::string::npos);
+
+    // the Date header is refreshed once per second
+    sleep(1);
+    const std::string refreshed =
+        cache.getOK(PATH, reader, true, true).toString();
+    CPPUNIT_ASSERT(refreshed.find("Date: " + cache.getDate()) !=
+                   std::string::npos);
+
+    // errors
+    const std::string notfound = cache.getError(404, false, false).toString();
+    CPPUNIT_ASSERT(notfound.find("HTTP/1.1 404 Not Found\r\n") == 0);
+    CPPUNIT_ASSERT(notfound.find("Content-Type") == std::string::npos);
+    CPPUNIT_ASSERT(notfound.find("<h1>404 Not Found</h1>") !=
+                   std::string::npos);
+    const std::string head = cache.getError(404, true, true).toString();
+    CPPUNIT_ASSERT(head.find("Connection: keep-alive\r\n") !=
+                   std::string::npos);
+    CPPUNIT_ASSERT(head.substr(head.size() - 4) == "\r\n\r\n");
+    // HEAD response has the same Content-Length but without the body
+    const std::string body =
+        notfound.substr(notfound.find("\r\n\r\n") + 4);
+    char length[64];
+    snprintf(length, sizeof(length), "Content-Length: %d\r\n",
+             static_cast<int>(body.size()));
+    CPPUNIT_ASSERT(notfound.find(length) != std::string::npos);
+    CPPUNIT_ASSERT(head.find(length) != std::string::npos);
+
+    const std::string allow = cache.getError(405, false, false).toString();
+    CPPUNIT_ASSERT(allow.find("Allow: GET, HEAD\r\n") != std::string::npos);
+}
+
+// The benchmark
+void TestResponseCache::testBenchmark()
+{
+    test::printOut("\nHTTP responses cache benchmark ... ");
+
+    const double cache = measureCache();
+    const double build = measureBuild();
+    char msg[128];
+    snprintf(msg, sizeof(msg), "\n\tcache: %.0f resp/sec"
+             "\n\tbuild: %.0f resp/sec", cache, build);
+    test::printOut(msg);
+
+    // the check is very rough to avoid false failures on loaded hosts
+    CPPUNIT_ASSERT(cache * 2 > build);
+}
+
+// Measures the cache throughput
+double TestResponseCache::measureCache()
+{
+    ResponseCache cache;
+    IReaderPtr reader = makeReader();
+    size_t total = 0;
+    const double start = test::getTime();
+    for (size_t i = 0; i < RESCOUNT; i++)
+    {
+        total += cache.getOK(PATH, reader, true, true).size();
+    }
+    const double duration = test::getTime() - start;
+
+    CPPUNIT_ASSERT(total > RESCOUNT);
+    return (duration > 0) ? RESCOUNT / duration : RESCOUNT;
+}
+
+// Measures the throughput of the responses that are built for each
+// connection
+double TestResponseCache::measureBuild()
+{
+    IReaderPtr reader = makeReader();
+    size_t total = 0;
+    const double start = test::getTime();
+    for (size_t i = 0; i < RESCOUNT; i++)
+    {
+        // the same way as it was done at the connection
+        std::stringstream response;
+        response << "HTTP/1.1 200 OK\r\n";
+        response << "Date: " <<
+            base::Utils::getCurrentTime("%a, %d %b %Y %H:%M:%S %Z\r\n");
+        response << "Server: " << VERSION_STR << "\r\n";
+        response << "Pragma: no-cache,private\r\n";
+        response << "Cache-Control: no-cache\r\n";
+        response << "Content-Type: "
+                 << reader->getContentType() << "\r\n";
+        response << "Transfer-Encoding: chunked\r\n";
+        response << "Connection: keep-alive\r\n";
+        response << "\r\n";
+        total += BinaryData(response.str()).size();
+    }
+    const double duration = test::getTime() - start;
+
+    CPPUNIT_ASSERT(total > RESCOUNT);
+    return (duration > 0) ? RESCOUNT / duration : RESCOUNT;
+}
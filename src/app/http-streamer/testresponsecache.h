@@ -0,0 +1,97 @@
+/**
+   @file testresponsecache.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_TESTRESPONSECACHE_H
+#define KLK_TESTRESPONSECACHE_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    namespace http
+    {
+        /**
+           @brief HTTP responses cache test
+
+           The test checks klk::http::ResponseCache responses and the
+           Date header refresh. There is also a benchmark that compares
+           the cache with the responses that are built for each
+           connection
+
+           @ingroup grTestHTTP
+        */
+        class TestResponseCache : public CppUnit::TestFixture
+        {
+            CPPUNIT_TEST_SUITE(TestResponseCache);
+            CPPUNIT_TEST(testCache);
+            CPPUNIT_TEST(testBenchmark);
+            CPPUNIT_TEST_SUITE_END();
+        public:
+            /// Constructor
+            TestResponseCache();
+
+            /// Destructor
+            virtual ~TestResponseCache(){}
+
+            /// The responses test
+            void testCache();
+
+            /// The benchmark
+            void testBenchmark();
+        private:
+            /**
+               Measures the cache throughput
+
+               @return responses per second
+            */
+            double measureCache();
+
+            /**
+               Measures the throughput of the responses that are
+               built for each connection
+
+               @return responses per second
+            */
+            double measureBuild();
+        private:
+            /// Fake copy constructor
+            TestResponseCache(const TestResponseCache&);
+
+            /// Fake assigment operator
+            TestResponseCache& operator=(const TestResponseCache&);
+        };
+    }
+}
+
+#endif //KLK_TESTRESPONSECACHE_H
@@ -102,7 +102,7 @@ void TestSNMP::testTableGet()
     while (snmp::TableRow *row = SNMPFactory::instance()->getNext())
     {
         // check row size
-        CPPUNIT_ASSERT(row->size() == 7);
+        CPPUNIT_ASSERT(row->size() == 8);
 
         // klkOutputPath        DisplayString,
         if ((*row)[1].toString() == TESTPATH1)
@@ -120,6 +120,8 @@ void TestSNMP::testTableGet()
             CPPUNIT_ASSERT((*row)[5].toInt() == 0);
             // klkBrokenPackages    Counter32
             CPPUNIT_ASSERT((*row)[6].toInt() == 0);
+            // klkDroppedPackages   Counter32
+            CPPUNIT_ASSERT((*row)[7].toInt() == 0);
         }
         else if ((*row)[1].toString() == TESTPATH2)
         {
@@ -136,6 +138,8 @@ void TestSNMP::testTableGet()
             CPPUNIT_ASSERT((*row)[5].toInt() == 0);
             // klkBrokenPackages    Counter32
             CPPUNIT_ASSERT((*row)[6].toInt() == 0);
+            // klkDroppedPackages   Counter32
+            CPPUNIT_ASSERT((*row)[7].toInt() == 0);
         }
         else
         {
@@ -149,3 +149,16 @@ void TestSocket::send(const sock::RouteInfo& route, const BinaryData& data)
     NOTIMPLEMENTED;
 }
 
+// @copydoc klk::ISocket::sendv
+void TestSocket::sendv(const BinaryDataVector& data)
+{
+    NOTIMPLEMENTED;
+}
+
+// @copydoc klk::ISocket::sendvNonBlock
+const size_t TestSocket::sendvNonBlock(const BinaryDataVector& data,
+                                       size_t offset)
+{
+    NOTIMPLEMENTED;
+    return 0;
+}
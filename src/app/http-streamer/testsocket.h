@@ -132,6 +132,36 @@ namespace klk
             virtual void setKeepAlive(time_t timeout)
             {
             }
+
+            /// @copydoc klk::ISocket::setRecvBuffer
+            virtual void setRecvBuffer(size_t size)
+            {
+            }
+
+            /// @copydoc klk::ISocket::getDroppedCount
+            virtual const u_long getDroppedCount() const
+            {
+                return 0;
+            }
+
+            /**
+               @copydoc klk::ISocket::sendv
+            */
+            virtual void sendv(const BinaryDataVector& data);
+
+            /**
+               @copydoc klk::ISocket::sendvNonBlock
+            */
+            virtual const size_t sendvNonBlock(const BinaryDataVector& data,
+                                               size_t offset);
+
+            /**
+               @copydoc klk::ISocket::getDescriptor
+            */
+            virtual const int getDescriptor() const throw()
+            {
+                return -1;
+            }
         private:
             /**
                Copy constructor
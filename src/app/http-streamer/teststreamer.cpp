@@ -56,6 +56,10 @@
 #include "testsnmp.h"
 #include "testtheora.h"
 #include "testslowconnection.h"
+#include "testchunkring.h"
+#include "testmpegts.h"
+#include "testhttprequest.h"
+#include "testresponsecache.h"
 
 
 // modules specific info
@@ -96,6 +100,23 @@ void klk_module_test_init()
     CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestTheora, TESTTHEORA);
     CPPUNIT_REGISTRY_ADD(TESTTHEORA, MODNAME);
 
+    const std::string TESTCHUNKRING = MODNAME + "/chunkring";
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestChunkRing, TESTCHUNKRING);
+    CPPUNIT_REGISTRY_ADD(TESTCHUNKRING, MODNAME);
+
+    const std::string TESTMPEGTS = MODNAME + "/mpegts";
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestMPEGTS, TESTMPEGTS);
+    CPPUNIT_REGISTRY_ADD(TESTMPEGTS, MODNAME);
+
+    const std::string TESTHTTPREQUEST = MODNAME + "/httprequest";
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestHTTPRequest, TESTHTTPREQUEST);
+    CPPUNIT_REGISTRY_ADD(TESTHTTPREQUEST, MODNAME);
+
+    const std::string TESTRESPONSECACHE = MODNAME + "/responsecache";
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TestResponseCache,
+                                          TESTRESPONSECACHE);
+    CPPUNIT_REGISTRY_ADD(TESTRESPONSECACHE, MODNAME);
+
     CPPUNIT_REGISTRY_ADD(MODNAME, test::ALL);
 }
 
@@ -92,9 +92,9 @@ bool ModuleFactory::isLoaded(const std::string& id)
 /// @copydoc klk::IModuleFactory::sendMessage
 void ModuleFactory::sendMessage(const IMessagePtr& msg)
 {
-    StringList receivers = msg->getReceiverList();
+    const StringList& receivers = msg->getReceiverList();
     bool local_receivers = false, remote_receivers = false;
-    for (StringList::iterator item = receivers.begin();
+    for (StringList::const_iterator item = receivers.begin();
          item != receivers.end(); item++)
     {
         if (isLocal(*item))
@@ -97,7 +97,7 @@ void Module::sendSyncMessage(const klk::IMessagePtr& in,
                              klk::IMessagePtr& out)
 {
     // get receiver
-    const StringList list = in->getReceiverList();
+    const StringList& list = in->getReceiverList();
     BOOST_ASSERT(list.size() == 1);
     const std::string receiver_id = *(list.begin());
 
@@ -113,6 +113,33 @@ void Module::sendSyncMessage(const klk::IMessagePtr& in,
     }
 }
 
+// @copydoc klk::Module::postRequest
+klk::MessageFuturePtr Module::postRequest(const klk::IMessagePtr& in)
+{
+    // get receiver
+    const StringList& list = in->getReceiverList();
+    BOOST_ASSERT(list.size() == 1);
+    const std::string receiver_id = *(list.begin());
+
+    if (isLocal(receiver_id))
+    {
+        // use local call
+        return klk::app::Module::postRequest(in);
+    }
+
+    // use RPC call
+    MessageFuturePtr future(new MessageFuture(in));
+    try
+    {
+        future->setResponse(getProtocol()->sendSync(in));
+    }
+    catch(const std::exception& err)
+    {
+        future->setFailed(err.what());
+    }
+    return future;
+}
+
 /// @return the protocol instance
 klk::adapter::MessagesProtocol* Module::getProtocol()
 {
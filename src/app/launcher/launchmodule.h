@@ -73,6 +73,14 @@ namespace klk
         protected:
             /// @copydoc klk::IModule::registerProcessors()
             virtual void registerProcessors();
+
+            /**
+               @copydoc klk::Module::postRequest
+
+               @note a request to a remote module is sent via RPC
+               synchronously and the future is completed at once
+            */
+            virtual MessageFuturePtr postRequest(const IMessagePtr& in);
         private:
             adapter::MessagesProtocol* m_proto; ///< RPC communication protocol
             klk::Mutex m_proto_lock; ///< mutex for locking
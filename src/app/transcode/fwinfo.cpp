@@ -93,7 +93,8 @@ void FWSrcInfo::initInternal(Transcode* module)
                         flags: readable, writable
                         Integer. Range: -1 - 16 Default: -1 Current: -1
      */
-    int port = boost::lexical_cast<int>(res->getValue(msg::key::IEEE1394PORT));
+    const int port =
+        static_cast<int>(res->getInteger(msg::key::IEEE1394PORT));
 
     initElement("dv1394src", module->getFactory());
     g_object_set(G_OBJECT (m_element), "port", port, NULL);
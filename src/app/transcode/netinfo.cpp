@@ -37,8 +37,6 @@
 #include "config.h"
 #endif
 
-#include <boost/lexical_cast.hpp>
-
 #include "netinfo.h"
 #include "exception.h"
 #include "trans.h"
@@ -165,15 +163,7 @@ void NetInfo::initInternal(Transcode* module)
     initElement(element_name, module->getFactory());
 
     const std::string host = res->getValue(msg::key::NETHOST);
-    u_int port = 0;
-    try
-    {
-        port = boost::lexical_cast<u_int>(res->getValue(msg::key::NETPORT));
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw Exception(__FILE__, __LINE__, err::BADLEXCAST);
-    }
+    const u_int port = static_cast<u_int>(res->getInteger(msg::key::NETPORT));
 
     // only udpsrc has uri format all others sets host, port values
     if (proto == sock::UDP && getDirection() == SOURCE)
@@ -0,0 +1,154 @@
+/**
+   @file src/common/affinity.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <strings.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include "affinity.h"
+#include "exception.h"
+#include "taskpool.h"
+
+using namespace klk;
+
+/// No pinning target
+static const std::string NONE_TARGET("none");
+
+/// CPU core target prefix
+static const std::string CPU_PREFIX("cpu");
+
+/// NUMA node target prefix
+static const std::string NODE_PREFIX("node");
+
+//
+// Affinity class
+//
+
+// Constructor
+Affinity::Affinity(const std::string& spec) :
+    m_auto(false), m_targets()
+{
+    std::string value = spec;
+    boost::trim(value);
+    if (value.empty() || strcasecmp(value.c_str(), "none") == 0)
+    {
+        return;
+    }
+    if (strcasecmp(value.c_str(), "auto") == 0)
+    {
+        m_auto = true;
+        return;
+    }
+
+    std::vector<std::string> items;
+    boost::split(items, value, boost::is_any_of(","));
+    for (std::vector<std::string>::iterator i = items.begin();
+         i != items.end(); i++)
+    {
+        std::string item = *i;
+        boost::trim(item);
+        std::string prefix = CPU_PREFIX;
+        if (item.compare(0, NODE_PREFIX.size(), NODE_PREFIX) == 0)
+        {
+            prefix = NODE_PREFIX;
+            item.erase(0, NODE_PREFIX.size());
+        }
+
+        try
+        {
+            if (item.empty() ||
+                item.find_first_not_of("0123456789") != std::string::npos)
+            {
+                throw boost::bad_lexical_cast();
+            }
+            const u_int no = boost::lexical_cast<u_int>(item);
+            m_targets.push_back(prefix +
+                                boost::lexical_cast<std::string>(no));
+        }
+        catch(const boost::bad_lexical_cast&)
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Incorrect affinity item '%s' in '%s'",
+                            i->c_str(), spec.c_str());
+        }
+    }
+}
+
+// Retrives the pin target for a thread
+const std::string Affinity::getTarget(u_int no) const
+{
+    if (m_auto)
+    {
+        return CPU_PREFIX + boost::lexical_cast<std::string>(
+            no % TaskPool::getCPUCount());
+    }
+
+    if (m_targets.empty())
+    {
+        return NONE_TARGET;
+    }
+
+    return m_targets[no % m_targets.size()];
+}
+
+// Pins the current thread
+Result Affinity::pin(const std::string& target) throw()
+{
+    try
+    {
+        if (target.compare(0, CPU_PREFIX.size(), CPU_PREFIX) == 0)
+        {
+            return TaskPool::pinThread(
+                boost::lexical_cast<u_int>(target.substr(CPU_PREFIX.size())));
+        }
+        if (target.compare(0, NODE_PREFIX.size(), NODE_PREFIX) == 0)
+        {
+            return TaskPool::pinThreadToNode(
+                boost::lexical_cast<u_int>(
+                    target.substr(NODE_PREFIX.size())));
+        }
+    }
+    catch(...)
+    {
+        return ERROR;
+    }
+
+    return OK;
+}
@@ -0,0 +1,111 @@
+/**
+   @file src/common/affinity.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_AFFINITY_H
+#define KLK_AFFINITY_H
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+#include "errors.h"
+
+namespace klk
+{
+    /**
+       @brief CPU affinity spec
+
+       Maps thread numbers (e.g. DVB adapter numbers) to the CPU cores
+       or NUMA nodes the threads are pinned to. The spec format is
+       - none - the threads are not pinned
+       - auto - the threads are spread over the cores
+       - comma separated items, each one is a core number (e.g. 3)
+       or a NUMA node (e.g. node1). The thread number selects the item
+       (modulo the items count)
+    */
+    class Affinity
+    {
+    public:
+        /**
+           Constructor
+
+           @param[in] spec - the affinity spec
+
+           @exception klk::Exception if the spec is wrong
+        */
+        explicit Affinity(const std::string& spec);
+
+        /**
+           Destructor
+        */
+        virtual ~Affinity(){}
+
+        /**
+           Retrives the pin target for a thread
+
+           @param[in] no - the thread number
+
+           @return none, cpuN or nodeN
+        */
+        const std::string getTarget(u_int no) const;
+
+        /**
+           Pins the current thread
+
+           @param[in] target - the target returned by getTarget()
+
+           @return
+           - @ref klk::OK - the thread was pinned (or the target is none)
+           - @ref klk::ERROR - the pinning failed
+        */
+        static Result pin(const std::string& target) throw();
+    private:
+        bool m_auto; ///< spread over the cores
+        std::vector<std::string> m_targets; ///< cpuN/nodeN list
+    private:
+        /**
+           Copy constructor
+           @param[in] value - the copy param
+        */
+        Affinity(const Affinity& value);
+
+        /**
+           Assigment operator
+           @param[in] value - the copy param
+        */
+        Affinity& operator=(const Affinity& value);
+    };
+}
+
+#endif //KLK_AFFINITY_H
@@ -48,14 +48,28 @@ using namespace klk;
 // Constructor
 BaseMessage::BaseMessage(const std::string& id, const msg::UUID& uuid,
                          const std::string& sender_id) :
-    m_lock(), m_id(id), m_uuid(uuid), m_sender_id(sender_id)
+    m_lock(), m_id(id), m_uuid(uuid), m_type(msg::UNDEF),
+    m_sender_id(sender_id), m_sealed(false)
 {
 }
 
+// Checks that the message can be modified
+void BaseMessage::checkWritable() const
+{
+    if (m_sealed)
+    {
+        throw klk::Exception(__FILE__, __LINE__,
+                             "Message with id '%s' can not be modified "
+                             "after it was sent",
+                             m_id.c_str());
+    }
+}
+
 // Gets message type
+// @note the type is changed only before the message is sent
+// thus there is no lock here
 msg::Type BaseMessage::getType() const
 {
-    Locker lock(&m_lock);
     BOOST_ASSERT(m_type != msg::UNDEF);
     return m_type;
 }
@@ -64,7 +78,11 @@ msg::Type BaseMessage::getType() const
 // @param[in] type - the type to be set
 void BaseMessage::setType(msg::Type type)
 {
-    Locker lock(&m_lock);
+    if (m_type == type)
+    {
+        return;
+    }
+    checkWritable();
     m_type = type;
 }
 
@@ -72,7 +90,6 @@ void BaseMessage::setType(msg::Type type)
 // @return the ID
 const std::string BaseMessage::getSenderID() const
 {
-    Locker lock(&m_lock);
     // it really can be empty if it's used for serialization
     // FIXME!!!
     //BOOST_ASSERT(!m_sender_id.empty());
@@ -83,7 +100,11 @@ const std::string BaseMessage::getSenderID() const
 // @param[in] id - the id to be set
 void BaseMessage::setSenderID(const std::string& id)
 {
-    Locker lock(&m_lock);
     BOOST_ASSERT(!id.empty());
+    if (m_sender_id == id)
+    {
+        return;
+    }
+    checkWritable();
     m_sender_id = id;
 }
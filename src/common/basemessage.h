@@ -72,12 +72,26 @@ namespace klk
 
         /// @copydoc klk::IMessage::getSenderID()
         virtual const std::string getSenderID() const;
+
+        /// @copydoc klk::IMessage::seal()
+        virtual void seal() throw() {m_sealed = true;}
+
+        /// @return true if the message was sealed
+        bool isSealed() const throw() {return m_sealed;}
+
+        /**
+           Checks that the message can be modified
+
+           @exception klk::Exception if the message was sealed
+        */
+        void checkWritable() const;
     private:
         const std::string m_id; ///< message id
         const msg::UUID m_uuid; ///< message UUID
 
         msg::Type m_type; ///< message type
         std::string m_sender_id; ///< sender's id
+        volatile bool m_sealed; ///< the message is read only
 
         /// @copydoc klk::IMessage::getUUID()
         virtual msg::UUID getUUID(){return m_uuid;}
@@ -153,6 +153,12 @@ BinaryData& BinaryData::operator=(const BinaryData& value)
     return *this;
 }
 
+// Exchanges the content with another binary data container
+void BinaryData::swap(BinaryData& value) throw()
+{
+    m_data.swap(value.m_data);
+}
+
 // Converts data to klk::BinaryDataContainer
 const BinaryDataContainer BinaryData::toData() const
 {
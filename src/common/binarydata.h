@@ -185,6 +185,15 @@ namespace klk
         */
         void add(const BinaryDataContainer& data);
 
+        /**
+           Exchanges the content with another binary data container
+
+           @param[in] value - the data to be exchanged with
+
+           @note there is no data copying
+        */
+        void swap(BinaryData& value) throw();
+
         /**
            Checks is there any data or not
 
@@ -63,6 +63,7 @@
 #include "paths.h"
 #include "exception.h"
 #include "options.h"
+#include "affinity.h"
 
 using namespace klk;
 
@@ -300,7 +301,9 @@ const int MAX_CONFIG_OPTION_LEN = 1024;
 Config::Config() :
     Mutex(),
     m_hostname(""), m_config_path(dir::CFG),
-    m_dbinfo(), m_snmpinfo(), m_options()
+    m_dbinfo(), m_snmpinfo(), m_msgtrace(false),
+    m_loglevel(KLKLOG_INFO), m_logtarget("syslog"),
+    m_dvbaffinity("none"), m_options()
 {
 }
 
@@ -487,6 +490,48 @@ void Config::fillOptionList() throw()
             "public",
             boost::bind(&SNMPInfo::setCommunity, &m_snmpinfo, _1)));
     m_options.push_back(option);
+
+    option = IOptionPtr(
+        new Option(
+            conf::MSGTRACE,
+            "Routes all async messages through the messaging core",
+            "Format :\n"
+            "       yes|no",
+            "no",
+            boost::bind(&Config::setMessageTrace, this, _1)));
+    m_options.push_back(option);
+
+    option = IOptionPtr(
+        new Option(
+            conf::LOGLEVEL,
+            "Sets the lowest level of the messages written to the log",
+            "Format :\n"
+            "       error|warning|info|debug",
+            "info",
+            boost::bind(&Config::setLogLevel, this, _1)));
+    m_options.push_back(option);
+
+    option = IOptionPtr(
+        new Option(
+            conf::LOGTARGET,
+            "Sets the log destination",
+            "Format :\n"
+            "       syslog|stderr|/path/to/file",
+            "syslog",
+            boost::bind(&Config::setLogTarget, this, _1)));
+    m_options.push_back(option);
+
+    option = IOptionPtr(
+        new Option(
+            conf::DVBAFFINITY,
+            "Pins DVB adapter loops to CPU cores or NUMA nodes",
+            "Format :\n"
+            "       none|auto|item[,item...]\n"
+            "       The item is a core number (e.g. 3) or a NUMA node\n"
+            "       (e.g. node1). The items are taken by adapter number",
+            "none",
+            boost::bind(&Config::setDVBAffinity, this, _1)));
+    m_options.push_back(option);
 }
 
 // Sets mediaserver host name
@@ -497,3 +542,78 @@ void Config::setHostName(const std::string& value)
     BOOST_ASSERT(value.empty() == false);
     m_hostname = value;
 }
+
+// Sets message trace mode
+void Config::setMessageTrace(const std::string& value)
+{
+    // private method protected at the Config::load
+    // no necessary to lock it
+    if (strcasecmp(value.c_str(), "yes") == 0)
+    {
+        m_msgtrace = true;
+    }
+    else if (strcasecmp(value.c_str(), "no") == 0)
+    {
+        m_msgtrace = false;
+    }
+    else
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Incorrect message trace value: " + value);
+    }
+}
+
+// Sets log level
+void Config::setLogLevel(const std::string& value)
+{
+    // private method protected at the Config::load
+    // no necessary to lock it
+    if (strcasecmp(value.c_str(), "error") == 0)
+    {
+        m_loglevel = KLKLOG_ERROR;
+    }
+    else if (strcasecmp(value.c_str(), "warning") == 0)
+    {
+        m_loglevel = KLKLOG_WARNING;
+    }
+    else if (strcasecmp(value.c_str(), "info") == 0)
+    {
+        m_loglevel = KLKLOG_INFO;
+    }
+    else if (strcasecmp(value.c_str(), "debug") == 0)
+    {
+        m_loglevel = KLKLOG_DEBUG;
+    }
+    else
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Incorrect log level value: " + value);
+    }
+
+    klk_log_set_level(m_loglevel);
+}
+
+// Sets log target
+void Config::setLogTarget(const std::string& value)
+{
+    // private method protected at the Config::load
+    // no necessary to lock it
+    if (klk_log_set_target(value.c_str()) != 0)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Incorrect log target value: " + value);
+    }
+    m_logtarget = value;
+}
+
+// Sets DVB adapter loops CPU affinity
+void Config::setDVBAffinity(const std::string& value)
+{
+    // private method protected at the Config::load
+    // no necessary to lock it
+    std::string affinity = value;
+    boost::trim_if(affinity, boost::is_any_of(" \r\n\t"));
+    // throws an exception if the value is wrong
+    Affinity check(affinity);
+    m_dvbaffinity = affinity;
+}
@@ -42,19 +42,72 @@
 #include <mysqld_error.h>
 #include <errmsg.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
 
 #include <sstream>
+#include <memory>
+#include <algorithm>
 
 #include <boost/bind.hpp>
 
 #include "common.h"
 #include "log.h"
 #include "db.h"
+#include "dbstatement.h"
 #include "commontraps.h"
 #include "exception.h"
 
 using namespace klk::db;
 
+/**
+   Sends a MySQL error message to our log and the SNMP trap
+
+   @param[in] factory - the factory
+   @param[in] error - the MySQL error message
+   @param[in] query - the failed query (can be empty)
+*/
+static void displayError(klk::IFactory* factory, const std::string& error,
+                         const std::string& query) throw()
+{
+    try
+    {
+        // send trap
+        factory->getSNMP()->sendTrap(klk::snmp::DB_FAILED, error);
+
+        if (query.empty())
+        {
+            klk_log(KLKLOG_ERROR,
+                    "We have the following error at MySQL DB: %s",
+                    error.c_str());
+        }
+        else
+        {
+            klk_log(KLKLOG_ERROR,
+                    "We have the following error at MySQL DB: %s. Query: %s",
+                    error.c_str(), query.c_str());
+        }
+    }
+    catch(...)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Error detected while display MySQL error message");
+    }
+}
+
+/**
+   Retrives the current time with microseconds precision
+
+   @return the time in seconds
+*/
+static double getPreciseTime() throw()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<double>(tv.tv_sec) +
+        static_cast<double>(tv.tv_usec) / 1000000.0;
+}
+
 //
 // Parameters class
 //
@@ -71,6 +124,7 @@ void Parameters::add(const std::string& key, const char *param)
     if (param == NULL)
     {
         m_params.push_back(Pair(key, "NULL"));
+        m_values.push_back(Value());
     }
     else
     {
@@ -86,6 +140,11 @@ void Parameters::add(const std::string& key, const std::string& param)
     checkKey(key);
     std::string queryparam = "'" + param + "'";
     m_params.push_back(Pair(key, queryparam));
+
+    Value value;
+    value.m_type = Value::STRING;
+    value.m_string = param;
+    m_values.push_back(value);
 }
 
 
@@ -97,6 +156,11 @@ void Parameters::add(const std::string& key, int param)
     std::stringstream data;
     data << param;
     m_params.push_back(Pair(key, data.str()));
+
+    Value value;
+    value.m_type = Value::INTEGER;
+    value.m_integer = param;
+    m_values.push_back(value);
 }
 
 // check functor
@@ -277,94 +341,358 @@ const std::string Answer::getColumnName(size_t colnum) const
 }
 
 //
-// DB class
+// PooledConnection class
 //
 
 // Constructor
-// @param[in] config - the config interface
-DB::DB(IFactory* factory):
-    m_factory(factory), m_connection(NULL), m_hostuuid("")
+PooledConnection::PooledConnection() :
+    m_handle(), m_thread(pthread_self()), m_last_time(time(NULL)),
+    m_pending(false), m_statements()
+{
+    mysql_init(&m_handle);
+}
+
+// Destructor
+PooledConnection::~PooledConnection()
+{
+    // the statements should be closed before the connection
+    for (StatementMap::iterator i = m_statements.begin();
+         i != m_statements.end(); i++)
+    {
+        delete i->second;
+    }
+    m_statements.clear();
+
+    mysql_close(&m_handle);
+}
+
+// Retrives the prepared statement for a stored procedure
+Statement* PooledConnection::getStatement(const std::string& procedure)
+{
+    StatementMap::iterator i = m_statements.find(procedure);
+    if (i != m_statements.end())
+    {
+        return i->second;
+    }
+
+    Statement* statement = new Statement(&m_handle, procedure);
+    m_statements.insert(StatementMap::value_type(procedure, statement));
+    return statement;
+}
+
+//
+// ConnectionPool class
+//
+
+// Constructor
+ConnectionPool::ConnectionPool(IFactory* factory) :
+    m_factory(factory), m_lock(), m_idle(), m_check_time(time(NULL)),
+    m_next_attempt(0), m_backoff(0), m_stat()
 {
     BOOST_ASSERT(m_factory);
-    mysql_init(&m_dbhandle);
 }
 
 // Destructor
-DB::~DB()
+ConnectionPool::~ConnectionPool()
 {
-    disconnect();
+    for (ThreadMap::iterator i = m_idle.begin(); i != m_idle.end(); i++)
+    {
+        for (ConnectionList::iterator j = i->second.begin();
+             j != i->second.end(); j++)
+        {
+            delete *j;
+        }
+    }
+    m_idle.clear();
 }
 
-// Connects to the DB
-void DB::connect()
+// Retrives a connection for the calling thread
+PooledConnection* ConnectionPool::checkout()
 {
-    // infinite attempts
-    while (m_connection == NULL)
-    {
-        m_connection =
-            mysql_real_connect(
-                &m_dbhandle,
-                m_factory->getConfig()->getDBInfo()->getHost().c_str(),
-                m_factory->getConfig()->getDBInfo()->getUserName().c_str(),
-                m_factory->getConfig()->getDBInfo()->getUserPwd().c_str(),
-                m_factory->getConfig()->getDBInfo()->getDBName().c_str(),
-                m_factory->getConfig()->getDBInfo()->getPort(),
-                NULL, CLIENT_MULTI_STATEMENTS);
-        if (m_connection == NULL &&
-            m_factory->getEventTrigger()->isStopped() == false)
+    const double start = getPreciseTime();
+
+    PooledConnection* connection = NULL;
+    while ((connection = getIdle()) != NULL)
+    {
+        if (check(connection))
         {
-            // connection error
-            dispResult("");
-            // sleep for awhile
-            sleep(10);
-            // try to reread config
-            m_factory->getConfig()->load();
+            break;
         }
+        // the connection was lost
+        KLKDELETE(connection);
     }
-    BOOST_ASSERT(m_connection);
 
-    // set connection charset params
-    safeQuery("SET NAMES 'utf8'");
+    if (connection == NULL)
+    {
+        connection = connect();
+    }
+    BOOST_ASSERT(connection);
+    connection->touch();
+    connection->setPending(false);
+
+    const double wait = getPreciseTime() - start;
+    Locker lock(&m_lock);
+    m_stat.m_checkouts++;
+    m_stat.m_busy++;
+    m_stat.m_wait_total += wait;
+    if (wait > m_stat.m_wait_max)
+    {
+        m_stat.m_wait_max = wait;
+    }
+
+    return connection;
 }
 
-// Disconnects from the DB
-void DB::disconnect() throw()
+// Returns the connection to the pool
+void ConnectionPool::checkin(PooledConnection* connection) throw()
 {
-    if (m_connection)
+    BOOST_ASSERT(connection);
+
+    ConnectionList expired;
     {
-	mysql_close(m_connection);
-        m_connection = NULL;
+        Locker lock(&m_lock);
+        BOOST_ASSERT(m_stat.m_busy > 0);
+        m_stat.m_busy--;
+
+        connection->touch();
+        ConnectionList& list = m_idle[connection->getThread()];
+        // a connection with an incomplete query can not be reused
+        if (connection->isPending() || list.size() >= DB_POOL_THREAD_IDLE_MAX)
+        {
+            expired.push_back(connection);
+        }
+        else
+        {
+            list.push_front(connection);
+            m_stat.m_idle++;
+        }
+
+        // close connections that were not used for a long time
+        // the connections of finished threads are also closed here
+        const time_t now = time(NULL);
+        if (now - m_check_time >= DB_POOL_CHECK_INTERVAL)
+        {
+            m_check_time = now;
+            for (ThreadMap::iterator i = m_idle.begin(); i != m_idle.end();)
+            {
+                ConnectionList::iterator j = i->second.begin();
+                while (j != i->second.end())
+                {
+                    if (now - (*j)->getLastTime() >= DB_POOL_IDLE_TIMEOUT)
+                    {
+                        expired.push_back(*j);
+                        j = i->second.erase(j);
+                        m_stat.m_idle--;
+                    }
+                    else
+                    {
+                        j++;
+                    }
+                }
+
+                if (i->second.empty())
+                {
+                    m_idle.erase(i++);
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+    }
+
+    // mysql_close() does network IO thus it's called outside the lock
+    for (ConnectionList::iterator i = expired.begin(); i != expired.end(); i++)
+    {
+        delete *i;
     }
 }
 
-// Sends an error message to our log
-void DB::dispResult(const std::string& query) throw()
+// Retrives the pool statistics
+const PoolStat ConnectionPool::getStat() const
 {
-    try
+    Locker lock(&m_lock);
+    return m_stat;
+}
+
+// Retrives an idle connection of the calling thread
+PooledConnection* ConnectionPool::getIdle() throw()
+{
+    Locker lock(&m_lock);
+    ThreadMap::iterator i = m_idle.find(pthread_self());
+    if (i == m_idle.end() || i->second.empty())
     {
-        const std::string error = mysql_error(&m_dbhandle);
-        // send trap
-        m_factory->getSNMP()->sendTrap(klk::snmp::DB_FAILED,
-                                       error);
+        return NULL;
+    }
 
-        if (query.empty())
+    // the most recently used connection is the first one
+    PooledConnection* connection = i->second.front();
+    i->second.pop_front();
+    BOOST_ASSERT(m_stat.m_idle > 0);
+    m_stat.m_idle--;
+    return connection;
+}
+
+// Checks an idle connection
+const bool ConnectionPool::check(PooledConnection* connection) throw()
+{
+    BOOST_ASSERT(connection);
+    if (time(NULL) - connection->getLastTime() < DB_POOL_CHECK_INTERVAL)
+    {
+        return true;
+    }
+
+    if (mysql_ping(connection->getHandle()) != 0)
+    {
+        klk_log(KLKLOG_ERROR, "Pooled MySQL connection was lost: %s",
+                mysql_error(connection->getHandle()));
+        return false;
+    }
+    return true;
+}
+
+// Creates a new connection
+PooledConnection* ConnectionPool::connect()
+{
+    // infinite attempts
+    for (;;)
+    {
+        time_t next_attempt = 0;
         {
-            klk_log(KLKLOG_ERROR,
-                    "We have the following error at MySQL DB: %s",
-                    error.c_str());
+            Locker lock(&m_lock);
+            next_attempt = m_next_attempt;
         }
-        else
+
+        // the DB is known to be not available:
+        // wait for the next attempt time
+        if (time(NULL) < next_attempt)
         {
-            klk_log(KLKLOG_ERROR,
-                    "We have the following error at MySQL DB: %s. Query: %s",
-                    error.c_str(), query.c_str());
+            if (m_factory->getEventTrigger()->isStopped())
+            {
+                throw klk::Exception(__FILE__, __LINE__,
+                                     "DB is not available");
+            }
+            sleep(1);
+            continue;
+        }
+
+        PooledConnection* connection = tryConnect();
+        if (connection)
+        {
+            return connection;
         }
+
+        if (m_factory->getEventTrigger()->isStopped())
+        {
+            throw klk::Exception(__FILE__, __LINE__,
+                                 "DB is not available");
+        }
+
+        // try to reread config
+        m_factory->getConfig()->load();
+    }
+
+    return NULL; // never reached
+}
+
+// Does a connection attempt
+PooledConnection* ConnectionPool::tryConnect() throw()
+{
+    try
+    {
+        std::auto_ptr<PooledConnection> connection(new PooledConnection());
+        const IDBInfo* info = m_factory->getConfig()->getDBInfo();
+        BOOST_ASSERT(info);
+        MYSQL* handle = connection->getHandle();
+        if (mysql_real_connect(handle,
+                               info->getHost().c_str(),
+                               info->getUserName().c_str(),
+                               info->getUserPwd().c_str(),
+                               info->getDBName().c_str(),
+                               info->getPort(),
+                               NULL, CLIENT_MULTI_STATEMENTS) != NULL &&
+            mysql_query(handle, "SET NAMES 'utf8'") == 0)
+        {
+            Locker lock(&m_lock);
+            m_stat.m_connects++;
+            m_backoff = 0;
+            m_next_attempt = 0;
+            return connection.release();
+        }
+
+        // connection error
+        displayError(m_factory, mysql_error(handle), std::string());
+
+        Locker lock(&m_lock);
+        m_stat.m_failures++;
+        m_backoff = (m_backoff == 0) ? DB_RECONNECT_MIN_INTERVAL :
+            std::min(m_backoff * 2, DB_RECONNECT_MAX_INTERVAL);
+        m_next_attempt = time(NULL) + m_backoff;
+    }
+    catch(const std::exception& err)
+    {
+        klk_log(KLKLOG_ERROR, "Error while connecting to MySQL DB: %s",
+                err.what());
     }
     catch(...)
     {
         klk_log(KLKLOG_ERROR,
-                "Error detected while display MySQL error message");
+                "Unknown error while connecting to MySQL DB");
     }
+
+    return NULL;
+}
+
+//
+// DB class
+//
+
+// Constructor
+// @param[in] config - the config interface
+DB::DB(IFactory* factory):
+    m_factory(factory), m_connection(NULL), m_hostuuid("")
+{
+    BOOST_ASSERT(m_factory);
+}
+
+// Destructor
+DB::~DB()
+{
+    disconnect();
+}
+
+// Connects to the DB
+void DB::connect()
+{
+    if (m_connection == NULL)
+    {
+        m_connection = m_factory->getDBPool()->checkout();
+    }
+    BOOST_ASSERT(m_connection);
+}
+
+// Returns the connection to the pool
+void DB::disconnect() throw()
+{
+    if (m_connection)
+    {
+        m_factory->getDBPool()->checkin(m_connection);
+        m_connection = NULL;
+    }
+}
+
+// Retrives the connection handle
+MYSQL* DB::getHandle() throw()
+{
+    BOOST_ASSERT(m_connection);
+    return m_connection->getHandle();
+}
+
+// Sends an error message to our log
+void DB::dispResult(const std::string& query) throw()
+{
+    displayError(m_factory, mysql_error(getHandle()), query);
 }
 
 
@@ -382,10 +710,10 @@ const Result DB::callSimple(const std::string& query,
     // go throught all statements up to result
     for (u_int i = 0; i < params.get()->size(); i++)
     {
-        int qr = mysql_next_result(&m_dbhandle);
+        int qr = mysql_next_result(getHandle());
         if (qr != 0)
         {
-            const std::string error = mysql_error(&m_dbhandle);
+            const std::string error = mysql_error(getHandle());
             throw klk::Exception(__FILE__, __LINE__,
                                  "Incomplete DB response. "
                                  "Total parameters: %u. "
@@ -401,9 +729,9 @@ const Result DB::callSimple(const std::string& query,
     ResultVector rv;
     int qr = 0;
     while (qr == 0)
-        qr = mysql_next_result(&m_dbhandle);
+        qr = mysql_next_result(getHandle());
     // process answers stored procedure output
-    MYSQL_RES* res = mysql_store_result(&m_dbhandle);
+    MYSQL_RES* res = mysql_store_result(getHandle());
     BOOST_ASSERT(res);
     Answer answer(res);
     klk::Result rc = answer.fetchRow();
@@ -414,10 +742,11 @@ const Result DB::callSimple(const std::string& query,
 
     qr = 0;
     while (qr == 0)
-        qr = mysql_next_result(&m_dbhandle);
+        qr = mysql_next_result(getHandle());
 
     // last one (just a check)
     BOOST_ASSERT(qr == -1);
+    m_connection->setPending(false);
 
     return result;
 }
@@ -437,10 +766,10 @@ const ResultVector DB::callSelect(const std::string& query,
     // go throught all statements up to result
     for (u_int i = 0; i < params.get()->size(); i++)
     {
-        int qr = mysql_next_result(&m_dbhandle);
+        int qr = mysql_next_result(getHandle());
         if (qr != 0)
         {
-            const std::string error = mysql_error(&m_dbhandle);
+            const std::string error = mysql_error(getHandle());
             throw klk::Exception(__FILE__, __LINE__,
                                  "mysql_next_result() failed "
                                  "Res: %d. "
@@ -453,7 +782,7 @@ const ResultVector DB::callSelect(const std::string& query,
     }
 
     // is there select?
-    MYSQL_RES* res = mysql_store_result(&m_dbhandle);
+    MYSQL_RES* res = mysql_store_result(getHandle());
     BOOST_ASSERT(res);
     Answer answer(res);
     ResultVector rv;
@@ -466,9 +795,9 @@ const ResultVector DB::callSelect(const std::string& query,
     {
         int qr = 0;
         while (qr == 0)
-            qr = mysql_next_result(&m_dbhandle);
+            qr = mysql_next_result(getHandle());
         // process answers stored procedure output
-        MYSQL_RES* res = mysql_store_result(&m_dbhandle);
+        MYSQL_RES* res = mysql_store_result(getHandle());
         BOOST_ASSERT(res);
         Answer answer(res);
         if (result)
@@ -483,15 +812,59 @@ const ResultVector DB::callSelect(const std::string& query,
 
     int qr = 0;
     while (qr == 0)
-        qr = mysql_next_result(&m_dbhandle);
+        qr = mysql_next_result(getHandle());
 
     // last one (just a check)
     BOOST_ASSERT(qr == -1);
+    m_connection->setPending(false);
 
     return rv;
 }
 
 
+// Executes a stored procedure with a prepared statement
+const ResultVector DB::callPrepared(const std::string& query,
+                                    const Parameters& params,
+                                    Result* result)
+{
+    BOOST_ASSERT(query.empty() == false);
+    connect();
+
+    ResultVector rv;
+    for (int attempt = 0; ; attempt++)
+    {
+        // the results should be read before the connection reuse
+        m_connection->setPending(true);
+        Statement* statement = m_connection->getStatement(query);
+        BOOST_ASSERT(statement);
+        rv.clear();
+        if (statement->execute(params, rv, result) == klk::OK)
+        {
+            break;
+        }
+
+        const unsigned int error = statement->getErrno();
+        if (attempt == 0 &&
+            (error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR ||
+             error == ER_SERVER_SHUTDOWN))
+        {
+            // the pending connection is closed at the checkin
+            // retry once with a fresh one
+            disconnect();
+            connect();
+            continue;
+        }
+
+        displayError(m_factory, statement->getError(), query);
+        throw klk::Exception(__FILE__, __LINE__,
+                             "DB error while execute the prepared "
+                             "statement: " + query);
+    }
+    m_connection->setPending(false);
+
+    return rv;
+}
+
 // Gets result
 const Result DB::getResult(const Answer& answer)
 {
@@ -517,16 +890,22 @@ const Result DB::getResult(const Answer& answer)
 void DB::safeQuery(const std::string& query)
 {
     BOOST_ASSERT(query.empty() == false);
-    int rc = mysql_real_query(&m_dbhandle, query.c_str(), query.size());
+    connect();
+    // the results should be read before the connection reuse
+    m_connection->setPending(true);
+    int rc = mysql_real_query(getHandle(), query.c_str(), query.size());
     if (rc)
     {
-	if ((mysql_errno(&m_dbhandle) == CR_SERVER_LOST) ||
-	    (mysql_errno(&m_dbhandle) == CR_SERVER_GONE_ERROR ) ||
-	    (mysql_errno(&m_dbhandle) == ER_SERVER_SHUTDOWN))
+	if ((mysql_errno(getHandle()) == CR_SERVER_LOST) ||
+	    (mysql_errno(getHandle()) == CR_SERVER_GONE_ERROR ) ||
+	    (mysql_errno(getHandle()) == ER_SERVER_SHUTDOWN))
 	{
-	    // sleep 5 sec.
-	    usleep(5000000);
-	    rc = mysql_real_query(&m_dbhandle, query.c_str(), query.size());
+            // the pending connection is closed at the checkin
+            // retry once with a fresh one
+            disconnect();
+            connect();
+            m_connection->setPending(true);
+	    rc = mysql_real_query(getHandle(), query.c_str(), query.size());
 	}
     }
 
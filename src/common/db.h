@@ -39,13 +39,18 @@
 #define KLK_DB_H
 
 #include <mysql.h>
+#include <pthread.h>
+#include <time.h>
 
 #include <map>
+#include <list>
+#include <vector>
 
 #include "ifactory.h"
 #include "stringlist.h"
 #include "stringwrapper.h"
 #include "errors.h"
+#include "thread.h"
 
 
 namespace klk
@@ -69,6 +74,37 @@ namespace klk
         */
         typedef std::list<Pair> ParameterMap;
 
+        /**
+           @brief Typed parameter value
+
+           The value is bound to a prepared statement
+           (see klk::db::Statement) without string conversion
+        */
+        struct Value
+        {
+            /**
+               Value type
+            */
+            typedef enum
+            {
+                NULLVALUE = 0,
+                STRING = 1,
+                INTEGER = 2
+            } Type;
+
+            Type m_type; ///< the value type
+            std::string m_string; ///< the string value
+            long long m_integer; ///< the integer value
+
+            /// Constructor
+            Value() : m_type(NULLVALUE), m_string(), m_integer(0){}
+        };
+
+        /**
+           Typed parameters values in the parameters order
+        */
+        typedef std::vector<Value> ValueVector;
+
         /**
            @brief Class that holds sql query params
 
@@ -94,6 +130,14 @@ namespace klk
             */
             const ParameterMap* get() const throw() {return &m_params;}
 
+            /**
+               Gets typed values of parameters
+
+               @return the values in the same order as
+               klk::db::Parameters::get returns the parameters
+            */
+            const ValueVector* getValues() const throw() {return &m_values;}
+
             /**
                Adds a std::string as a parameter
 
@@ -133,9 +177,10 @@ namespace klk
             /**
                Clears parameters list
             */
-            void clear() throw(){m_params.clear();}
+            void clear() throw(){m_params.clear(); m_values.clear();}
         private:
             ParameterMap m_params; ///< parameters
+            ValueVector m_values; ///< typed values
 
             /**
                Checks the key
@@ -301,10 +346,267 @@ namespace klk
             MYSQL_FIELD* m_fields; // result fields
         };
 
+        /**
+           Pooled connections health check interval (in seconds).
+           A connection that was idle longer is pinged before usage
+        */
+        const time_t DB_POOL_CHECK_INTERVAL = 30;
+
+        /**
+           Idle connections are closed after the interval (in seconds)
+        */
+        const time_t DB_POOL_IDLE_TIMEOUT = 300;
+
+        /**
+           Max idle connections count for a thread
+        */
+        const size_t DB_POOL_THREAD_IDLE_MAX = 2;
+
+        /**
+           Min interval between connection attempts after an error
+           (in seconds)
+        */
+        const time_t DB_RECONNECT_MIN_INTERVAL = 1;
+
+        /**
+           Max interval between connection attempts after an error
+           (in seconds)
+        */
+        const time_t DB_RECONNECT_MAX_INTERVAL = 30;
+
+        class Statement;
+
+        /**
+           @brief Pooled MySQL connection
+
+           The connection belongs to the thread that has created it
+        */
+        class PooledConnection
+        {
+        public:
+            /**
+               Constructor
+            */
+            PooledConnection();
+
+            /**
+               Destructor
+            */
+            ~PooledConnection();
+
+            /**
+               Retrives the MySQL handle
+
+               @return the handle
+            */
+            MYSQL* getHandle() throw(){return &m_handle;}
+
+            /**
+               Retrives the thread that owns the connection
+
+               @return the thread id
+            */
+            const pthread_t getThread() const throw(){return m_thread;}
+
+            /**
+               Retrives the last usage time
+
+               @return the time
+            */
+            const time_t getLastTime() const throw(){return m_last_time;}
+
+            /**
+               Updates the last usage time
+            */
+            void touch() throw(){m_last_time = time(NULL);}
+
+            /**
+               Checks is there an incomplete query at the connection
+
+               @return
+               - true - the connection can not be reused
+               - false
+            */
+            const bool isPending() const throw(){return m_pending;}
+
+            /**
+               Sets the incomplete query flag
+
+               @param[in] value - the value to be set
+            */
+            void setPending(bool value) throw(){m_pending = value;}
+
+            /**
+               Retrives the prepared statement for a stored procedure.
+               The statement is created at the first call and kept
+               while the connection is alive
+
+               @param[in] procedure - the stored procedure name
+
+               @return the statement
+            */
+            Statement* getStatement(const std::string& procedure);
+        private:
+            /**
+               Prepared statements by procedure names
+            */
+            typedef std::map<std::string, Statement*> StatementMap;
+
+            MYSQL m_handle; ///< MySQL handle
+            const pthread_t m_thread; ///< the owner thread
+            time_t m_last_time; ///< last usage time
+            bool m_pending; ///< there is an incomplete query
+            StatementMap m_statements; ///< prepared statements
+        private:
+            /**
+               Copy constructor
+            */
+            PooledConnection(const PooledConnection&);
+
+            /**
+               Assignment opearator
+            */
+            PooledConnection& operator=(const PooledConnection&);
+        };
+
+        /**
+           @brief Connections pool statistics
+        */
+        struct PoolStat
+        {
+            u_long m_checkouts; ///< checkouts count
+            u_long m_connects; ///< new connections count
+            u_long m_failures; ///< failed connection attempts count
+            double m_wait_total; ///< total checkout wait time (seconds)
+            double m_wait_max; ///< max checkout wait time (seconds)
+            size_t m_idle; ///< idle connections count
+            size_t m_busy; ///< checked out connections count
+
+            /// Constructor
+            PoolStat() : m_checkouts(0), m_connects(0), m_failures(0),
+                m_wait_total(0.0), m_wait_max(0.0), m_idle(0), m_busy(0){}
+        };
+
+        /**
+           @brief Process-wide MySQL connections pool
+
+           The pool keeps idle connections per thread: each thread
+           does mysql_thread_init() at start (see klk::base::Scheduler)
+           and gets back the connections it has created. Connections
+           that were idle for a long time are pinged before usage and
+           closed after klk::db::DB_POOL_IDLE_TIMEOUT. Connection
+           errors are followed by reconnect attempts with an exponential
+           backoff that is shared by all threads.
+        */
+        class ConnectionPool
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] factory - the factory interface
+            */
+            explicit ConnectionPool(IFactory* factory);
+
+            /**
+               Destructor
+            */
+            ~ConnectionPool();
+
+            /**
+               Retrives a connection for the calling thread. A new
+               connection is created if there is no idle one
+
+               @return the connection
+
+               @exception klk::Exception - the application is being
+               stopped and the DB is not available
+            */
+            PooledConnection* checkout();
+
+            /**
+               Returns the connection to the pool
+
+               @param[in] connection - the connection
+            */
+            void checkin(PooledConnection* connection) throw();
+
+            /**
+               Retrives the pool statistics
+
+               @return the statistics
+            */
+            const PoolStat getStat() const;
+        private:
+            /**
+               Connections list
+            */
+            typedef std::list<PooledConnection*> ConnectionList;
+
+            /**
+               Idle connections per thread
+            */
+            typedef std::map<pthread_t, ConnectionList> ThreadMap;
+
+            IFactory* const m_factory; ///< the factory
+            mutable klk::Mutex m_lock; ///< locker
+            ThreadMap m_idle; ///< idle connections
+            time_t m_check_time; ///< last idle timeout check time
+            time_t m_next_attempt; ///< next connection attempt time
+            time_t m_backoff; ///< current reconnect interval
+            PoolStat m_stat; ///< statistics
+
+            /**
+               Retrives an idle connection of the calling thread
+
+               @return the connection or NULL if there is no such one
+            */
+            PooledConnection* getIdle() throw();
+
+            /**
+               Checks an idle connection
+
+               @param[in] connection - the connection
+
+               @return
+               - true - the connection is alive
+               - false - the connection was lost
+            */
+            const bool check(PooledConnection* connection) throw();
+
+            /**
+               Creates a new connection. Does attempts until success
+
+               @return the connection
+
+               @exception klk::Exception
+            */
+            PooledConnection* connect();
+
+            /**
+               Does a connection attempt
+
+               @return the connection or NULL if there was an error
+            */
+            PooledConnection* tryConnect() throw();
+        private:
+            /**
+               Copy constructor
+            */
+            ConnectionPool(const ConnectionPool&);
+
+            /**
+               Assignment opearator
+            */
+            ConnectionPool& operator=(const ConnectionPool&);
+        };
+
         /**
            @brief The DB interface
 
-           The DB interface
+           The DB interface. The MySQL connection is taken from
+           klk::db::ConnectionPool at klk::db::DB::connect and returned
+           back at the destructor
         */
         class DB
         {
@@ -363,6 +665,26 @@ namespace klk
                                           const Parameters& params,
                                           Result* result);
 
+            /**
+               Executes a stored procedure with a prepared statement
+
+               The statement is prepared once per connection and the
+               parameters are sent with the binary protocol. The result
+               is the same as klk::db::DB::callSelect gives
+
+               @param[in] query - the stored procedure name
+               @param[in] params - the parameters
+               @param[out] result - the pointer to the output parameters
+               can be NULL - this means to don't store them
+
+               @return the first select result
+
+               @exception @ref klk::Exception
+            */
+            const ResultVector callPrepared(const std::string& query,
+                                            const Parameters& params,
+                                            Result* result);
+
             /**
                Gets mediaserver host UUID
 
@@ -382,10 +704,16 @@ namespace klk
             void reset() throw();
         private:
             IFactory * const m_factory; ///< the config interface
-            MYSQL m_dbhandle; ///< MySQL DB's handle
-            MYSQL *m_connection; ///< connection handle
+            PooledConnection *m_connection; ///< the pooled connection
             std::string m_hostuuid; ///< mediaserver host's uuid
 
+            /**
+               Retrives the connection handle
+
+               @return the handle
+            */
+            MYSQL* getHandle() throw();
+
             /**
                Sends an error message to our log
 
@@ -427,7 +755,7 @@ namespace klk
             const Result getResult(const Answer& answer);
 
             /**
-               Disconnects from the DB
+               Returns the connection to the pool
             */
             void disconnect() throw();
         private:
@@ -0,0 +1,169 @@
+/**
+   @file dbchange.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <boost/lexical_cast.hpp>
+
+#include "dbchange.h"
+#include "exception.h"
+
+using namespace klk;
+using namespace klk::db;
+
+//
+// ChangeSet class
+//
+
+// Constructor
+ChangeSet::ChangeSet() :
+    m_changes(), m_full(false)
+{
+}
+
+// Constructor
+ChangeSet::ChangeSet(const IMessagePtr& msg) :
+    m_changes(), m_full(false)
+{
+    BOOST_ASSERT(msg);
+    if (!msg->hasValue(msg::key::DBCHANGECOUNT))
+    {
+        m_full = true;
+        return;
+    }
+
+    const StringList uuids = msg->getList(msg::key::DBCHANGEUUID);
+    const StringList types = msg->getList(msg::key::DBCHANGEOPERATION);
+    const StringList tables = msg->getList(msg::key::DBCHANGETABLE);
+    const long long count = msg->getInteger(msg::key::DBCHANGECOUNT);
+    if (uuids.size() != types.size() || uuids.size() != tables.size() ||
+        static_cast<long long>(uuids.size()) != count)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Incorrect DB change message. Count: %lld, "
+                        "UUIDs: %u, operations: %u, tables: %u",
+                        count, uuids.size(), types.size(), tables.size());
+    }
+
+    StringList::const_iterator type = types.begin();
+    StringList::const_iterator table = tables.begin();
+    for (StringList::const_iterator uuid = uuids.begin();
+         uuid != uuids.end(); uuid++, type++, table++)
+    {
+        add(*table, *uuid,
+            static_cast<ChangeType>(boost::lexical_cast<int>(*type)));
+    }
+}
+
+// Destructor
+ChangeSet::~ChangeSet()
+{
+}
+
+// Adds a change
+void ChangeSet::add(const std::string& table, const std::string& uuid,
+                    ChangeType type)
+{
+    if (uuid.empty() ||
+        (type != CHANGE_INSERT && type != CHANGE_UPDATE &&
+         type != CHANGE_DELETE))
+    {
+        // the row is unknown
+        m_full = true;
+        return;
+    }
+
+    // the last operation wins
+    Change& change = m_changes[uuid];
+    change.m_table = table;
+    change.m_type = type;
+}
+
+// Retrives the inserted and updated rows uuids
+const StringList ChangeSet::getChanged() const
+{
+    StringList result;
+    for (ChangeMap::const_iterator i = m_changes.begin();
+         i != m_changes.end(); i++)
+    {
+        if (i->second.m_type != CHANGE_DELETE)
+        {
+            result.push_back(i->first);
+        }
+    }
+    return result;
+}
+
+// Retrives the deleted rows uuids
+const StringList ChangeSet::getDeleted() const
+{
+    StringList result;
+    for (ChangeMap::const_iterator i = m_changes.begin();
+         i != m_changes.end(); i++)
+    {
+        if (i->second.m_type == CHANGE_DELETE)
+        {
+            result.push_back(i->first);
+        }
+    }
+    return result;
+}
+
+// Puts the set into a message
+void ChangeSet::fillMessage(const IMessagePtr& msg) const
+{
+    BOOST_ASSERT(msg);
+    if (m_full)
+    {
+        // the message without the changes requires the full reload
+        return;
+    }
+
+    StringList uuids, types, tables;
+    for (ChangeMap::const_iterator i = m_changes.begin();
+         i != m_changes.end(); i++)
+    {
+        uuids.push_back(i->first);
+        types.push_back(boost::lexical_cast<std::string>(
+                            static_cast<int>(i->second.m_type)));
+        tables.push_back(i->second.m_table);
+    }
+
+    msg->setData(msg::key::DBCHANGEUUID, uuids);
+    msg->setData(msg::key::DBCHANGEOPERATION, types);
+    msg->setData(msg::key::DBCHANGETABLE, tables);
+    msg->setData(msg::key::DBCHANGECOUNT,
+                 static_cast<long long>(uuids.size()));
+}
@@ -0,0 +1,188 @@
+/**
+   @file dbchange.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_DBCHANGE_H
+#define KLK_DBCHANGE_H
+
+#include <map>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "imessage.h"
+#include "stringlist.h"
+
+namespace klk
+{
+    namespace db
+    {
+        /** @addtogroup grDB
+            @{
+        */
+
+        /**
+           DB row change operation. The values are the same as
+           klk_log.operation column keeps
+        */
+        typedef enum
+        {
+            CHANGE_UNKNOWN = 0,
+            CHANGE_INSERT = 1,
+            CHANGE_UPDATE = 2,
+            CHANGE_DELETE = 3
+        } ChangeType;
+
+        /**
+           @brief Changes of DB rows for a module
+
+           The set is filled by @ref grCheckDB "DB checker" from the
+           klk_log table and is sent to a module with
+           klk::msg::id::CHANGEDB message. Only the last operation is kept
+           for a row. A change that can not be identified (the row uuid
+           is unknown) makes the full data reload necessary
+        */
+        class ChangeSet
+        {
+        public:
+            /**
+               Constructor. Creates an empty set
+            */
+            ChangeSet();
+
+            /**
+               Constructor. Reads the set from a message
+
+               @param[in] msg - the message
+
+               @note a message without the changes list
+               (for instance klk::msg::id::INITFROMDB) gives the full set
+
+               @exception klk::Exception
+            */
+            explicit ChangeSet(const IMessagePtr& msg);
+
+            /**
+               Destructor
+            */
+            ~ChangeSet();
+
+            /**
+               Adds a change
+
+               @param[in] table - the table name
+               @param[in] uuid - the row uuid (can be empty)
+               @param[in] type - the operation
+            */
+            void add(const std::string& table, const std::string& uuid,
+                     ChangeType type);
+
+            /**
+               Marks the set as the full data reload request
+            */
+            void setFull() throw(){m_full = true;}
+
+            /**
+               Is the full data reload necessary or not
+
+               @return
+               - true - the changes are unknown
+               - false - only the rows from the set were changed
+            */
+            const bool isFull() const throw(){return m_full;}
+
+            /**
+               Retrives the inserted and updated rows uuids
+
+               @return the list
+            */
+            const StringList getChanged() const;
+
+            /**
+               Retrives the deleted rows uuids
+
+               @return the list
+            */
+            const StringList getDeleted() const;
+
+            /**
+               Retrives the changes count
+
+               @return the count
+            */
+            const size_t size() const throw(){return m_changes.size();}
+
+            /**
+               Puts the set into a message
+
+               @param[in] msg - the message
+            */
+            void fillMessage(const IMessagePtr& msg) const;
+        private:
+            /**
+               Row change
+            */
+            struct Change
+            {
+                std::string m_table; ///< the table name
+                ChangeType m_type; ///< the operation
+            };
+
+            /**
+               Changes by rows uuids
+            */
+            typedef std::map<std::string, Change> ChangeMap;
+
+            ChangeMap m_changes; ///< the changes
+            bool m_full; ///< the full reload flag
+        private:
+            /**
+               Copy constructor
+            */
+            ChangeSet(const ChangeSet&);
+
+            /**
+               Assignment opearator
+            */
+            ChangeSet& operator=(const ChangeSet&);
+        };
+
+        /**
+           Smart pointer for the changes set
+        */
+        typedef boost::shared_ptr<ChangeSet> ChangeSetPtr;
+
+        /** @} */
+    }
+}
+
+#endif //KLK_DBCHANGE_H
@@ -0,0 +1,406 @@
+/**
+   @file dbstatement.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <boost/shared_ptr.hpp>
+
+#include "dbstatement.h"
+#include "exception.h"
+#include "log.h"
+
+using namespace klk::db;
+
+//
+// Statement class
+//
+
+// Constructor
+Statement::Statement(MYSQL* handle, const std::string& procedure) :
+    m_handle(handle), m_procedure(procedure), m_stmt(NULL), m_outputs(),
+    m_param_bind(), m_param_length(), m_param_null(), m_columns(),
+    m_result_bind(), m_errno(0), m_error()
+{
+    BOOST_ASSERT(m_handle);
+    BOOST_ASSERT(m_procedure.empty() == false);
+}
+
+// Destructor
+Statement::~Statement()
+{
+    if (m_stmt)
+    {
+        mysql_stmt_close(m_stmt);
+        m_stmt = NULL;
+    }
+}
+
+// Executes the statement
+klk::Result Statement::execute(const Parameters& params,
+                               ResultVector& rows, Result* result)
+{
+    m_errno = 0;
+    m_error.clear();
+
+    if (m_stmt == NULL && prepare() != klk::OK)
+    {
+        return klk::ERROR;
+    }
+
+    if (params.getValues()->size() != m_outputs.size())
+    {
+        throw klk::Exception(__FILE__, __LINE__,
+                             "Wrong parameters count for '%s': %u. "
+                             "Expected: %u",
+                             m_procedure.c_str(),
+                             params.getValues()->size(),
+                             m_outputs.size());
+    }
+
+    if (bindParams(params) != klk::OK)
+    {
+        return klk::ERROR;
+    }
+
+    if (mysql_stmt_execute(m_stmt) != 0)
+    {
+        return setError();
+    }
+
+    // the output parameters come as a separate result set
+    // marked with SERVER_PS_OUT_PARAMS status
+    const KeyVector outputs = getOutputKeys(params);
+    const KeyVector names;
+    bool first = true;
+    int status = 0;
+    do
+    {
+        if (mysql_stmt_field_count(m_stmt) > 0)
+        {
+            if (m_handle->server_status & SERVER_PS_OUT_PARAMS)
+            {
+                ResultVector out;
+                if (fetch(out, outputs) != klk::OK)
+                {
+                    return klk::ERROR;
+                }
+                if (result && !out.empty())
+                {
+                    *result = out.front();
+                }
+            }
+            else if (first)
+            {
+                first = false;
+                if (fetch(rows, names) != klk::OK)
+                {
+                    return klk::ERROR;
+                }
+            }
+            else
+            {
+                // only the first select is returned (see DB::callSelect)
+                ResultVector skip;
+                if (fetch(skip, names) != klk::OK)
+                {
+                    return klk::ERROR;
+                }
+            }
+        }
+        status = mysql_stmt_next_result(m_stmt);
+    }
+    while (status == 0);
+
+    if (status > 0)
+    {
+        return setError();
+    }
+
+    return klk::OK;
+}
+
+// Prepares the statement
+klk::Result Statement::prepare() throw()
+{
+    BOOST_ASSERT(m_stmt == NULL);
+
+    if (readModes() != klk::OK)
+    {
+        return klk::ERROR;
+    }
+
+    std::string query = "CALL " + m_procedure + "(";
+    for (size_t i = 0; i < m_outputs.size(); i++)
+    {
+        query += (i == 0) ? "?" : ", ?";
+    }
+    query += ")";
+
+    m_stmt = mysql_stmt_init(m_handle);
+    if (m_stmt == NULL)
+    {
+        m_errno = mysql_errno(m_handle);
+        m_error = mysql_error(m_handle);
+        return klk::ERROR;
+    }
+
+    if (mysql_stmt_prepare(m_stmt, query.c_str(), query.size()) != 0)
+    {
+        setError();
+        mysql_stmt_close(m_stmt);
+        m_stmt = NULL;
+        return klk::ERROR;
+    }
+
+    klk_log(KLKLOG_DEBUG, "SQL statement was prepared: %s", query.c_str());
+    return klk::OK;
+}
+
+// Reads the parameters modes from information_schema
+klk::Result Statement::readModes() throw()
+{
+    m_outputs.clear();
+
+    std::vector<char> name(m_procedure.size() * 2 + 1);
+    mysql_real_escape_string(m_handle, &name[0], m_procedure.c_str(),
+                             m_procedure.size());
+    const std::string query =
+        "SELECT PARAMETER_MODE FROM information_schema.PARAMETERS "
+        "WHERE SPECIFIC_SCHEMA = DATABASE() AND ROUTINE_TYPE = 'PROCEDURE' "
+        "AND SPECIFIC_NAME = '" + std::string(&name[0]) + "' "
+        "ORDER BY ORDINAL_POSITION";
+    if (mysql_real_query(m_handle, query.c_str(), query.size()) != 0)
+    {
+        m_errno = mysql_errno(m_handle);
+        m_error = mysql_error(m_handle);
+        return klk::ERROR;
+    }
+
+    MYSQL_RES* res = mysql_store_result(m_handle);
+    if (res == NULL)
+    {
+        m_errno = mysql_errno(m_handle);
+        m_error = mysql_error(m_handle);
+        return klk::ERROR;
+    }
+
+    try
+    {
+        Answer answer(res);
+        while (answer.fetchRow() == klk::OK)
+        {
+            const char* mode = answer.getColumn(0);
+            m_outputs.push_back(mode != NULL && std::string(mode) != "IN");
+        }
+    }
+    catch(const std::exception& err)
+    {
+        m_errno = 0;
+        m_error = err.what();
+        return klk::ERROR;
+    }
+
+    return klk::OK;
+}
+
+// Binds the parameters
+klk::Result Statement::bindParams(const Parameters& params)
+{
+    const ValueVector* values = params.getValues();
+    const size_t count = values->size();
+    if (count == 0)
+    {
+        return klk::OK;
+    }
+
+    // the buffers are reused by next executions
+    m_param_bind.assign(count, MYSQL_BIND());
+    m_param_length.resize(count);
+    m_param_null.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Value& value = (*values)[i];
+        MYSQL_BIND& bind = m_param_bind[i];
+        m_param_null[i] = (value.m_type == Value::NULLVALUE);
+        bind.is_null = &m_param_null[i];
+        switch (value.m_type)
+        {
+        case Value::STRING:
+            m_param_length[i] = value.m_string.size();
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = const_cast<char*>(value.m_string.data());
+            bind.buffer_length = m_param_length[i];
+            bind.length = &m_param_length[i];
+            break;
+        case Value::INTEGER:
+            bind.buffer_type = MYSQL_TYPE_LONGLONG;
+            bind.buffer = const_cast<long long*>(&value.m_integer);
+            break;
+        default:
+            bind.buffer_type = MYSQL_TYPE_NULL;
+            break;
+        }
+    }
+
+    if (mysql_stmt_bind_param(m_stmt, &m_param_bind[0]) != 0)
+    {
+        return setError();
+    }
+
+    return klk::OK;
+}
+
+// Fetches the current result set
+klk::Result Statement::fetch(ResultVector& rows, const KeyVector& keys)
+{
+    MYSQL_RES* res = mysql_stmt_result_metadata(m_stmt);
+    if (res == NULL)
+    {
+        return setError();
+    }
+    boost::shared_ptr<MYSQL_RES> meta(res, mysql_free_result);
+
+    const size_t count = mysql_num_fields(res);
+    const MYSQL_FIELD* fields = mysql_fetch_fields(res);
+    if (m_columns.size() < count)
+    {
+        m_columns.resize(count);
+    }
+    m_result_bind.assign(count, MYSQL_BIND());
+    for (size_t i = 0; i < count; i++)
+    {
+        bindColumn(i);
+    }
+
+    if (mysql_stmt_bind_result(m_stmt, &m_result_bind[0]) != 0)
+    {
+        mysql_stmt_free_result(m_stmt);
+        return setError();
+    }
+
+    int rc = 0;
+    while ((rc = mysql_stmt_fetch(m_stmt)) == 0 || rc == MYSQL_DATA_TRUNCATED)
+    {
+        bool rebind = false;
+        Result row;
+        for (size_t i = 0; i < count; i++)
+        {
+            const std::string key = (i < keys.size()) ? keys[i] :
+                std::string(fields[i].name);
+            Column& column = m_columns[i];
+            if (column.m_null)
+            {
+                row.push_back_null(key);
+                continue;
+            }
+
+            if (column.m_length > column.m_buffer.size())
+            {
+                // the value was truncated: the buffer is enlarged
+                // and kept for next rows and executions
+                column.m_buffer.resize(column.m_length);
+                bindColumn(i);
+                rebind = true;
+                if (mysql_stmt_fetch_column(m_stmt, &m_result_bind[i],
+                                            i, 0) != 0)
+                {
+                    mysql_stmt_free_result(m_stmt);
+                    return setError();
+                }
+            }
+
+            row.push_back(key, std::string(&column.m_buffer[0],
+                                           column.m_length));
+        }
+        rows.push_back(row);
+
+        if (rebind && mysql_stmt_bind_result(m_stmt, &m_result_bind[0]) != 0)
+        {
+            mysql_stmt_free_result(m_stmt);
+            return setError();
+        }
+    }
+
+    mysql_stmt_free_result(m_stmt);
+    if (rc != MYSQL_NO_DATA)
+    {
+        return setError();
+    }
+
+    return klk::OK;
+}
+
+// Binds a result column to its buffer
+void Statement::bindColumn(size_t index) throw()
+{
+    BOOST_ASSERT(index < m_columns.size());
+    BOOST_ASSERT(index < m_result_bind.size());
+
+    Column& column = m_columns[index];
+    MYSQL_BIND& bind = m_result_bind[index];
+    bind.buffer_type = MYSQL_TYPE_STRING;
+    bind.buffer = &column.m_buffer[0];
+    bind.buffer_length = column.m_buffer.size();
+    bind.length = &column.m_length;
+    bind.is_null = &column.m_null;
+    bind.error = &column.m_error;
+}
+
+// Retrives the output parameters keys
+const Statement::KeyVector
+Statement::getOutputKeys(const Parameters& params) const
+{
+    KeyVector keys;
+    size_t i = 0;
+    for (ParameterMap::const_iterator param = params.get()->begin();
+         param != params.get()->end() && i < m_outputs.size();
+         param++, i++)
+    {
+        if (m_outputs[i])
+        {
+            keys.push_back(param->first);
+        }
+    }
+    return keys;
+}
+
+// Stores the statement error
+klk::Result Statement::setError() throw()
+{
+    BOOST_ASSERT(m_stmt);
+    m_errno = mysql_stmt_errno(m_stmt);
+    m_error = mysql_stmt_error(m_stmt);
+    return klk::ERROR;
+}
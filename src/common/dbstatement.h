@@ -0,0 +1,235 @@
+/**
+   @file dbstatement.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_DBSTATEMENT_H
+#define KLK_DBSTATEMENT_H
+
+#include <mysql.h>
+
+#include <string>
+#include <vector>
+
+#include "db.h"
+
+namespace klk
+{
+    namespace db
+    {
+        /**
+           Initial size of a result column buffer. The buffer grows
+           when a longer value is fetched
+        */
+        const size_t STATEMENT_COLUMN_SIZE = 256;
+
+        /**
+           @brief Prepared statement for a stored procedure call
+
+           The statement is "CALL procedure(?, ..., ?)". Parameter modes
+           (IN, OUT or INOUT) are read from information_schema at the
+           preparation. The output parameters are returned by the server
+           as a separate result set and they are put into the result
+           with the keys from klk::db::Parameters.
+
+           Parameter and result binding buffers are kept between
+           executions thus a repeated call does not allocate them.
+
+           @note the statement belongs to the connection
+           (see klk::db::PooledConnection::getStatement)
+        */
+        class Statement
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] handle - the connection handle
+               @param[in] procedure - the stored procedure name
+            */
+            Statement(MYSQL* handle, const std::string& procedure);
+
+            /**
+               Destructor
+            */
+            ~Statement();
+
+            /**
+               Executes the statement. The statement is prepared at the
+               first call
+
+               @param[in] params - the parameters
+               @param[out] rows - the first select result
+               @param[out] result - the output parameters (can be NULL)
+
+               @return
+               - klk::OK
+               - klk::ERROR - see klk::db::Statement::getErrno and
+               klk::db::Statement::getError for details
+            */
+            klk::Result execute(const Parameters& params,
+                                ResultVector& rows, Result* result);
+
+            /**
+               Retrives the last error code
+
+               @return the code
+            */
+            const unsigned int getErrno() const throw(){return m_errno;}
+
+            /**
+               Retrives the last error message
+
+               @return the message
+            */
+            const std::string getError() const throw(){return m_error;}
+        private:
+            /**
+               Result column buffer
+            */
+            struct Column
+            {
+                std::vector<char> m_buffer; ///< the data
+                unsigned long m_length; ///< the data length
+                my_bool m_null; ///< is the value NULL
+                my_bool m_error; ///< truncation flag
+
+                /// Constructor
+                Column() : m_buffer(STATEMENT_COLUMN_SIZE), m_length(0),
+                    m_null(0), m_error(0){}
+            };
+
+            /**
+               Column buffers
+            */
+            typedef std::vector<Column> ColumnVector;
+
+            /**
+               Result keys
+            */
+            typedef std::vector<std::string> KeyVector;
+
+            /**
+               Binding structures
+            */
+            typedef std::vector<MYSQL_BIND> BindVector;
+
+            MYSQL* const m_handle; ///< the connection handle
+            const std::string m_procedure; ///< the procedure name
+            MYSQL_STMT* m_stmt; ///< the statement handle
+            std::vector<bool> m_outputs; ///< output parameters flags
+            BindVector m_param_bind; ///< parameters binding
+            std::vector<unsigned long> m_param_length; ///< string lengths
+            std::vector<my_bool> m_param_null; ///< NULL flags
+            ColumnVector m_columns; ///< result columns
+            BindVector m_result_bind; ///< result binding
+            unsigned int m_errno; ///< last error code
+            std::string m_error; ///< last error message
+
+            /**
+               Prepares the statement
+
+               @return
+               - klk::OK
+               - klk::ERROR
+            */
+            klk::Result prepare() throw();
+
+            /**
+               Reads the parameters modes from information_schema
+
+               @return
+               - klk::OK
+               - klk::ERROR
+            */
+            klk::Result readModes() throw();
+
+            /**
+               Binds the parameters
+
+               @param[in] params - the parameters
+
+               @return
+               - klk::OK
+               - klk::ERROR
+            */
+            klk::Result bindParams(const Parameters& params);
+
+            /**
+               Fetches the current result set
+
+               @param[out] rows - the rows
+               @param[in] keys - the result keys. Column names are used
+               if the list is empty
+
+               @return
+               - klk::OK
+               - klk::ERROR
+            */
+            klk::Result fetch(ResultVector& rows, const KeyVector& keys);
+
+            /**
+               Binds a result column to its buffer
+
+               @param[in] index - the column index
+            */
+            void bindColumn(size_t index) throw();
+
+            /**
+               Retrives the output parameters keys
+
+               @param[in] params - the parameters
+
+               @return the keys in the output result set order
+            */
+            const KeyVector getOutputKeys(const Parameters& params) const;
+
+            /**
+               Stores the statement error
+
+               @return klk::ERROR
+            */
+            klk::Result setError() throw();
+        private:
+            /**
+               Copy constructor
+            */
+            Statement(const Statement&);
+
+            /**
+               Assignment opearator
+            */
+            Statement& operator=(const Statement&);
+        };
+    }
+}
+
+#endif //KLK_DBSTATEMENT_H
@@ -73,7 +73,7 @@ Factory::Factory(const char* ident) :
     m_lock(),
     m_module_factory(NULL), m_message_factory(NULL),
     m_resources(NULL), m_config(NULL),
-    m_snmp(NULL), m_stop()
+    m_snmp(NULL), m_dbpool(NULL), m_timerwheel(NULL), m_stop()
 {
     // open log
     klk_open_log(ident);
@@ -116,8 +116,12 @@ Factory::~Factory()
     KLKDELETE(m_resources);
     KLKDELETE(m_snmp);
     KLKDELETE(m_module_factory); // module factory first
+    // the timer callbacks can use all objects below
+    KLKDELETE(m_timerwheel);
     KLKDELETE(m_message_factory);
     KLKDELETE(m_config);
+    // the connections can be used by all objects above
+    KLKDELETE(m_dbpool);
 
     KLKASSERT(m_config == NULL);
     KLKASSERT(m_resources == NULL);
@@ -231,6 +235,30 @@ ISNMP* Factory::getSNMP()
     return m_snmp;
 }
 
+// Gets the process-wide DB connections pool
+db::ConnectionPool* Factory::getDBPool()
+{
+    Locker lock(&m_lock);
+    if (m_dbpool == NULL)
+    {
+        m_dbpool = new db::ConnectionPool(this);
+    }
+    BOOST_ASSERT(m_dbpool);
+    return m_dbpool;
+}
+
+// Gets the process-wide timer service
+TimerWheel* Factory::getTimerWheel()
+{
+    Locker lock(&m_lock);
+    if (m_timerwheel == NULL)
+    {
+        m_timerwheel = new TimerWheel();
+    }
+    BOOST_ASSERT(m_timerwheel);
+    return m_timerwheel;
+}
+
 /// @copydoc klk::IFactory::getMainModuleId()
 const std::string Factory::getMainModuleId() const
 {
@@ -41,6 +41,7 @@
 #include "ifactory.h"
 #include "thread.h"
 #include "db.h"
+#include "timerwheel.h"
 
 namespace klk
 {
@@ -66,6 +67,16 @@ namespace klk
             */
             virtual ITrigger* getEventTrigger() {return &m_stop;}
 
+            /**
+               @copydoc IFactory::getDBPool()
+            */
+            virtual db::ConnectionPool* getDBPool();
+
+            /**
+               @copydoc IFactory::getTimerWheel()
+            */
+            virtual TimerWheel* getTimerWheel();
+
             /**
                @copydoc IFactory::getConfig()
             */
@@ -92,6 +103,8 @@ namespace klk
         private:
             IConfig* m_config; ///< config interface
             ISNMP* m_snmp; ///< pointer to ISNMP interface
+            db::ConnectionPool* m_dbpool; ///< DB connections pool
+            TimerWheel* m_timerwheel; ///< timer service
             Trigger m_stop; ///< stop trigger
 
 
@@ -335,6 +335,43 @@ namespace klk
         */
         void setHostName(const std::string& hostname);
 
+        /**
+           Sets message trace mode
+
+           @param[in] value - the value to be set (yes/no)
+
+           @exception @ref klk::Exception
+        */
+        void setMessageTrace(const std::string& value);
+
+        /**
+           Sets log level
+
+           @param[in] value - the value to be set (error/warning/info/debug)
+
+           @exception @ref klk::Exception
+        */
+        void setLogLevel(const std::string& value);
+
+        /**
+           Sets log target
+
+           @param[in] value - the value to be set (syslog/stderr/file path)
+
+           @exception @ref klk::Exception
+        */
+        void setLogTarget(const std::string& value);
+
+        /**
+           Sets DVB adapter loops CPU affinity
+
+           @param[in] value - the value to be set
+           (see @ref klk::Affinity for the format)
+
+           @exception @ref klk::Exception
+        */
+        void setDVBAffinity(const std::string& value);
+
         /**
            @copydoc IConfig::setPath()
         */
@@ -378,6 +415,27 @@ namespace klk
         virtual const ISNMPInfo* getSNMPInfo()
             const throw() {return &m_snmpinfo;}
 
+        /// @copydoc IConfig::isMessageTrace()
+        virtual bool isMessageTrace() const throw() {return m_msgtrace;}
+
+        /**
+           Gets log level
+
+           @return the level (KLKLOG_ERROR ... KLKLOG_DEBUG)
+        */
+        int getLogLevel() const throw() {return m_loglevel;}
+
+        /**
+           Gets log target
+
+           @return the target
+        */
+        const std::string getLogTarget() const throw() {return m_logtarget;}
+
+        /// @copydoc IConfig::getDVBAffinity()
+        virtual const std::string getDVBAffinity() const throw()
+        {return m_dvbaffinity;}
+
         /**
            Retrives the options list
 
@@ -390,6 +448,10 @@ namespace klk
         std::string m_config_path; ///< path to config file
         DBInfo m_dbinfo; ///< dbinfo
         SNMPInfo m_snmpinfo; ///< snmp info
+        bool m_msgtrace; ///< message trace mode
+        int m_loglevel; ///< log level
+        std::string m_logtarget; ///< log target
+        std::string m_dvbaffinity; ///< DVB adapter loops affinity
         OptionList m_options; ///< options list
 
         /**
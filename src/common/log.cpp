@@ -51,6 +51,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/wait.h>
+#include <pthread.h>
+#include <sched.h>
+#include <assert.h>
 
 #include "log.h"
 #include "common.h"
@@ -59,55 +62,512 @@
 
 #define MAX_LOGBUFSIZE	2048
 
+// log queue size (should be a power of 2)
+#define LOGQUEUE_SIZE 1024
+
+// the interval (milliseconds) for repeated messages counting
+#define LOGREPEAT_INTERVAL 1000
+
+// max number of same messages from a thread within the interval
+#define LOGREPEAT_MAX 10
+
+// log outputs
+typedef enum
+{
+    LOGTARGET_SYSLOG = 0,
+    LOGTARGET_STDERR = 1,
+    LOGTARGET_FILE = 2
+} LogTarget;
+
+// log queue slot
+typedef struct
+{
+    volatile size_t seq; // slot sequence number
+    int level; // message level
+    char text[MAX_LOGBUFSIZE]; // the message
+} LogSlot;
+
+// per thread log data
+typedef struct
+{
+    char buffer[MAX_LOGBUFSIZE]; // format buffer
+    u_long hash; // last message hash
+    int level; // last message level
+    long long start; // repeat interval start (milliseconds)
+    u_long repeat; // repeat count within the interval
+    u_long suppressed; // suppressed messages count
+} LogThreadData;
+
+// level threshold
+static volatile int s_level = KLKLOG_DEBUG;
+
+// the queue: producers are any threads, the consumer is the writer thread
+static LogSlot s_queue[LOGQUEUE_SIZE];
+static volatile size_t s_tail = 0;
+static volatile size_t s_head = 0;
+
+// writer thread
+static pthread_t s_writer;
+static volatile bool s_running = false;
+static volatile bool s_waiting = false;
+static pthread_mutex_t s_wait_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_wait_cond = PTHREAD_COND_INITIALIZER;
+// producers that saw the writer running and still fill their slots
+static volatile u_long s_producers = 0;
+
+// output
+static pthread_mutex_t s_output_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LogTarget s_target = LOGTARGET_SYSLOG;
+static FILE* s_file = NULL;
+
+// per thread data key
+static pthread_key_t s_key;
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+// statistics
+static volatile u_long s_written = 0;
+static volatile u_long s_dropped = 0;
+static volatile u_long s_suppressed = 0;
+
+// Gets level name
+static const char* klk_log_level_name(int level)
+{
+    switch (level)
+    {
+    case KLKLOG_ERR:
+        return "ERROR";
+    case KLKLOG_WARN:
+        return "WARNING";
+    case KLKLOG_INFO:
+        return "INFO";
+    case KLKLOG_DEBUG:
+        return "DEBUG";
+    default:
+        break;
+    }
+    return "NOTICE";
+}
+
+// Writes a message to the output
+// @param[in] level - the message level
+// @param[in] text - the message
+// @param[in] flush - flush the stream after the write
+static void klk_log_output(int level, const char* text, bool flush)
+{
+    pthread_mutex_lock(&s_output_mutex);
+    if (s_target == LOGTARGET_SYSLOG)
+    {
+        syslog(level, "%s", text);
+    }
+    else
+    {
+        FILE* out = (s_target == LOGTARGET_FILE ? s_file : stderr);
+        char stamp[32];
+        time_t now = time(NULL);
+        struct tm tm_now;
+        localtime_r(&now, &tm_now);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_now);
+        fprintf(out, "%s [%s] %s\n", stamp, klk_log_level_name(level), text);
+        if (flush)
+        {
+            fflush(out);
+        }
+    }
+    pthread_mutex_unlock(&s_output_mutex);
+    __sync_add_and_fetch(&s_written, 1);
+}
+
+// Frees per thread data
+static void klk_log_free_data(void* data)
+{
+    free(data);
+}
+
+// Marks the writer as stopped at the child process after fork
+// (the writer thread does not exist there)
+static void klk_log_atfork_child()
+{
+    s_running = false;
+    s_waiting = false;
+    s_producers = 0;
+    pthread_mutex_init(&s_wait_mutex, NULL);
+    pthread_cond_init(&s_wait_cond, NULL);
+    pthread_mutex_init(&s_output_mutex, NULL);
+}
+
+// Does one time initialization
+static void klk_log_init()
+{
+    pthread_key_create(&s_key, klk_log_free_data);
+    for (size_t i = 0; i < LOGQUEUE_SIZE; i++)
+    {
+        s_queue[i].seq = i;
+    }
+    pthread_atfork(NULL, NULL, klk_log_atfork_child);
+}
+
+// Gets per thread data
+static LogThreadData* klk_log_get_data()
+{
+    pthread_once(&s_once, klk_log_init);
+    LogThreadData* data =
+        static_cast<LogThreadData*>(pthread_getspecific(s_key));
+    if (data == NULL)
+    {
+        data = static_cast<LogThreadData*>(calloc(1, sizeof(LogThreadData)));
+        if (data == NULL)
+        {
+            return NULL;
+        }
+        pthread_setspecific(s_key, data);
+    }
+    return data;
+}
+
+// Calculates the message hash
+static u_long klk_log_hash(const char* text)
+{
+    // FNV-1a
+    u_long hash = 2166136261UL;
+    for (; *text; text++)
+    {
+        hash ^= static_cast<unsigned char>(*text);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Puts a message to the queue
+// @param[in] level - the message level
+// @param[in] text - the message
+static void klk_log_enqueue(int level, const char* text)
+{
+    size_t pos = s_tail;
+    LogSlot* slot = NULL;
+    for (;;)
+    {
+        slot = &s_queue[pos & (LOGQUEUE_SIZE - 1)];
+        const long diff = static_cast<long>(slot->seq - pos);
+        if (diff == 0)
+        {
+            if (__sync_bool_compare_and_swap(&s_tail, pos, pos + 1))
+            {
+                break;
+            }
+            pos = s_tail;
+        }
+        else if (diff < 0)
+        {
+            // the queue is full: the caller is never blocked
+            __sync_add_and_fetch(&s_dropped, 1);
+            return;
+        }
+        else
+        {
+            pos = s_tail;
+        }
+    }
+
+    slot->level = level;
+    strncpy(slot->text, text, MAX_LOGBUFSIZE - 1);
+    slot->text[MAX_LOGBUFSIZE - 1] = '\0';
+    __sync_synchronize();
+    slot->seq = pos + 1;
+
+    // the writer sets the flag before the queue check
+    __sync_synchronize();
+    if (s_waiting)
+    {
+        pthread_mutex_lock(&s_wait_mutex);
+        pthread_cond_signal(&s_wait_cond);
+        pthread_mutex_unlock(&s_wait_mutex);
+    }
+}
+
+// Puts a message to the queue or writes it directly
+// if there is no writer
+// @param[in] level - the message level
+// @param[in] text - the message
+static void klk_log_push(int level, const char* text)
+{
+    // klk_close_log waits for the producer before the final drain
+    __sync_add_and_fetch(&s_producers, 1);
+    if (s_running)
+    {
+        klk_log_enqueue(level, text);
+        __sync_sub_and_fetch(&s_producers, 1);
+        return;
+    }
+    __sync_sub_and_fetch(&s_producers, 1);
+
+    klk_log_output(level, text, true);
+}
+
+// Writes all queued messages
+// @note called only from one thread (the writer)
+static void klk_log_drain()
+{
+    for (;;)
+    {
+        LogSlot* slot = &s_queue[s_head & (LOGQUEUE_SIZE - 1)];
+        if (slot->seq != s_head + 1)
+        {
+            break;
+        }
+        __sync_synchronize();
+        klk_log_output(slot->level, slot->text, false);
+        __sync_synchronize();
+        slot->seq = s_head + LOGQUEUE_SIZE;
+        s_head = s_head + 1;
+    }
+
+    // one flush per batch
+    pthread_mutex_lock(&s_output_mutex);
+    if (s_target != LOGTARGET_SYSLOG)
+    {
+        fflush(s_target == LOGTARGET_FILE ? s_file : stderr);
+    }
+    pthread_mutex_unlock(&s_output_mutex);
+}
+
+// Checks is the queue empty
+static bool klk_log_empty()
+{
+    return (s_queue[s_head & (LOGQUEUE_SIZE - 1)].seq != s_head + 1);
+}
+
+// The writer thread
+static void* klk_log_writer(void*)
+{
+    for (;;)
+    {
+        klk_log_drain();
+        if (!s_running)
+        {
+            break;
+        }
+
+        pthread_mutex_lock(&s_wait_mutex);
+        s_waiting = true;
+        // producers check the flag after the message publishing
+        __sync_synchronize();
+        while (s_running && klk_log_empty())
+        {
+            pthread_cond_wait(&s_wait_cond, &s_wait_mutex);
+        }
+        s_waiting = false;
+        pthread_mutex_unlock(&s_wait_mutex);
+    }
+    return NULL;
+}
+
+// Checks repeated messages from the current thread
+// @param[in] data - the thread data
+// @param[in] level - the message level
+// @return true if the message should be suppressed
+static bool klk_log_repeated(LogThreadData* data, int level)
+{
+    const u_long hash = klk_log_hash(data->buffer);
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    const long long now =
+        static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+    if (hash == data->hash && level == data->level &&
+        now < data->start + LOGREPEAT_INTERVAL)
+    {
+        data->repeat++;
+        if (data->repeat > LOGREPEAT_MAX)
+        {
+            data->suppressed++;
+            __sync_add_and_fetch(&s_suppressed, 1);
+            return true;
+        }
+        return false;
+    }
+
+    if (data->suppressed != 0)
+    {
+        char note[128];
+        snprintf(note, sizeof(note),
+                 "Previous message was repeated %lu more times",
+                 data->suppressed);
+        klk_log_push(data->level, note);
+    }
+
+    data->hash = hash;
+    data->level = level;
+    data->start = now;
+    data->repeat = 1;
+    data->suppressed = 0;
+    return false;
+}
 
 // klk_open_log opens the log
 void klk_open_log(const char* application)
 {
+    pthread_once(&s_once, klk_log_init);
+
     // open syslog
     openlog(application, LOG_CONS | LOG_NDELAY, LOG_LOCAL7);
+
+    // start the writer
+    if (!s_running)
+    {
+        s_running = true;
+        if (pthread_create(&s_writer, NULL, klk_log_writer, NULL) != 0)
+        {
+            // the messages will be written synchronously
+            s_running = false;
+        }
+    }
 }
 
 // klk_close_log closes the log
 void klk_close_log()
 {
+    if (s_running)
+    {
+        pthread_mutex_lock(&s_wait_mutex);
+        s_running = false;
+        pthread_cond_signal(&s_wait_cond);
+        pthread_mutex_unlock(&s_wait_mutex);
+        pthread_join(s_writer, NULL);
+        // the producers that passed the running check before the stop
+        // finish their slots, the later ones write directly
+        __sync_synchronize();
+        while (s_producers != 0)
+        {
+            sched_yield();
+        }
+        // the messages that were added during the stop
+        klk_log_drain();
+    }
+
+    if (s_dropped != 0 || s_suppressed != 0)
+    {
+        char note[128];
+        snprintf(note, sizeof(note),
+                 "Log statistics: written %lu, dropped %lu, suppressed %lu",
+                 s_written, s_dropped, s_suppressed);
+        klk_log_output(KLKLOG_INFO, note, true);
+    }
+
     closelog();
 }
 
+// Sets the log level threshold
+// @param[in] level - the threshold (KLKLOG_XXX)
+void klk_log_set_level(int level)
+{
+    s_level = level;
+}
+
+// Gets the log level threshold
+int klk_log_get_level()
+{
+    return s_level;
+}
+
+// Checks is the log level enabled
+// @param[in] level - the level to be checked (KLKLOG_XXX)
+int klk_log_is_enabled(int level)
+{
+    if (level == KLKLOG_TERMINAL)
+    {
+        return 1;
+    }
+    if (level == KLKLOG_XTREME)
+    {
+        return 0;
+    }
+    return (level <= s_level ? 1 : 0);
+}
+
+// Sets the log output
+// @param[in] target - "syslog", "stderr" or a file path
+int klk_log_set_target(const char* target)
+{
+    assert(target);
+    LogTarget new_target = LOGTARGET_FILE;
+    FILE* new_file = NULL;
+    if (strcmp(target, "syslog") == 0)
+    {
+        new_target = LOGTARGET_SYSLOG;
+    }
+    else if (strcmp(target, "stderr") == 0)
+    {
+        new_target = LOGTARGET_STDERR;
+    }
+    else
+    {
+        new_file = fopen(target, "a");
+        if (new_file == NULL)
+        {
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&s_output_mutex);
+    FILE* old_file = s_file;
+    s_target = new_target;
+    s_file = new_file;
+    pthread_mutex_unlock(&s_output_mutex);
+
+    if (old_file)
+    {
+        fclose(old_file);
+    }
+    return 0;
+}
+
+// Gets the log statistics
+// @param[out] written - number of written messages
+// @param[out] dropped - number of messages dropped due to the full queue
+// @param[out] suppressed - number of suppressed repeated messages
+void klk_log_get_stat(u_long* written, u_long* dropped, u_long* suppressed)
+{
+    assert(written && dropped && suppressed);
+    *written = s_written;
+    *dropped = s_dropped;
+    *suppressed = s_suppressed;
+}
+
 // Send a message to the log
 // @param[in] i_iLogLevel - logging's level (KLKLOG_XXX)
 // @param[in] i_szFormat - output format (see printf(3))
 void klk_log(int i_iLogLevel, const char* i_szFormat, ...)
 {
-    va_list args;
-    char* szBuffer = NULL;
+    // the level is checked before any formatting
+    if (!klk_log_is_enabled(i_iLogLevel))
+    {
+        return;
+    }
 
-    va_start(args, i_szFormat);
-    szBuffer = (char*)malloc(MAX_LOGBUFSIZE * sizeof(char));
-    if (szBuffer == NULL)
+    LogThreadData* data = klk_log_get_data();
+    if (data == NULL)
     {
         assert(0);
         fprintf(stderr,
                 "Cannot allocate %" SIZE_T_FORMAT "bytes for log output",
-                MAX_LOGBUFSIZE * sizeof(char));
+                sizeof(LogThreadData));
+        return;
     }
 
-    vsnprintf(szBuffer, MAX_LOGBUFSIZE, i_szFormat, args);
+    va_list args;
+    va_start(args, i_szFormat);
+    vsnprintf(data->buffer, MAX_LOGBUFSIZE, i_szFormat, args);
+    va_end(args);
+
     if (i_iLogLevel == KLKLOG_TERMINAL)
     {
-        fprintf(stderr, "%s", szBuffer);
+        fprintf(stderr, "%s", data->buffer);
+        return;
     }
-    else if (i_iLogLevel == KLKLOG_XTREME)
-    {
-        // nothing to do yet
-        // FIXME!!!
-    }
-    else
+
+    assert(i_iLogLevel > 0);
+    if (klk_log_repeated(data, i_iLogLevel))
     {
-        assert(i_iLogLevel > 0);
-        syslog(i_iLogLevel, "%s", szBuffer);
+        return;
     }
-
-    va_end(args);
-    KLKFREE(szBuffer);
+    klk_log_push(i_iLogLevel, data->buffer);
 }
-
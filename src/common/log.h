@@ -183,6 +183,9 @@ Thus the log files will have format klk-YYYYMMDD.log and there will be no more t
    @brief klk_open_log opens the log
    klk_open_log opens the log
 
+   Starts the writer thread. Messages are formatted at the caller
+   and written to the output by the thread.
+
    @param[in] application the application id (human readable string)
 */
 void klk_open_log(const char* application);
@@ -190,6 +193,8 @@ void klk_open_log(const char* application);
 /**
    @brief klk_close_log closes the log
    klk_close_log closes the log
+
+   All messages that were not written yet are flushed
 */
 void klk_close_log();
 
@@ -209,6 +214,56 @@ extern "C" {
     */
     void klk_log(int i_iLogLevel, const char* i_szFormat, ...);
 
+    /**
+       @brief Sets the log level threshold
+
+       Messages with less priority (greater level value) are dropped before
+       formatting. @ref KLKLOG_TERMINAL messages are always printed.
+
+       @param[in] level - the threshold (KLKLOG_XXX)
+    */
+    void klk_log_set_level(int level);
+
+    /**
+       @brief Gets the log level threshold
+
+       @return the threshold (KLKLOG_XXX)
+    */
+    int klk_log_get_level();
+
+    /**
+       @brief Checks is the log level enabled
+
+       Can be used to skip costly arguments preparation
+
+       @param[in] level - the level to be checked (KLKLOG_XXX)
+
+       @return
+       - 1 - messages with the level are logged
+       - 0 - messages with the level are dropped
+    */
+    int klk_log_is_enabled(int level);
+
+    /**
+       @brief Sets the log output
+
+       @param[in] target - "syslog", "stderr" or a file path
+
+       @return
+       - 0 - the target was set
+       - -1 - the file can not be opened (the prev target is kept)
+    */
+    int klk_log_set_target(const char* target);
+
+    /**
+       @brief Gets the log statistics
+
+       @param[out] written - number of written messages
+       @param[out] dropped - number of messages dropped due to the full queue
+       @param[out] suppressed - number of suppressed repeated messages
+    */
+    void klk_log_get_stat(u_long* written, u_long* dropped, u_long* suppressed);
+
 #ifdef __cplusplus
 }
 #endif
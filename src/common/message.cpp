@@ -38,9 +38,10 @@
 #include "config.h"
 #endif
 
-#include <sstream>
+#include <algorithm>
 
 #include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include "message.h"
 #include "common.h"
@@ -53,26 +54,65 @@ using namespace klk;
 // Constructor
 Message::Message(const std::string& id, msg::UUID uuid) :
     BaseMessage(id, uuid),
-    m_values(), m_lists(), m_receivers()
+    m_data(), m_receivers()
 {
 }
 
+// Finds a value by its key
+// @param[in] key - the key name (data id)
+// @param[in] list - true if a list is looked for
+const Message::Value* Message::findValue(const std::string& key,
+                                         bool list) const
+{
+    for (ValueVector::const_iterator i = m_data.begin();
+         i != m_data.end(); i++)
+    {
+        if ((i->m_type == LIST) == list && i->m_key == key)
+        {
+            return &(*i);
+        }
+    }
+    return NULL;
+}
+
+// Finds a value by its key or adds a new one
+// @param[in] key - the key name (data id)
+// @param[in] list - true if a list is looked for
+Message::Value& Message::addValue(const std::string& key, bool list)
+{
+    checkWritable();
+    Value* value = const_cast<Value*>(findValue(key, list));
+    if (value)
+    {
+        return *value;
+    }
+    if (m_data.empty())
+    {
+        // a single allocation for the usual message data
+        m_data.reserve(MESSAGE_VALUES_RESERVE);
+    }
+    m_data.push_back(Value());
+    m_data.back().m_key = key;
+    m_data.back().m_integer = 0;
+    return m_data.back();
+}
+
 // Adds a new receiver to the list
 // @param[in] id - the receiver's id
 void Message::addReceiver(const std::string& id)
 {
-    Locker lock(&m_lock);
+    checkWritable();
     // check that it does not exist
-    StringList::iterator i =
-        std::find(m_receivers.begin(), m_receivers.end(), id);
-    BOOST_ASSERT(i == m_receivers.end());
+    BOOST_ASSERT(std::find(m_receivers.begin(), m_receivers.end(), id) ==
+                 m_receivers.end());
     m_receivers.push_back(id);
 }
 
 // Gets the list with modules IDs that should get the message
-const StringList Message::getReceiverList() const throw()
+// @note there is no lock: the list is modified only before
+// the message is sent
+const StringList& Message::getReceiverList() const throw()
 {
-    Locker lock(&m_lock);
     return m_receivers;
 }
 
@@ -80,10 +120,8 @@ const StringList Message::getReceiverList() const throw()
 // @param[in] key - the key name (data id)
 const std::string Message::getValue(const std::string& key) const
 {
-    Locker lock(&m_lock);
-    StringMap::const_iterator i = m_values.find(key);
-
-    if (i == m_values.end())
+    const Value* value = findValue(key, false);
+    if (value == NULL)
     {
         throw klk::Exception(__FILE__, __LINE__,
                              "Cannot find simple data for key '%s' "
@@ -91,17 +129,19 @@ const std::string Message::getValue(const std::string& key) const
                              key.c_str(), getID().c_str());
     }
 
-    return i->second;
+    if (value->m_type == INTEGER)
+    {
+        return boost::lexical_cast<std::string>(value->m_integer);
+    }
+    return value->m_string;
 }
 
 // Gets message specific data
 // @param[in] key - the key name (data id)
 const StringList Message::getList(const std::string& key) const
 {
-    Locker lock(&m_lock);
-    StringListMap::const_iterator i = m_lists.find(key);
-
-    if (i == m_lists.end())
+    const Value* value = findValue(key, true);
+    if (value == NULL)
     {
         throw klk::Exception(__FILE__, __LINE__,
                              "Cannot find list data for key '%s' "
@@ -109,17 +149,50 @@ const StringList Message::getList(const std::string& key) const
                              key.c_str(), getID().c_str());
     }
 
-    return i->second;
+    return value->m_list;
 }
 
+// Gets message specific data (integer value)
+// @param[in] key - the key name (data id)
+long long Message::getInteger(const std::string& key) const
+{
+    const Value* value = findValue(key, false);
+    if (value == NULL)
+    {
+        throw klk::Exception(__FILE__, __LINE__,
+                             "Cannot find simple data for key '%s' "
+                             "in message with id '%s'",
+                             key.c_str(), getID().c_str());
+    }
+
+    if (value->m_type == INTEGER)
+    {
+        return value->m_integer;
+    }
+
+    // the value was set as a string (for example got from a remote side)
+    try
+    {
+        return boost::lexical_cast<long long>(value->m_string);
+    }
+    catch(const boost::bad_lexical_cast&)
+    {
+        throw klk::Exception(__FILE__, __LINE__,
+                             "Data for key '%s' in message with id '%s' "
+                             "is not an integer: '%s'",
+                             key.c_str(), getID().c_str(),
+                             value->m_string.c_str());
+    }
+}
 
 // Sets message specific data
 // @param[in] data - the data to be set
 // @param[in] key - the key name (data id)
 void Message::setData(const std::string& key, const std::string& data)
 {
-    Locker lock(&m_lock);
-    m_values[key] = data;
+    Value& value = addValue(key, false);
+    value.m_type = STRING;
+    value.m_string = data;
 }
 
 // Sets message specific data
@@ -127,30 +200,36 @@ void Message::setData(const std::string& key, const std::string& data)
 // @param[in] key - the key name (data id)
 void Message::setData(const std::string& key, const StringList& data)
 {
-    Locker lock(&m_lock);
-    m_lists[key] = data;
+    Value& value = addValue(key, true);
+    value.m_type = LIST;
+    value.m_list = data;
 }
 
-// Checks message specific data
-bool Message::hasValue(const std::string& key) const
+// Sets message specific data (integer value)
+// @param[in] data - the data to be set
+// @param[in] key - the key name (data id)
+void Message::setData(const std::string& key, long long data)
 {
-    Locker lock(&m_lock);
-    return (m_values.find(key) != m_values.end());
+    Value& value = addValue(key, false);
+    value.m_type = INTEGER;
+    value.m_integer = data;
+    value.m_string.clear();
 }
 
-#if 0
 // Checks message specific data
-bool Message::hasList(const std::string& key) const
+bool Message::hasValue(const std::string& key) const
 {
-    Locker lock(&m_lock);
-    return (m_lists.find(key) != m_lists.end());
+    return (findValue(key, false) != NULL);
 }
-#endif
 
 // Clears receiver list
 void Message::clearReceiverList() throw()
 {
-    Locker lock(&m_lock);
-    m_receivers.clear();
+    // the method can not throw: the sealed message is left untouched
+    BOOST_ASSERT(isSealed() == false);
+    if (isSealed() == false)
+    {
+        m_receivers.clear();
+    }
 }
 
@@ -37,7 +37,7 @@
 #ifndef KLK_MESSAGE_H
 #define KLK_MESSAGE_H
 
-#include <map>
+#include <vector>
 #include <string>
 
 #include <boost/static_assert.hpp>
@@ -46,6 +46,12 @@
 
 namespace klk
 {
+    /**
+       The number of message specific data items
+       the storage is preallocated for
+    */
+    const size_t MESSAGE_VALUES_RESERVE = 4;
+
     /**
        @brief Base class for messages
 
@@ -74,7 +80,7 @@ namespace klk
 
            @return the list
         */
-        virtual const StringList getReceiverList() const throw();
+        virtual const StringList& getReceiverList() const throw();
 
         /**
            Adds a new receiver to the list
@@ -116,26 +122,62 @@ namespace klk
         }
     private:
         /**
-           @brief String map class
-
-           There is a container storage for simple data:
-           pairs key -> value
+           @brief Stored value type
         */
-        typedef std::map<std::string, std::string> StringMap;
+        typedef enum
+        {
+            STRING = 0, ///< string value
+            INTEGER = 1, ///< integer value
+            LIST = 2 ///< list with strings
+        } ValueType;
 
         /**
-           @brief StringList map class
+           @brief Message specific data item
 
-           There is a container storage for list data:
-           pairs key -> list with values
+           A message usually keeps a few items thus they are stored
+           in a flat vector and looked up by a linear search. It is
+           cheaper than a tree map with a node allocation per item.
         */
-        typedef std::map<std::string, StringList> StringListMap;
+        struct Value
+        {
+            std::string m_key; ///< the key name (data id)
+            ValueType m_type; ///< the value type
+            std::string m_string; ///< string data
+            long long m_integer; ///< integer data
+            StringList m_list; ///< list data
+        };
 
+        /**
+           @brief Value storage
+        */
+        typedef std::vector<Value> ValueVector;
 
-        StringMap m_values; ///< message specific data
-        StringListMap m_lists; ///< message specific data
+        ValueVector m_data; ///< message specific data
         StringList m_receivers; ///< receivers list
 
+        /**
+           Finds a value by its key
+
+           Simple (string or integer) values and lists have
+           separate key spaces
+
+           @param[in] key - the key name (data id)
+           @param[in] list - true if a list is looked for
+
+           @return the value or NULL if there is no such one
+        */
+        const Value* findValue(const std::string& key, bool list) const;
+
+        /**
+           Finds a value by its key or adds a new one
+
+           @param[in] key - the key name (data id)
+           @param[in] list - true if a list is looked for
+
+           @return the value
+        */
+        Value& addValue(const std::string& key, bool list);
+
         /**
            Checks message specific data
 
@@ -165,6 +207,14 @@ namespace klk
         */
         virtual const StringList getList(const std::string& key) const;
 
+        /**
+           Gets message specific data (integer value)
+
+           @param[in] key - the key name (data id)
+
+           @return the data
+        */
+        virtual long long getInteger(const std::string& key) const;
 
         /**
            Sets message specific data (simple value)
@@ -181,6 +231,14 @@ namespace klk
            @param[in] key - the key name (data id)
         */
         virtual void setData(const std::string& key, const StringList& data);
+
+        /**
+           Sets message specific data (integer value)
+
+           @param[in] data - the data to be set
+           @param[in] key - the key name (data id)
+        */
+        virtual void setData(const std::string& key, long long data);
     private:
         /**
            Copy constructor
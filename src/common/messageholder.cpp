@@ -48,327 +48,332 @@
 using namespace klk;
 
 //
-// Class MessageHolderBase
+// MessageHolder4Standard class
 //
 
-// Constructor
-// @param[in] interval - the wait interval
-MessageHolderBase::MessageHolderBase(u_long interval) :
-    m_wait_interval(interval), m_stop(false),
-    m_wait_exit(false), m_wait_loop(false)
+// Rounds the ring size up to a power of 2
+static size_t getRingSize(size_t size)
 {
-    if (pthread_condattr_init(&m_wait_attr))
+    size_t res = 1;
+    while (res < size)
     {
-        KLKASSERT(0);
-        return;
+        res <<= 1;
     }
+    return res;
+}
 
-    try
-    {
-        if (pthread_mutex_init(&m_wait_mutex, NULL))
-        {
-            throw Exception(__FILE__, __LINE__,
-                                 "pthread_mutex_init() failed");
-        }
-
-        if (pthread_cond_init(&m_wait_cond, &m_wait_attr))
-        {
-            throw Exception(__FILE__, __LINE__,
-                                 "pthread_cond_init() failed");
-        }
-    }
-    catch(Exception& err)
+// Constructor
+// @param[in] size - the ring size (rounded up to a power of 2)
+MessageHolder4Standard::MessageHolder4Standard(size_t size) :
+    m_slots(NULL), m_mask(getRingSize(size) - 1),
+    m_tail(0), m_head(0), m_overflow(), m_overflow_size(0),
+    m_stop(false), m_waiting(false), m_interrupt(false),
+    m_overflow_count(0), m_processed(0), m_max_depth(0),
+    m_wait_sum(0), m_wait_max(0)
+{
+    if (pthread_mutex_init(&m_wait_mutex, NULL))
     {
-        KLKASSERT(0);
-        pthread_condattr_destroy(&m_wait_attr);
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_mutex_init() failed");
     }
 
-
-    if (pthread_mutex_init(&m_wait_mutex, NULL))
+    if (pthread_cond_init(&m_wait_cond, NULL))
     {
-        KLKASSERT(0);
-        pthread_condattr_destroy(&m_wait_attr);
-        return;
+        pthread_mutex_destroy(&m_wait_mutex);
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_cond_init() failed");
     }
 
-    if (pthread_cond_init(&m_wait_cond, &m_wait_attr))
+    m_slots = new Slot[m_mask + 1];
+    for (size_t i = 0; i <= m_mask; i++)
     {
-        pthread_condattr_destroy(&m_wait_attr);
-        return;
+        m_slots[i].m_seq = i;
     }
-
-    pthread_condattr_destroy(&m_wait_attr);
 }
 
 // Destructor
-MessageHolderBase::~MessageHolderBase()
+MessageHolder4Standard::~MessageHolder4Standard()
 {
-    pthread_mutex_destroy(&m_wait_mutex);
+    delete [] m_slots;
     pthread_cond_destroy(&m_wait_cond);
+    pthread_mutex_destroy(&m_wait_mutex);
 }
 
-// locks the object
-void MessageHolderBase::lock()
-{
-    pthread_mutex_lock(&m_wait_mutex);
-}
-
-// unlocks the object
-void MessageHolderBase::unlock()
-{
-    pthread_mutex_unlock(&m_wait_mutex);
-}
-
-
-// Gets a message from the holder
-// @param[out] msg - the container for retriving message
-Result MessageHolderBase::get(IMessagePtr& msg)
+// Puts a message to the ring
+bool MessageHolder4Standard::push(const IMessagePtr& msg)
 {
-    Result rc = OK;
-    // wait for awhile
-    struct timespec to;
-    to.tv_sec = time(NULL) + m_wait_interval;
-    to.tv_nsec = 0;
-
-    lock();
-
-    if (empty() == true)
+    size_t pos = m_tail;
+    Slot* slot = NULL;
+    for (;;)
     {
-        KLKASSERT(m_wait_loop == false);
-        while (!m_wait_exit)
+        slot = &m_slots[pos & m_mask];
+        const size_t seq = slot->m_seq;
+        __sync_synchronize();
+        const long diff = static_cast<long>(seq - pos);
+        if (diff == 0)
         {
-            m_wait_loop = true;
-            if (m_wait_interval != 0)
+            // the slot is free, try to claim it
+            if (__sync_bool_compare_and_swap(&m_tail, pos, pos + 1))
             {
-                int ret = pthread_cond_timedwait(&m_wait_cond,
-                                                 &m_wait_mutex, &to);
-                if (/* ( ret == ETIME ) || */( ret == ETIMEDOUT ))
-                {
-                    rc = ERROR; // timeout exceed
-                    break;
-                }
-
-                if (ret != EINTR)
-                {
-                    break;
-                }
-            }
-            else
-            {
-                pthread_cond_wait(&m_wait_cond, &m_wait_mutex);
+                break;
             }
         }
+        else if (diff < 0)
+        {
+            // the consumer has not released the slot yet: ring is full
+            return false;
+        }
+        pos = m_tail;
     }
 
-    m_wait_loop = false;
-    m_wait_exit = false;
+    slot->m_msg = msg;
+    gettimeofday(&slot->m_time, NULL);
+    // publish the slot for the consumer
+    __sync_synchronize();
+    slot->m_seq = pos + 1;
+    return true;
+}
 
-    if (m_stop)
+// Takes a message from the ring or the overflow list
+bool MessageHolder4Standard::pop(IMessagePtr& msg,
+                                 const struct timeval& now)
+{
+    Slot& slot = m_slots[m_head & m_mask];
+    if (slot.m_seq == m_head + 1)
     {
-        rc = ERROR;
+        __sync_synchronize();
+        msg.swap(slot.m_msg);
+        updateWaitTime(slot.m_time, now);
+        // release the slot for producers
+        __sync_synchronize();
+        slot.m_seq = m_head + m_mask + 1;
+        m_head = m_head + 1;
+        return true;
     }
-    else
+
+    // a producer has claimed the head slot but has not published it yet:
+    // the overflow messages were added later and have to wait for it
+    if (m_overflow_size == 0 || m_tail != m_head)
     {
-        rc = getUnsafe(msg);
+        return false;
     }
 
-    unlock();
-    return rc;
+    bool res = false;
+    pthread_mutex_lock(&m_wait_mutex);
+    if (!m_overflow.empty())
+    {
+        msg = m_overflow.front().first;
+        updateWaitTime(m_overflow.front().second, now);
+        m_overflow.pop_front();
+        m_overflow_size = m_overflow.size();
+        res = true;
+    }
+    pthread_mutex_unlock(&m_wait_mutex);
+    return res;
 }
 
-// Adds a message to the holder
-// @param[in] msg - the message to be added
-Result MessageHolderBase::add(const IMessagePtr& msg)
+// Checks is the queue empty or not
+bool MessageHolder4Standard::empty() const
 {
-    lock();
-
-    Result rc = OK;
-
-    try
+    if (m_slots[m_head & m_mask].m_seq == m_head + 1)
     {
-        // check exit condition
-        if (m_stop)
-        {
-            // there can be a message
-            // (db change) that can be sent to a stopped module
-            // thus we should just reject the message
-            //KLKASSERT(0);
-            throw Exception(__FILE__, __LINE__,
-                "Add message attempt was detected during module stop");
-        }
+        return false;
+    }
+    // the claimed head slot will wake up the consumer at the publishing
+    return (m_tail != m_head || m_overflow_size == 0);
+}
 
-        // add it to the container
-        if (addUnsafe(msg) != OK)
-        {
-            //KLKASSERT(0); we have a unit test on it
-            throw Exception(__FILE__, __LINE__,
-                "Add message failed");
-        }
+// Wakes up the consumer if it sleeps
+void MessageHolder4Standard::wakeup()
+{
+    __sync_synchronize();
+    if (m_waiting)
+    {
+        pthread_mutex_lock(&m_wait_mutex);
+        pthread_cond_signal(&m_wait_cond);
+        pthread_mutex_unlock(&m_wait_mutex);
+    }
+}
 
-        // stop waiting
-        if (m_wait_loop)
-        {
-            m_wait_exit = true;
-            if (pthread_cond_broadcast(&m_wait_cond) != 0)
-            {
-                klk_log(KLKLOG_ERROR,
-                        "Error %d in pthread_cond_broadcast(): %s",
-                        errno, strerror(errno));
-                throw Exception(__FILE__, __LINE__,
-                                     "Error in pthread_cond_broadcast()");
-            }
-        }
+// Removes all messages from the queue
+void MessageHolder4Standard::clear()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    size_t count = 0;
+    IMessagePtr msg;
+    while (pop(msg, now))
+    {
+        msg.reset();
+        count++;
     }
-    catch(const std::exception& err)
+
+    if (count != 0)
     {
-        //KLKASSERT(0); we have a unit test on it
         klk_log(KLKLOG_ERROR,
-                "Error while message add: %s",
-                err.what());
-        rc = ERROR;
+                "There are %d unprocessed messages at container",
+                count);
     }
-
-    unlock();
-
-    return rc;
 }
 
-// Starts processing
-// Clears all prev states
-void MessageHolderBase::start()
+// Updates wait time counters
+void MessageHolder4Standard::updateWaitTime(const struct timeval& added,
+                                            const struct timeval& now)
 {
-    lock();
-    m_stop = false;
-    m_wait_loop = false;
-    m_wait_exit = false;
-    unlock();
+    const double wait = (now.tv_sec - added.tv_sec) +
+        (now.tv_usec - added.tv_usec) / 1000000.0;
+    m_wait_sum += wait;
+    if (wait > m_wait_max)
+    {
+        m_wait_max = wait;
+    }
+    m_processed = m_processed + 1;
 }
 
-// Stops processing
-void MessageHolderBase::stop()
+// Gets a batch of messages from the holder
+// @param[out] msgs - the container for retriving messages
+// @param[in] max - max number of messages to be retrieved
+// @param[in] timeout - max wait interval in seconds (0 - no limit)
+Result MessageHolder4Standard::get(MessageVector& msgs, size_t max,
+                                   time_t timeout)
 {
-    lock();
-
-    m_stop = true;
+    BOOST_ASSERT(max > 0);
+    msgs.clear();
 
-    // stop waiting
-    if (m_wait_loop)
+    if (empty() && !m_stop && !m_interrupt)
     {
-        m_wait_exit = true;
-        if (pthread_cond_broadcast(&m_wait_cond) != 0)
+        struct timespec to;
+        to.tv_sec = time(NULL) + timeout;
+        to.tv_nsec = 0;
+
+        pthread_mutex_lock(&m_wait_mutex);
+        m_waiting = true;
+        // producers check the flag after the message publishing
+        __sync_synchronize();
+        while (!m_stop && !m_interrupt && empty())
         {
-            klk_log(KLKLOG_ERROR,
-                    "Error %d in pthread_cond_broadcast(): %s",
-                    errno, strerror(errno));
-            KLKASSERT(0);
+            if (timeout == 0)
+            {
+                pthread_cond_wait(&m_wait_cond, &m_wait_mutex);
+            }
+            else if (pthread_cond_timedwait(&m_wait_cond, &m_wait_mutex,
+                                            &to) == ETIMEDOUT)
+            {
+                break;
+            }
         }
+        m_waiting = false;
+        pthread_mutex_unlock(&m_wait_mutex);
     }
-    unlock();
-}
+    m_interrupt = false;
 
-//
-// MessageHolder4Standard class
-//
-
-// Constructor
-MessageHolder4Standard::MessageHolder4Standard() :
-    MessageHolderBase(0)
-{
-}
+    if (m_stop)
+    {
+        clear();
+        return ERROR;
+    }
 
-// Destructor
-MessageHolder4Standard::~MessageHolder4Standard()
-{
-}
+    const size_t depth = getStat().m_depth;
+    if (depth > m_max_depth)
+    {
+        m_max_depth = depth;
+    }
 
-// Gets a message from the holder
-Result MessageHolder4Standard::getUnsafe(IMessagePtr& msg)
-{
-    if (m_container.empty())
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    IMessagePtr msg;
+    while (msgs.size() < max && pop(msg, now))
     {
-        return ERROR;
+        BOOST_ASSERT(msg);
+        msgs.push_back(msg);
+        msg.reset();
     }
 
-    msg = m_container.front();
-    CHECKNOTNULL(msg);
-    m_container.pop_front();
     return OK;
 }
 
 // Adds a message to the holder
 // @param[in] msg - the message to be added
-Result MessageHolder4Standard::addUnsafe(const IMessagePtr& msg)
+Result MessageHolder4Standard::add(const IMessagePtr& msg)
 {
     CHECKNOTNULL(msg);
-    m_container.push_back(msg);
-    return OK;
-}
 
-// Stops processing
-void MessageHolder4Standard::stop()
-{
-    // check that container is not empty
-    if (m_container.empty() == false)
+    if (m_stop)
     {
+        // there can be a message
+        // (db change) that can be sent to a stopped module
+        // thus we should just reject the message
         klk_log(KLKLOG_ERROR,
-                "There are %d unprocessed messages at container",
-                m_container.size());
+                "Error while message add: "
+                "Add message attempt was detected during module stop");
+        return ERROR;
     }
 
-    m_container.clear();
+    // the messages go to the overflow list until it will be drained
+    // to keep the order
+    if (m_overflow_size != 0 || !push(msg))
+    {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        pthread_mutex_lock(&m_wait_mutex);
+        m_overflow.push_back(OverflowElem(msg, now));
+        m_overflow_size = m_overflow.size();
+        m_overflow_count = m_overflow_count + 1;
+        pthread_mutex_unlock(&m_wait_mutex);
+    }
 
-    MessageHolderBase::stop();
+    wakeup();
+    return OK;
 }
 
-//
-// SyncMessageHolder4SyncRes class
-//
-
-// Constructor
-MessageHolder4SyncRes::MessageHolder4SyncRes() :
-    MessageHolderBase(TIMEINTERVAL4SYNCRES)
+// Interrupts the consumer wait
+void MessageHolder4Standard::interrupt()
 {
+    m_interrupt = true;
+    wakeup();
 }
 
-// Destructor
-MessageHolder4SyncRes::~MessageHolder4SyncRes()
+// Starts processing
+// Clears all prev states
+void MessageHolder4Standard::start()
 {
+    pthread_mutex_lock(&m_wait_mutex);
+    m_stop = false;
+    pthread_mutex_unlock(&m_wait_mutex);
 }
 
-// Gets a message from the holder
-// @param[out] msg - the container for retriving message
-// @note not thread safe method
-Result MessageHolder4SyncRes::getUnsafe(IMessagePtr& msg)
+// Stops processing
+void MessageHolder4Standard::stop()
 {
-    msg.reset();
-    if (!m_msg)
+    pthread_mutex_lock(&m_wait_mutex);
+    m_stop = true;
+    // stop waiting
+    if (pthread_cond_broadcast(&m_wait_cond) != 0)
     {
-        return ERROR;
+        klk_log(KLKLOG_ERROR,
+                "Error %d in pthread_cond_broadcast(): %s",
+                errno, strerror(errno));
+        KLKASSERT(0);
     }
-    msg = m_msg;
-    m_msg.reset();
-    return OK;
-}
-
-// Adds a message to the holder
-// @param[in] msg - the message to be added
-// @note not thread safe method
-Result MessageHolder4SyncRes::addUnsafe(const IMessagePtr& msg)
-{
-    BOOST_ASSERT(msg->getType() == msg::SYNC_RES);
-    BOOST_ASSERT(msg);
-    m_msg = msg;
-    return OK;
+    pthread_mutex_unlock(&m_wait_mutex);
 }
 
-// Stops processing
-void MessageHolder4SyncRes::stop()
+// Retrives the queue statistics
+const mod::QueueStat MessageHolder4Standard::getStat() const
 {
-    if (m_msg)
+    mod::QueueStat stat;
+    stat.m_overflow = m_overflow_count;
+    stat.m_received = m_tail + stat.m_overflow;
+    stat.m_processed = m_processed;
+    if (stat.m_received > stat.m_processed)
     {
-        klk_log(KLKLOG_ERROR, "Unprocessed sync responses");
-        m_msg.reset();
+        stat.m_depth = stat.m_received - stat.m_processed;
     }
-
-    MessageHolderBase::stop();
+    stat.m_max_depth = m_max_depth;
+    if (stat.m_processed != 0)
+    {
+        stat.m_wait_avg = m_wait_sum / stat.m_processed;
+    }
+    stat.m_wait_max = m_wait_max;
+    return stat;
 }
@@ -38,11 +38,15 @@
 #define KLK_MESSAGEHOLDER_H
 
 #include <sys/types.h>
+#include <sys/time.h>
 #include <pthread.h>
 
 #include <deque>
+#include <vector>
+#include <utility>
 
 #include "imessage.h"
+#include "imodule.h"
 #include "common.h"
 #include "errors.h"
 
@@ -60,40 +64,74 @@ namespace klk
 #endif
 
     /**
-       @brief Base class for message holders
+       Message queue ring size (should be a power of 2)
 
-       Base class for message holders
+       @ingroup grModule
+    */
+    const size_t MESSAGEQUEUE_SIZE = 4096;
 
-       @ingroup grThread
+    /**
+       Max number of messages retrieved by one @ref MessageHolder4Standard::get
+       call
+
+       @ingroup grModule
+    */
+    const size_t MESSAGEQUEUE_BATCH = 64;
+
+    /**
+       Messages batch
+
+       @ingroup grModule
+    */
+    typedef std::vector<IMessagePtr> MessageVector;
+
+    /**
+       @brief Message holder for standard messages
+
+       Bounded multi-producer/single-consumer queue. Producers claim a ring
+       slot with an atomic operation and publish it with the slot sequence
+       number, the consumer (the module thread) reads the slots without
+       locks. The mutex and the condition variable are used only when the
+       consumer has to sleep on an empty queue.
+
+       If the ring is full the messages are put into a locked overflow list
+       thus producers are never blocked and never lose messages. The
+       messages from one producer are kept in order.
+
+       @ingroup grModule
     */
-    class MessageHolderBase
+    class MessageHolder4Standard
     {
     public:
         /**
            Constructor
 
-           @param[in] interval - the wait interval
+           @param[in] size - the ring size (rounded up to a power of 2)
         */
-        explicit MessageHolderBase(u_long interval);
+        explicit MessageHolder4Standard(size_t size = MESSAGEQUEUE_SIZE);
 
         /**
            Destructor
         */
-        virtual ~MessageHolderBase();
+        virtual ~MessageHolder4Standard();
 
         /**
-           Gets a message from the holder
+           Gets a batch of messages from the holder
 
-           @param[out] msg - the container for retriving message
+           @param[out] msgs - the container for retriving messages
+           @param[in] max - max number of messages to be retrieved
+           @param[in] timeout - max wait interval in seconds (0 - no limit)
 
-           @note the method will wait until @ref stop or @ref add will
-           be called
+           @note the method will wait until @ref stop, @ref add or
+           @ref interrupt will be called or the timeout will be exceeded.
+           Can be called only from one (consumer) thread
 
            @return
-           - @ref OK
+           - @ref OK (the batch is empty after the timeout or interrupt)
            - @ref ERROR
         */
-        Result get(IMessagePtr& msg);
+        Result get(MessageVector& msgs, size_t max = MESSAGEQUEUE_BATCH,
+                   time_t timeout = 0);
 
         /**
            Adds a message to the holder
@@ -108,153 +146,119 @@ namespace klk
         */
         Result add(const IMessagePtr& msg);
 
+        /**
+           Interrupts the consumer wait
+
+           @ref get returns immediately (with an empty batch
+           if there are no messages)
+        */
+        void interrupt();
+
         /**
            Starts processing
            Clears all prev states
         */
-        virtual void start();
+        void start();
 
         /**
            Stops processing
         */
-        virtual void stop();
-    protected:
-        /**
-           Gets a message from the holder
-
-           @param[out] msg - the container for retriving message
-
-           @note not thread safe method
-
-           @return
-           - @ref OK
-           - @ref ERROR
-        */
-        virtual Result getUnsafe(IMessagePtr& msg) = 0;
+        void stop();
 
         /**
-           Adds a message to the holder
-
-           @param[in] msg - the message to be added
-
-           @note not thread safe method
+           Removes all messages from the queue
 
-           @return
-           - @ref OK
-           - @ref ERROR
+           @note can be called only from the consumer thread
         */
-        virtual Result addUnsafe(const IMessagePtr& msg) = 0;
+        void clear();
 
         /**
-           Checks is container empty or not
+           Retrives the queue statistics
 
-           @note not thread safe method
-
-           @return
-           - true
-           - false
+           @return the statistics
         */
-        virtual bool empty() = 0;
+        const mod::QueueStat getStat() const;
     private:
-        u_long m_wait_interval; ///< wait interval
-        bool m_stop; ///< stop flag
-        bool m_wait_exit; ///< exit flag
-        bool m_wait_loop; ///< was started or not
-        pthread_mutex_t m_wait_mutex; ///< wait mutex
-        pthread_cond_t m_wait_cond; ///< wait condition
-        pthread_condattr_t	m_wait_attr; ///< CondVar attribute
-
         /**
-           locks the object
+           Ring slot
         */
-        void lock();
+        struct Slot
+        {
+            volatile size_t m_seq; ///< slot sequence number
+            IMessagePtr m_msg; ///< the message
+            struct timeval m_time; ///< the time when the message was added
+        };
 
         /**
-           unlocks the object
+           Overflow list element
         */
-        void unlock();
+        typedef std::pair<IMessagePtr, struct timeval> OverflowElem;
+
+        Slot* m_slots; ///< the ring
+        const size_t m_mask; ///< ring index mask
+        volatile size_t m_tail; ///< producers position
+        volatile size_t m_head; ///< consumer position
+        std::deque<OverflowElem> m_overflow; ///< overflow list
+        volatile size_t m_overflow_size; ///< overflow list size
+        volatile bool m_stop; ///< stop flag
+        volatile bool m_waiting; ///< the consumer sleeps
+        volatile bool m_interrupt; ///< the consumer wait was interrupted
+        pthread_mutex_t m_wait_mutex; ///< wait mutex
+        pthread_cond_t m_wait_cond; ///< wait condition
+        volatile u_long m_overflow_count; ///< overflow counter
+        volatile u_long m_processed; ///< processed messages counter
+        volatile size_t m_max_depth; ///< max depth
+        double m_wait_sum; ///< total time in queue
+        double m_wait_max; ///< max time in queue
 
         /**
-           Constructor
-        */
-        MessageHolderBase();
+           Puts a message to the ring
 
-        /**
-           Copy constructor
-           @param[in] value - the copy param
-        */
-        MessageHolderBase(const MessageHolderBase& value);
+           @param[in] msg - the message to be added
 
-        /**
-           Assigment operator
-           @param[in] value - the copy param
+           @return
+           - true the message was added
+           - false the ring is full
         */
-        MessageHolderBase& operator=(const MessageHolderBase& value);
-    };
-
-    /**
-       @brief Message holder for standard messages
-
-       Message holder for standard messages
+        bool push(const IMessagePtr& msg);
 
-       @ingroup grModule
-    */
-    class MessageHolder4Standard : public MessageHolderBase
-    {
-    public:
         /**
-           Constructor
-        */
-        MessageHolder4Standard();
+           Takes a message from the ring or the overflow list
 
-        /**
-           Destructor
-        */
-        virtual ~MessageHolder4Standard();
+           @param[out] msg - the container for retriving message
+           @param[in] now - the current time
 
-        /**
-           Stops processing
+           @note not thread safe method (consumer only)
+
+           @return
+           - true the message was retrieved
+           - false the queue is empty
         */
-        virtual void stop();
-    private:
-        std::deque<IMessagePtr> m_container; ///< the messages container
+        bool pop(IMessagePtr& msg, const struct timeval& now);
 
         /**
-           Checks is container empty or not
-
-           @note not thread safe method
+           Checks is the queue empty or not
 
            @return
            - true
            - false
         */
-        virtual bool empty() {return m_container.empty();}
+        bool empty() const;
 
         /**
-           Gets a message from the holder
-
-           @param[out] msg - the container for retriving message
-
-           @note not thread safe method
-
-           @return
-           - @ref OK
-           - @ref ERROR
+           Wakes up the consumer if it sleeps
         */
-        virtual Result getUnsafe(IMessagePtr& msg);
-
-        /**
-           Adds a message to the holder
+        void wakeup();
 
-           @param[in] msg - the message to be added
 
-           @note not thread safe method
+        /**
+           Updates wait time counters
 
-           @return
-           - @ref OK
-           - @ref ERROR
+           @param[in] added - the time when the message was added
+           @param[in] now - the current time
         */
-        virtual Result addUnsafe(const IMessagePtr& msg);
+        void updateWaitTime(const struct timeval& added,
+                            const struct timeval& now);
 
         /**
            Copy constructor
@@ -268,81 +272,6 @@ namespace klk
         */
         MessageHolder4Standard& operator=(const MessageHolder4Standard& value);
     };
-
-    /**
-       @brief The holder for sync messages
-
-       The holder for sync messages
-
-       @ingroup grModule
-    */
-    class MessageHolder4SyncRes : public MessageHolderBase
-    {
-    public:
-        /**
-           Constructor
-        */
-        MessageHolder4SyncRes();
-
-        /**
-           Destructor
-        */
-        virtual ~MessageHolder4SyncRes();
-
-        /**
-           Stops processing
-        */
-        virtual void stop();
-    private:
-        IMessagePtr m_msg; ///< message
-
-        /**
-           Checks is container empty or not
-
-           @note not thread safe method
-
-           @return
-           - true
-           - false
-        */
-        virtual bool empty() {return !m_msg;}
-
-        /**
-           Gets a message from the holder
-
-           @param[out] msg - the container for retriving message
-
-           @note not thread safe method
-
-           @return
-           - @ref OK
-           - @ref ERROR
-        */
-        virtual Result getUnsafe(IMessagePtr& msg);
-
-        /**
-           Adds a message to the holder
-
-           @param[in] msg - the message to be added
-
-           @note not thread safe method
-
-           @return
-           - @ref OK
-           - @ref ERROR
-        */
-        virtual Result addUnsafe(const IMessagePtr& msg);
-
-        /**
-           Copy constructor
-        */
-        MessageHolder4SyncRes(const MessageHolder4SyncRes&);
-
-        /**
-           Assignment operator constructor
-        */
-        MessageHolder4SyncRes& operator=(const MessageHolder4SyncRes&);
-    };
 }
 
 #endif //KLK_MESSAGEHOLDER_H
@@ -35,6 +35,8 @@
 #ifndef KLK_INFOCONTAINER_H
 #define KLK_INFOCONTAINER_H
 
+#include <map>
+
 #include <boost/bind.hpp>
 
 #include "info.h"
@@ -140,7 +142,7 @@ namespace klk
 
             /// Constructor
             InfoContainer() :
-            m_lock(), m_container()
+            m_lock(), m_container(), m_index()
             {
             }
 
@@ -152,6 +154,7 @@ namespace klk
             {
                 Locker lock(&m_lock);
                 m_container.clear();
+                m_index.clear();
             }
 
             /**
@@ -237,18 +240,15 @@ namespace klk
                 BOOST_ASSERT(uuid.empty() == false);
                 Locker lock(&m_lock);
 
-                InfoSetConstIterator i =
-                    std::find_if(m_container.begin(), m_container.end(),
-                                 boost::bind(FindInfoByUUID<T>(),
-                                             _1, uuid));
-                if (i == m_container.end())
+                IndexConstIterator i = m_index.find(uuid);
+                if (i == m_index.end())
                 {
                     throw Exception(__FILE__, __LINE__,
                                     "Cannot find module info with uuid '%s'",
                                     uuid.c_str());
                 }
 
-                return  *i;
+                return  i->second;
             }
 
             /**
@@ -331,6 +331,7 @@ namespace klk
                     // remove it
                     Locker lock(&m_lock);
                     m_container.erase(elem);
+                    m_index.erase(elem->getUUID());
                 }
             }
 
@@ -367,6 +368,7 @@ namespace klk
                 if (find == m_container.end())
                 {
                     m_container.insert(elem);
+                    m_index[elem->getUUID()] = elem;
                 }
                 else if (update)
                 {
@@ -374,6 +376,65 @@ namespace klk
                 }
             }
 
+            /**
+               Applies changes for the specified infos only
+
+               The infos from the set are added or updated. The infos
+               with uuids from the list that are missing at the set
+               are deleted
+
+               @param[in] uuids - the changed infos uuids
+               @param[in] set - the actual infos for the uuids
+               @param[in] ignore_not_used - should we ignore not used
+               elements at deletion
+
+               @exception klk::Exception
+            */
+            void apply(const StringList& uuids, const InfoSet& set,
+                       bool ignore_not_used = true)
+            {
+                // the set is small: it keeps changed elements only
+                Index actual;
+                for (InfoSetConstIterator i = set.begin(); i != set.end(); i++)
+                {
+                    actual[(*i)->getUUID()] = *i;
+                }
+
+                for (StringList::const_iterator uuid = uuids.begin();
+                     uuid != uuids.end(); uuid++)
+                {
+                    typename Index::iterator found = actual.find(*uuid);
+                    if (found != actual.end())
+                    {
+                        addElem(found->second, true);
+                        actual.erase(found);
+                        continue;
+                    }
+
+                    // the info has gone
+                    TPtr elem;
+                    {
+                        Locker lock(&m_lock);
+                        IndexConstIterator i = m_index.find(*uuid);
+                        if (i != m_index.end())
+                        {
+                            elem = i->second;
+                        }
+                    }
+                    if (elem)
+                    {
+                        delElem(elem, ignore_not_used);
+                    }
+                }
+
+                // infos that were not requested
+                for (typename Index::iterator i = actual.begin();
+                     i != actual.end(); i++)
+                {
+                    addElem(i->second, true);
+                }
+            }
+
             /**
                Retrives a list with module specific info
 
@@ -387,9 +448,14 @@ namespace klk
         private:
             /// The info container const iterator
             typedef typename InfoSet::const_iterator InfoSetConstIterator;
+            /// The uuid index type
+            typedef std::map<std::string, TPtr> Index;
+            /// The uuid index const iterator
+            typedef typename Index::const_iterator IndexConstIterator;
 
             mutable Mutex m_lock; ///< locker
             InfoSet m_container; ///< container with module info
+            Index m_index; ///< the infos by uuids
         private:
             /**
                Copy constructor
@@ -64,7 +64,8 @@ using namespace klk;
 ModuleFactory::ModuleFactory(IFactory *factory) :
     m_lock(),
     m_modules(), m_resources(), m_factory(factory),
-    m_libfactory(NULL), m_scheduler(NULL), m_dependency()
+    m_libfactory(NULL), m_scheduler(NULL), m_dependency(),
+    m_routes_lock(), m_routes(new RouteMap()), m_trace(false)
 {
     BOOST_ASSERT(m_factory);
 }
@@ -73,6 +74,7 @@ ModuleFactory::ModuleFactory(IFactory *factory) :
 ModuleFactory::~ModuleFactory()
 {
     m_modules.clear();
+    updateRoutes();
     m_resources.clear();
     KLKDELETE(m_scheduler);
     // Lib factory should be last
@@ -245,9 +247,14 @@ void ModuleFactory::unloadAll()
 // @param[in] id the module's id
 const IModulePtr ModuleFactory::getModule(const std::string& id)
 {
-    Locker lock(&m_lock);
-    IModulePtr res = getModuleUnsafe(id);
-    return res;
+    BOOST_ASSERT(id.empty() == false);
+    const RouteMapPtr routes = getRoutes();
+    RouteMap::const_iterator i = routes->find(id);
+    if (i == routes->end())
+    {
+        return IModulePtr();
+    }
+    return i->second;
 }
 
 // Gets resources by its id
@@ -270,18 +277,14 @@ const IResourcesPtr ModuleFactory::getResources(const std::string& id)
 // @param[in] id the module's id
 const IModulePtr ModuleFactory::getModule(const std::string& id) const
 {
-    Locker lock(&m_lock);
-
-    ModuleList::const_iterator i = std::find_if(
-        m_modules.begin(), m_modules.end(),
-        boost::bind(std::equal_to<std::string>(), id,
-                    boost::bind(&IModule::getID, _1)));
-    if (i == m_modules.end())
+    const RouteMapPtr routes = getRoutes();
+    RouteMap::const_iterator i = routes->find(id);
+    if (i == routes->end())
     {
         BOOST_ASSERT(false);
     }
 
-    return *i;
+    return i->second;
 }
 
 // Gets module by its id
@@ -329,6 +332,29 @@ void ModuleFactory::addModule(const IModulePtr& module)
     // register messages
     module->registerProcessors();
     m_modules.push_back(module);
+    updateRoutes();
+}
+
+// Rebuilds the routing table from the known modules list
+void ModuleFactory::updateRoutes()
+{
+    // readers keep using the old table until they release it
+    boost::shared_ptr<RouteMap> routes(new RouteMap());
+    for (ModuleList::iterator i = m_modules.begin();
+         i != m_modules.end(); i++)
+    {
+        routes->insert(RouteMap::value_type((*i)->getID(), *i));
+    }
+
+    Locker lock(&m_routes_lock);
+    m_routes = routes;
+}
+
+// Gets the current routing table
+const ModuleFactory::RouteMapPtr ModuleFactory::getRoutes() const
+{
+    Locker lock(&m_routes_lock);
+    return m_routes;
 }
 
 // Adds resources to the known resources list
@@ -369,11 +395,45 @@ void ModuleFactory::sendMessage(const IMessagePtr& msg)
     }
     }
 
-    // get the message core module
-    IModulePtr core = getModule(msgcore::MODID);
-    BOOST_ASSERT(core);
-    // add the message to the core for dispatching
-    core->addMessage(msg);
+    if (m_trace && msg->getType() == msg::ASYNC)
+    {
+        // get the message core module
+        IModulePtr core = getModule(msgcore::MODID);
+        BOOST_ASSERT(core);
+        // add the message to the core for dispatching
+        core->addMessage(msg);
+        return;
+    }
+
+    deliverMessage(msg);
+}
+
+// Delivers a message directly to its receivers
+void ModuleFactory::deliverMessage(const IMessagePtr& msg)
+{
+    const RouteMapPtr routes = getRoutes();
+    const StringList& receivers = msg->getReceiverList();
+    for (StringList::const_iterator i = receivers.begin();
+         i != receivers.end(); i++)
+    {
+        RouteMap::const_iterator route = routes->find(*i);
+        if (route == routes->end())
+        {
+            // the sender should not fail because of one wrong receiver
+            klk_log(KLKLOG_ERROR,
+                    "Sending message with id '%s' to module '%s' "
+                    "was failed: unkown module id",
+                    msg->getID().c_str(), i->c_str());
+            continue;
+        }
+        route->second->addMessage(msg);
+    }
+}
+
+// Sets message trace mode
+void ModuleFactory::setMessageTrace(bool trace)
+{
+    m_trace = trace;
 }
 
 // Retrieves a list with available module ids
@@ -204,6 +204,9 @@ namespace klk
         /// @copydoc IModuleFactory::sendMessage()
         virtual  void sendMessage(const IMessagePtr& msg);
 
+        /// @copydoc IModuleFactory::setMessageTrace()
+        virtual void setMessageTrace(bool trace);
+
         /// @copydoc klk::IModuleFactory::isLoaded
         virtual bool isLoaded(const std::string& id);
     protected:
@@ -247,11 +250,46 @@ namespace klk
            @note use it instead of m_scheduler direct usage
         */
         base::Scheduler* getScheduler();
+
+        /**
+           Rebuilds the routing table from the known modules list
+
+           @note - there is an internal method that does not do any locks
+           for the modules list
+        */
+        void updateRoutes();
     private:
+        /**
+           Routing table: module id to the module
+        */
+        typedef std::map<std::string, IModulePtr> RouteMap;
+
+        /**
+           Routing table smart pointer
+        */
+        typedef boost::shared_ptr<const RouteMap> RouteMapPtr;
+
         IFactory * const m_factory; ///< main factory
         LibFactory *m_libfactory; ///< libfactory
         base::Scheduler *m_scheduler; ///< the module scheduler
         mod::Dependency m_dependency; ///< the dependency
+        mutable klk::Mutex m_routes_lock; ///< routing table pointer lock
+        RouteMapPtr m_routes; ///< the routing table
+        volatile bool m_trace; ///< message trace mode
+
+        /**
+           Gets the current routing table
+
+           @return the routing table snapshot
+        */
+        const RouteMapPtr getRoutes() const;
+
+        /**
+           Delivers a message directly to its receivers
+
+           @param[in] msg - the message to be delivered
+        */
+        void deliverMessage(const IMessagePtr& msg);
 
         /// @copydoc klk::IModuleFactory::getModules
         virtual const ModuleList getModules();
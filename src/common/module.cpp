@@ -61,6 +61,12 @@
 
 using namespace klk;
 
+/**
+   Module timers can be delayed up to 1/8 of their interval
+   to be coalesced with other timers at the timer wheel
+*/
+const u_long TIMER_SLACK_DIVIDER = 8;
+
 //
 // Module
 //
@@ -70,16 +76,19 @@ Module::Module(IFactory *factory,
                const std::string& id) :
     base::Thread(), m_factory(factory),
     m_id(id),
-    m_container(), m_sync_container(),
+    m_container(), m_batch(),
+    m_pending(), m_completed(), m_pending_lock(),
     m_processor(factory, id),
     m_start_time(time(NULL)),
     m_scheduler(),
+    m_timers(), m_timers_lock(),
     m_usage(),
     m_start_sem(),
     m_checkpoint_count(0),
     m_checkpoint_mutex()
 {
     BOOST_ASSERT(m_factory);
+    m_batch.reserve(MESSAGEQUEUE_BATCH);
 }
 
 // Gets factory
@@ -107,14 +116,20 @@ void Module::preMainLoop()
     }
     // starts threads
     m_scheduler.start();
+    startTimers();
 }
 
 // Do some actions after main loop
 void Module::postMainLoop() throw()
 {
     m_start_time = 0;
-    m_sync_container.stop();
-    // stop threads
+    // drop messages that were not processed before the stop
+    m_container.clear();
+    // nobody will wait for the responses
+    cancelRequests("module '" + getName() + "' was stopped");
+    dispatchResponses();
+    // stop timers and threads
+    stopTimers();
     m_scheduler.stop();
 }
 
@@ -158,40 +173,60 @@ void Module::start()
     postMainLoop();
 }
 
-// Processes a message
+// Processes a batch of messages
 void Module::processMessage() throw()
 {
+    time_t timeout = 0;
     try
     {
-        IMessagePtr msg;
-        if (m_container.get(msg) != OK)
-        {
-            if (!isStopped())
-            {
-                klk_log(
-                    KLKLOG_ERROR,
-                    "Error while message retreiving at module '%s'",
-                    getName().c_str());
-            }
-            return;
-        }
-        m_processor.process(msg);
+        timeout = expireRequests();
     }
     catch(const std::exception& err)
     {
         klk_log(KLKLOG_ERROR,
-                "Got an exception during a message processing. "
-                "Module name: '%s'; Description: %s",
-                getName().c_str(),
-                err.what());
+                "Error while sync requests check at module '%s': %s",
+                getName().c_str(), err.what());
     }
-    catch(...)
+
+    if (m_container.get(m_batch, MESSAGEQUEUE_BATCH, timeout) != OK)
     {
-        klk_log(KLKLOG_ERROR,
-                "Got an unknown exception during a message processing. "
-                "Module name: '%s'",
+        if (!isStopped())
+        {
+            klk_log(
+                KLKLOG_ERROR,
+                "Error while message retreiving at module '%s'",
                 getName().c_str());
+        }
+        return;
+    }
+
+    for (MessageVector::iterator i = m_batch.begin();
+         i != m_batch.end(); i++)
+    {
+        try
+        {
+            m_processor.process(*i);
+        }
+        catch(const std::exception& err)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an exception during a message processing. "
+                    "Module name: '%s'; Description: %s",
+                    getName().c_str(),
+                    err.what());
+        }
+        catch(...)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an unknown exception during a message processing. "
+                    "Module name: '%s'",
+                    getName().c_str());
+        }
     }
+    // release the messages
+    m_batch.clear();
+
+    dispatchResponses();
 }
 
 
@@ -202,7 +237,6 @@ void Module::init()
     Thread::init();
     BOOST_ASSERT(isStopped() == false);
     m_container.start();
-    m_sync_container.start();
 
     m_start_sem.init();
     registerStartupCheckpoint();
@@ -220,16 +254,19 @@ void Module::stop() throw()
 void Module::addMessage(const IMessagePtr& msg)
 {
     BOOST_ASSERT(msg);
-
-    klk_log(KLKLOG_DEBUG, "Module '%s' got a message (id: %s; UUID: %d)",
-            this->getName().c_str(),
-            msg->getID().c_str(), msg->getUUID());
+    if (msg->getType() != msg::SYNC_REQ)
+    {
+        // the message can be shared between several receivers
+        // since this moment thus it is read only.
+        // A sync request stays at the sender ownership: the sender
+        // waits for the response and can reuse the request after that
+        msg->seal();
+    }
 
     if (msg->getType() == msg::SYNC_RES)
     {
         // sync response message
-        Result rc = m_sync_container.add(msg);
-        BOOST_ASSERT(rc == OK);
+        completeRequest(msg);
     }
     else
     {
@@ -251,12 +288,77 @@ void Module::addMessage(const IMessagePtr& msg)
 void Module::sendSyncMessage(
     const IMessagePtr& in, IMessagePtr& out)
 {
+    BOOST_ASSERT(out == NULL);
     // initial set
     in->setType(msg::SYNC_REQ);
     in->setSenderID(this->getID());
 
+    MessageFuturePtr future = postRequest(in);
+    if (future->wait(TIMEINTERVAL4SYNCRES) != OK)
+    {
+        cancelRequest(in->getUUID());
+        // send trap
+        m_factory->getSNMP()->sendTrap(snmp::MODULE_DNT_RESPONDE,
+                                       *(in->getReceiverList().begin()));
+        throw Exception(__FILE__, __LINE__,
+                        "Module %s could not get response for "
+                        "sync message with id "
+                        "'%s' (UUID: %d) within '%d' sec.",
+                        getName().c_str(),
+                        in->getID().c_str(), in->getUUID(),
+                        TIMEINTERVAL4SYNCRES);
+    }
+
+    out = future->get(0);
+    BOOST_ASSERT(out->getID() == in->getID());
+    BOOST_ASSERT(out->getUUID() == in->getUUID());
+}
+
+// Sends a sync request without waiting for the response
+// @param[in] in - the request (should have one receiver)
+MessageFuturePtr Module::sendRequest(const IMessagePtr& in)
+{
+    in->setType(msg::SYNC_REQ);
+    in->setSenderID(this->getID());
+    // the receiver reads the request while the sender works
+    in->seal();
+    return postRequest(in);
+}
+
+// Sends a sync request with a completion callback
+// @param[in] in - the request (should have one receiver)
+// @param[in] func - the callback
+void Module::sendRequest(const IMessagePtr& in, ResponseFunction func)
+{
+    BOOST_ASSERT(func);
+    MessageFuturePtr future = sendRequest(in);
+
+    Locker lock(&m_pending_lock);
+    PendingMap::iterator i = m_pending.find(in->getUUID());
+    if (i != m_pending.end() && i->second.m_future == future)
+    {
+        i->second.m_func = func;
+        return;
+    }
+
+    // the request has been already completed
+    BOOST_ASSERT(future->isReady());
+    PendingRequest request;
+    request.m_future = future;
+    request.m_func = func;
+    request.m_deadline = 0;
+    m_completed.push_back(request);
+    m_container.interrupt();
+}
+
+// Delivers a sync request to the receiver
+// @param[in] in - the request
+MessageFuturePtr Module::postRequest(const IMessagePtr& in)
+{
+    BOOST_ASSERT(in->getType() == msg::SYNC_REQ);
+
     // get receiver
-    const StringList list = in->getReceiverList();
+    const StringList& list = in->getReceiverList();
     BOOST_ASSERT(list.size() == 1);
 
     const std::string receiver_id = *(list.begin());
@@ -274,56 +376,151 @@ void Module::sendSyncMessage(
 
     BOOST_ASSERT(receiver);
 
+    MessageFuturePtr future(new MessageFuture(in));
+    {
+        Locker lock(&m_pending_lock);
+        if (m_pending.find(in->getUUID()) != m_pending.end())
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Sync message with id '%s' (UUID: %d) "
+                            "is already in progress at module '%s'",
+                            in->getID().c_str(), in->getUUID(),
+                            getName().c_str());
+        }
+        PendingRequest request;
+        request.m_future = future;
+        request.m_deadline = time(NULL) + TIMEINTERVAL4SYNCRES;
+        m_pending.insert(PendingMap::value_type(in->getUUID(), request));
+    }
+
     klk_log(KLKLOG_DEBUG,
             "Send message (id: %s; UUID: %d) %s -> %s",
             in->getID().c_str(), in->getUUID(),
             this->getName().c_str(), receiver->getName().c_str());
 
     receiver->addMessage(in);
+    return future;
+}
 
-    BOOST_ASSERT(out == NULL);
-    while (!out)
+// Completes a pending request by the response
+// @param[in] response - the response
+void Module::completeRequest(const IMessagePtr& response)
+{
+    Locker lock(&m_pending_lock);
+    PendingMap::iterator i = m_pending.find(response->getUUID());
+    if (i == m_pending.end())
     {
-        Result rc = m_sync_container.get(out);
-        if (rc != OK)
+        // the request was expired or cancelled
+        klk_log(KLKLOG_ERROR,
+                "The module '%s' rejected message (id: %s, uuid: %d)",
+                getName().c_str(), response->getID().c_str(),
+                response->getUUID());
+        return;
+    }
+
+    const PendingRequest request = i->second;
+    m_pending.erase(i);
+    request.m_future->setResponse(response);
+    if (request.m_func)
+    {
+        m_completed.push_back(request);
+        m_container.interrupt();
+    }
+}
+
+// Removes a pending request
+// @param[in] uuid - the request UUID
+void Module::cancelRequest(msg::UUID uuid)
+{
+    Locker lock(&m_pending_lock);
+    m_pending.erase(uuid);
+}
+
+// Fails all pending requests
+// @param[in] reason - the failure description
+void Module::cancelRequests(const std::string& reason) throw()
+{
+    Locker lock(&m_pending_lock);
+    for (PendingMap::iterator i = m_pending.begin();
+         i != m_pending.end(); i++)
+    {
+        i->second.m_future->setFailed(reason);
+        if (i->second.m_func)
         {
-            // send trap
-            m_factory->getSNMP()->sendTrap(snmp::MODULE_DNT_RESPONDE,
-                                           receiver->getID());
-            throw Exception(__FILE__, __LINE__,
-                                 "Module %s could not get response for "
-                                 "sync message with id "
-                                 "'%s' (UUID: %d) within '%d' sec.",
-                                 getName().c_str(),
-                                 in->getID().c_str(), in->getUUID(),
-                                 TIMEINTERVAL4SYNCRES);
+            m_completed.push_back(i->second);
         }
+    }
+    m_pending.clear();
+}
 
-#if 0 //FIXME!!! dvbstreamer sends a lot of messages during unload
-        if (isStopped())
+// Fails the pending requests with exceeded deadline
+// @return the interval in seconds till the next deadline
+time_t Module::expireRequests()
+{
+    Locker lock(&m_pending_lock);
+    if (m_pending.empty())
+    {
+        return 0;
+    }
+
+    const time_t now = time(NULL);
+    time_t next = 0;
+    PendingMap::iterator i = m_pending.begin();
+    while (i != m_pending.end())
+    {
+        if (i->second.m_deadline > now)
         {
-            klk_log(KLKLOG_ERROR,
-                    "A sync message was not processed at module '%s'",
-                    getName().c_str());
-            KLKASSERT(0);
-            return ERROR;
+            const time_t interval = i->second.m_deadline - now;
+            if (next == 0 || interval < next)
+            {
+                next = interval;
+            }
+            i++;
+            continue;
         }
-#endif
-        BOOST_ASSERT(out);
 
-        if (out->getUUID() != in->getUUID())
+        i->second.m_future->setFailed("no response within the interval");
+        if (i->second.m_func)
         {
-            klk_log(
-                KLKLOG_ERROR,
-                "The  module'%s' rejected message (id: %s, uuid: %d)",
-                this->getName().c_str(), out->getID().c_str(),
-                out->getUUID());
-            out.reset();
+            m_completed.push_back(i->second);
         }
+        m_pending.erase(i++);
     }
+    return next;
+}
 
-    BOOST_ASSERT(out->getID() == in->getID());
-    BOOST_ASSERT(out->getUUID() == in->getUUID());
+// Calls callbacks for the completed requests
+void Module::dispatchResponses() throw()
+{
+    PendingList completed;
+    {
+        Locker lock(&m_pending_lock);
+        completed.swap(m_completed);
+    }
+
+    for (PendingList::iterator i = completed.begin();
+         i != completed.end(); i++)
+    {
+        try
+        {
+            i->m_func(i->m_future);
+        }
+        catch(const std::exception& err)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an exception during a response processing. "
+                    "Module name: '%s'; Description: %s",
+                    getName().c_str(),
+                    err.what());
+        }
+        catch(...)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an unknown exception during a response "
+                    "processing. Module name: '%s'",
+                    getName().c_str());
+        }
+    }
 }
 
 // Gets info for CLI
@@ -408,6 +605,12 @@ const double Module::getCPUUsage() const
     return -1;
 }
 
+// Retrives the message queue statistics
+const mod::QueueStat Module::getQueueStat() const
+{
+    return m_container.getStat();
+}
+
 // Register a thread
 void Module::registerThread(const IThreadPtr& thread)
 {
@@ -417,10 +620,17 @@ void Module::registerThread(const IThreadPtr& thread)
 // Register a timer
 void Module::registerTimer(TimerFunction f, const time_t intrv)
 {
+    BOOST_ASSERT(f);
+    BOOST_ASSERT(intrv > 0);
+    TimerInfo info;
+    info.m_f = f;
+    info.m_intrv = intrv;
+    info.m_id = 0;
+
+    Locker lock(&m_timers_lock);
     try
     {
-        IThreadPtr thread = IThreadPtr(new TimerThread(f, intrv));
-        registerThread(thread);
+        m_timers.push_back(info);
     }
     catch(const std::bad_alloc&)
     {
@@ -428,6 +638,35 @@ void Module::registerTimer(TimerFunction f, const time_t intrv)
     }
 }
 
+// Registers the module timers at the timer wheel
+void Module::startTimers()
+{
+    Locker lock(&m_timers_lock);
+    for (TimerList::iterator i = m_timers.begin(); i != m_timers.end(); i++)
+    {
+        if (i->m_id == 0)
+        {
+            const u_long interval = static_cast<u_long>(i->m_intrv) * 1000;
+            i->m_id = getFactory()->getTimerWheel()->add(
+                i->m_f, interval, interval / TIMER_SLACK_DIVIDER);
+        }
+    }
+}
+
+// Unregisters the module timers from the timer wheel
+void Module::stopTimers() throw()
+{
+    Locker lock(&m_timers_lock);
+    for (TimerList::iterator i = m_timers.begin(); i != m_timers.end(); i++)
+    {
+        if (i->m_id != 0)
+        {
+            getFactory()->getTimerWheel()->remove(i->m_id);
+            i->m_id = 0;
+        }
+    }
+}
+
 // Register an SNMP processor
 void Module::registerSNMP(snmp::DataProcessor f,
                           const std::string& sockname)
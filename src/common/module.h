@@ -41,14 +41,17 @@
 
 #include <string>
 #include <map>
+#include <list>
 
 #include "imodule.h"
 #include "ifactory.h"
 #include "messageholder.h"
+#include "msgfuture.h"
 #include "thread.h"
 #include "processor.h"
 #include "usage.h"
 #include "modulescheduler.h"
+#include "timerwheel.h"
 #include "klksemaphore.h"
 
 #include "snmp/processor.h"
@@ -83,6 +86,34 @@ namespace klk
         virtual void sendSyncMessage(const IMessagePtr& in,
                                      IMessagePtr& out);
 
+        /**
+           @brief Sends a sync request without waiting for the response
+
+           Several requests can be in progress at the same time. The
+           request can not be modified after the call.
+
+           @param[in] in - the request (should have one receiver)
+
+           @return the future for the response
+
+           @exception klk::Exception
+        */
+        MessageFuturePtr sendRequest(const IMessagePtr& in);
+
+        /**
+           @brief Sends a sync request with a completion callback
+
+           The callback is called from the module thread when the
+           response is got or the request is failed (for instance by
+           the timeout)
+
+           @param[in] in - the request (should have one receiver)
+           @param[in] func - the callback
+
+           @exception klk::Exception
+        */
+        void sendRequest(const IMessagePtr& in, ResponseFunction func);
+
         /// @copydoc klk::IModule::getUptime
         virtual const time_t getUptime() const;
 
@@ -93,6 +124,9 @@ namespace klk
            @return the CPU usage
         */
         virtual const double getCPUUsage() const;
+
+        /// @copydoc klk::IModule::getQueueStat
+        virtual const mod::QueueStat getQueueStat() const;
     protected:
         /**
            Gets factory
@@ -198,13 +232,30 @@ namespace klk
         void registerThread(const IThreadPtr& thread);
 
         /**
-           Register a time
+           Register a timer
+
+           The timer is served by the process-wide klk::TimerWheel
+           while the module is running
 
            @param[in] f - the function to be called
-           @param[in] intrv - the timer interval
+           @param[in] intrv - the timer interval (seconds)
         */
         void registerTimer(TimerFunction f, const time_t intrv);
 
+        /**
+           @brief Delivers a sync request to the receiver
+
+           The request is added to the pending requests list and is
+           delivered to the receiver module
+
+           @param[in] in - the request
+
+           @return the future for the response
+
+           @exception klk::Exception
+        */
+        virtual MessageFuturePtr postRequest(const IMessagePtr& in);
+
         /**
            Register an SNMP processor
 
@@ -218,10 +269,51 @@ namespace klk
         IFactory * const m_factory; ///< module factory
         std::string m_id; ///< module id
         MessageHolder4Standard m_container; ///< messages containers
-        MessageHolder4SyncRes m_sync_container; ///< sync msg container
+        MessageVector m_batch; ///< messages batch being processed
+        /**
+           @brief Sync request in progress
+        */
+        struct PendingRequest
+        {
+            MessageFuturePtr m_future; ///< the response future
+            ResponseFunction m_func; ///< completion callback (optional)
+            time_t m_deadline; ///< the response wait deadline
+        };
+
+        /**
+           Pending requests: UUID -> request
+        */
+        typedef std::map<msg::UUID, PendingRequest> PendingMap;
+
+        /**
+           Completed requests with callbacks
+        */
+        typedef std::list<PendingRequest> PendingList;
+
+        PendingMap m_pending; ///< sync requests in progress
+        PendingList m_completed; ///< requests for callbacks call
+        mutable Mutex m_pending_lock; ///< pending requests sync object
         Processor m_processor; ///< processor
         time_t m_start_time; ///< start time
         mod::Scheduler m_scheduler; ///< module scheduler
+
+        /**
+           @brief Module timer
+        */
+        struct TimerInfo
+        {
+            TimerFunction m_f; ///< timer function
+            time_t m_intrv; ///< timer interval
+            TimerID m_id; ///< id at the timer wheel (0 if not started)
+        };
+
+        /**
+           Module timers list
+        */
+        typedef std::list<TimerInfo> TimerList;
+
+        TimerList m_timers; ///< module timers
+        mutable Mutex m_timers_lock; ///< timers sync object
         UsagePtr m_usage; ///< usage class
         Semaphore m_start_sem; ///< startup semaphore
         int m_checkpoint_count; ///< check point counter
@@ -246,12 +338,60 @@ namespace klk
         /**
            Does the main action
 
-           Processes a message
+           Processes a batch of messages
         */
         void processMessage() throw();
 
         /// @copydoc klk::IModule::isStarted
         virtual bool isStarted() const;
+
+        /**
+           Completes a pending request by the response
+
+           @param[in] response - the response
+        */
+        void completeRequest(const IMessagePtr& response);
+
+        /**
+           Removes a pending request
+
+           @param[in] uuid - the request UUID
+        */
+        void cancelRequest(msg::UUID uuid);
+
+        /**
+           Fails all pending requests
+
+           @param[in] reason - the failure description
+        */
+        void cancelRequests(const std::string& reason) throw();
+
+        /**
+           Fails the pending requests with exceeded deadline
+
+           @return the interval in seconds till the next deadline
+           (0 - there are no pending requests)
+        */
+        time_t expireRequests();
+
+        /**
+           Calls callbacks for the completed requests
+        */
+        void dispatchResponses() throw();
+
+        /**
+           Registers the module timers at the timer wheel
+
+           @exception klk::Exception
+        */
+        void startTimers();
+
+        /**
+           Unregisters the module timers from the timer wheel
+
+           @note waits for the timer callbacks in progress
+        */
+        void stopTimers() throw();
     private:
         /**
            Copy constructor
@@ -49,51 +49,6 @@
 using namespace klk;
 using namespace klk::mod;
 
-//
-// TimerThread class
-//
-
-// Constructor
-TimerThread::TimerThread(TimerFunction f, time_t intrv) :
-    Thread(), m_f(f), m_intrv(intrv), m_wait()
-{
-}
-
-// starts the thread
-void TimerThread::start()
-{
-    // wait first
-    m_wait.startWait(m_intrv);
-
-    while (!isStopped())
-    {
-        try
-        {
-            // do the action
-            m_f();
-        }
-        catch(const std::exception& err)
-        {
-            klk_log(KLKLOG_ERROR,
-                    "Got an error in timer thread: %s",
-                    err.what());
-        }
-        catch(...)
-        {
-            klk_log(KLKLOG_ERROR, "Got an unspecified error in timer thread");
-        }
-
-        m_wait.startWait(m_intrv);
-    }
-}
-
-// stops the thread
-void TimerThread::stop() throw()
-{
-    Thread::stop();
-    m_wait.stopWait();
-}
-
 //
 // Scheduler class
 //
@@ -37,73 +37,15 @@
 #ifndef KLK_MODULESCHEDULER_H
 #define KLK_MODULESCHEDULER_H
 
-#include <boost/function/function0.hpp>
-
 #include "scheduler.h"
 
 namespace klk
 {
-    /**
-       Timer processor functor
-    */
-    typedef boost::function0<void> TimerFunction;
-
     /**
        Module scheduler thred list
     */
     typedef std::list<IThreadPtr> ThreadList;
 
-    /**
-       @brief Timer thread
-
-       The thread that does an action by a timer
-
-       @ingroup grThread
-    */
-    class TimerThread : public base::Thread
-    {
-    public:
-        /**
-           Constructor
-
-           @param[in] f - the function to be called
-           @param[in] intrv - the timer interval
-        */
-        explicit TimerThread(TimerFunction f,
-                             time_t intrv);
-
-        /**
-           Destructor
-        */
-        virtual ~TimerThread(){}
-    private:
-        TimerFunction m_f; ///< timer function
-        time_t m_intrv; ///< timer interval
-        klk::Event m_wait; ///< wait object
-
-        /**
-           @copydoc IThread::start
-        */
-        virtual void start();
-
-        /**
-           @copydoc IThread::stop
-        */
-        virtual void stop() throw();
-    private:
-        /**
-           Copy constructor
-           @param[in] value - the copy param
-        */
-        TimerThread(const TimerThread& value);
-
-        /**
-           Assigment operator
-           @param[in] value - the copy param
-        */
-        TimerThread& operator=(const TimerThread& value);
-    };
-
     namespace mod
     {
         /**
@@ -37,10 +37,13 @@
 #ifndef KLK_MODULEWITHINFO_H
 #define KLK_MODULEWITHINFO_H
 
+#include <set>
+
 #include <boost/static_assert.hpp>
 
 #include "mod/infocontainer.h"
 #include "moduledb.h"
+#include "dbchange.h"
 
 namespace klk
 {
@@ -176,6 +179,10 @@ namespace klk
         /**
            Process changes at the DB
 
+           The message can keep the changed rows (see klk::db::ChangeSet).
+           In the case only the infos for the rows are reloaded and
+           updated, otherwise all infos are reloaded
+
            @param[in] msg - the input message
 
            @exception @ref klk::Exception
@@ -184,6 +191,20 @@ namespace klk
         {
             BOOST_ASSERT(msg);
 
+            const db::ChangeSet changes(msg);
+            if (!changes.isFull())
+            {
+                klk_log(KLKLOG_DEBUG, "Processing %u DB changes for "
+                        "module '%s'", changes.size(), getName().c_str());
+
+                StringList uuids = changes.getChanged();
+                const InfoSet db_set = getChangedInfoFromDB(uuids);
+                const StringList deleted = changes.getDeleted();
+                uuids.insert(uuids.end(), deleted.begin(), deleted.end());
+                m_info.apply(uuids, db_set);
+                return;
+            }
+
             klk_log(KLKLOG_DEBUG, "Processing DB change event for module '%s'",
                     getName().c_str());
 
@@ -224,6 +245,38 @@ namespace klk
         */
         virtual const InfoSet getInfoFromDB() = 0;
 
+        /**
+           Retrives infos for the specified uuids from
+           @ref grDB "database"
+
+           The default implementation filters the full list. A module
+           should override it if the infos can be selected by uuids
+
+           @param[in] uuids - the uuids
+
+           @return the infos that are present at the DB
+        */
+        virtual const InfoSet getChangedInfoFromDB(const StringList& uuids)
+        {
+            if (uuids.empty())
+            {
+                return InfoSet();
+            }
+
+            const std::set<std::string> filter(uuids.begin(), uuids.end());
+            const InfoSet all = getInfoFromDB();
+            InfoSet result;
+            for (typename InfoSet::const_iterator i = all.begin();
+                 i != all.end(); i++)
+            {
+                if (filter.find((*i)->getUUID()) != filter.end())
+                {
+                    result.insert(*i);
+                }
+            }
+            return result;
+        }
+
         /**
            Finds an info by another info stored at an input message
 
@@ -0,0 +1,198 @@
+/**
+   @file src/common/msgfuture.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <time.h>
+
+#include <boost/assert.hpp>
+
+#include "msgfuture.h"
+#include "exception.h"
+
+using namespace klk;
+
+//
+// MessageFuture class
+//
+
+// Constructor
+// @param[in] request - the request message
+MessageFuture::MessageFuture(const IMessagePtr& request) :
+    m_request(request), m_response(), m_error(), m_ready(false)
+{
+    BOOST_ASSERT(m_request);
+    if (pthread_mutex_init(&m_mutex, NULL))
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_mutex_init() failed");
+    }
+
+    if (pthread_cond_init(&m_cond, NULL))
+    {
+        pthread_mutex_destroy(&m_mutex);
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_cond_init() failed");
+    }
+}
+
+// Destructor
+MessageFuture::~MessageFuture()
+{
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+// Checks is the future completed or not
+bool MessageFuture::isReady() const
+{
+    pthread_mutex_lock(&m_mutex);
+    const bool ready = m_ready;
+    pthread_mutex_unlock(&m_mutex);
+    return ready;
+}
+
+// Waits for the request completion
+// @param[in] timeout - the wait interval in seconds
+Result MessageFuture::wait(time_t timeout)
+{
+    struct timespec to;
+    to.tv_sec = time(NULL) + timeout;
+    to.tv_nsec = 0;
+
+    Result rc = OK;
+    pthread_mutex_lock(&m_mutex);
+    while (!m_ready)
+    {
+        if (pthread_cond_timedwait(&m_cond, &m_mutex, &to) == ETIMEDOUT)
+        {
+            rc = (m_ready ? OK : ERROR);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return rc;
+}
+
+// Gets the response
+// @param[in] timeout - the wait interval in seconds
+const IMessagePtr MessageFuture::get(time_t timeout)
+{
+    if (wait(timeout) != OK)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Could not get response for sync message "
+                        "with id '%s' (UUID: %d) within '%d' sec.",
+                        m_request->getID().c_str(), m_request->getUUID(),
+                        static_cast<int>(timeout));
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    const IMessagePtr response = m_response;
+    const std::string error = m_error;
+    pthread_mutex_unlock(&m_mutex);
+
+    if (!response)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Sync message with id '%s' (UUID: %d) "
+                        "was failed: %s",
+                        m_request->getID().c_str(), m_request->getUUID(),
+                        error.c_str());
+    }
+
+    return response;
+}
+
+// Completes the request with the response
+// @param[in] response - the response
+bool MessageFuture::setResponse(const IMessagePtr& response)
+{
+    BOOST_ASSERT(response);
+    if (response->getID() != m_request->getID())
+    {
+        return complete(IMessagePtr(),
+                        "wrong response with id '" +
+                        response->getID() + "'");
+    }
+    return complete(response, std::string());
+}
+
+// Completes the request with a failure
+// @param[in] reason - the failure description
+bool MessageFuture::setFailed(const std::string& reason)
+{
+    return complete(IMessagePtr(), reason);
+}
+
+// Completes the future
+// @param[in] response - the response (NULL for a failure)
+// @param[in] reason - the failure description
+bool MessageFuture::complete(const IMessagePtr& response,
+                             const std::string& reason)
+{
+    pthread_mutex_lock(&m_mutex);
+    const bool first = !m_ready;
+    if (first)
+    {
+        m_response = response;
+        m_error = reason;
+        m_ready = true;
+        pthread_cond_broadcast(&m_cond);
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return first;
+}
+
+// Waits for several requests completion (fan-in)
+// @param[in] futures - the requests to wait for
+// @param[in] timeout - the wait interval in seconds for all requests
+Result klk::waitFutures(const MessageFutureList& futures, time_t timeout)
+{
+    const time_t deadline = time(NULL) + timeout;
+    for (MessageFutureList::const_iterator i = futures.begin();
+         i != futures.end(); i++)
+    {
+        BOOST_ASSERT(*i);
+        const time_t now = time(NULL);
+        if ((*i)->wait(deadline > now ? deadline - now : 0) != OK)
+        {
+            return ERROR;
+        }
+    }
+    return OK;
+}
@@ -0,0 +1,197 @@
+/**
+   @file src/common/msgfuture.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_MSGFUTURE_H
+#define KLK_MSGFUTURE_H
+
+#include <pthread.h>
+
+#include <list>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function/function1.hpp>
+
+#include "imessage.h"
+#include "errors.h"
+#include "messageholder.h"
+
+namespace klk
+{
+    /**
+       @brief The response for a sync request
+
+       The future is created when a sync request is sent and it's
+       completed by the response or by a failure (timeout, module stop).
+       The requests are correlated with the responses by the
+       message UUID.
+
+       @ingroup grModule
+    */
+    class MessageFuture
+    {
+    public:
+        /**
+           Constructor
+
+           @param[in] request - the request message
+        */
+        explicit MessageFuture(const IMessagePtr& request);
+
+        /**
+           Destructor
+        */
+        ~MessageFuture();
+
+        /**
+           @return the request message
+        */
+        const IMessagePtr& getRequest() const throw() {return m_request;}
+
+        /**
+           Checks is the future completed or not
+
+           @return
+           - true - there is a response or the request was failed
+           - false - the request is in progress
+        */
+        bool isReady() const;
+
+        /**
+           Waits for the request completion
+
+           @param[in] timeout - the wait interval in seconds
+           (0 - just checks the state)
+
+           @return
+           - @ref OK - the request was completed
+           - @ref ERROR - the timeout exceeded
+        */
+        Result wait(time_t timeout);
+
+        /**
+           Gets the response
+
+           @param[in] timeout - the wait interval in seconds
+
+           @return the response
+
+           @exception klk::Exception if the request was failed or
+           it was not completed within the interval
+        */
+        const IMessagePtr get(time_t timeout = TIMEINTERVAL4SYNCRES);
+
+        /**
+           Completes the request with the response
+
+           @param[in] response - the response
+
+           @return
+           - true - the future was completed
+           - false - the future has been already completed
+        */
+        bool setResponse(const IMessagePtr& response);
+
+        /**
+           Completes the request with a failure
+
+           @param[in] reason - the failure description
+
+           @return
+           - true - the future was completed
+           - false - the future has been already completed
+        */
+        bool setFailed(const std::string& reason);
+    private:
+        const IMessagePtr m_request; ///< the request
+        IMessagePtr m_response; ///< the response
+        std::string m_error; ///< failure description
+        bool m_ready; ///< completion flag
+        mutable pthread_mutex_t m_mutex; ///< sync object
+        pthread_cond_t m_cond; ///< completion condition
+
+        /**
+           Completes the future
+
+           @param[in] response - the response (NULL for a failure)
+           @param[in] reason - the failure description
+
+           @return true if the future was completed by the call
+        */
+        bool complete(const IMessagePtr& response, const std::string& reason);
+    private:
+        /**
+           Copy constructor
+           @param[in] value - the copy param
+        */
+        MessageFuture(const MessageFuture& value);
+
+        /**
+           Assigment operator
+           @param[in] value - the copy param
+        */
+        MessageFuture& operator=(const MessageFuture& value);
+    };
+
+    /**
+       Message future smart pointer
+    */
+    typedef boost::shared_ptr<MessageFuture> MessageFuturePtr;
+
+    /**
+       Message future list
+    */
+    typedef std::list<MessageFuturePtr> MessageFutureList;
+
+    /**
+       Completion callback for a sync request
+
+       The callback is called from the requester module thread
+    */
+    typedef boost::function1<void, const MessageFuturePtr&> ResponseFunction;
+
+    /**
+       Waits for several requests completion (fan-in)
+
+       @param[in] futures - the requests to wait for
+       @param[in] timeout - the wait interval in seconds for all requests
+
+       @return
+       - @ref OK - all requests were completed
+       - @ref ERROR - the timeout exceeded
+    */
+    Result waitFutures(const MessageFutureList& futures, time_t timeout);
+}
+
+#endif //KLK_MSGFUTURE_H
@@ -71,6 +71,26 @@ namespace klk
         */
         const std::string SNMPCOMMUNITY = "SNMPCommunity";
 
+        /**
+           Message trace
+        */
+        const std::string MSGTRACE = "MessageTrace";
+
+        /**
+           Log level
+        */
+        const std::string LOGLEVEL = "LogLevel";
+
+        /**
+           Log target
+        */
+        const std::string LOGTARGET = "LogTarget";
+
+        /**
+           DVB adapter loops CPU affinity
+        */
+        const std::string DVBAFFINITY = "DVBAffinity";
+
         /** @} */
 
     }
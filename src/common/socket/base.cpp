@@ -40,6 +40,8 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <string.h>
 #include <errno.h>
 #include <netdb.h>
@@ -210,12 +212,12 @@ void Raw::setDescriptor(int sock)
 //
 
 // Default constructor
-Socket::Socket() : m_sock(), m_rater()
+Socket::Socket() : m_sock(), m_rater(), m_sndbuf(0)
 {
 }
 
 // Constructor from fd
-Socket::Socket(int fd) : m_sock(fd), m_rater()
+Socket::Socket(int fd) : m_sock(fd), m_rater(), m_sndbuf(0)
 {
 }
 
@@ -251,6 +253,7 @@ void Socket::disconnect() throw()
 {
     m_sock.stopCheckData();
     m_sock.disconnect();
+    m_sndbuf = 0;
 }
 
 // Helper function for host by name
@@ -332,20 +335,23 @@ void Socket::send(const BinaryData& data)
     if (data.empty())
         return; // no data nothing to send
 
-    size_t chunk_size = data.size();
-
     // During test on Mac OS X I discovered that it could not recive
     // UDP packet greater tan SO_SNDBUF bytes long
     // thus we split all data into packets that are no more than
-    // the buffer length
-    socklen_t optlen = sizeof(int);
-    if (getsockopt(m_sock.getDescriptor(), SOL_SOCKET, SO_SNDBUF,
-                   static_cast<size_t*>(&chunk_size), &optlen) < 0)
+    // the buffer length. The value is asked once per connection
+    if (m_sndbuf <= 0)
     {
-        throw Exception(__FILE__, __LINE__,
-                        "Error %d in getsockopt(): %s",
-                        errno, strerror(errno));
+        socklen_t optlen = sizeof(m_sndbuf);
+        if (getsockopt(m_sock.getDescriptor(), SOL_SOCKET, SO_SNDBUF,
+                       &m_sndbuf, &optlen) < 0)
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Error %d in getsockopt(): %s",
+                            errno, strerror(errno));
+        }
     }
+    const size_t chunk_size = (m_sndbuf > 0) ?
+        static_cast<size_t>(m_sndbuf) : data.size();
 
     // split data
     const u_char* begin = static_cast<const u_char*>(data.toVoid());
@@ -364,6 +370,89 @@ void Socket::send(const BinaryData& data)
     }
 }
 
+// Sends the data portions with one sendmsg() call
+const size_t Socket::sendVector(const BinaryDataVector& data,
+                                size_t offset, int flags)
+{
+    BOOST_ASSERT(m_sock.getDescriptor() >= 0);
+
+    std::vector<struct iovec> iov;
+    iov.reserve(std::min(data.size(), static_cast<size_t>(IOV_MAX)));
+    for (BinaryDataVector::const_iterator i = data.begin();
+         i != data.end() && iov.size() < static_cast<size_t>(IOV_MAX); i++)
+    {
+        BOOST_ASSERT(*i);
+        const size_t size = (*i)->size();
+        if (offset >= size)
+        {
+            // already sent
+            offset -= size;
+            continue;
+        }
+        struct iovec item;
+        item.iov_base = const_cast<u_char*>(
+            static_cast<const u_char*>((*i)->toVoid())) + offset;
+        item.iov_len = size - offset;
+        iov.push_back(item);
+        offset = 0;
+    }
+
+    if (iov.empty())
+        return 0; // nothing to send
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov[0];
+    msg.msg_iovlen = iov.size();
+    ssize_t err = ::sendmsg(m_sock.getDescriptor(), &msg, flags);
+    if (err < 0)
+    {
+        if (errno == EINTR ||
+            ((flags & MSG_DONTWAIT) && (errno == EAGAIN ||
+                                        errno == EWOULDBLOCK)))
+        {
+            // not ready for writing
+            return 0;
+        }
+        throw Exception(__FILE__, __LINE__,
+                        "Error %d in sendmsg(): %s",
+                        errno, strerror(errno));
+    }
+
+    m_rater.updateOutput(static_cast<size_t>(err));
+    return static_cast<size_t>(err);
+}
+
+// Sends several data portions with one system call
+void Socket::sendv(const BinaryDataVector& data)
+{
+    size_t total = 0;
+    for (BinaryDataVector::const_iterator i = data.begin();
+         i != data.end(); i++)
+    {
+        total += (*i)->size();
+    }
+
+    // a partial write is continued from the sent offset
+    for (size_t sent = 0; sent < total; )
+    {
+        sent += sendVector(data, sent, 0);
+    }
+}
+
+// Sends several data portions without blocking
+const size_t Socket::sendvNonBlock(const BinaryDataVector& data,
+                                   size_t offset)
+{
+    return sendVector(data, offset, MSG_DONTWAIT);
+}
+
+// Retrives the socket descriptor
+const int Socket::getDescriptor() const throw()
+{
+    return m_sock.getDescriptor();
+}
+
 // @copydoc klk::sock::ISocket::setSendTimeout
 void Socket::setSendTimeout(time_t timeout)
 {
@@ -386,6 +475,34 @@ void Socket::setKeepAlive(time_t timeout)
     klk_log(KLKLOG_DEBUG, "setKeepAlive() is not supported and ignored");
 }
 
+// @copydoc klk::ISocket::setRecvBuffer
+void Socket::setRecvBuffer(size_t size)
+{
+    BOOST_ASSERT(m_sock.getDescriptor() >= 0);
+    int value = static_cast<int>(size);
+#ifdef SO_RCVBUFFORCE
+    // the privileged call is not limited by net.core.rmem_max
+    if (setsockopt(m_sock.getDescriptor(), SOL_SOCKET, SO_RCVBUFFORCE,
+                   &value, sizeof(value)) == 0)
+    {
+        return;
+    }
+#endif
+    if (setsockopt(m_sock.getDescriptor(), SOL_SOCKET, SO_RCVBUF,
+                   &value, sizeof(value)) < 0)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Error %d in setsockopt(): %s",
+                        errno, strerror(errno));
+    }
+}
+
+// @copydoc klk::ISocket::getDroppedCount
+const u_long Socket::getDroppedCount() const
+{
+    return m_rater.getDropped();
+}
+
 //
 // Listener class
 //
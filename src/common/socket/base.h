@@ -186,6 +186,16 @@ namespace klk
                @exception klk::Exception
             */
             virtual void send(const BinaryData& data);
+
+            /// @copydoc klk::ISocket::sendv
+            virtual void sendv(const BinaryDataVector& data);
+
+            /// @copydoc klk::ISocket::sendvNonBlock
+            virtual const size_t sendvNonBlock(const BinaryDataVector& data,
+                                               size_t offset);
+
+            /// @copydoc klk::ISocket::getDescriptor
+            virtual const int getDescriptor() const throw();
         protected:
             Raw m_sock; ///< the socket descriptor
             Rater m_rater; ///< rate mesure
@@ -213,6 +223,24 @@ namespace klk
                 addr2String(const int af,
                             const struct sockaddr_in& addr);
         private:
+            int m_sndbuf; ///< cached SO_SNDBUF value, 0 if unknown
+
+            /**
+               Sends the data portions with one sendmsg() call
+
+               @param[in] data - the data portions
+               @param[in] offset - the offset in the whole data
+               @param[in] flags - the sendmsg() flags
+
+               @return the number of bytes that were sent. 0 means that
+               the call was interrupted or the non blocking socket
+               is not ready
+
+               @exception klk::Exception
+            */
+            const size_t sendVector(const BinaryDataVector& data,
+                                    size_t offset, int flags);
+
             /**
                Retrive input rate
 
@@ -241,6 +269,12 @@ namespace klk
 
             /// @copydoc klk::sock::ISocket::setKeepAlive
             virtual void setKeepAlive(time_t timeout);
+
+            /// @copydoc klk::ISocket::setRecvBuffer
+            virtual void setRecvBuffer(size_t size);
+
+            /// @copydoc klk::ISocket::getDroppedCount
+            virtual const u_long getDroppedCount() const;
         private:
             /**
                Copy constructor
@@ -54,7 +54,7 @@ Rater::Rater() :
     m_lock(),
     m_in_rate(0), m_out_rate(0),
     m_in_size(0), m_out_size(0),
-    m_in_last(time(NULL)), m_out_last(time(NULL))
+    m_in_last(time(NULL)), m_out_last(time(NULL)), m_dropped(0)
 {
 }
 
@@ -97,6 +97,20 @@ void Rater::updateOutput(const size_t size)
     }
 }
 
+// Updates the dropped data packets count
+void Rater::updateDropped(const size_t count)
+{
+    Locker lock(&m_lock);
+    m_dropped += count;
+}
+
+// Retrives the dropped data packets count
+const u_long Rater::getDropped() const
+{
+    Locker lock(&m_lock);
+    return m_dropped;
+}
+
 // Retrives input rate
 const double Rater::getInputRate() const
 {
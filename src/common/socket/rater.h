@@ -75,6 +75,21 @@ namespace klk
         */
         void updateOutput(const size_t size);
 
+        /**
+           Updates the count of the data packets that were dropped
+           before they were received (receive buffer overflow)
+
+           @param[in] count - the count to be added
+        */
+        void updateDropped(const size_t count);
+
+        /**
+           Retrives the dropped data packets count
+
+           @return the count
+        */
+        const u_long getDropped() const;
+
         /**
            Retrives input rate
 
@@ -96,6 +111,7 @@ namespace klk
         size_t m_out_size; ///< output data sent
         time_t m_in_last; ///< last mesured time (for input data)
         time_t m_out_last; ///< last mesured time (for output data)
+        u_long m_dropped; ///< dropped data packets count
     private:
         /**
            Copy constructor
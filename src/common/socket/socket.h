@@ -41,6 +41,7 @@
 #include <time.h>
 
 #include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
@@ -61,6 +62,12 @@ namespace klk
         @{
     */
 
+    /**
+       Data portions for the vectored send. The data is not owned
+       by the vector
+    */
+    typedef std::vector<const BinaryData*> BinaryDataVector;
+
     /**
        @brief Socket interface
 
@@ -88,6 +95,14 @@ namespace klk
         */
         virtual const double getOutputRate() const = 0;
 
+        /**
+           Retrives the count of data packets that were dropped by
+           the kernel because of the receive buffer overflow
+
+           @return the count (0 if it is not supported for the socket)
+        */
+        virtual const u_long getDroppedCount() const = 0;
+
         /**
            Sends a data portion
 
@@ -191,6 +206,50 @@ namespace klk
            sending keepalive probes. 0 means disable the keepalive
         */
         virtual void setKeepAlive(time_t timeout) = 0;
+
+        /**
+           Sets the receive buffer size
+
+           @param[in] size - the size in bytes
+
+           @exception Exception
+        */
+        virtual void setRecvBuffer(size_t size) = 0;
+
+        /**
+           Sends several data portions with one system call (vectored send)
+
+           @param[in] data - the data portions
+
+           @exception Exception
+        */
+        virtual void sendv(const BinaryDataVector& data) = 0;
+
+        /**
+           Sends several data portions without blocking
+
+           @param[in] data - the data portions
+           @param[in] offset - the offset (in bytes) in the whole data
+           from which the send starts
+
+           @return the number of bytes that were sent. 0 means that
+           the socket is not ready for writing now
+
+           @note used by event driven connection engines
+
+           @exception Exception
+        */
+        virtual const size_t sendvNonBlock(const BinaryDataVector& data,
+                                           size_t offset) = 0;
+
+        /**
+           Retrives the socket descriptor
+
+           @return the descriptor or -1 if there is no such one
+
+           @note used by event driven connection engines (epoll)
+        */
+        virtual const int getDescriptor() const throw() = 0;
     };
 
     /**
@@ -308,6 +367,22 @@ namespace klk
     */
     const size_t SOCKBUFFSIZE = (16384);
 
+    /**
+       Max datagrams count that is received by a UDP socket
+       with one system call
+    */
+    const size_t UDP_BATCH_SIZE = (16);
+
+    /**
+       Max UDP datagram size
+    */
+    const size_t UDP_DATAGRAM_MAX_SIZE = (65536);
+
+    /**
+       Default receive buffer size for UDP listeners
+    */
+    const size_t UDP_RCVBUF_SIZE = (2*1024*1024);
+
     /** @} */
 };
 
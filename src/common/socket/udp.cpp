@@ -44,6 +44,8 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 
+#include <algorithm>
+
 #include "udp.h"
 #include "exception.h"
 #include "socket/exception.h"
@@ -51,6 +53,11 @@
 using namespace klk;
 using namespace klk::sock;
 
+/**
+   Control message buffer size for a datagram (SO_RXQ_OVFL)
+*/
+static const size_t UDP_CONTROL_SIZE = CMSG_SPACE(sizeof(u_int32_t));
+
 //
 // UDPSocket class
 //
@@ -198,7 +205,9 @@ void UDPConnectSocket::connect(const RouteInfo& route)
 
 // Constructor
 UDPListenSocket::UDPListenSocket(int fd) :
-    UDPSocket(fd), m_event(), m_addr_len(0)
+    UDPSocket(fd), m_event(), m_addr_len(0), m_slab(), m_msgs(), m_iov(),
+    m_addrs(), m_control(), m_count(0), m_index(0), m_offset(0),
+    m_drops(0)
 {
     BOOST_ASSERT(m_sock.getDescriptor() >= 0);
 }
@@ -261,12 +270,69 @@ void UDPListenSocket::send(const BinaryData& data)
 }
 
 // Recieves a data portion
+// The data from several datagrams can be returned
 void UDPListenSocket::recv(BinaryData& data)
 {
     BOOST_ASSERT(m_sock.getDescriptor() >= 0);
     BOOST_ASSERT(data.empty() == false);
 
     try
+    {
+        if (m_index >= m_count)
+        {
+            receiveBatch();
+        }
+
+        char* out = static_cast<char*>(data.toVoid());
+        size_t size = 0;
+        while (m_index < m_count && size < data.size())
+        {
+            const size_t len = m_msgs[m_index].msg_len;
+            const size_t count = std::min(len - m_offset, data.size() - size);
+            memcpy(out + size,
+                   &m_slab[m_index * UDP_DATAGRAM_MAX_SIZE] + m_offset,
+                   count);
+            size += count;
+            m_offset += count;
+
+            // the sender of the datagram
+            m_addr = m_addrs[m_index];
+            m_addr_len = m_msgs[m_index].msg_hdr.msg_namelen;
+
+            if (m_offset == len)
+            {
+                m_index++;
+                m_offset = 0;
+            }
+        }
+
+        if (size < data.size())
+        {
+            data.resize(size);
+        }
+    }
+    catch(...)
+    {
+        disconnect();
+        throw;
+    }
+}
+
+// Receives a batch of datagrams
+void UDPListenSocket::receiveBatch()
+{
+    if (m_slab.empty())
+    {
+        // the storage is allocated once
+        m_slab.resize(UDP_BATCH_SIZE * UDP_DATAGRAM_MAX_SIZE);
+        m_msgs.resize(UDP_BATCH_SIZE);
+        m_iov.resize(UDP_BATCH_SIZE);
+        m_addrs.resize(UDP_BATCH_SIZE);
+        m_control.resize(UDP_BATCH_SIZE * UDP_CONTROL_SIZE);
+    }
+
+    m_count = m_index = m_offset = 0;
+    for(;;)
     {
         // check data within a specified period
         const time_t CHECK_INTERVAL = (10);
@@ -277,31 +343,108 @@ void UDPListenSocket::recv(BinaryData& data)
                                         "on the localhost");
         }
 
-        m_addr_len = sizeof(m_addr);
-        int count =
-            ::recvfrom(m_sock.getDescriptor(), data.toVoid(), data.size(),
-                       0,
-                       reinterpret_cast<struct sockaddr*>(&m_addr),
-                       &m_addr_len);
+        // the kernel changes the lengths thus they are set each time
+        for (size_t i = 0; i < UDP_BATCH_SIZE; i++)
+        {
+            m_iov[i].iov_base = &m_slab[i * UDP_DATAGRAM_MAX_SIZE];
+            m_iov[i].iov_len = UDP_DATAGRAM_MAX_SIZE;
+            memset(&m_msgs[i], 0, sizeof(m_msgs[i]));
+            struct msghdr& hdr = m_msgs[i].msg_hdr;
+            hdr.msg_iov = &m_iov[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_name = &m_addrs[i];
+            hdr.msg_namelen = sizeof(m_addrs[i]);
+            hdr.msg_control = &m_control[i * UDP_CONTROL_SIZE];
+            hdr.msg_controllen = UDP_CONTROL_SIZE;
+        }
+
+#ifdef LINUX
+        int count = recvmmsg(m_sock.getDescriptor(), &m_msgs[0],
+                             UDP_BATCH_SIZE, MSG_DONTWAIT, NULL);
+#else
+        int count = recvmsg(m_sock.getDescriptor(), &m_msgs[0].msg_hdr,
+                            MSG_DONTWAIT);
+        if (count >= 0)
+        {
+            m_msgs[0].msg_len = count;
+            count = 1;
+        }
+#endif
         if (count < 0)
         {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                continue;
+            }
             throw Exception(__FILE__, __LINE__,
-                                 "Error %d in recvfrom(): %s",
+                                 "Error %d in recvmmsg(): %s",
                                  errno,
                                  strerror(errno));
         }
-        else if (count < static_cast<int>(data.size()))
+
+        size_t size = 0;
+        for (int i = 0; i < count; i++)
         {
-            data.resize(count);
+            size += m_msgs[i].msg_len;
+            processControl(m_msgs[i].msg_hdr);
         }
 
-        m_rater.updateInput(static_cast<size_t>(count));
+        m_count = static_cast<size_t>(count);
+        m_rater.updateInput(size);
+        return;
     }
-    catch(...)
+}
+
+// Processes the control messages of a datagram
+void UDPListenSocket::processControl(struct msghdr& msg)
+{
+    if (msg.msg_flags & MSG_TRUNC)
     {
-        disconnect();
-        throw;
+        klk_log(KLKLOG_ERROR, "UDP datagram from %s was truncated",
+                addr2String(AF_INET,
+                            *static_cast<struct sockaddr_in*>(
+                                msg.msg_name)).c_str());
+    }
+
+#ifdef SO_RXQ_OVFL
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+        {
+            // the kernel reports the total drops count for the socket
+            // and attaches it only after the first drop: the counter
+            // starts from 0 (the subtraction is wrap safe)
+            u_int32_t drops = 0;
+            memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+            if (drops != m_drops)
+            {
+                const u_int32_t count = drops - m_drops;
+                m_rater.updateDropped(count);
+                m_drops = drops;
+            }
+        }
+    }
+#endif
+}
+
+// Checks is there any data available at the socket or not
+Result UDPListenSocket::checkData(time_t timeout)
+{
+    if (m_index < m_count)
+    {
+        // there are datagrams that were not read yet
+        return OK;
     }
+    return Socket::checkData(timeout);
+}
+
+// Inits the UDP socket
+void UDPListenSocket::init()
+{
+    m_event.init();
+    // the datagrams from the previous session are dropped
+    m_count = m_index = m_offset = 0;
 }
 
 // Stops the UDP socket
@@ -397,7 +540,7 @@ void UDPListener::init()
                              errno, strerror(errno));
     }
 
-    u_int buffsize = 240*1024;
+    u_int buffsize = UDP_RCVBUF_SIZE;
     if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF,
                    &buffsize, sizeof(u_int)) < 0)
     {
@@ -406,6 +549,16 @@ void UDPListener::init()
                              errno, strerror(errno));
     }
 
+#ifdef SO_RXQ_OVFL
+    // the kernel will report dropped datagrams count
+    if (setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL,
+                   &yes, sizeof(u_int)) < 0)
+    {
+        klk_log(KLKLOG_ERROR, "Error %d in setsockopt(SO_RXQ_OVFL): %s",
+                errno, strerror(errno));
+    }
+#endif
+
 
 #if 0
     u_int mincount = 10;
@@ -38,6 +38,10 @@
 #define KLK_UDPSOCKET_H
 
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include <vector>
 
 #include "base.h"
 #include "thread.h"
@@ -172,10 +176,28 @@ namespace klk
         };
 
 
+#ifdef LINUX
+        /**
+           Datagram header for recvmmsg()
+        */
+        typedef struct mmsghdr UDPMessage;
+#else
+        /**
+           Datagram header (recvmmsg() compatible)
+        */
+        struct UDPMessage
+        {
+            struct msghdr msg_hdr; ///< the message header
+            unsigned int msg_len; ///< received bytes count
+        };
+#endif
+
         /**
            @brief UDP listen socket class
 
-           UDP listen socket class
+           UDP listen socket class. The datagrams are received in
+           batches (recvmmsg()) into a preallocated slab and then
+           are returned by recv() as a data stream
         */
         class UDPListenSocket : public UDPSocket
         {
@@ -215,10 +237,24 @@ namespace klk
             */
             void stop() throw();
 
+            /**
+               Checks is there any data available at the socket or not
+
+               The datagrams that were received but not read yet
+               are also taken into account
+
+               @param[in] timeout - the timeout interval
+
+               @return
+               - @ref klk::OK - data available
+               - @ref klk::ERROR - no data or timeout
+            */
+            virtual Result checkData(time_t timeout);
+
             /**
                Inits the UDP socket
             */
-            void init() {m_event.init();}
+            void init();
 
             /**
                Starts wait for a socket
@@ -242,6 +278,29 @@ namespace klk
             Trigger m_event;  ///< event for stopping
             struct sockaddr_in m_addr; ///< last input addr
             socklen_t m_addr_len; ///< last input addr len
+            std::vector<char> m_slab; ///< the datagrams storage
+            std::vector<UDPMessage> m_msgs; ///< the datagram headers
+            std::vector<struct iovec> m_iov; ///< the datagram buffers
+            std::vector<struct sockaddr_in> m_addrs; ///< the senders
+            std::vector<char> m_control; ///< the control messages
+            size_t m_count; ///< received datagrams count
+            size_t m_index; ///< the datagram that is being read
+            size_t m_offset; ///< read bytes count at the datagram
+            u_int32_t m_drops; ///< the last kernel drop counter value
+
+            /**
+               Receives a batch of datagrams
+
+               @exception klk::Exception
+            */
+            void receiveBatch();
+
+            /**
+               Processes the control messages of a datagram
+
+               @param[in] msg - the datagram header
+            */
+            void processControl(struct msghdr& msg);
 
             /**
                @brief Closes connection
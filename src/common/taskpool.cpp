@@ -0,0 +1,498 @@
+/**
+   @file src/common/taskpool.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include <boost/assert.hpp>
+#include <boost/bind.hpp>
+
+#include "taskpool.h"
+#include "log.h"
+#include "exception.h"
+
+using namespace klk;
+
+// Gets current time in milliseconds
+static long long get_current_ms()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+namespace klk
+{
+    /**
+       @brief Worker queue
+    */
+    struct TaskPool::Queue
+    {
+        u_int m_index; ///< worker index
+        Mutex m_lock; ///< queue locker
+        std::deque<TaskFunction> m_tasks; ///< tasks
+    };
+}
+
+//
+// TaskPool class
+//
+
+// Constructor
+// @param[in] workers - the worker threads count (0 - CPU count)
+// @param[in] pin - pin the workers to the CPU cores
+TaskPool::TaskPool(u_int workers, bool pin) :
+    m_mutex(), m_scheduler(), m_queues(), m_delayed(), m_delayed_next(0),
+    m_pin(pin),
+    m_stop(false), m_sleeping(0), m_next(0),
+    m_posted(0), m_executed(0), m_stolen(0), m_failed(0)
+{
+    if (workers == 0)
+    {
+        workers = getCPUCount();
+    }
+
+    if (pthread_cond_init(&m_cond, NULL))
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_cond_init() failed");
+    }
+
+    if (pthread_key_create(&m_key, NULL))
+    {
+        pthread_cond_destroy(&m_cond);
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_key_create() failed");
+    }
+
+    try
+    {
+        for (u_int i = 0; i < workers; i++)
+        {
+            Queue* queue = new Queue();
+            queue->m_index = i;
+            m_queues.push_back(queue);
+        }
+
+        for (QueueVector::iterator i = m_queues.begin();
+             i != m_queues.end(); i++)
+        {
+            m_scheduler.startThread(
+                IThreadPtr(new base::FunctionThread(
+                               boost::bind(&TaskPool::runWorker, this, *i),
+                               boost::bind(&TaskPool::wakeup, this))));
+        }
+    }
+    catch(...)
+    {
+        stop();
+        for (QueueVector::iterator i = m_queues.begin();
+             i != m_queues.end(); i++)
+        {
+            delete *i;
+        }
+        pthread_key_delete(m_key);
+        pthread_cond_destroy(&m_cond);
+        throw;
+    }
+}
+
+// Destructor
+TaskPool::~TaskPool()
+{
+    stop();
+    for (QueueVector::iterator i = m_queues.begin();
+         i != m_queues.end(); i++)
+    {
+        delete *i;
+    }
+    m_queues.clear();
+
+    pthread_key_delete(m_key);
+    pthread_cond_destroy(&m_cond);
+}
+
+// Adds a task for execution
+void TaskPool::post(TaskFunction f)
+{
+    BOOST_ASSERT(f);
+    if (m_stop)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Trying to post a task during the pool stop. "
+                "It was ignored");
+        return;
+    }
+
+    push(f);
+}
+
+// Adds a task that will be executed after the delay
+void TaskPool::schedule(TaskFunction f, u_long delay)
+{
+    BOOST_ASSERT(f);
+    if (delay == 0)
+    {
+        post(f);
+        return;
+    }
+
+    Locker lock(&m_mutex);
+    if (m_stop)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Trying to schedule a task during the pool stop. "
+                "It was ignored");
+        return;
+    }
+
+    m_delayed.insert(std::make_pair(get_current_ms() + delay, f));
+    m_delayed_next = m_delayed.begin()->first;
+    __sync_add_and_fetch(&m_posted, 1);
+    // an idle worker recalculates its wait interval
+    pthread_cond_signal(&m_cond);
+}
+
+// Stops the pool
+void TaskPool::stop() throw()
+{
+    {
+        Locker lock(&m_mutex);
+        m_stop = true;
+        m_delayed.clear();
+        m_delayed_next = 0;
+        pthread_cond_broadcast(&m_cond);
+    }
+    m_scheduler.stop();
+}
+
+// Gets the statistics
+const TaskPoolStat TaskPool::getStat() const
+{
+    TaskPoolStat stat;
+    stat.m_workers = m_queues.size();
+    stat.m_posted = __sync_add_and_fetch(
+        const_cast<u_long*>(&m_posted), 0);
+    stat.m_executed = __sync_add_and_fetch(
+        const_cast<u_long*>(&m_executed), 0);
+    stat.m_stolen = __sync_add_and_fetch(
+        const_cast<u_long*>(&m_stolen), 0);
+    stat.m_failed = __sync_add_and_fetch(
+        const_cast<u_long*>(&m_failed), 0);
+    stat.m_queued = 0;
+    for (QueueVector::const_iterator i = m_queues.begin();
+         i != m_queues.end(); i++)
+    {
+        Locker lock(&(*i)->m_lock);
+        stat.m_queued += (*i)->m_tasks.size();
+    }
+
+    Locker lock(&m_mutex);
+    stat.m_delayed = m_delayed.size();
+    return stat;
+}
+
+// Gets available CPU cores count
+u_int TaskPool::getCPUCount() throw()
+{
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0 ? static_cast<u_int>(count) : 1);
+}
+
+// Pins the current thread to a CPU core
+Result TaskPool::pinThread(u_int cpu) throw()
+{
+#ifdef LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % getCPUCount(), &set);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Error %d in pthread_setaffinity_np(): %s",
+                rc, strerror(rc));
+        return ERROR;
+    }
+    return OK;
+#else
+    return ERROR;
+#endif //LINUX
+}
+
+// Pins the current thread to the cores of a NUMA node
+Result TaskPool::pinThreadToNode(u_int node) throw()
+{
+#ifdef LINUX
+    char path[128];
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/node/node%u/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+    {
+        klk_log(KLKLOG_ERROR, "NUMA node %u is not available", node);
+        return ERROR;
+    }
+
+    // the list format is "0-3,8-11"
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    u_int first = 0, last = 0, count = 0;
+    int rc = 0;
+    while ((rc = fscanf(file, "%u", &first)) == 1)
+    {
+        last = first;
+        int ch = fgetc(file);
+        if (ch == '-')
+        {
+            if (fscanf(file, "%u", &last) != 1)
+                break;
+            ch = fgetc(file);
+        }
+        for (u_int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        {
+            CPU_SET(cpu, &set);
+            count++;
+        }
+        if (ch != ',')
+            break;
+    }
+    fclose(file);
+
+    if (count == 0)
+    {
+        klk_log(KLKLOG_ERROR, "NUMA node %u does not have any cores", node);
+        return ERROR;
+    }
+
+    rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Error %d in pthread_setaffinity_np(): %s",
+                rc, strerror(rc));
+        return ERROR;
+    }
+    return OK;
+#else
+    return ERROR;
+#endif //LINUX
+}
+
+// Pushes a task to a worker queue
+void TaskPool::push(const TaskFunction& f)
+{
+    BOOST_ASSERT(m_queues.empty() == false);
+
+    // the worker own queue first
+    Queue* queue = static_cast<Queue*>(pthread_getspecific(m_key));
+    if (queue == NULL)
+    {
+        const u_long next = __sync_fetch_and_add(&m_next, 1);
+        queue = m_queues[next % m_queues.size()];
+    }
+
+    {
+        Locker lock(&queue->m_lock);
+        queue->m_tasks.push_back(f);
+    }
+    __sync_add_and_fetch(&m_posted, 1);
+
+    // idle workers register before the queues check (see runWorker)
+    __sync_synchronize();
+    if (m_sleeping > 0)
+    {
+        Locker lock(&m_mutex);
+        pthread_cond_signal(&m_cond);
+    }
+}
+
+// Gets a task for a worker
+bool TaskPool::pop(Queue* queue, TaskFunction& f)
+{
+    // the own queue: last in first out (hot data in the cache)
+    {
+        Locker lock(&queue->m_lock);
+        if (!queue->m_tasks.empty())
+        {
+            f = queue->m_tasks.back();
+            queue->m_tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task from another worker
+    const size_t count = m_queues.size();
+    for (size_t k = 1; k < count; k++)
+    {
+        Queue* victim = m_queues[(queue->m_index + k) % count];
+        Locker lock(&victim->m_lock);
+        if (!victim->m_tasks.empty())
+        {
+            f = victim->m_tasks.front();
+            victim->m_tasks.pop_front();
+            __sync_add_and_fetch(&m_stolen, 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Moves the delayed tasks with expired time to a queue
+bool TaskPool::moveDelayed(Queue* queue, long long& next)
+{
+    bool moved = false;
+    const long long now = get_current_ms();
+    while (!m_delayed.empty() && m_delayed.begin()->first <= now)
+    {
+        {
+            Locker lock(&queue->m_lock);
+            queue->m_tasks.push_back(m_delayed.begin()->second);
+        }
+        m_delayed.erase(m_delayed.begin());
+        moved = true;
+    }
+
+    next = (m_delayed.empty() ? 0 : m_delayed.begin()->first);
+    m_delayed_next = next;
+    return moved;
+}
+
+// Executes a task
+void TaskPool::execute(const TaskFunction& f) throw()
+{
+    try
+    {
+        f();
+    }
+    catch(const std::exception& err)
+    {
+        __sync_add_and_fetch(&m_failed, 1);
+        klk_log(KLKLOG_ERROR, "Got an error in a pool task: %s",
+                err.what());
+    }
+    catch(...)
+    {
+        __sync_add_and_fetch(&m_failed, 1);
+        klk_log(KLKLOG_ERROR, "Got an unspecified error in a pool task");
+    }
+    __sync_add_and_fetch(&m_executed, 1);
+}
+
+// Worker thread body
+void TaskPool::runWorker(Queue* queue)
+{
+    BOOST_ASSERT(queue);
+    pthread_setspecific(m_key, queue);
+    if (m_pin)
+    {
+        pinThread(queue->m_index);
+    }
+
+    for (;;)
+    {
+        // the due delayed tasks should not wait until the workers are idle
+        const long long delayed = m_delayed_next;
+        if (delayed != 0 && delayed <= get_current_ms())
+        {
+            Locker lock(&m_mutex);
+            long long next = 0;
+            moveDelayed(queue, next);
+        }
+
+        TaskFunction f;
+        if (pop(queue, f))
+        {
+            execute(f);
+            continue;
+        }
+
+        bool found = false;
+        {
+            Locker lock(&m_mutex);
+            long long next = 0;
+            if (moveDelayed(queue, next))
+            {
+                continue;
+            }
+
+            if (m_stop)
+            {
+                // the queues were drained
+                break;
+            }
+
+            // posters check the counter after the task push
+            __sync_add_and_fetch(&m_sleeping, 1);
+            found = pop(queue, f);
+            if (!found)
+            {
+                if (next == 0)
+                {
+                    pthread_cond_wait(&m_cond, m_mutex.getMutex());
+                }
+                else
+                {
+                    struct timespec to;
+                    to.tv_sec = static_cast<time_t>(next / 1000);
+                    to.tv_nsec = static_cast<long>(next % 1000) * 1000000;
+                    pthread_cond_timedwait(&m_cond, m_mutex.getMutex(), &to);
+                }
+            }
+            __sync_sub_and_fetch(&m_sleeping, 1);
+        }
+
+        if (found)
+        {
+            execute(f);
+        }
+    }
+
+    pthread_setspecific(m_key, NULL);
+}
+
+// Wakes up all workers
+void TaskPool::wakeup() throw()
+{
+    Locker lock(&m_mutex);
+    pthread_cond_broadcast(&m_cond);
+}
@@ -0,0 +1,276 @@
+/**
+   @file src/common/taskpool.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TASKPOOL_H
+#define KLK_TASKPOOL_H
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <boost/function/function0.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "errors.h"
+#include "scheduler.h"
+#include "thread.h"
+
+namespace klk
+{
+    /**
+       Task functor
+    */
+    typedef boost::function0<void> TaskFunction;
+
+    /**
+       @brief Task pool statistics
+    */
+    struct TaskPoolStat
+    {
+        u_long m_workers; ///< worker threads count
+        u_long m_posted; ///< tasks posted
+        u_long m_executed; ///< tasks executed
+        u_long m_stolen; ///< tasks taken from another worker queue
+        u_long m_failed; ///< tasks finished with an exception
+        u_long m_queued; ///< tasks waiting for execution
+        u_long m_delayed; ///< delayed tasks waiting for the time
+    };
+
+    /**
+       @brief Work-stealing task pool
+
+       Executes short-lived jobs (connection teardown, DB reloads etc.)
+       without a thread per job.
+
+       Each worker has its own task queue. A task posted from a worker
+       goes to the worker queue, other tasks are distributed round-robin.
+       An idle worker takes tasks from the other queues.
+
+       The threads are started at the pool construction.
+
+       @ingroup grThread
+    */
+    class TaskPool
+    {
+    public:
+        /**
+           Constructor
+
+           @param[in] workers - the worker threads count (0 - CPU count)
+           @param[in] pin - pin the workers to the CPU cores
+        */
+        explicit TaskPool(u_int workers = 0, bool pin = false);
+
+        /**
+           Destructor
+
+           @see TaskPool::stop
+        */
+        ~TaskPool();
+
+        /**
+           Adds a task for execution
+
+           @param[in] f - the task
+
+           @note the task is ignored after the pool stop
+
+           @exception klk::Exception
+        */
+        void post(TaskFunction f);
+
+        /**
+           Adds a task that will be executed after the delay
+
+           @param[in] f - the task
+           @param[in] delay - the delay in milliseconds
+
+           @exception klk::Exception
+        */
+        void schedule(TaskFunction f, u_long delay);
+
+        /**
+           Stops the pool
+
+           The queued tasks are executed, the delayed ones are dropped
+        */
+        void stop() throw();
+
+        /**
+           Gets the statistics
+
+           @return the statistics
+        */
+        const TaskPoolStat getStat() const;
+
+        /**
+           Gets available CPU cores count
+
+           @return the count (at least 1)
+        */
+        static u_int getCPUCount() throw();
+
+        /**
+           Pins the current thread to a CPU core
+
+           Can be used by long-running I/O loops
+
+           @param[in] cpu - the core number (taken by modulo of the count)
+
+           @return
+           - @ref klk::OK - the thread was pinned
+           - @ref klk::ERROR - the pinning failed or is not supported
+        */
+        static Result pinThread(u_int cpu) throw();
+
+        /**
+           Pins the current thread to the cores of a NUMA node
+
+           The node cores are taken from
+           /sys/devices/system/node/node<N>/cpulist
+
+           @param[in] node - the node number
+
+           @return
+           - @ref klk::OK - the thread was pinned
+           - @ref klk::ERROR - there is no such node or the pinning failed
+        */
+        static Result pinThreadToNode(u_int node) throw();
+    private:
+        /**
+           Worker queue
+        */
+        struct Queue;
+
+        /**
+           Worker queues
+        */
+        typedef std::vector<Queue*> QueueVector;
+
+        /**
+           Delayed tasks: time (ms) -> task
+        */
+        typedef std::multimap<long long, TaskFunction> DelayedMap;
+
+        mutable Mutex m_mutex; ///< idle workers and delayed tasks locker
+        pthread_cond_t m_cond; ///< idle workers wakeup
+        base::Scheduler m_scheduler; ///< threads
+        QueueVector m_queues; ///< worker queues
+        DelayedMap m_delayed; ///< delayed tasks
+        volatile long long m_delayed_next; ///< the first delayed task time
+        pthread_key_t m_key; ///< current thread queue
+        const bool m_pin; ///< pin the workers
+        volatile bool m_stop; ///< stop flag
+        volatile u_long m_sleeping; ///< idle workers count
+        u_long m_next; ///< next queue for the round-robin
+        u_long m_posted; ///< tasks posted
+        u_long m_executed; ///< tasks executed
+        u_long m_stolen; ///< tasks stolen
+        u_long m_failed; ///< tasks failed
+
+        /**
+           Pushes a task to a worker queue
+
+           @param[in] f - the task
+        */
+        void push(const TaskFunction& f);
+
+        /**
+           Gets a task for a worker
+
+           @param[in] queue - the worker queue
+           @param[out] f - the task
+
+           @return
+           - true - the task was got
+           - false - there are no tasks
+        */
+        bool pop(Queue* queue, TaskFunction& f);
+
+        /**
+           Moves the delayed tasks with expired time to a queue
+
+           @param[in] queue - the destination queue
+           @param[out] next - the time (ms) of the next delayed task
+           (0 - there are no delayed tasks)
+
+           @return
+           - true - some tasks were moved
+           - false - nothing to move
+
+           @note called under the lock
+        */
+        bool moveDelayed(Queue* queue, long long& next);
+
+        /**
+           Executes a task
+
+           @param[in] f - the task
+        */
+        void execute(const TaskFunction& f) throw();
+
+        /**
+           Worker thread body
+
+           @param[in] queue - the worker queue
+        */
+        void runWorker(Queue* queue);
+
+        /**
+           Wakes up all workers
+        */
+        void wakeup() throw();
+    private:
+        /**
+           Copy constructor
+           @param[in] value - the copy param
+        */
+        TaskPool(const TaskPool& value);
+
+        /**
+           Assigment operator
+           @param[in] value - the copy param
+        */
+        TaskPool& operator=(const TaskPool& value);
+    };
+
+    /**
+       Task pool smart pointer
+    */
+    typedef boost::shared_ptr<TaskPool> TaskPoolPtr;
+}
+
+#endif //KLK_TASKPOOL_H
@@ -294,3 +294,34 @@ bool Thread::isStopped()
 {
     return m_stop.isStopped();
 }
+
+//
+// FunctionThread class
+//
+
+// Constructor
+FunctionThread::FunctionThread(boost::function0<void> run,
+                               boost::function0<void> wake) :
+    Thread(), m_run(run), m_wake(wake)
+{
+    BOOST_ASSERT(m_run);
+    BOOST_ASSERT(m_wake);
+}
+
+// Destructor
+FunctionThread::~FunctionThread()
+{
+}
+
+// Starts the thread body
+void FunctionThread::start()
+{
+    m_run();
+}
+
+// Stops the thread
+void FunctionThread::stop() throw()
+{
+    Thread::stop();
+    m_wake();
+}
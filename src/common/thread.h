@@ -42,6 +42,8 @@
 #include <pthread.h>
 #include <signal.h>
 
+#include <boost/function/function0.hpp>
+
 #include "common.h"
 #include "errors.h"
 #include "ithread.h"
@@ -272,6 +274,55 @@ namespace klk
             */
             Thread& operator=(const Thread& value);
         };
+
+        /**
+           @brief Thread that runs a functor
+
+           Used by the services (timers, tasks) that have several
+           identical worker threads
+        */
+        class FunctionThread : public Thread
+        {
+        public:
+            /**
+               Constructor
+
+               @param[in] run - the thread body
+               @param[in] wake - wakes the body at the stop
+            */
+            FunctionThread(boost::function0<void> run,
+                           boost::function0<void> wake);
+
+            /**
+               Destructor
+            */
+            virtual ~FunctionThread();
+        private:
+            boost::function0<void> m_run; ///< thread body
+            boost::function0<void> m_wake; ///< wakeup function
+
+            /**
+               @copydoc IThread::start
+            */
+            virtual void start();
+
+            /**
+               @copydoc IThread::stop
+            */
+            virtual void stop() throw();
+        private:
+            /**
+               Copy constructor
+               @param[in] value - the copy param
+            */
+            FunctionThread(const FunctionThread& value);
+
+            /**
+               Assigment operator
+               @param[in] value - the copy param
+            */
+            FunctionThread& operator=(const FunctionThread& value);
+        };
     }
 
     /**
@@ -0,0 +1,540 @@
+/**
+   @file src/common/timerwheel.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/time.h>
+#include <errno.h>
+#include <time.h>
+
+#include <memory>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/bind.hpp>
+
+#include "timerwheel.h"
+#include "thread.h"
+#include "log.h"
+#include "exception.h"
+
+using namespace klk;
+
+/**
+   The wheel tick in milliseconds
+*/
+const u_long TIMERWHEEL_TICK = 10;
+
+/**
+   Bits per wheel level (64 slots)
+*/
+const u_int TIMERWHEEL_BITS = 6;
+
+/**
+   Slot index mask
+*/
+const u_long TIMERWHEEL_MASK = (1UL << TIMERWHEEL_BITS) - 1;
+
+/**
+   Max timer delay in ticks (the whole wheel)
+*/
+const u_long TIMERWHEEL_RANGE = 1UL << (TIMERWHEEL_BITS * 4);
+
+// Checks that tick a is before tick b (counter wrap safe)
+static inline bool tick_before(u_long a, u_long b)
+{
+    return static_cast<long>(a - b) < 0;
+}
+
+// Gets current time in milliseconds
+static long long get_current_ms()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+namespace klk
+{
+    /**
+       @brief Timer info
+    */
+    struct TimerWheel::Entry
+    {
+        TimerID m_id; ///< timer id
+        TimerFunction m_f; ///< timer function
+        u_long m_interval; ///< period in ticks
+        u_long m_slack; ///< deadline rounding in ticks (power of 2)
+        u_long m_deadline; ///< the next deadline tick
+        u_long m_expires; ///< the deadline rounded with the slack
+        Slot* m_slot; ///< the slot with the timer (NULL if not queued)
+        Slot::iterator m_pos; ///< position at the slot
+        bool m_running; ///< the callback is executed
+        bool m_removed; ///< the timer was removed during the callback
+        bool m_detached; ///< the worker should free the timer
+        pthread_t m_worker; ///< the thread that executes the callback
+    };
+}
+
+//
+// TimerWheel class
+//
+
+// Constructor
+// @param[in] workers - the worker threads count
+TimerWheel::TimerWheel(u_int workers) :
+    m_mutex(), m_scheduler(), m_workers(workers),
+    m_started(false), m_stop(false),
+    m_base(get_current_ms()), m_tick(0), m_next(TIMERWHEEL_RANGE),
+    m_queued(0), m_wakeups(0), m_last_id(0), m_entries(), m_ready()
+{
+    BOOST_ASSERT(m_workers > 0);
+    if (pthread_cond_init(&m_dispatch_cond, NULL) ||
+        pthread_cond_init(&m_worker_cond, NULL) ||
+        pthread_cond_init(&m_done_cond, NULL))
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "pthread_cond_init() failed");
+    }
+}
+
+// Destructor
+TimerWheel::~TimerWheel()
+{
+    {
+        Locker lock(&m_mutex);
+        m_stop = true;
+    }
+    wakeup();
+    m_scheduler.stop();
+
+    for (EntryMap::iterator i = m_entries.begin();
+         i != m_entries.end(); i++)
+    {
+        delete i->second;
+    }
+    m_entries.clear();
+
+    pthread_cond_destroy(&m_done_cond);
+    pthread_cond_destroy(&m_worker_cond);
+    pthread_cond_destroy(&m_dispatch_cond);
+}
+
+// Registers a periodic timer
+TimerID TimerWheel::add(TimerFunction f, u_long interval, u_long slack)
+{
+    BOOST_ASSERT(f);
+    BOOST_ASSERT(interval > 0);
+
+    std::auto_ptr<Entry> entry(new Entry());
+    entry->m_f = f;
+    entry->m_interval =
+        std::max(1UL, (interval + TIMERWHEEL_TICK - 1) / TIMERWHEEL_TICK);
+    // the largest power of 2 that does not exceed the slack
+    entry->m_slack = 1;
+    while (entry->m_slack * 2 * TIMERWHEEL_TICK <= slack)
+    {
+        entry->m_slack *= 2;
+    }
+    entry->m_slot = NULL;
+    entry->m_running = false;
+    entry->m_removed = false;
+    entry->m_detached = false;
+
+    Locker lock(&m_mutex);
+    if (m_stop)
+    {
+        throw Exception(__FILE__, __LINE__,
+                        "Timer can not be added during the stop");
+    }
+
+    if (!m_started)
+    {
+        m_started = true;
+        m_scheduler.startThread(
+            IThreadPtr(new base::FunctionThread(
+                               boost::bind(&TimerWheel::runDispatcher, this),
+                               boost::bind(&TimerWheel::wakeup, this))));
+        for (u_int i = 0; i < m_workers; i++)
+        {
+            m_scheduler.startThread(
+                IThreadPtr(new base::FunctionThread(
+                                   boost::bind(&TimerWheel::runWorker, this),
+                                   boost::bind(&TimerWheel::wakeup, this))));
+        }
+    }
+
+    if (++m_last_id == 0)
+    {
+        ++m_last_id;
+    }
+    entry->m_id = m_last_id;
+    // the wheel can be behind if the dispatcher sleeps
+    advance();
+    entry->m_deadline = m_tick - 1 + entry->m_interval;
+    schedule(entry.get());
+    m_entries[entry->m_id] = entry.get();
+    return entry.release()->m_id;
+}
+
+// Unregisters a timer
+void TimerWheel::remove(TimerID id) throw()
+{
+    Locker lock(&m_mutex);
+    EntryMap::iterator i = m_entries.find(id);
+    if (i == m_entries.end())
+    {
+        return;
+    }
+    Entry* entry = i->second;
+    m_entries.erase(i);
+
+    if (!entry->m_running)
+    {
+        unlink(entry);
+        delete entry;
+        return;
+    }
+
+    entry->m_removed = true;
+    if (pthread_equal(entry->m_worker, pthread_self()))
+    {
+        // removed from the callback: the worker will free it
+        entry->m_detached = true;
+        return;
+    }
+
+    while (entry->m_running)
+    {
+        pthread_cond_wait(&m_done_cond, m_mutex.getMutex());
+    }
+    delete entry;
+}
+
+// Gets the registered timers count
+size_t TimerWheel::size() const
+{
+    Locker lock(&m_mutex);
+    return m_entries.size();
+}
+
+// Gets the dispatcher wakeups count
+u_long TimerWheel::getWakeups() const
+{
+    Locker lock(&m_mutex);
+    return m_wakeups;
+}
+
+// Gets the current tick
+u_long TimerWheel::getCurrentTick()
+{
+    const long long now = get_current_ms();
+    u_long tick = static_cast<u_long>((now - m_base) /
+                                      static_cast<long long>(TIMERWHEEL_TICK));
+    if (now < m_base || tick_before(tick + 1, m_tick))
+    {
+        // the clock was moved back: shift the wheel start
+        tick = m_tick - 1;
+        m_base = now - static_cast<long long>(tick) * TIMERWHEEL_TICK;
+    }
+    return tick;
+}
+
+// Places a timer to the wheel
+void TimerWheel::schedule(Entry* entry)
+{
+    BOOST_ASSERT(entry->m_slot == NULL);
+
+    const u_long mask = entry->m_slack - 1;
+    entry->m_expires = (entry->m_deadline + mask) & ~mask;
+
+    // the tick when the dispatcher has to process the slot
+    u_long when = m_tick;
+    Slot* slot = NULL;
+    if (tick_before(entry->m_expires, m_tick))
+    {
+        // already expired: the nearest tick
+        slot = &m_slots[0][m_tick & TIMERWHEEL_MASK];
+    }
+    else
+    {
+        u_long expires = entry->m_expires;
+        u_long delta = expires - m_tick;
+        u_int level = 0;
+        if (delta >= TIMERWHEEL_RANGE)
+        {
+            // will be rescheduled at the cascade
+            expires = m_tick + TIMERWHEEL_RANGE - 1;
+            delta = TIMERWHEEL_RANGE - 1;
+        }
+        while (delta >> (TIMERWHEEL_BITS * (level + 1)))
+        {
+            level++;
+        }
+        const u_int shift = TIMERWHEEL_BITS * level;
+        slot = &m_slots[level][(expires >> shift) & TIMERWHEEL_MASK];
+        // higher levels are processed at the slot cascade
+        when = (expires >> shift) << shift;
+    }
+
+    entry->m_pos = slot->insert(slot->end(), entry);
+    entry->m_slot = slot;
+    m_queued++;
+
+    if (tick_before(when, m_next))
+    {
+        m_next = when;
+        pthread_cond_signal(&m_dispatch_cond);
+    }
+}
+
+// Unlinks a timer from the wheel or the ready queue
+void TimerWheel::unlink(Entry* entry)
+{
+    if (entry->m_slot == NULL)
+    {
+        return;
+    }
+
+    entry->m_slot->erase(entry->m_pos);
+    if (entry->m_slot != &m_ready)
+    {
+        BOOST_ASSERT(m_queued > 0);
+        m_queued--;
+    }
+    entry->m_slot = NULL;
+}
+
+// Moves timers from a higher level slot to the lower levels
+u_int TimerWheel::cascade(u_int level)
+{
+    const u_int index = (m_tick >> (TIMERWHEEL_BITS * level)) &
+        TIMERWHEEL_MASK;
+    Slot list;
+    list.swap(m_slots[level][index]);
+    for (Slot::iterator i = list.begin(); i != list.end(); i++)
+    {
+        (*i)->m_slot = NULL;
+        m_queued--;
+        schedule(*i);
+    }
+    return index;
+}
+
+// Processes all ticks till the current time
+void TimerWheel::advance()
+{
+    const u_long now = getCurrentTick();
+    while (!tick_before(now, m_tick))
+    {
+        if (tick_before(m_tick, m_next))
+        {
+            // nothing till the planned tick
+            m_tick = (tick_before(now, m_next) ? now + 1 : m_next);
+            continue;
+        }
+
+        const u_int index = m_tick & TIMERWHEEL_MASK;
+        if (index == 0 && cascade(1) == 0 && cascade(2) == 0)
+        {
+            cascade(3);
+        }
+
+        Slot list;
+        list.swap(m_slots[0][index]);
+        for (Slot::iterator i = list.begin(); i != list.end(); i++)
+        {
+            Entry* entry = *i;
+            entry->m_slot = NULL;
+            m_queued--;
+            if (tick_before(m_tick, entry->m_expires))
+            {
+                // was clamped by the wheel range
+                schedule(entry);
+            }
+            else
+            {
+                entry->m_pos = m_ready.insert(m_ready.end(), entry);
+                entry->m_slot = &m_ready;
+            }
+        }
+
+        m_tick++;
+        updateNext();
+    }
+
+    if (!m_ready.empty())
+    {
+        pthread_cond_broadcast(&m_worker_cond);
+    }
+}
+
+// Calculates the next tick that has a work for the dispatcher
+void TimerWheel::updateNext()
+{
+    m_next = m_tick + TIMERWHEEL_RANGE;
+    if (m_queued == 0)
+    {
+        return;
+    }
+
+    for (u_long k = 0; k <= TIMERWHEEL_MASK; k++)
+    {
+        if (!m_slots[0][(m_tick + k) & TIMERWHEEL_MASK].empty())
+        {
+            m_next = m_tick + k;
+            return;
+        }
+    }
+
+    for (u_int level = 1; level < 4; level++)
+    {
+        const u_int shift = TIMERWHEEL_BITS * level;
+        for (u_long k = 1; k <= TIMERWHEEL_MASK + 1; k++)
+        {
+            const u_long slot = (m_tick >> shift) + k;
+            if (!m_slots[level][slot & TIMERWHEEL_MASK].empty())
+            {
+                if (tick_before(slot << shift, m_next))
+                {
+                    m_next = slot << shift;
+                }
+                break;
+            }
+        }
+    }
+}
+
+// Dispatcher thread body
+void TimerWheel::runDispatcher()
+{
+    Locker lock(&m_mutex);
+    while (!m_stop)
+    {
+        advance();
+        if (m_queued == 0)
+        {
+            pthread_cond_wait(&m_dispatch_cond, m_mutex.getMutex());
+        }
+        else
+        {
+            const long long wake = m_base +
+                static_cast<long long>(m_next) * TIMERWHEEL_TICK;
+            struct timespec to;
+            to.tv_sec = static_cast<time_t>(wake / 1000);
+            to.tv_nsec = static_cast<long>(wake % 1000) * 1000000;
+            pthread_cond_timedwait(&m_dispatch_cond,
+                                   m_mutex.getMutex(), &to);
+        }
+        m_wakeups++;
+    }
+}
+
+// Worker thread body
+void TimerWheel::runWorker()
+{
+    Locker lock(&m_mutex);
+    for (;;)
+    {
+        while (!m_stop && m_ready.empty())
+        {
+            pthread_cond_wait(&m_worker_cond, m_mutex.getMutex());
+        }
+        if (m_stop)
+        {
+            break;
+        }
+
+        Entry* entry = m_ready.front();
+        m_ready.pop_front();
+        entry->m_slot = NULL;
+        entry->m_running = true;
+        entry->m_worker = pthread_self();
+
+        pthread_mutex_unlock(m_mutex.getMutex());
+        try
+        {
+            // do the action
+            entry->m_f();
+        }
+        catch(const std::exception& err)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an error in timer %lu: %s",
+                    entry->m_id, err.what());
+        }
+        catch(...)
+        {
+            klk_log(KLKLOG_ERROR,
+                    "Got an unspecified error in timer %lu", entry->m_id);
+        }
+        pthread_mutex_lock(m_mutex.getMutex());
+
+        entry->m_running = false;
+        if (entry->m_removed)
+        {
+            if (entry->m_detached)
+            {
+                delete entry;
+            }
+            else
+            {
+                pthread_cond_broadcast(&m_done_cond);
+            }
+            continue;
+        }
+
+        // the next period counts from the deadline, missed ones are skipped
+        advance();
+        const u_long now = m_tick - 1;
+        u_long next = entry->m_deadline + entry->m_interval;
+        if (!tick_before(now, next))
+        {
+            next += ((now - next) / entry->m_interval + 1) *
+                entry->m_interval;
+        }
+        entry->m_deadline = next;
+        schedule(entry);
+    }
+}
+
+// Wakes up all threads
+void TimerWheel::wakeup() throw()
+{
+    Locker lock(&m_mutex);
+    pthread_cond_broadcast(&m_dispatch_cond);
+    pthread_cond_broadcast(&m_worker_cond);
+    pthread_cond_broadcast(&m_done_cond);
+}
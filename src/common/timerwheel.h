@@ -0,0 +1,246 @@
+/**
+   @file src/common/timerwheel.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TIMERWHEEL_H
+#define KLK_TIMERWHEEL_H
+
+#include <sys/types.h>
+#include <pthread.h>
+
+#include <list>
+#include <map>
+
+#include <boost/function/function0.hpp>
+
+#include "scheduler.h"
+#include "thread.h"
+
+namespace klk
+{
+    /**
+       Timer processor functor
+    */
+    typedef boost::function0<void> TimerFunction;
+
+    /**
+       Timer id (0 is never used)
+    */
+    typedef u_long TimerID;
+
+    /**
+       @brief Process-wide timer service
+
+       Hierarchical timer wheel (4 levels x 64 slots, 10 ms tick)
+       served by one dispatcher thread. The expired callbacks are
+       executed by a bounded pool of worker threads.
+
+       - a periodic timer is never executed concurrently with itself
+       - the next deadline is counted from the previous one, so the
+       callback duration does not shift the period; missed periods are
+       skipped
+       - a timer can be delayed up to its slack to be fired together
+       with other timers (less wakeups)
+       - the dispatcher sleeps till the next occupied slot instead of
+       waking up each tick
+
+       The threads are started at the first timer registration.
+
+       @ingroup grThread
+    */
+    class TimerWheel
+    {
+    public:
+        /**
+           Constructor
+
+           @param[in] workers - the worker threads count
+        */
+        explicit TimerWheel(u_int workers = 2);
+
+        /**
+           Destructor
+
+           Stops all threads, the registered timers are dropped
+        */
+        ~TimerWheel();
+
+        /**
+           Registers a periodic timer
+
+           @param[in] f - the function to be called
+           @param[in] interval - the period in milliseconds
+           @param[in] slack - the allowed delay in milliseconds
+
+           @return the timer id
+
+           @exception klk::Exception
+        */
+        TimerID add(TimerFunction f, u_long interval, u_long slack = 0);
+
+        /**
+           Unregisters a timer
+
+           Waits for the callback completion if it is executed
+           at the moment (except a call from the callback itself)
+
+           @param[in] id - the timer id
+        */
+        void remove(TimerID id) throw();
+
+        /**
+           Gets the registered timers count
+
+           @return the count
+        */
+        size_t size() const;
+
+        /**
+           Gets the dispatcher wakeups count
+
+           @return the count
+        */
+        u_long getWakeups() const;
+    private:
+        /**
+           Timer info
+        */
+        struct Entry;
+
+        /**
+           Wheel slot
+        */
+        typedef std::list<Entry*> Slot;
+
+        /**
+           Timers by ids
+        */
+        typedef std::map<TimerID, Entry*> EntryMap;
+
+        mutable Mutex m_mutex; ///< data locker
+        pthread_cond_t m_dispatch_cond; ///< dispatcher wakeup
+        pthread_cond_t m_worker_cond; ///< workers wakeup
+        pthread_cond_t m_done_cond; ///< callback completion
+        base::Scheduler m_scheduler; ///< threads
+        u_int m_workers; ///< workers count
+        bool m_started; ///< are the threads started
+        bool m_stop; ///< stop flag
+        long long m_base; ///< wheel start time (ms)
+        u_long m_tick; ///< current tick
+        u_long m_next; ///< planned dispatcher wakeup tick
+        u_long m_queued; ///< timers in the wheel
+        u_long m_wakeups; ///< dispatcher wakeups
+        TimerID m_last_id; ///< last timer id
+        EntryMap m_entries; ///< registered timers
+        Slot m_slots[4][64]; ///< the wheel
+        Slot m_ready; ///< expired timers
+
+        /**
+           Gets the current tick
+
+           @note called under the lock
+        */
+        u_long getCurrentTick();
+
+        /**
+           Places a timer to the wheel
+
+           @param[in] entry - the timer
+
+           @note called under the lock
+        */
+        void schedule(Entry* entry);
+
+        /**
+           Unlinks a timer from the wheel or the ready queue
+
+           @param[in] entry - the timer
+
+           @note called under the lock
+        */
+        void unlink(Entry* entry);
+
+        /**
+           Moves timers from a higher level slot to the lower levels
+
+           @param[in] level - the level (1..3)
+
+           @return the slot index at the level
+
+           @note called under the lock
+        */
+        u_int cascade(u_int level);
+
+        /**
+           Processes all ticks till the current time
+
+           @note called under the lock
+        */
+        void advance();
+
+        /**
+           Calculates the next tick that has a work for the dispatcher
+
+           @note called under the lock
+        */
+        void updateNext();
+
+        /**
+           Dispatcher thread body
+        */
+        void runDispatcher();
+
+        /**
+           Worker thread body
+        */
+        void runWorker();
+
+        /**
+           Wakes up all threads
+        */
+        void wakeup() throw();
+    private:
+        /**
+           Copy constructor
+           @param[in] value - the copy param
+        */
+        TimerWheel(const TimerWheel& value);
+
+        /**
+           Assigment operator
+           @param[in] value - the copy param
+        */
+        TimerWheel& operator=(const TimerWheel& value);
+    };
+}
+
+#endif //KLK_TIMERWHEEL_H
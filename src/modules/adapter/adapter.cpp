@@ -55,6 +55,7 @@
 #include "modulesproxy.h"
 #include "messagesprotocol.h"
 #include "ipcmsg.h"
+#include "converter.h"
 
 // modules specific info
 #include "msgcore/defines.h"
@@ -316,18 +317,19 @@ void Adapter::processRemoteSync(const IMessagePtr& in, const IMessagePtr& out)
 {
     StringList receivers = getReceiverList(in);
     BOOST_ASSERT(receivers.empty() == false);
+    // the input message is read only: it's converted once and
+    // the copy is sent to each receiver
+    ipc::SMessage data = Converter(getFactory()).msg2ice(in);
     for (StringList::iterator receiver = receivers.begin(); receiver != receivers.end();
         receiver++)
     {
         try
         {
-            // update the receiver list
-            in->clearReceiverList();
-            in->addReceiver(*receiver);
             MessagesProtocol proto(getFactory(), *receiver);
 
             // FIXME!!! very bad code
-            IMessagePtr res = proto.sendSync(in);
+            IMessagePtr res =
+                proto.sendSync(getRemoteMessage(data, in, *receiver));
             ipc::SMessage msg_data =
                 boost::dynamic_pointer_cast<ipc::Message>(res)->getICEData();
             // fill the data
@@ -360,16 +362,16 @@ void Adapter::processRemoteASync(const IMessagePtr& in)
 {
     StringList receivers = getReceiverList(in);
     BOOST_ASSERT(receivers.empty() == false);
+    // the input message is read only: it's converted once and
+    // the copy is sent to each receiver
+    ipc::SMessage data = Converter(getFactory()).msg2ice(in);
     for (StringList::iterator receiver = receivers.begin(); receiver != receivers.end();
         receiver++)
     {
         try
         {
-            // update the receiver list
-            in->clearReceiverList();
-            in->addReceiver(*receiver);
             MessagesProtocol proto(getFactory(), *receiver);
-            proto.sendASync(in);
+            proto.sendASync(getRemoteMessage(data, in, *receiver));
         }
         catch(const std::exception& err)
         {
@@ -380,6 +382,21 @@ void Adapter::processRemoteASync(const IMessagePtr& in)
     }
 }
 
+// Makes a copy of the input message for the specified remote receiver
+// @param[in,out] data - the message data converted to ICE format
+// @param[in] in - the input message
+// @param[in] receiver - the receiver module id
+const IMessagePtr Adapter::getRemoteMessage(ipc::SMessage& data,
+                                            const IMessagePtr& in,
+                                            const std::string& receiver)
+{
+    data.mReceivers.clear();
+    data.mReceivers.push_back(receiver);
+    IMessagePtr msg(new ipc::Message(data, in->getUUID()));
+    msg->setType(in->getType());
+    return msg;
+}
+
 // Retrieves remote receivers list (list of module ids) by the input message
 const StringList Adapter::getReceiverList(const IMessagePtr& in)
 {
@@ -44,6 +44,7 @@
 
 #include "module.h"
 #include "scheduler.h"
+#include "iproxy.h"
 
 namespace klk
 {
@@ -163,6 +164,20 @@ class Adapter : public klk::Module
                @return the list
             */
             const StringList getReceiverList(const IMessagePtr& in);
+
+            /**
+               Makes a copy of the input message for the specified
+               remote receiver
+
+               @param[in,out] data - the message data converted to ICE format
+               @param[in] in - the input message
+               @param[in] receiver - the receiver module id
+
+               @return the message to be sent
+            */
+            const IMessagePtr getRemoteMessage(ipc::SMessage& data,
+                                               const IMessagePtr& in,
+                                               const std::string& receiver);
         private:
             /**
                Copy constructor
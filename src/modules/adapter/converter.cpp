@@ -36,6 +36,8 @@
 #include "config.h"
 #endif
 
+#include <boost/lexical_cast.hpp>
+
 #include "converter.h"
 #include "exception.h"
 
@@ -54,14 +56,29 @@ namespace klk
         adapter::ipc::SMessage msg;
         msg.mID = getID();
         msg.mSender = getSenderID();
-        msg.mValues = m_values;
         std::copy(m_receivers.begin(), m_receivers.end(),
                   std::back_inserter(msg.mReceivers));
-        for (StringListMap::const_iterator value = m_lists.begin();
-             value != m_lists.end(); value++)
+        for (ValueVector::const_iterator value = m_data.begin();
+             value != m_data.end(); value++)
         {
-            std::copy(value->second.begin(), value->second.end(),
-                  std::back_inserter(msg.mLists[value->first]));
+            switch (value->m_type)
+            {
+            case STRING:
+                msg.mValues[value->m_key] = value->m_string;
+                break;
+            case INTEGER:
+                // ICE keeps simple data as strings
+                msg.mValues[value->m_key] =
+                    boost::lexical_cast<std::string>(value->m_integer);
+                break;
+            case LIST:
+                std::copy(value->m_list.begin(), value->m_list.end(),
+                          std::back_inserter(msg.mLists[value->m_key]));
+                break;
+            default:
+                BOOST_ASSERT(false);
+                break;
+            }
         }
         return msg;
     }
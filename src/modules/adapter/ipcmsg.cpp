@@ -36,6 +36,8 @@
 #include "config.h"
 #endif
 
+#include <boost/lexical_cast.hpp>
+
 #include "ipcmsg.h"
 #include "exception.h"
 
@@ -50,23 +52,22 @@ using namespace klk::adapter::ipc;
 // Constructor
 Message::Message(const SMessage& ice_data, const msg::UUID uuid) :
     BaseMessage(ice_data.mID, uuid, ice_data.mSender),
-    m_ice_data(ice_data)
+    m_ice_data(ice_data), m_receivers()
 {
+    std::copy(m_ice_data.mReceivers.begin(), m_ice_data.mReceivers.end(),
+              std::back_inserter(m_receivers));
 }
 
 /// @copydoc klk::IMessage::getReceiverList()
-const klk::StringList Message::getReceiverList() const throw()
+const klk::StringList& Message::getReceiverList() const throw()
 {
-    klk::StringList res;
-    Locker lock(&m_lock);
-    std::copy(m_ice_data.mReceivers.begin(), m_ice_data.mReceivers.end(),
-              std::back_inserter(res));
-    return res;
+    return m_receivers;
 }
 
 /// @copydoc klk::IMessage::addReceiver()
 void Message::addReceiver(const std::string& id)
 {
+    checkWritable();
     Locker lock(&m_lock);
     // check only one presence of the id at the lis
     if (std::find(m_ice_data.mReceivers.begin(),
@@ -78,13 +79,20 @@ void Message::addReceiver(const std::string& id)
     }
 
     m_ice_data.mReceivers.push_back(id);
+    m_receivers.push_back(id);
 }
 
 /// @copydoc klk::IMessage::clearReceiverList()
 void Message::clearReceiverList() throw()
 {
+    BOOST_ASSERT(isSealed() == false);
+    if (isSealed())
+    {
+        return;
+    }
     Locker lock(&m_lock);
     m_ice_data.mReceivers.clear();
+    m_receivers.clear();
 }
 
 /// @copydoc klk::IMessage::getReceiverList()
@@ -131,9 +139,27 @@ const klk::StringList Message::getList(const std::string& key) const
     return res;
 }
 
+/// @copydoc klk::IMessage::getInteger()
+long long Message::getInteger(const std::string& key) const
+{
+    const std::string value = getValue(key);
+    try
+    {
+        return boost::lexical_cast<long long>(value);
+    }
+    catch(const boost::bad_lexical_cast&)
+    {
+        throw klk::Exception(__FILE__, __LINE__,
+                             "Data for key '%s' in message with id '%s' "
+                             "is not an integer: '%s'",
+                             key.c_str(), getID().c_str(), value.c_str());
+    }
+}
+
 /// @copydoc klk::IMessage::setData()
 void Message::setData(const std::string& key, const std::string& data)
 {
+    checkWritable();
     Locker lock(&m_lock);
     m_ice_data.mValues[key] = data;
 }
@@ -141,8 +167,16 @@ void Message::setData(const std::string& key, const std::string& data)
 /// @copydoc klk::IMessage::setData()
 void Message::setData(const std::string& key, const klk::StringList& data)
 {
+    checkWritable();
     Locker lock(&m_lock);
     m_ice_data.mLists[key].clear();
     std::copy(data.begin(), data.end(),
               std::back_inserter(m_ice_data.mLists[key]));
 }
+
+/// @copydoc klk::IMessage::setData()
+void Message::setData(const std::string& key, long long data)
+{
+    // ICE keeps simple data as strings
+    setData(key, boost::lexical_cast<std::string>(data));
+}
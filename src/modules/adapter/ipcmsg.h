@@ -72,10 +72,10 @@ namespace klk
                 const SMessage& getICEData(){return m_ice_data;}
             private:
                 SMessage m_ice_data; ///< ice data holder
-
+                klk::StringList m_receivers; ///< receivers (copy of ICE data)
 
                 /// @copydoc klk::IMessage::getReceiverList()
-                virtual const klk::StringList getReceiverList() const throw();
+                virtual const klk::StringList& getReceiverList() const throw();
 
                 /// @copydoc klk::IMessage::addReceiver()
                 virtual void addReceiver(const std::string& id);
@@ -94,6 +94,9 @@ namespace klk
                 virtual const klk::StringList
                     getList(const std::string& key) const;
 
+                /// @copydoc klk::IMessage::getInteger()
+                virtual long long getInteger(const std::string& key) const;
+
                 /// @copydoc klk::IMessage::setData()
                 virtual void
                     setData(const std::string& key, const std::string& data);
@@ -102,6 +105,9 @@ namespace klk
                 virtual void
                     setData(const std::string& key,
                             const klk::StringList& data);
+
+                /// @copydoc klk::IMessage::setData()
+                virtual void setData(const std::string& key, long long data);
             private:
                 /**
                    Assigment operator
@@ -38,12 +38,16 @@
 #include "config.h"
 #endif
 
+#include <map>
+
 #include <boost/bind.hpp>
 
 #include "checkdb.h"
 #include "exception.h"
+#include "log.h"
 #include "defines.h"
 #include "db.h"
+#include "dbchange.h"
 
 using namespace klk;
 using namespace klk::db;
@@ -66,7 +70,7 @@ IModulePtr klk_module_get(IFactory *factory)
 // Constructor
 // @param[in] factory the module factory
 CheckDB::CheckDB(IFactory *factory) :
-    Module(factory, MODID), m_last(-1)
+    Module(factory, MODID), m_last(-1), m_gap(-1), m_gap_checks(0)
 {
 }
 
@@ -93,6 +97,20 @@ void CheckDB::checkDB()
     db::DB db(getFactory());
     db.connect();
 
+    if (m_last < 0)
+    {
+        sendFull(db);
+    }
+    else
+    {
+        sendChanges(db);
+    }
+}
+
+// Sends the full reload notification to all modules
+// that have changes at the DB
+void CheckDB::sendFull(db::DB& db)
+{
     // retrive the current last
     //klk_checkdb_getlastid` (
     // OUT return_id INT
@@ -125,3 +143,89 @@ void CheckDB::checkDB()
     }
     m_last = new_last;
 }
+
+// Reads the changes feed and sends the changes to modules
+void CheckDB::sendChanges(db::DB& db)
+{
+    //CREATE PROCEDURE `klk_checkdb_get_changes` (
+    // IN last_id INT,
+    // IN max_count INT
+    db::Parameters params;
+    params.add("@last_id", m_last);
+    params.add("@max_count", CHECKDB_CHANGES_MAX);
+    const db::ResultVector rv = db.callPrepared("klk_checkdb_get_changes",
+                                                params, NULL);
+    if (rv.empty())
+    {
+        m_gap_checks = 0;
+        return;
+    }
+
+    if (rv.size() >= static_cast<size_t>(CHECKDB_CHANGES_MAX))
+    {
+        // the full reload is cheaper than the long feed
+        klk_log(KLKLOG_DEBUG, "Too many DB changes after id %d", m_last);
+        m_gap_checks = 0;
+        sendFull(db);
+        return;
+    }
+
+    // SELECT id, module_uuid, table_name, row_uuid, operation
+    typedef std::map<std::string, db::ChangeSetPtr> ModuleChangeMap;
+    ModuleChangeMap changes;
+    int last = m_last;
+    db::ResultVector::const_iterator row = rv.begin();
+    for (; row != rv.end(); row++)
+    {
+        const int id = (*row)["id"].toInt();
+        if (id != last + 1)
+        {
+            // AUTO_INCREMENT ids are committed out of order:
+            // the missing row can be committed later
+            break;
+        }
+
+        db::ChangeSetPtr& set = changes[(*row)["module_uuid"].toString()];
+        if (!set)
+        {
+            set = db::ChangeSetPtr(new db::ChangeSet());
+        }
+        set->add((*row)["table_name"].toString(),
+                 (*row)["row_uuid"].toString(),
+                 static_cast<db::ChangeType>((*row)["operation"].toInt()));
+        last = id;
+    }
+
+    if (row == rv.end() || last != m_gap)
+    {
+        m_gap_checks = 0;
+    }
+
+    if (row != rv.end())
+    {
+        m_gap = last;
+        if (++m_gap_checks > CHECKDB_GAP_CHECKS)
+        {
+            // the id was not used (a rolled back transaction)
+            // or the row was committed after the next rows were read
+            klk_log(KLKLOG_DEBUG, "Gap at the DB changes after id %d",
+                    last);
+            m_gap_checks = 0;
+            sendFull(db);
+            return;
+        }
+    }
+
+    // the rest changes (if any) will be read at the next check
+    m_last = last;
+    for (ModuleChangeMap::iterator i = changes.begin();
+         i != changes.end(); i++)
+    {
+        IMessagePtr msg =
+            getFactory()->getMessageFactory()->getMessage(msg::id::CHANGEDB);
+        msg->clearReceiverList();
+        msg->addReceiver(i->first);
+        i->second->fillMessage(msg);
+        getFactory()->getModuleFactory()->sendMessage(msg);
+    }
+}
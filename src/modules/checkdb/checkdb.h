@@ -39,6 +39,7 @@
 
 #include "moduledb.h"
 #include "modulescheduler.h"
+#include "db.h"
 
 namespace klk
 {
@@ -58,6 +59,10 @@ namespace klk
             The module peridiocally retrive info about modules that have changed data
             at the DB and send them a notification message
 
+            The notification keeps the changed rows (see klk::db::ChangeSet)
+            if the DB triggers provide them with klk_log_add_row procedure.
+            Thus the module reloads only the changed data
+
             @ingroup grModule
 
             @{
@@ -84,6 +89,8 @@ namespace klk
             virtual ~CheckDB();
         private:
             int m_last; ///< last processed id at the DB
+            int m_gap; ///< the id before a gap at the changes feed
+            int m_gap_checks; ///< checks that have seen the gap
 
             /**
                Register all processors
@@ -110,6 +117,31 @@ namespace klk
                @exception klk::Exception
             */
             void checkDB();
+
+            /**
+               Sends the full reload notification to all modules
+               that have changes at the DB. It's used at the first
+               check
+
+               @param[in] db - the DB connection
+
+               @exception klk::Exception
+            */
+            void sendFull(db::DB& db);
+
+            /**
+               Reads the changes feed and sends the changes to modules
+
+               The changes are sent till the first gap at the ids. The
+               rest is read again at the next check or sent as the full
+               reload if the gap is not filled (see CHECKDB_GAP_CHECKS).
+               Too many changes are sent as the full reload too
+
+               @param[in] db - the DB connection
+
+               @exception klk::Exception
+            */
+            void sendChanges(db::DB& db);
         private:
             /**
                Copy constructor
@@ -120,5 +120,35 @@ void TestCheckDB::test()
 
     // test that we have 2 updates
     CPPUNIT_ASSERT(testmod->getCount() == 3);
+    // the change feed keeps both rows
+    CPPUNIT_ASSERT(testmod->isFull() == false);
+    CPPUNIT_ASSERT(testmod->getChanged().size() == 2);
+    CPPUNIT_ASSERT(testmod->getDeleted().empty());
+
+    // delete all 3 rows
+    Result res4 = m_db->callSimple("test_checkdb_del_all", params);
+    CPPUNIT_ASSERT(res4["@return_value"].toInt() == 0);
+    sleep(CHECKDBINTERVAL + 2);
+    CPPUNIT_ASSERT(testmod->getCount() == 4);
+    CPPUNIT_ASSERT(testmod->isFull() == false);
+    CPPUNIT_ASSERT(testmod->getChanged().empty());
+    CPPUNIT_ASSERT(testmod->getDeleted().size() == 3);
+
+    // the change without the row info requires the full reload
+    Result res5 = m_db->callSimple("test_checkdb_touch", params);
+    CPPUNIT_ASSERT(res5["@return_value"].toInt() == 0);
+    sleep(CHECKDBINTERVAL + 2);
+    CPPUNIT_ASSERT(testmod->getCount() == 5);
+    CPPUNIT_ASSERT(testmod->isFull() == true);
+
+    // the change after a gap at the log ids is held for the gap checks
+    // and then sent as the full reload
+    Result res6 = m_db->callSimple("test_checkdb_gap", params);
+    CPPUNIT_ASSERT(res6["@return_value"].toInt() == 0);
+    sleep(CHECKDBINTERVAL + 2);
+    CPPUNIT_ASSERT(testmod->getCount() == 5);
+    sleep(CHECKDBINTERVAL * CHECKDB_GAP_CHECKS);
+    CPPUNIT_ASSERT(testmod->getCount() == 6);
+    CPPUNIT_ASSERT(testmod->isFull() == true);
 }
 
@@ -41,6 +41,7 @@
 #include "testhelpmodule.h"
 #include "exception.h"
 #include "testdefines.h"
+#include "dbchange.h"
 
 using namespace klk;
 using namespace klk::db;
@@ -51,7 +52,8 @@ using namespace klk::db;
 
 // Constructor
 TestModule::TestModule(IFactory *factory) :
-    ModuleWithDB(factory, TESTMODID), m_count(0)
+    ModuleWithDB(factory, TESTMODID), m_count(0), m_full(false),
+    m_changed(), m_deleted()
 {
 }
 
@@ -59,5 +61,9 @@ TestModule::TestModule(IFactory *factory) :
 // @ref msg::id::CHANGEDB message
 void TestModule::processDB(const IMessagePtr& msg)
 {
+    const ChangeSet changes(msg);
+    m_full = changes.isFull();
+    m_changed = changes.getChanged();
+    m_deleted = changes.getDeleted();
     m_count++;
 }
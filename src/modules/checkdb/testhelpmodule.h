@@ -68,8 +68,26 @@ namespace klk
                Retrive DB update count
             */
             const u_int getCount() const throw(){return m_count;}
+
+            /**
+               Retrives the last DB change full reload flag
+            */
+            const bool isFull() const throw(){return m_full;}
+
+            /**
+               Retrives the last DB change inserted and updated rows
+            */
+            const StringList getChanged() const {return m_changed;}
+
+            /**
+               Retrives the last DB change deleted rows
+            */
+            const StringList getDeleted() const {return m_deleted;}
         private:
             u_int m_count; ///< count
+            bool m_full; ///< the last change full reload flag
+            StringList m_changed; ///< the last change inserted rows
+            StringList m_deleted; ///< the last change deleted rows
 
             /**
                Gets a human readable module name
@@ -55,6 +55,8 @@
 #include "utils.h"
 #include "exception.h"
 #include "defines.h"
+#include "db.h"
+#include "dev.h"
 
 using namespace klk;
 using namespace klk::dvb;
@@ -125,6 +127,54 @@ void Resources::initDevs()
         klk_log(KLKLOG_INFO,
                 "The mediaserver does not have any DVB devices");
     }
+
+    try
+    {
+        addVirtualDevs();
+    }
+    catch(const std::exception& err)
+    {
+        klk_log(KLKLOG_ERROR,
+                "Failed to add virtual DVB devices. Error: %s", err.what());
+    }
+}
+
+// Adds virtual DVB devices registered at the DB
+void Resources::addVirtualDevs()
+{
+    IDevList buses = m_factory->getResources()->getResourceByType(dev::PCIBUS);
+    BOOST_ASSERT(buses.size() == 1);
+
+    // `klk_dvb_resource_virtual_list` (
+    // IN bus VARCHAR(40)
+    db::Parameters params;
+    params.add("@bus", (*buses.begin())->getStringParam(dev::UUID));
+    db::DB db(m_factory);
+    db.connect();
+    db::ResultVector rv =
+        db.callSelect("klk_dvb_resource_virtual_list", params, NULL);
+    for (db::ResultVector::iterator i = rv.begin(); i != rv.end(); i++)
+    {
+        // SELECT
+        // klk_dvb_resources.dvb_type,
+        // klk_dvb_resources.adapter_no,
+        // klk_dvb_resources.frontend_no,
+        // klk_dvb_resources.virtual_source,
+        // klk_dvb_resources.virtual_realtime,
+        // klk_resources.resource_name
+        IDevPtr dev(new dev::DVB(m_factory, (*i)["dvb_type"].toString()));
+        dev->setParam(dev::ADAPTER, (*i)["adapter_no"].toString());
+        dev->setParam(dev::FRONTEND, (*i)["frontend_no"].toString());
+        dev->setParam(dev::NAME, (*i)["resource_name"].toString());
+        dev->setParam(dev::VIRTUAL_SOURCE,
+                      (*i)["virtual_source"].toString());
+        dev->setParam(dev::VIRTUAL_REALTIME,
+                      (*i)["virtual_realtime"].toInt());
+        klk_log(KLKLOG_INFO, "Virtual DVB device '%s' reads '%s'",
+                dev->getStringParam(dev::NAME).c_str(),
+                dev->getStringParam(dev::VIRTUAL_SOURCE).c_str());
+        addDev(dev);
+    }
 }
 
 // Adds DVB device info
@@ -79,6 +79,14 @@ namespace klk
             */
             void addDevInfo(u_int adapter, u_int frontend);
 
+            /**
+               Adds virtual DVB devices (recorded TS files or FIFOs)
+               registered at the DB
+
+               @exception @ref klk::Exception
+            */
+            void addVirtualDevs();
+
             /**
                Checks DVB device
 
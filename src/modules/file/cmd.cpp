@@ -65,8 +65,8 @@ const StringList BaseCommand::getNameList()
     db::Parameters dbparams;
     dbparams.add("@host", db.getHostUUID());
 
-    db::ResultVector rv = db.callSelect("klk_file_list",
-                                        dbparams, NULL);
+    db::ResultVector rv = db.callPrepared("klk_file_list",
+                                          dbparams, NULL);
     for (db::ResultVector::iterator item = rv.begin();
          item != rv.end(); item++)
     {
@@ -213,8 +213,8 @@ const StringList AddCommand::getPathList()
     db::Parameters dbparams;
     dbparams.add("@host", db.getHostUUID());
 
-    db::ResultVector rv = db.callSelect("klk_file_list",
-                                        dbparams, NULL);
+    db::ResultVector rv = db.callPrepared("klk_file_list",
+                                          dbparams, NULL);
     for (db::ResultVector::iterator item = rv.begin();
          item != rv.end(); item++)
     {
@@ -380,8 +380,8 @@ const std::string ShowCommand::process(const cli::ParameterVector& params)
     db::Parameters dbparams;
     dbparams.add("@host", db.getHostUUID());
 
-    db::ResultVector rv = db.callSelect("klk_file_list",
-                                        dbparams, NULL);
+    db::ResultVector rv = db.callPrepared("klk_file_list",
+                                          dbparams, NULL);
     for (db::ResultVector::iterator item = rv.begin();
          item != rv.end(); item++)
     {
@@ -88,37 +88,74 @@ const File::InfoSet File::getInfoFromDB()
     // IN host VARCHAR(40)
     db::Parameters params;
     params.add("@host", db.getHostUUID());
-    db::ResultVector rv = db.callSelect("klk_file_list", params, NULL);
+    db::ResultVector rv = db.callPrepared("klk_file_list", params, NULL);
     InfoSet set;
     for (db::ResultVector::iterator i = rv.begin(); i != rv.end(); i++)
     {
-        // SELECT file, name, file_path, file_type  FROM klk_file
-        const std::string uuid = (*i)["file"].toString();
-        const std::string name = (*i)["name"].toString();
-        const std::string path = (*i)["file_path"].toString();
-        const std::string type = (*i)["type_uuid"].toString();
-
-        // FIXME!!! bad code here
-        if (type == type::REGULAR)
-        {
-            const FileInfoPtr info(new FileInfo(uuid, name,
-                                                path, getFactory()));
-            set.insert(info);
-        }
-        else if (type == type::FOLDER)
-        {
-            const FileInfoPtr info(new FolderInfo(uuid, name, path, getFactory()));
-            set.insert(info);
-        }
-        else
+        addInfo(*i, set);
+    }
+
+    return set;
+}
+
+// Retrives infos for the changed files from @ref grDB "database"
+const File::InfoSet File::getChangedInfoFromDB(const StringList& uuids)
+{
+    InfoSet set;
+    if (uuids.empty())
+    {
+        return set;
+    }
+
+    db::DB db(getFactory());
+    db.connect();
+    const std::string host = db.getHostUUID();
+    for (StringList::const_iterator uuid = uuids.begin();
+         uuid != uuids.end(); uuid++)
+    {
+        // CREATE PROCEDURE `klk_file_get` (
+        // IN host VARCHAR(40),
+        // IN file VARCHAR(40)
+        db::Parameters params;
+        params.add("@host", host);
+        params.add("@file", *uuid);
+        db::ResultVector rv = db.callPrepared("klk_file_get", params, NULL);
+        for (db::ResultVector::iterator i = rv.begin(); i != rv.end(); i++)
         {
-            throw Exception(__FILE__, __LINE__, "Unsopported file type: " + type);
+            addInfo(*i, set);
         }
     }
 
     return set;
 }
 
+// Adds a file info from a DB row
+void File::addInfo(const db::Result& row, InfoSet& set)
+{
+    // SELECT file, name, file_path, file_type  FROM klk_file
+    const std::string uuid = row["file"].toString();
+    const std::string name = row["name"].toString();
+    const std::string path = row["file_path"].toString();
+    const std::string type = row["type_uuid"].toString();
+
+    // FIXME!!! bad code here
+    if (type == type::REGULAR)
+    {
+        const FileInfoPtr info(new FileInfo(uuid, name,
+                                            path, getFactory()));
+        set.insert(info);
+    }
+    else if (type == type::FOLDER)
+    {
+        const FileInfoPtr info(new FolderInfo(uuid, name, path, getFactory()));
+        set.insert(info);
+    }
+    else
+    {
+        throw Exception(__FILE__, __LINE__, "Unsopported file type: " + type);
+    }
+}
+
 // Starts a file usage
 void File::doStart(const IMessagePtr& in,
                    const IMessagePtr& out)
@@ -39,6 +39,7 @@
 
 #include "modulewithinfo.h"
 #include "fileinfo.h"
+#include "db.h"
 
 namespace klk
 {
@@ -111,6 +112,26 @@ namespace klk
             */
             virtual const InfoSet getInfoFromDB();
 
+            /**
+               Retrives infos for the changed files from
+               @ref grDB "database"
+
+               @param[in] uuids - the files uuids
+
+               @return set
+            */
+            virtual const InfoSet getChangedInfoFromDB(const StringList& uuids);
+
+            /**
+               Adds a file info from a DB row
+
+               @param[in] row - the row (see klk_file_list)
+               @param[out] set - the set to be filled
+
+               @exception klk::Exception
+            */
+            void addInfo(const db::Result& row, InfoSet& set);
+
             /**
                Register all processors
 
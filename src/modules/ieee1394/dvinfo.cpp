@@ -38,8 +38,6 @@
 #include "config.h"
 #endif
 
-#include <boost/lexical_cast.hpp>
-
 #include "dvinfo.h"
 #include "messages.h"
 #include "exception.h"
@@ -55,7 +53,7 @@ using namespace klk::fw;
 DVInfo::DVInfo(const std::string& uuid, const std::string& name,
                const std::string& description) :
     mod::Info(uuid, name), m_description(description),
-    m_port("-1")
+    m_port(-1)
 {
     BOOST_ASSERT(m_description.empty() == false);
 }
@@ -75,19 +73,12 @@ const std::string DVInfo::getDescription() const throw()
 // Sets port
 void DVInfo::setPort(const int port)
 {
-    try
-    {
-        Locker lock(&m_lock);
-        m_port = boost::lexical_cast<std::string>(port);
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw Exception(__FILE__, __LINE__, err::BADLEXCAST);
-    }
+    Locker lock(&m_lock);
+    m_port = port;
 }
 
 // Gets port
-const std::string DVInfo::getPort() const throw()
+const int DVInfo::getPort() const throw()
 {
     Locker lock(&m_lock);
     return m_port;
@@ -108,6 +99,6 @@ void DVInfo::fillOutMessage(const IMessagePtr& out) const
 {
     Locker lock(&m_lock);
     mod::Info::fillOutMessage(out);
-    out->setData(msg::key::IEEE1394PORT, m_port);
+    out->setData(msg::key::IEEE1394PORT, static_cast<long long>(m_port));
 }
 
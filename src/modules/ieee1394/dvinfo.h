@@ -86,17 +86,15 @@ namespace klk
                Sets port
 
                @param[in] port - the value to be set
-
-               @exception klk::Exception
             */
             void setPort(const int port);
 
             /**
-               Gets port in the string form
+               Gets port
 
-               @return the string with port
+               @return the port (-1 if it is not known)
             */
-            const std::string getPort() const throw();
+            const int getPort() const throw();
 
             /**
                Updates the module info
@@ -108,7 +106,7 @@ namespace klk
             virtual void updateInfo(const mod::InfoPtr& value);
         private:
             std::string m_description; ///< description
-            std::string m_port; ///< port value
+            int m_port; ///< port value
 
             /**
                @copydoc klk::mod::Info::fillOutMessage
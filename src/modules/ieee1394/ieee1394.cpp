@@ -169,7 +169,8 @@ void FireWire::checkCameras()
         IMessagePtr msg = msgfactory->getMessage(msg::id::IEEE1394DEV);
         msg->setData(msg::key::MODINFOUUID, info->getUUID());
         msg->setData(msg::key::IEEE1394STATE, msg::key::IEEE1394STATENEW);
-        msg->setData(msg::key::IEEE1394PORT, info->getPort());
+        msg->setData(msg::key::IEEE1394PORT,
+                     static_cast<long long>(info->getPort()));
         getFactory()->getModuleFactory()->sendMessage(msg);
 
         // add the info about the new element to the db
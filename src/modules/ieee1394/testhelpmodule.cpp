@@ -103,8 +103,7 @@ void TestHelpModule::processASync(const IMessagePtr& msg)
         if (state == msg::key::IEEE1394STATENEW)
         {
             // check port
-            const std::string port = msg->getValue(msg::key::IEEE1394PORT);
-            BOOST_ASSERT(port == "-1");
+            BOOST_ASSERT(msg->getInteger(msg::key::IEEE1394PORT) == -1);
 
             if (was1)
             {
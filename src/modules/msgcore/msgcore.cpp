@@ -81,6 +81,26 @@ const std::string MessageCore::getName() const throw()
     return MODNAME;
 }
 
+// Do some actions before main loop
+void MessageCore::preMainLoop()
+{
+    Module::preMainLoop();
+    // the module works as a message tap only in the trace mode
+    // all other time the messages are delivered directly
+    if (getFactory()->getConfig()->isMessageTrace())
+    {
+        klk_log(KLKLOG_INFO, "Message trace mode is enabled");
+        getFactory()->getModuleFactory()->setMessageTrace(true);
+    }
+}
+
+// Do some actions after main loop
+void MessageCore::postMainLoop() throw()
+{
+    getFactory()->getModuleFactory()->setMessageTrace(false);
+    Module::postMainLoop();
+}
+
 // Process a message
 // @param[in] msg the message to be processed
 void MessageCore::process(const IMessagePtr& msg)
@@ -88,8 +108,11 @@ void MessageCore::process(const IMessagePtr& msg)
     BOOST_ASSERT(msg);
     BOOST_ASSERT(msg->getType() == msg::ASYNC);
 
+    klk_log(KLKLOG_DEBUG, "Trace message (id: %s; UUID: %d) from '%s'",
+            msg->getID().c_str(), msg->getUUID(),
+            msg->getSenderID().c_str());
 
-    const StringList receivers = msg->getReceiverList();
+    const StringList& receivers = msg->getReceiverList();
     IModuleFactory *mod_factory = getFactory()->getModuleFactory();
     BOOST_ASSERT(mod_factory);
     for (StringList::const_iterator i = receivers.begin();
@@ -46,7 +46,9 @@ namespace klk
         /**
            @brief The message core class implementation
 
-           The message core class implementation
+           Async messages are delivered directly by the module factory.
+           The module dispatches them only in the message trace mode
+           (see klk::IModuleFactory::setMessageTrace)
 
            @ingroup grMsgCore
         */
@@ -84,6 +86,18 @@ namespace klk
             /// @copydoc klk::IModule::registerProcessors
             virtual void registerProcessors();
 
+            /**
+               Do some actions before main loop
+
+               Enables the message trace mode if it was set at the config
+            */
+            virtual void preMainLoop();
+
+            /**
+               Do some actions after main loop
+            */
+            virtual void postMainLoop() throw();
+
             /**
                @copydoc IModule::getType
             */
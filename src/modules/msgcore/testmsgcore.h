@@ -69,6 +69,7 @@ namespace klk
             CPPUNIT_TEST(testSync);
             CPPUNIT_TEST(testSync);
             CPPUNIT_TEST(testASync);
+            CPPUNIT_TEST(testLatency);
             CPPUNIT_TEST_SUITE_END();
         public:
             /**
@@ -91,6 +92,11 @@ namespace klk
             */
             void testSync();
 
+            /**
+               The async. messages delivery latency benchmark
+            */
+            void testLatency();
+
             /**
                Destructor
             */
@@ -101,6 +107,15 @@ namespace klk
 
             /// Loads all necessary modules at setUp()
             virtual void loadModules();
+
+            /**
+               Measures async. message delivery latency
+
+               @param[in] trace - use the message trace mode or not
+
+               @return the average latency in seconds
+            */
+            double getLatency(bool trace);
         };
 
         /** @} */
@@ -177,7 +177,7 @@ void Network::processDev(const IDevPtr& dev, InfoSet& result)
         const std::string name = (*res)["name"].toString();
         const std::string route = (*res)["route"].toString();
         const std::string host = (*res)["host"].toString();
-        const std::string port = (*res)["port"].toString();
+        const u_int port = (*res)["port"].toUInt();
         const std::string protocol = (*res)["protocol"].toString();
         const std::string proto_name = (*res)["proto_name"].toString();
 
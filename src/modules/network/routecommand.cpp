@@ -58,6 +58,21 @@
 using namespace klk;
 using namespace klk::net;
 
+namespace
+{
+    /**
+       Gets the route port in the string form
+
+       @param[in] info - the route info
+
+       @return the port
+    */
+    const std::string getPortStr(const RouteInfoPtr& info)
+    {
+        return boost::lexical_cast<std::string>(info->getPort());
+    }
+}
+
 //
 // RouteListCommand class
 //
@@ -122,7 +137,7 @@ RouteListCommand::process(const cli::ParameterVector& params)
             (*item)->getDev()->getStringParam(dev::NAME).size());
         max_addr = std::max(max_addr,
                             (*item)->getHost().size() +
-                            (*item)->getPort().size() + 1);
+                            getPortStr(*item).size() + 1);
     }
 
     if (was == false)
@@ -155,7 +170,8 @@ RouteListCommand::process(const cli::ParameterVector& params)
         const std::string devname =
             (*info)->getDev()->getStringParam(dev::NAME);
         result << base::Utils::align(devname, max_dev);
-        const std::string addr = (*info)->getHost() + ":" + (*info)->getPort();
+        const std::string addr =
+            (*info)->getHost() + ":" + getPortStr(*info);
         result << base::Utils::align(addr, max_addr);
 
         if ((*info)->getProtocol() == TCPIP)
@@ -233,7 +249,7 @@ struct FindRouteInfoByContent
         BOOST_ASSERT(info);
         BOOST_ASSERT(dev);
         if (info->getHost() == host &&
-            info->getPort() == port &&
+            getPortStr(info) == port &&
             info->getDev()->getStringParam(dev::UUID) ==
             dev->getStringParam(dev::UUID))
         {
@@ -369,7 +385,7 @@ void RouteAddCommand::checkName(const std::string& name)
             "'%s:%s at %s'",
             name.c_str(),
             (*test)->getHost().c_str(),
-            (*test)->getPort().c_str(),
+            getPortStr(*test).c_str(),
             (*test)->getDev()->getStringParam(dev::NAME).c_str());
     }
 }
@@ -508,7 +524,7 @@ bool RouteAddCommand::isPortValid(const std::string& host,
     for (RouteInfoList::iterator item = list.begin();
          item != list.end(); item++)
     {
-        if (port == (*item)->getPort() && (*item)->getHost() == host)
+        if (port == getPortStr(*item) && (*item)->getHost() == host)
             return false; // already in use
     }
 
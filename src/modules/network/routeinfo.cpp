@@ -53,7 +53,7 @@ using namespace klk::net;
 RouteInfo::RouteInfo(const std::string& route,
                      const std::string& name,
                      const std::string& host,
-                     const std::string& port,
+                     u_int port,
                      const std::string& protocol,
                      const std::string& type,
                      const IDevPtr& dev,
@@ -75,7 +75,7 @@ const std::string RouteInfo::getHost() const throw()
 
 
 // Retrives route port
-const std::string RouteInfo::getPort() const throw()
+const u_int RouteInfo::getPort() const throw()
 {
     Locker lock(&m_lock);
     return m_port;
@@ -200,7 +200,7 @@ void RouteInfo::fillOutMessage(const IMessagePtr& out) const
     BOOST_ASSERT(out);
     out->setData(msg::key::MODINFONAME, getName());
     out->setData(msg::key::NETHOST, getHost());
-    out->setData(msg::key::NETPORT, getPort());
+    out->setData(msg::key::NETPORT, static_cast<long long>(getPort()));
     out->setData(msg::key::NETPROTO, getProtocol());
     out->setData(msg::key::NETTYPE, getType());
 }
@@ -76,7 +76,7 @@ namespace klk
             RouteInfo(const std::string& route,
                       const std::string& name,
                       const std::string& host,
-                      const std::string& port,
+                      u_int port,
                       const std::string& protocol,
                       const std::string& type,
                       const IDevPtr& dev,
@@ -94,7 +94,7 @@ namespace klk
 
                @return route's port
             */
-            const std::string getPort() const throw();
+            const u_int getPort() const throw();
 
             /**
                Retrives route protocol
@@ -154,7 +154,7 @@ namespace klk
             virtual void setInUse(bool value);
         private:
             std::string m_host; ///< host
-            std::string m_port; ///< port
+            u_int m_port; ///< port
             std::string m_protocol; ///< protocol
             std::string m_type; ///< type
             IDevPtr m_dev; ///< network device
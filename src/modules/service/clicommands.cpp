@@ -39,6 +39,7 @@
 #endif
 
 #include <sstream>
+#include <iomanip>
 
 #include <boost/bind.hpp>
 
@@ -124,7 +125,9 @@ const std::string InfoHelper::getResponse(IModuleFactory* factory,
     data << "  ";
     data << base::Utils::align("Uptime", maxsize);
     data << "  ";
-    data << "CPU usage\n";
+    data << base::Utils::align("CPU usage", maxsize);
+    data << "  ";
+    data << "Queue (depth/max, wait avg/max)\n";
     bool wasFound = false;
     for (ModuleList::iterator i = list.begin(); i != list.end(); i++)
     {
@@ -140,6 +143,8 @@ const std::string InfoHelper::getResponse(IModuleFactory* factory,
         data << base::Utils::align(getLoadInfo(factory, (*i)->getID()), maxsize);
         data << "  ";
         data << base::Utils::align(getCPUUsageInfo(factory, (*i)->getID()), maxsize);
+        data << "  ";
+        data << getQueueInfo(factory, (*i)->getID());
         data << "\n";
     }
     if (!wasFound)
@@ -173,6 +178,13 @@ const std::string InfoHelper::process(const cli::ParameterVector&
 }
 
 
+// Retrives module message queue info
+const std::string InfoHelper::getQueueInfo(IModuleFactory* factory,
+                                           const std::string& id) const
+{
+    return NOTAVAILABLE;
+}
+
 // Finds max  base::Utils::align ment length
 size_t InfoHelper::getMaxSize(IModuleFactory* factory,
                               const ModuleList& list) const
@@ -291,6 +303,22 @@ const std::string ModInfoCommand::getCPUUsageInfo(IModuleFactory* factory,
     return NOTAVAILABLE;
 }
 
+/// @copydoc klk::srv::InfoHelper::getQueueInfo()
+const std::string ModInfoCommand::getQueueInfo(IModuleFactory* factory,
+                                               const std::string& id) const
+{
+    if (!factory->isLoaded(id))
+    {
+        return NOTAVAILABLE;
+    }
+
+    const mod::QueueStat stat = factory->getModule(id)->getQueueStat();
+    std::stringstream data;
+    data << stat.m_depth << "/" << stat.m_max_depth << ", ";
+    data << std::fixed << std::setprecision(1);
+    data << stat.m_wait_avg * 1000 << "/" << stat.m_wait_max * 1000 << " ms";
+    return data.str();
+}
 
 //
 // LoadModuleCommand class
@@ -184,6 +184,17 @@ namespace klk
             */
             virtual const std::string getCPUUsageInfo(IModuleFactory* factory,
                                                       const std::string& id) const = 0;
+
+            /**
+               Retrives module message queue info
+
+               @param[in] factory - the module factory to retrive the module instance
+               @param[in] id - the interested module id
+
+               @return a string with message queue info
+            */
+            virtual const std::string getQueueInfo(IModuleFactory* factory,
+                                                   const std::string& id) const;
         private:
             mod::Type m_type; ///< type
 
@@ -271,6 +282,10 @@ namespace klk
             /// @copydoc klk::srv::InfoHelper::getCPUUsageInfo()
             virtual const std::string getCPUUsageInfo(IModuleFactory* factory,
                                                       const std::string& id) const;
+
+            /// @copydoc klk::srv::InfoHelper::getQueueInfo()
+            virtual const std::string getQueueInfo(IModuleFactory* factory,
+                                                   const std::string& id) const;
         private:
             /**
                Copy constructor
@@ -86,6 +86,9 @@ void Config::test()
     CPPUNIT_ASSERT(config.getSNMPInfo()->getReceiver() == "localhost");
     CPPUNIT_ASSERT(config.getSNMPInfo()->getReceiverPort() == 162);
     CPPUNIT_ASSERT(config.getSNMPInfo()->getCommunity() == "public");
+    CPPUNIT_ASSERT(config.isMessageTrace() == false);
+    CPPUNIT_ASSERT(config.getLogTarget() == "syslog");
+    CPPUNIT_ASSERT(config.getDVBAffinity() == "none");
 
     std::string fname = dir::SHARE + "/test/conf.test";
     config.setPath(fname);
@@ -97,6 +100,9 @@ void Config::test()
     config.save();
     config.load();
     testValues(config);
+
+    // conf.test lowers the log verbosity, restore it for the other tests
+    klk_log_set_level(KLKLOG_DEBUG);
 }
 
 // tests config value values
@@ -114,4 +120,14 @@ void Config::testValues(const klk::Config& config)
     CPPUNIT_ASSERT(config.getSNMPInfo()->getReceiver() == "localhost:45000");
     CPPUNIT_ASSERT(config.getSNMPInfo()->getReceiverPort() == 45000);
     CPPUNIT_ASSERT(config.getSNMPInfo()->getCommunity() == "private");
+
+    CPPUNIT_ASSERT(config.isMessageTrace() == true);
+
+    CPPUNIT_ASSERT(config.getLogLevel() == KLKLOG_WARNING);
+    CPPUNIT_ASSERT(klk_log_get_level() == KLKLOG_WARNING);
+    CPPUNIT_ASSERT(klk_log_is_enabled(KLKLOG_INFO) == 0);
+    CPPUNIT_ASSERT(klk_log_is_enabled(KLKLOG_ERROR) != 0);
+    CPPUNIT_ASSERT(config.getLogTarget() == "syslog");
+
+    CPPUNIT_ASSERT(config.getDVBAffinity() == "node0,2,3");
 }
@@ -40,6 +40,7 @@
 #endif
 
 #include <string.h>
+#include <stdio.h>
 
 #include <memory>
 
@@ -56,6 +57,12 @@
 
 using namespace klk::db;
 
+namespace
+{
+    /// Calls count for the benchmark
+    const u_int CALLCOUNT = 1000;
+}
+
 //
 // DBTest class
 //
@@ -136,4 +143,176 @@ void DBTest::test()
     db.disconnect();
 }
 
+// Tests the connections pool
+void DBTest::testPool()
+{
+    test::printOut("\nDB connections pool test ... ");
+
+    CPPUNIT_ASSERT(m_factory != NULL);
+    ConnectionPool* pool = m_factory->getDBPool();
+    CPPUNIT_ASSERT(pool != NULL);
+
+    // warm up: there is at least one idle connection after that
+    {
+        DB db(m_factory);
+        db.connect();
+        db.callSelect("klk_host_list", Parameters(), NULL);
+    }
+
+    const PoolStat before = pool->getStat();
+    CPPUNIT_ASSERT(before.m_idle > 0);
+
+    // sequential usage in the same thread reuses the connection
+    const u_int count = 100;
+    for (u_int i = 0; i < count; i++)
+    {
+        DB db(m_factory);
+        db.connect();
+        ResultVector rv = db.callSelect("klk_host_list", Parameters(), NULL);
+    }
+
+    PoolStat after = pool->getStat();
+    CPPUNIT_ASSERT(after.m_connects == before.m_connects);
+    CPPUNIT_ASSERT(after.m_checkouts == before.m_checkouts + count);
+    CPPUNIT_ASSERT(after.m_busy == 0);
+
+    // nested usage requires one more connection
+    {
+        DB db1(m_factory);
+        db1.connect();
+        DB db2(m_factory);
+        db2.connect();
+        db1.callSelect("klk_host_list", Parameters(), NULL);
+        db2.callSelect("klk_host_list", Parameters(), NULL);
+        CPPUNIT_ASSERT(pool->getStat().m_busy == 2);
+    }
+
+    after = pool->getStat();
+    CPPUNIT_ASSERT(after.m_busy == 0);
+    CPPUNIT_ASSERT(after.m_idle <= DB_POOL_THREAD_IDLE_MAX);
+    CPPUNIT_ASSERT(after.m_connects <= before.m_connects + 1);
+
+    char stat[256];
+    snprintf(stat, sizeof(stat),
+             "\n\tcheckouts: %lu, connects: %lu, failures: %lu, "
+             "avg wait: %.6f s., max wait: %.6f s. ",
+             after.m_checkouts, after.m_connects, after.m_failures,
+             after.m_wait_total / after.m_checkouts, after.m_wait_max);
+    test::printOut(stat);
+}
+
+// Tests prepared statements calls
+void DBTest::testPrepared()
+{
+    test::printOut("\nDB prepared statements test ... ");
+
+    CPPUNIT_ASSERT(m_factory != NULL);
+
+    DB db(m_factory);
+    db.connect();
+
+    const char *testhost = "db_unittest_host";
+    dynamic_cast<klk::Config*>(m_factory->getConfig())->setHostName(testhost);
+
+    // INOUT, IN and OUT parameters of different types
+    Parameters params_add;
+    params_add.add("@uuid", Parameters::null);
+    params_add.add("@host", testhost);
+    params_add.add("@cpu_index_typ", 1);
+    params_add.add("@cpu_index_max", 2);
+    params_add.add("@return", Parameters::null);
+    Result rv_add;
+    ResultVector rv = db.callPrepared("klk_host_add", params_add, &rv_add);
+    CPPUNIT_ASSERT(rv.empty());
+    CPPUNIT_ASSERT(rv_add["@return"].toInt() == 0);
+    const std::string uuid = rv_add["@uuid"].toString();
+    CPPUNIT_ASSERT(uuid.empty() == false);
+
+    // the same result as the text protocol gives
+    for (u_int i = 0; i < 2; i++)
+    {
+        rv = db.callPrepared("klk_host_list", Parameters(), NULL);
+        const ResultVector rv_text =
+            db.callSelect("klk_host_list", Parameters(), NULL);
+        CPPUNIT_ASSERT(rv.size() == 1);
+        CPPUNIT_ASSERT(rv_text.size() == 1);
+        CPPUNIT_ASSERT(rv[0]["host"].toString() == uuid);
+        CPPUNIT_ASSERT(rv[0]["host_name"].toString() == testhost);
+        CPPUNIT_ASSERT(rv[0]["cpu_index_typ"].toInt() == 1);
+        CPPUNIT_ASSERT(rv[0]["cpu_index_max"].toString() ==
+                       rv_text[0]["cpu_index_max"].toString());
+    }
+
+    Parameters params_uuid;
+    params_uuid.add("@host_name", testhost);
+    params_uuid.add("@uuid", Parameters::null);
+    Result rv_uuid;
+    db.callPrepared("klk_host_get_uuid", params_uuid, &rv_uuid);
+    CPPUNIT_ASSERT(rv_uuid["@uuid"].toString() == uuid);
+
+    // wrong parameters count
+    Parameters params_wrong;
+    params_wrong.add("@host_name", testhost);
+    bool failed = false;
+    try
+    {
+        db.callPrepared("klk_host_get_uuid", params_wrong, NULL);
+    }
+    catch(const klk::Exception&)
+    {
+        failed = true;
+    }
+    CPPUNIT_ASSERT(failed);
+
+    // clear at the end
+    DB db_clear(m_factory);
+    db_clear.connect();
+    Parameters params_delete;
+    params_delete.add("@host", uuid);
+    params_delete.add("@return", Parameters::null);
+    Result rv_del;
+    db_clear.callPrepared("klk_host_delete", params_delete, &rv_del);
+    CPPUNIT_ASSERT(rv_del["@return"].toInt() == 0);
+}
+
+// Compares prepared statements and text queries performance
+void DBTest::testBenchmark()
+{
+    test::printOut("\nDB prepared statements benchmark ... ");
+
+    CPPUNIT_ASSERT(m_factory != NULL);
+
+    DB db(m_factory);
+    db.connect();
+
+    // klk_file_list like select: a host filter and several rows
+    const std::string host = db.getHostUUID();
+    Parameters params;
+    params.add("@hostuuid", host);
+
+    size_t count = 0;
+    double start = test::getTime();
+    for (u_int i = 0; i < CALLCOUNT; i++)
+    {
+        count += db.callSelect("klk_application_list", params, NULL).size();
+    }
+    const double text = CALLCOUNT / (test::getTime() - start);
+
+    size_t count_prepared = 0;
+    start = test::getTime();
+    for (u_int i = 0; i < CALLCOUNT; i++)
+    {
+        count_prepared +=
+            db.callPrepared("klk_application_list", params, NULL).size();
+    }
+    const double prepared = CALLCOUNT / (test::getTime() - start);
+
+    CPPUNIT_ASSERT(count == count_prepared);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "\n\ttext queries: %.0f calls/sec"
+             "\n\tprepared statements: %.0f calls/sec", text, prepared);
+    test::printOut(msg);
+}
+
 
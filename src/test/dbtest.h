@@ -59,6 +59,9 @@ namespace klk
         {
             CPPUNIT_TEST_SUITE(DBTest);
             CPPUNIT_TEST(test);
+            CPPUNIT_TEST(testPool);
+            CPPUNIT_TEST(testPrepared);
+            CPPUNIT_TEST(testBenchmark);
             CPPUNIT_TEST_SUITE_END();
         public:
             /**
@@ -75,6 +78,22 @@ namespace klk
                The unit test itself
             */
             void test();
+
+            /**
+               Tests the connections pool
+            */
+            void testPool();
+
+            /**
+               Tests prepared statements calls
+            */
+            void testPrepared();
+
+            /**
+               Compares prepared statements and text queries
+               performance
+            */
+            void testBenchmark();
         private:
             test::DBScriptLauncher* m_launcher; ///< db script launcher
             IFactory* m_factory; ///< factory
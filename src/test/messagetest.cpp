@@ -0,0 +1,188 @@
+/**
+   @file src/test/messagetest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "messagetest.h"
+#include "message.h"
+#include "msgfuture.h"
+#include "exception.h"
+
+using namespace klk;
+
+// Checks that the expression produces klk::Exception
+#define MESSAGETEST_ASSERT_THROW(expr)        \
+    {                                           \
+        bool thrown = false;                    \
+        try                                     \
+        {                                       \
+            expr;                               \
+        }                                       \
+        catch(const Exception&)                 \
+        {                                       \
+            thrown = true;                      \
+        }                                       \
+        CPPUNIT_ASSERT(thrown);                 \
+    }
+
+//
+// MessageTest class
+//
+
+// Constructor
+void MessageTest::setUp()
+{
+}
+
+// Destructor
+void MessageTest::tearDown()
+{
+}
+
+// Tests string, integer and list values
+void MessageTest::testValues()
+{
+    IMessagePtr msg(new Message("test", 1));
+
+    msg->setData("string", "value");
+    msg->setData("integer", 12345LL);
+    msg->setData("number", "-7");
+    StringList list;
+    list.push_back("item1");
+    list.push_back("item2");
+    msg->setData("list", list);
+
+    CPPUNIT_ASSERT(msg->hasValue("string"));
+    CPPUNIT_ASSERT(msg->hasValue("integer"));
+    // lists are not simple values
+    CPPUNIT_ASSERT(msg->hasValue("list") == false);
+    CPPUNIT_ASSERT(msg->hasValue("unknown") == false);
+
+    CPPUNIT_ASSERT(msg->getValue("string") == "value");
+    // integers are accessible as strings
+    CPPUNIT_ASSERT(msg->getValue("integer") == "12345");
+    CPPUNIT_ASSERT(msg->getInteger("integer") == 12345LL);
+    // and strings as integers
+    CPPUNIT_ASSERT(msg->getInteger("number") == -7LL);
+    CPPUNIT_ASSERT(msg->getList("list") == list);
+
+    MESSAGETEST_ASSERT_THROW(msg->getInteger("string"));
+    MESSAGETEST_ASSERT_THROW(msg->getValue("list"));
+    MESSAGETEST_ASSERT_THROW(msg->getList("string"));
+    MESSAGETEST_ASSERT_THROW(msg->getValue("unknown"));
+
+    // overwrite changes the type
+    msg->setData("integer", "text");
+    CPPUNIT_ASSERT(msg->getValue("integer") == "text");
+    msg->setData("string", 1LL);
+    CPPUNIT_ASSERT(msg->getValue("string") == "1");
+
+    // lists and simple values have different keys
+    msg->setData("list", "simple");
+    CPPUNIT_ASSERT(msg->getValue("list") == "simple");
+    CPPUNIT_ASSERT(msg->getList("list") == list);
+}
+
+// Tests the sealed message
+void MessageTest::testSeal()
+{
+    IMessagePtr msg(new Message("test", 2));
+    msg->setData("string", "value");
+    msg->addReceiver("receiver");
+    msg->setType(msg::ASYNC);
+    msg->setSenderID("sender");
+
+    msg->seal();
+
+    // the data is still available
+    CPPUNIT_ASSERT(msg->getValue("string") == "value");
+    CPPUNIT_ASSERT(msg->getReceiverList().size() == 1);
+    CPPUNIT_ASSERT(msg->getType() == msg::ASYNC);
+
+    // same values can be set again
+    msg->setType(msg::ASYNC);
+    msg->setSenderID("sender");
+
+    MESSAGETEST_ASSERT_THROW(msg->setData("string", "new"));
+    MESSAGETEST_ASSERT_THROW(msg->setData("integer", 1LL));
+    MESSAGETEST_ASSERT_THROW(msg->setData("list", StringList()));
+    MESSAGETEST_ASSERT_THROW(msg->addReceiver("receiver2"));
+    MESSAGETEST_ASSERT_THROW(msg->setType(msg::SYNC_REQ));
+    MESSAGETEST_ASSERT_THROW(msg->setSenderID("sender2"));
+    CPPUNIT_ASSERT(msg->getValue("string") == "value");
+}
+
+// Tests the sync request future
+void MessageTest::testFuture()
+{
+    IMessagePtr request(new Message("test", 3));
+    request->setType(msg::SYNC_REQ);
+    IMessagePtr response(new Message("test", 3));
+    response->setType(msg::SYNC_RES);
+
+    // not completed
+    MessageFuturePtr future(new MessageFuture(request));
+    CPPUNIT_ASSERT(future->isReady() == false);
+    CPPUNIT_ASSERT(future->wait(0) == ERROR);
+    MESSAGETEST_ASSERT_THROW(future->get(0));
+
+    // the first completion wins
+    CPPUNIT_ASSERT(future->setResponse(response) == true);
+    CPPUNIT_ASSERT(future->setFailed("late") == false);
+    CPPUNIT_ASSERT(future->isReady());
+    CPPUNIT_ASSERT(future->wait(0) == OK);
+    CPPUNIT_ASSERT(future->get(0) == response);
+
+    // failed request
+    MessageFuturePtr failed(new MessageFuture(request));
+    CPPUNIT_ASSERT(failed->setFailed("timeout") == true);
+    CPPUNIT_ASSERT(failed->wait(0) == OK);
+    MESSAGETEST_ASSERT_THROW(failed->get(0));
+
+    // response for another request
+    MessageFuturePtr wrong(new MessageFuture(request));
+    IMessagePtr wrong_response(new Message("wrong", 3));
+    wrong->setResponse(wrong_response);
+    MESSAGETEST_ASSERT_THROW(wrong->get(0));
+
+    // fan-in
+    MessageFutureList futures;
+    futures.push_back(future);
+    futures.push_back(failed);
+    CPPUNIT_ASSERT(waitFutures(futures, 0) == OK);
+    futures.push_back(MessageFuturePtr(new MessageFuture(request)));
+    CPPUNIT_ASSERT(waitFutures(futures, 1) == ERROR);
+}
@@ -0,0 +1,84 @@
+/**
+   @file src/test/messagetest.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+
+#ifndef KLK_MESSAGETEST_H
+#define KLK_MESSAGETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    /**
+       @brief Message unit test
+
+       Tests the message data storage (@ref klk::Message)
+
+       @ingroup grTest
+    */
+    class MessageTest : public CppUnit::TestFixture
+    {
+        CPPUNIT_TEST_SUITE(MessageTest);
+        CPPUNIT_TEST(testValues);
+        CPPUNIT_TEST(testSeal);
+        CPPUNIT_TEST(testFuture);
+        CPPUNIT_TEST_SUITE_END();
+    public:
+        /**
+           Constructor
+        */
+        void setUp();
+
+        /**
+           Destructor
+        */
+        void tearDown();
+
+        /**
+           Tests string, integer and list values
+        */
+        void testValues();
+
+        /**
+           Tests the sealed message
+        */
+        void testSeal();
+
+        /**
+           Tests the sync request future
+        */
+        void testFuture();
+    };
+}
+
+#endif //KLK_MESSAGETEST_H
@@ -62,7 +62,7 @@ void InfoTest::setUp()
 // Destructor
 void InfoTest::tearDown()
 {
-    m_container.m_container.clear();
+    m_container.clear();
 }
 
 // Do the test of dependency creation
@@ -96,3 +96,49 @@ void InfoTest::checkContainer()
     CPPUNIT_ASSERT(del.size() == 1);
 
 }
+
+// Tests changes apply
+void InfoTest::checkApply()
+{
+    test::printOut("\nModules info container changes test ... ");
+
+    // test1 was changed, test2 was deleted, test3 was added
+    InfoPtr info1(new Info("test1", "test1_new"));
+    InfoPtr info3(new Info("test3", "test3"));
+    InfoContainer<Info>::InfoSet set;
+    set.insert(info1);
+    set.insert(info3);
+
+    StringList uuids;
+    uuids.push_back("test1");
+    uuids.push_back("test2");
+    uuids.push_back("test3");
+    // unknown info that was deleted
+    uuids.push_back("test4");
+    m_container.apply(uuids, set);
+
+    CPPUNIT_ASSERT(m_container.size() == 2);
+    CPPUNIT_ASSERT(m_container.getInfoByUUID("test1") == m_info1);
+    CPPUNIT_ASSERT(m_info1->getName() == "test1_new");
+    CPPUNIT_ASSERT(m_container.getInfoByUUID("test3") == info3);
+    bool found = true;
+    try
+    {
+        m_container.getInfoByUUID("test2");
+    }
+    catch(const Exception&)
+    {
+        found = false;
+    }
+    CPPUNIT_ASSERT(found == false);
+
+    // an info in use is not deleted
+    m_info1->setInUse(true);
+    uuids.clear();
+    uuids.push_back("test1");
+    m_container.apply(uuids, InfoContainer<Info>::InfoSet());
+    CPPUNIT_ASSERT(m_container.size() == 2);
+    m_info1->setInUse(false);
+    m_container.apply(uuids, InfoContainer<Info>::InfoSet());
+    CPPUNIT_ASSERT(m_container.size() == 1);
+}
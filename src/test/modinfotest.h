@@ -55,6 +55,7 @@ namespace klk
         {
             CPPUNIT_TEST_SUITE(InfoTest);
             CPPUNIT_TEST(checkContainer);
+            CPPUNIT_TEST(checkApply);
             CPPUNIT_TEST_SUITE_END();
         public:
             /**
@@ -71,6 +72,11 @@ namespace klk
                Do the test
             */
             void checkContainer();
+
+            /**
+               Tests changes apply
+            */
+            void checkApply();
         private:
             InfoContainer<Info> m_container; ///< the tested object
             InfoPtr m_info1; ///< first info
@@ -0,0 +1,299 @@
+/**
+   @file msgqueuetest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/time.h>
+
+#include <map>
+#include <sstream>
+
+#include "msgqueuetest.h"
+#include "message.h"
+#include "exception.h"
+#include "testutils.h"
+
+using namespace klk;
+
+// number of producers
+static const size_t PRODUCERCOUNT = 4;
+// number of messages sent by a producer
+static const msg::UUID MSGCOUNT = 100000;
+
+//
+// ProducerThread class
+//
+
+// Constructor
+ProducerThread::ProducerThread(MessageHolder4Standard* holder,
+                               const std::string& id, msg::UUID count) :
+    test::Thread(), m_holder(holder), m_id(id), m_count(count)
+{
+    BOOST_ASSERT(m_holder);
+}
+
+// Sends the messages
+void ProducerThread::mainLoop()
+{
+    for (msg::UUID i = 0; i < m_count; i++)
+    {
+        IMessagePtr msg(new Message(m_id, i));
+        if (m_holder->add(msg) != OK)
+        {
+            throw Exception(__FILE__, __LINE__,
+                            "Cannot add message %u from producer %s",
+                            i, m_id.c_str());
+        }
+    }
+}
+
+//
+// MessageQueueTest class
+//
+
+// Constructor
+void MessageQueueTest::setUp()
+{
+    m_scheduler.clear();
+}
+
+// Destructor
+void MessageQueueTest::tearDown()
+{
+    m_scheduler.stop();
+    m_scheduler.clear();
+}
+
+// Tests several producers and checks the messages order
+void MessageQueueTest::testProducers()
+{
+    test::printOut("\nMessage queue test ... ");
+
+    MessageHolder4Standard holder;
+    holder.start();
+
+    std::map<std::string, msg::UUID> expected;
+    for (size_t i = 0; i < PRODUCERCOUNT; i++)
+    {
+        std::stringstream id;
+        id << "producer" << i;
+        expected[id.str()] = 0;
+        m_scheduler.addTestThread(
+            test::ThreadPtr(new ProducerThread(&holder, id.str(),
+                                               MSGCOUNT)));
+    }
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    m_scheduler.start();
+
+    size_t count = 0;
+    MessageVector msgs;
+    while (count < PRODUCERCOUNT * MSGCOUNT)
+    {
+        CPPUNIT_ASSERT(holder.get(msgs) == OK);
+        CPPUNIT_ASSERT(msgs.empty() == false);
+        CPPUNIT_ASSERT(msgs.size() <= MESSAGEQUEUE_BATCH);
+        for (MessageVector::iterator i = msgs.begin(); i != msgs.end(); i++)
+        {
+            // the messages from one producer should be in order
+            CPPUNIT_ASSERT(expected.find((*i)->getID()) != expected.end());
+            CPPUNIT_ASSERT((*i)->getUUID() == expected[(*i)->getID()]);
+            expected[(*i)->getID()]++;
+        }
+        count += msgs.size();
+    }
+
+    struct timeval stop;
+    gettimeofday(&stop, NULL);
+    m_scheduler.stop();
+    m_scheduler.checkResult();
+
+    const double interval = (stop.tv_sec - start.tv_sec) +
+        (stop.tv_usec - start.tv_usec) / 1000000.0;
+    CPPUNIT_NS::stdCOut() << "\nMessages per second: " <<
+        static_cast<u_long>(count / interval);
+    CPPUNIT_NS::stdCOut().flush();
+
+    const mod::QueueStat stat = holder.getStat();
+    CPPUNIT_ASSERT(stat.m_received == PRODUCERCOUNT * MSGCOUNT);
+    CPPUNIT_ASSERT(stat.m_processed == PRODUCERCOUNT * MSGCOUNT);
+    CPPUNIT_ASSERT(stat.m_depth == 0);
+    CPPUNIT_ASSERT(stat.m_max_depth > 0);
+    CPPUNIT_ASSERT(stat.m_wait_max >= stat.m_wait_avg);
+
+    holder.stop();
+}
+
+// Tests the ring overflow
+void MessageQueueTest::testOverflow()
+{
+    test::printOut("\nMessage queue overflow test ... ");
+
+    const size_t SIZE = 8;
+    const msg::UUID COUNT = 100;
+    MessageHolder4Standard holder(SIZE);
+    holder.start();
+
+    for (msg::UUID i = 0; i < COUNT; i++)
+    {
+        CPPUNIT_ASSERT(holder.add(IMessagePtr(new Message("test", i))) == OK);
+    }
+
+    mod::QueueStat stat = holder.getStat();
+    CPPUNIT_ASSERT(stat.m_received == COUNT);
+    CPPUNIT_ASSERT(stat.m_overflow == COUNT - SIZE);
+    CPPUNIT_ASSERT(stat.m_depth == COUNT);
+
+    msg::UUID expected = 0;
+    MessageVector msgs;
+    while (expected < COUNT)
+    {
+        CPPUNIT_ASSERT(holder.get(msgs, 10) == OK);
+        CPPUNIT_ASSERT(msgs.size() <= 10);
+        for (MessageVector::iterator i = msgs.begin(); i != msgs.end(); i++)
+        {
+            CPPUNIT_ASSERT((*i)->getUUID() == expected);
+            expected++;
+            // the ring has free slots now but the order should be kept
+            CPPUNIT_ASSERT(holder.add(
+                               IMessagePtr(new Message("test",
+                                                       COUNT + expected))) ==
+                           OK);
+        }
+    }
+
+    stat = holder.getStat();
+    CPPUNIT_ASSERT(stat.m_processed == COUNT);
+    CPPUNIT_ASSERT(stat.m_depth == COUNT);
+    CPPUNIT_ASSERT(stat.m_max_depth == COUNT);
+
+    while (expected < 2 * COUNT)
+    {
+        CPPUNIT_ASSERT(holder.get(msgs) == OK);
+        for (MessageVector::iterator i = msgs.begin(); i != msgs.end(); i++)
+        {
+            expected++;
+            CPPUNIT_ASSERT((*i)->getUUID() == expected);
+        }
+    }
+    CPPUNIT_ASSERT(holder.getStat().m_depth == 0);
+
+    holder.stop();
+}
+
+// Tests several producers with the ring overflow
+void MessageQueueTest::testOverflowProducers()
+{
+    test::printOut("\nMessage queue overflow producers test ... ");
+
+    const size_t SIZE = 16;
+    const msg::UUID COUNT = 20000;
+    MessageHolder4Standard holder(SIZE);
+    holder.start();
+
+    // the ring is full before the producers start: the overflow list
+    // is used and the producers race with the ring slots releasing
+    std::map<std::string, msg::UUID> expected;
+    expected["prefill"] = 0;
+    for (msg::UUID i = 0; i <= SIZE; i++)
+    {
+        CPPUNIT_ASSERT(holder.add(
+                           IMessagePtr(new Message("prefill", i))) == OK);
+    }
+    CPPUNIT_ASSERT(holder.getStat().m_overflow > 0);
+
+    for (size_t i = 0; i < PRODUCERCOUNT; i++)
+    {
+        std::stringstream id;
+        id << "producer" << i;
+        expected[id.str()] = 0;
+        m_scheduler.addTestThread(
+            test::ThreadPtr(new ProducerThread(&holder, id.str(), COUNT)));
+    }
+    m_scheduler.start();
+
+    const size_t total = PRODUCERCOUNT * COUNT + SIZE + 1;
+    size_t count = 0;
+    MessageVector msgs;
+    while (count < total)
+    {
+        CPPUNIT_ASSERT(holder.get(msgs) == OK);
+        for (MessageVector::iterator i = msgs.begin(); i != msgs.end(); i++)
+        {
+            // the messages from one producer should be in order
+            CPPUNIT_ASSERT(expected.find((*i)->getID()) != expected.end());
+            CPPUNIT_ASSERT((*i)->getUUID() == expected[(*i)->getID()]);
+            expected[(*i)->getID()]++;
+        }
+        count += msgs.size();
+    }
+
+    m_scheduler.stop();
+    m_scheduler.checkResult();
+
+    const mod::QueueStat stat = holder.getStat();
+    CPPUNIT_ASSERT(stat.m_received == total);
+    CPPUNIT_ASSERT(stat.m_processed == total);
+    CPPUNIT_ASSERT(stat.m_depth == 0);
+
+    holder.stop();
+}
+
+// Tests add/get after stop
+void MessageQueueTest::testStop()
+{
+    test::printOut("\nMessage queue stop test ... ");
+
+    MessageHolder4Standard holder;
+    holder.start();
+    CPPUNIT_ASSERT(holder.add(IMessagePtr(new Message("test", 0))) == OK);
+    holder.stop();
+
+    // unprocessed messages are dropped
+    MessageVector msgs;
+    CPPUNIT_ASSERT(holder.get(msgs) == ERROR);
+    CPPUNIT_ASSERT(msgs.empty());
+    CPPUNIT_ASSERT(holder.add(IMessagePtr(new Message("test", 1))) == ERROR);
+    CPPUNIT_ASSERT(holder.getStat().m_depth == 0);
+
+    // the holder can be restarted
+    holder.start();
+    CPPUNIT_ASSERT(holder.add(IMessagePtr(new Message("test", 2))) == OK);
+    CPPUNIT_ASSERT(holder.get(msgs) == OK);
+    CPPUNIT_ASSERT(msgs.size() == 1);
+    CPPUNIT_ASSERT(msgs.front()->getUUID() == 2);
+    holder.stop();
+}
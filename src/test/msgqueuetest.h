@@ -0,0 +1,140 @@
+/**
+   @file msgqueuetest.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_MSGQUEUETEST_H
+#define KLK_MSGQUEUETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "messageholder.h"
+#include "testthread.h"
+
+namespace klk
+{
+    /**
+       @brief Message producer for the message queue test
+
+       Sends messages with increasing UUIDs to the message holder
+
+       @ingroup grTest
+    */
+    class ProducerThread : public test::Thread
+    {
+    public:
+        /**
+           Constructor
+
+           @param[in] holder - the holder to be filled
+           @param[in] id - the producer id (message id)
+           @param[in] count - number of messages to be sent
+        */
+        ProducerThread(MessageHolder4Standard* holder,
+                       const std::string& id, msg::UUID count);
+
+        /**
+           Destructor
+        */
+        virtual ~ProducerThread(){}
+    private:
+        MessageHolder4Standard* const m_holder; ///< the holder
+        const std::string m_id; ///< producer id
+        const msg::UUID m_count; ///< messages count
+
+        /// @copydoc klk::test::Thread::mainLoop
+        virtual void mainLoop();
+    private:
+        /**
+           Copy constructor
+           @param[in] value - the copy param
+        */
+        ProducerThread(const ProducerThread& value);
+
+        /**
+           Assigment operator
+           @param[in] value - the copy param
+        */
+        ProducerThread& operator=(const ProducerThread& value);
+    };
+
+    /**
+       @brief Message queue unit test
+
+       Tests the module message queue (@ref klk::MessageHolder4Standard)
+
+       @ingroup grTest
+    */
+    class MessageQueueTest : public CppUnit::TestFixture
+    {
+        CPPUNIT_TEST_SUITE(MessageQueueTest);
+        CPPUNIT_TEST(testProducers);
+        CPPUNIT_TEST(testOverflow);
+        CPPUNIT_TEST(testOverflowProducers);
+        CPPUNIT_TEST(testStop);
+        CPPUNIT_TEST_SUITE_END();
+    public:
+        /**
+           Constructor
+        */
+        void setUp();
+
+        /**
+           Destructor
+        */
+        void tearDown();
+
+        /**
+           Tests several producers and checks the messages order
+        */
+        void testProducers();
+
+        /**
+           Tests the ring overflow
+        */
+        void testOverflow();
+
+        /**
+           Tests several producers with the ring overflow
+           and checks the messages order
+        */
+        void testOverflowProducers();
+
+        /**
+           Tests add/get after stop
+        */
+        void testStop();
+    private:
+        test::Scheduler m_scheduler; ///< producers scheduler
+    };
+}
+
+#endif //KLK_MSGQUEUETEST_H
@@ -39,6 +39,9 @@
 #endif
 
 #include <string.h>
+#include <time.h>
+#include <sys/select.h>
+#include <sys/socket.h>
 
 #include "socktest.h"
 #include "exception.h"
@@ -70,6 +73,21 @@ const u_int TESTSOCK_PORT = 80600;
 */
 const size_t SOCKBUFFSIZE = (13*1024);
 
+/**
+   UDP benchmark port
+*/
+const u_int TESTSOCK_BENCHPORT = 20601;
+
+/**
+   UDP drops test port
+*/
+const u_int TESTSOCK_DROPPORT = 20602;
+
+/**
+   UDP benchmark datagram size (7 MPEG-TS packets)
+*/
+const size_t TESTSOCK_DATAGRAM = 7*188;
+
 //
 // We always send data size at the begining of send request
 // to be able read all necessary in corresponding recieve
@@ -542,6 +560,90 @@ void SocketTest::testDomain()
 }
 
 
+// Measures UDP receive performance
+const double SocketTest::measureUDP(bool batch)
+{
+    const int ROUNDS = 500, DATAGRAMS = 64;
+
+    sock::RouteInfo route(TESTSOCK_HOST, TESTSOCK_BENCHPORT,
+                          sock::UDP, sock::UNICAST);
+    IListenerPtr listener = sock::Factory::getListener(route);
+    ISocketPtr input = listener->accept();
+    CPPUNIT_ASSERT(input);
+    input->setRecvBuffer(UDP_RCVBUF_SIZE);
+    ISocketPtr output = sock::Factory::getSocket(sock::UDP);
+    output->connect(route);
+
+    const BinaryData datagram(std::string(TESTSOCK_DATAGRAM, 'x'));
+    BinaryData buff(TESTSOCK_DATAGRAM * UDP_BATCH_SIZE);
+    double cpu = 0;
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        for (int j = 0; j < DATAGRAMS; j++)
+        {
+            output->send(datagram);
+        }
+
+        // only the receive side is measured
+        struct timespec start, stop;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+        size_t size = 0;
+        while (size < TESTSOCK_DATAGRAM * DATAGRAMS)
+        {
+            if (batch)
+            {
+                BinaryData data(buff.size());
+                input->recv(data);
+                size += data.size();
+            }
+            else
+            {
+                // the receive path without batching
+                const int fd = input->getDescriptor();
+                fd_set fds;
+                FD_ZERO(&fds);
+                FD_SET(fd, &fds);
+                struct timeval timeout = {10, 0};
+                CPPUNIT_ASSERT(select(fd + 1, &fds, NULL, NULL,
+                                      &timeout) == 1);
+                const ssize_t count =
+                    ::recvfrom(fd, buff.toVoid(), buff.size(), 0, NULL, NULL);
+                CPPUNIT_ASSERT(count > 0);
+                size += static_cast<size_t>(count);
+            }
+        }
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &stop);
+        cpu += (stop.tv_sec - start.tv_sec) +
+            (stop.tv_nsec - start.tv_nsec) / 1e9;
+    }
+
+    // the datagrams were not lost on the loopback
+    CPPUNIT_ASSERT(input->getDroppedCount() == 0);
+    listener->stop();
+
+    return (cpu > 0) ? (ROUNDS * DATAGRAMS) / cpu : 0;
+}
+
+// UDP batch receive benchmark
+void SocketTest::testUDPBatch()
+{
+    printOut("\nUDP batch receive benchmark ... ");
+
+    const double single = measureUDP(false);
+    const double batch = measureUDP(true);
+
+    CPPUNIT_NS::stdCOut() << "\n\tselect() + recvfrom(): "
+                          << static_cast<u_long>(single)
+                          << " datagrams per CPU second";
+    CPPUNIT_NS::stdCOut() << "\n\trecvmmsg(): "
+                          << static_cast<u_long>(batch)
+                          << " datagrams per CPU second";
+    CPPUNIT_NS::stdCOut().flush();
+
+    CPPUNIT_ASSERT(single > 0);
+    CPPUNIT_ASSERT(batch > 0);
+}
+
 // Tests the exception after two connect
 void SocketTest::test2Connect()
 {
@@ -563,3 +665,46 @@ void SocketTest::test2Connect()
     sock->connect(testroute); // should produce exception ???
     m_scheduler.stop();
 }
+
+// Tests the kernel drops report for the UDP input
+void SocketTest::testUDPDrops()
+{
+    printOut("\nUDP drops test ... ");
+
+    const int DATAGRAMS = 256;
+
+    sock::RouteInfo route(TESTSOCK_HOST, TESTSOCK_DROPPORT,
+                          sock::UDP, sock::UNICAST);
+    IListenerPtr listener = sock::Factory::getListener(route);
+    ISocketPtr input = listener->accept();
+    CPPUNIT_ASSERT(input);
+    // the buffer keeps only several datagrams
+    input->setRecvBuffer(TESTSOCK_DATAGRAM * 4);
+    ISocketPtr output = sock::Factory::getSocket(sock::UDP);
+    output->connect(route);
+
+    const BinaryData datagram(std::string(TESTSOCK_DATAGRAM, 'x'));
+    for (int i = 0; i < DATAGRAMS; i++)
+    {
+        output->send(datagram);
+    }
+
+    // the datagrams at the buffer were queued before the drops
+    while (input->checkData(0) == OK)
+    {
+        BinaryData data(TESTSOCK_DATAGRAM * UDP_BATCH_SIZE);
+        input->recv(data);
+    }
+
+    // the next one brings the drops counter
+    output->send(datagram);
+    CPPUNIT_ASSERT(input->checkData(10) == OK);
+    BinaryData data(TESTSOCK_DATAGRAM);
+    input->recv(data);
+    CPPUNIT_ASSERT(data.size() == TESTSOCK_DATAGRAM);
+#ifdef SO_RXQ_OVFL
+    CPPUNIT_ASSERT(input->getDroppedCount() > 0);
+#endif
+
+    listener->stop();
+}
@@ -245,6 +245,8 @@ namespace klk
             CPPUNIT_TEST(testTCPIP);
             CPPUNIT_TEST(testUDP);
             CPPUNIT_TEST(testDomain);
+            CPPUNIT_TEST(testUDPBatch);
+            CPPUNIT_TEST(testUDPDrops);
             CPPUNIT_TEST_EXCEPTION(test2Connect, klk::Exception);
             CPPUNIT_TEST_SUITE_END();
         public:
@@ -283,6 +285,16 @@ namespace klk
             */
             void testDomain();
 
+            /**
+               UDP batch receive benchmark
+            */
+            void testUDPBatch();
+
+            /**
+               Tests the kernel drops report for the UDP input
+            */
+            void testUDPDrops();
+
             /**
                Tests the exception after two connect
             */
@@ -296,6 +308,16 @@ namespace klk
                @param[in] proto - the protocol
             */
             void test(const sock::Protocol proto);
+
+            /**
+               Measures UDP receive performance
+
+               @param[in] batch - use the batch receive (recvmmsg)
+               or select() + recvfrom() for each datagram
+
+               @return datagrams per second of CPU time
+            */
+            const double measureUDP(bool batch);
         private:
             /**
                Assigment operator
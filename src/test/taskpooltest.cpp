@@ -0,0 +1,218 @@
+/**
+   @file src/test/taskpooltest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+
+#include "taskpooltest.h"
+#include "taskpool.h"
+
+using namespace klk;
+
+/**
+   Tasks count for the tests
+*/
+const int TASKPOOLTEST_COUNT = 1000;
+
+// Increases the counter
+static void task_count(volatile int* counter)
+{
+    __sync_add_and_fetch(counter, 1);
+}
+
+// Increases the counter and sleeps
+static void task_sleep(volatile int* counter, useconds_t usec)
+{
+    usleep(usec);
+    task_count(counter);
+}
+
+// Posts several slow tasks from a worker (to the worker own queue)
+static void task_spawn(TaskPool* pool, volatile int* counter, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        pool->post(boost::bind(task_sleep, counter, 10000));
+    }
+}
+
+// Throws an exception
+static void task_throw()
+{
+    throw std::runtime_error("task pool test");
+}
+
+// Stores the task execution time
+static void task_time(volatile long long* ms)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    *ms = static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+// Stores the counter value at the task execution
+static void task_seen(volatile int* counter, volatile int* seen)
+{
+    *seen = *counter + 1;
+}
+
+// Waits till the counter reaches the value (max 5 sec)
+static void task_wait(volatile int* counter, int value)
+{
+    for (int i = 0; i < 500 && *counter < value; i++)
+    {
+        usleep(10000);
+    }
+}
+
+//
+// TaskPoolTest class
+//
+
+// Constructor
+void TaskPoolTest::setUp()
+{
+}
+
+// Destructor
+void TaskPoolTest::tearDown()
+{
+}
+
+// Tests tasks execution and the statistics
+void TaskPoolTest::testPost()
+{
+    TaskPool pool(4);
+    volatile int count = 0;
+
+    for (int i = 0; i < TASKPOOLTEST_COUNT; i++)
+    {
+        pool.post(boost::bind(task_count, &count));
+    }
+    pool.post(task_throw);
+
+    task_wait(&count, TASKPOOLTEST_COUNT);
+    CPPUNIT_ASSERT(count == TASKPOOLTEST_COUNT);
+
+    usleep(10000);
+    const TaskPoolStat stat = pool.getStat();
+    CPPUNIT_ASSERT(stat.m_workers == 4);
+    CPPUNIT_ASSERT(stat.m_posted == TASKPOOLTEST_COUNT + 1);
+    CPPUNIT_ASSERT(stat.m_executed == TASKPOOLTEST_COUNT + 1);
+    CPPUNIT_ASSERT(stat.m_failed == 1);
+    CPPUNIT_ASSERT(stat.m_queued == 0);
+}
+
+// Tests that idle workers take tasks from a busy one
+void TaskPoolTest::testSteal()
+{
+    TaskPool pool(4);
+    volatile int count = 0;
+
+    // all tasks go to the queue of the worker that runs task_spawn
+    pool.post(boost::bind(task_spawn, &pool, &count, 100));
+    task_wait(&count, 100);
+    CPPUNIT_ASSERT(count == 100);
+    CPPUNIT_ASSERT(pool.getStat().m_stolen > 0);
+}
+
+// Tests delayed tasks
+void TaskPoolTest::testSchedule()
+{
+    TaskPool pool(2);
+    volatile long long executed = 0;
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    const long long start =
+        static_cast<long long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+
+    pool.schedule(boost::bind(task_time, &executed), 100);
+    CPPUNIT_ASSERT(pool.getStat().m_delayed == 1);
+    usleep(50000);
+    CPPUNIT_ASSERT(executed == 0);
+    usleep(150000);
+    CPPUNIT_ASSERT(executed >= start + 100);
+    CPPUNIT_ASSERT(executed < start + 200);
+    CPPUNIT_ASSERT(pool.getStat().m_delayed == 0);
+}
+
+// Tests delayed tasks while the workers are busy
+void TaskPoolTest::testScheduleBusy()
+{
+    TaskPool pool(1);
+    volatile int count = 0, seen = 0;
+
+    // the only worker does not become idle for about 500 ms
+    pool.post(boost::bind(task_spawn, &pool, &count, 50));
+    pool.schedule(boost::bind(task_seen, &count, &seen), 20);
+
+    task_wait(&count, 50);
+    CPPUNIT_ASSERT(count == 50);
+    task_wait(&seen, 1);
+    // the delayed task was not starved by the busy worker
+    CPPUNIT_ASSERT(seen > 0);
+    CPPUNIT_ASSERT(seen < 50);
+}
+
+// Tests the pool stop
+void TaskPoolTest::testStop()
+{
+    TaskPool pool(1);
+    volatile int count = 0, delayed = 0;
+
+    for (int i = 0; i < 10; i++)
+    {
+        pool.post(boost::bind(task_sleep, &count, 10000));
+    }
+    pool.schedule(boost::bind(task_count, &delayed), 10000);
+
+    // queued tasks are executed, delayed ones are dropped
+    pool.stop();
+    CPPUNIT_ASSERT(count == 10);
+    CPPUNIT_ASSERT(delayed == 0);
+    CPPUNIT_ASSERT(pool.getStat().m_delayed == 0);
+
+    // ignored after the stop
+    pool.post(boost::bind(task_count, &count));
+    usleep(10000);
+    CPPUNIT_ASSERT(count == 10);
+}
@@ -0,0 +1,95 @@
+/**
+   @file src/test/taskpooltest.h
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifndef KLK_TASKPOOLTEST_H
+#define KLK_TASKPOOLTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace klk
+{
+    /**
+       @brief Task pool unit test
+
+       Tests the work-stealing task pool (@ref klk::TaskPool)
+
+       @ingroup grTest
+    */
+    class TaskPoolTest : public CppUnit::TestFixture
+    {
+        CPPUNIT_TEST_SUITE(TaskPoolTest);
+        CPPUNIT_TEST(testPost);
+        CPPUNIT_TEST(testSteal);
+        CPPUNIT_TEST(testSchedule);
+        CPPUNIT_TEST(testScheduleBusy);
+        CPPUNIT_TEST(testStop);
+        CPPUNIT_TEST_SUITE_END();
+    public:
+        /**
+           Constructor
+        */
+        void setUp();
+
+        /**
+           Destructor
+        */
+        void tearDown();
+
+        /**
+           Tests tasks execution and the statistics
+        */
+        void testPost();
+
+        /**
+           Tests that idle workers take tasks from a busy one
+        */
+        void testSteal();
+
+        /**
+           Tests delayed tasks
+        */
+        void testSchedule();
+
+        /**
+           Tests delayed tasks while the workers are busy
+        */
+        void testScheduleBusy();
+
+        /**
+           Tests the pool stop
+        */
+        void testStop();
+    };
+}
+
+#endif //KLK_TASKPOOLTEST_H
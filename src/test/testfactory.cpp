@@ -65,6 +65,10 @@
 #include "exception.h"
 #include "socktest.h"
 #include "modinfotest.h"
+#include "msgqueuetest.h"
+#include "messagetest.h"
+#include "timerwheeltest.h"
+#include "taskpooltest.h"
 
 using namespace klk;
 using namespace klk::test;
@@ -169,6 +173,22 @@ void Factory::createAll()
     CPPUNIT_REGISTRY_ADD(MODINFO, ALL);
     m_ids += MODINFO  + ", ";
 
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MessageQueueTest, MSGQUEUE);
+    CPPUNIT_REGISTRY_ADD(MSGQUEUE, ALL);
+    m_ids += MSGQUEUE + ", ";
+
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MessageTest, MESSAGE);
+    CPPUNIT_REGISTRY_ADD(MESSAGE, ALL);
+    m_ids += MESSAGE + ", ";
+
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TimerWheelTest, TIMERWHEEL);
+    CPPUNIT_REGISTRY_ADD(TIMERWHEEL, ALL);
+    m_ids += TIMERWHEEL + ", ";
+
+    CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TaskPoolTest, TASKPOOL);
+    CPPUNIT_REGISTRY_ADD(TASKPOOL, ALL);
+    m_ids += TASKPOOL + ", ";
+
     CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SocketTest, SOCKET);
     CPPUNIT_REGISTRY_ADD(SOCKET, ALL);
     m_ids += SOCKET;
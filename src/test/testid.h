@@ -139,6 +139,34 @@ namespace klk
         */
         const std::string SOCKET = "socket";
 
+        /**
+           @brief ID for message queue unit tests
+
+           ID for module message queue tests
+        */
+        const std::string MSGQUEUE = "msgqueue";
+
+        /**
+           @brief ID for message unit tests
+
+           ID for message data storage tests
+        */
+        const std::string MESSAGE = "message";
+
+        /**
+           @brief ID for timer wheel unit tests
+
+           ID for the process-wide timer service tests
+        */
+        const std::string TIMERWHEEL = "timerwheel";
+
+        /**
+           @brief ID for task pool unit tests
+
+           ID for the work-stealing task pool tests
+        */
+        const std::string TASKPOOL = "taskpool";
+
         /**
            @brief ID for main unit tests
 
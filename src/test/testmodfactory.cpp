@@ -76,6 +76,7 @@ void ModuleFactory::clear()
         KLKASSERT(getScheduler()->isStarted(thread) == false);
     }
     m_modules.clear();
+    updateRoutes();
     m_resources.clear();
 
     getScheduler()->clear();
@@ -37,6 +37,8 @@
 #include "config.h"
 #endif
 
+#include <sys/time.h>
+
 #include "testutils.h"
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -48,3 +50,10 @@ void klk::test::printOut(const std::string& message)
         CPPUNIT_NS::stdCOut().flush();
 }
 
+// Retrives current time in seconds
+double klk::test::getTime()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
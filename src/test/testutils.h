@@ -59,6 +59,13 @@ namespace klk
         */
         void printOut(const std::string& message);
 
+        /**
+           Retrives current time in seconds
+
+           @return the time
+        */
+        double getTime();
+
         /** @} */
     }
 }
@@ -0,0 +1,143 @@
+/**
+   @file src/test/timerwheeltest.cpp
+   @brief This file is part of Kalinka mediaserver.
+   @author Ivan Murashko <ivan.murashko@gmail.com>
+
+   Copyright (c) 2007-2012 Kalinka Team
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   CHANGE HISTORY
+
+   @date
+   - 2026/10/17 created by ipp (Ivan Murashko)
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+
+#include "timerwheeltest.h"
+#include "timerwheel.h"
+
+using namespace klk;
+
+// Increases the counter
+static void timer_count(volatile int* counter)
+{
+    __sync_add_and_fetch(counter, 1);
+}
+
+// Increases the counter and sleeps
+static void timer_sleep(volatile int* counter, useconds_t usec)
+{
+    timer_count(counter);
+    usleep(usec);
+}
+
+// Increases the counter and removes the timer from its callback
+static void timer_remove(volatile int* counter, TimerWheel* wheel,
+                         TimerID* id)
+{
+    timer_count(counter);
+    wheel->remove(*id);
+}
+
+//
+// TimerWheelTest class
+//
+
+// Constructor
+void TimerWheelTest::setUp()
+{
+}
+
+// Destructor
+void TimerWheelTest::tearDown()
+{
+}
+
+// Tests timer periods and the overrun handling
+void TimerWheelTest::testPeriod()
+{
+    TimerWheel wheel;
+    volatile int fast = 0, slow = 0, never = 0;
+
+    wheel.add(boost::bind(timer_count, &fast), 50);
+    // the callback is longer than the period: missed periods are skipped
+    wheel.add(boost::bind(timer_sleep, &slow, 300000), 100);
+    wheel.add(boost::bind(timer_count, &never), 100000);
+    CPPUNIT_ASSERT(wheel.size() == 3);
+
+    usleep(1020000);
+    CPPUNIT_ASSERT(fast >= 18 && fast <= 21);
+    CPPUNIT_ASSERT(slow >= 3 && slow <= 4);
+    CPPUNIT_ASSERT(never == 0);
+}
+
+// Tests the timer removal
+void TimerWheelTest::testRemove()
+{
+    TimerWheel wheel;
+    volatile int count = 0, self = 0;
+
+    TimerID id = wheel.add(boost::bind(timer_sleep, &count, 200000), 20);
+    TimerID self_id = 0;
+    self_id = wheel.add(boost::bind(timer_remove, &self, &wheel, &self_id),
+                        20);
+    CPPUNIT_ASSERT(id != self_id);
+
+    usleep(100000);
+    CPPUNIT_ASSERT(self == 1);
+    CPPUNIT_ASSERT(wheel.size() == 1);
+
+    // the callback is in progress: remove waits for it
+    CPPUNIT_ASSERT(count == 1);
+    wheel.remove(id);
+    const int removed = count;
+    usleep(100000);
+    CPPUNIT_ASSERT(count == removed);
+    CPPUNIT_ASSERT(wheel.size() == 0);
+
+    // unknown ids are ignored
+    wheel.remove(id);
+}
+
+// Tests that timers with slack share the dispatcher wakeups
+void TimerWheelTest::testCoalescing()
+{
+    TimerWheel wheel;
+    volatile int count = 0;
+
+    for (u_int i = 0; i < 100; i++)
+    {
+        wheel.add(boost::bind(timer_count, &count), 200 + i % 7, 100);
+    }
+
+    const u_long wakeups = wheel.getWakeups();
+    usleep(1000000);
+    CPPUNIT_ASSERT(count >= 300);
+    CPPUNIT_ASSERT(wheel.getWakeups() - wakeups <= 10);
+}